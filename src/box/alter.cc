@@ -215,6 +215,16 @@ index_opts_decode(struct index_opts *opts, const char *map,
 			  "bloom_fpr must be greater than 0 and "
 			  "less than or equal to 1");
 	}
+	if (opts->compaction_policy == index_compaction_policy_MAX) {
+		tnt_raise(ClientError, ER_WRONG_INDEX_OPTIONS,
+			  BOX_INDEX_FIELD_OPTS, "compaction_policy must be "
+			  "'tiered', 'leveled' or 'time_window'");
+	}
+	if (opts->compaction_time_window <= 0) {
+		tnt_raise(ClientError, ER_WRONG_INDEX_OPTIONS,
+			  BOX_INDEX_FIELD_OPTS,
+			  "compaction_time_window must be greater than 0");
+	}
 }
 
 /**
@@ -554,6 +564,11 @@ public:
 	AlterSpaceOp(struct alter_space *alter);
 	struct rlist link;
 	virtual void alter_def(struct alter_space * /* alter */) {}
+	/**
+	 * Build new indexes. Called before alter(), while the
+	 * old space is still intact, and may yield.
+	 */
+	virtual void prepare(struct alter_space * /* alter */) {}
 	virtual void alter(struct alter_space * /* alter */) {}
 	virtual void commit(struct alter_space * /* alter */,
 			    int64_t /* signature */) {}
@@ -770,8 +785,16 @@ alter_space_do(struct txn *txn, struct alter_space *alter)
 	       sizeof(alter->old_space->access));
 
 	/*
-	 * Change the new space: build the new index, rename,
-	 * change the fixed field count.
+	 * Build new indexes. This may yield, so it must be done
+	 * before any changes are made to the old space, which
+	 * remains available for reads and writes meanwhile.
+	 */
+	rlist_foreach_entry(op, &alter->ops, link)
+		op->prepare(alter);
+
+	/*
+	 * Change the new space: rename, change the fixed field
+	 * count. This must not yield.
 	 */
 	try {
 		rlist_foreach_entry(op, &alter->ops, link)
@@ -780,9 +803,7 @@ alter_space_do(struct txn *txn, struct alter_space *alter)
 		/*
 		 * Undo space changes from the last successful
 		 * operation back to the first. Skip the operation
-		 * which failed. An operation may fail during
-		 * alter if, e.g. if it adds a unique key and
-		 * there is a duplicate.
+		 * which failed.
 		 */
 		while (op != rlist_first_entry(&alter->ops,
 					       class AlterSpaceOp, link)) {
@@ -1115,6 +1136,7 @@ public:
 	/** New index index_def. */
 	struct index_def *new_index_def;
 	virtual void alter_def(struct alter_space *alter);
+	virtual void prepare(struct alter_space *alter);
 	virtual void alter(struct alter_space *alter);
 	virtual void commit(struct alter_space *alter, int64_t lsn);
 	virtual ~CreateIndex();
@@ -1154,12 +1176,20 @@ CreateIndex::alter(struct alter_space *alter)
 		space_add_primary_key_xc(alter->new_space);
 		return;
 	}
+}
+
+void
+CreateIndex::prepare(struct alter_space *alter)
+{
+	if (new_index_def->iid == 0)
+		return;
 	/**
-	 * Get the new index and build it.
+	 * Get the new index and build it from the primary key
+	 * of the old space.
 	 */
 	struct index *new_index = index_find_xc(alter->new_space,
 						new_index_def->iid);
-	space_build_secondary_key_xc(alter->new_space,
+	space_build_secondary_key_xc(alter->old_space,
 				     alter->new_space, new_index);
 }
 
@@ -1201,7 +1231,7 @@ public:
 	/** Old index index_def. */
 	struct index_def *old_index_def;
 	virtual void alter_def(struct alter_space *alter);
-	virtual void alter(struct alter_space *alter);
+	virtual void prepare(struct alter_space *alter);
 	virtual void commit(struct alter_space *alter, int64_t signature);
 	virtual ~RebuildIndex();
 };
@@ -1215,14 +1245,13 @@ RebuildIndex::alter_def(struct alter_space *alter)
 }
 
 void
-RebuildIndex::alter(struct alter_space *alter)
+RebuildIndex::prepare(struct alter_space *alter)
 {
 	/* Get the new index and build it.  */
 	struct index *new_index = space_index(alter->new_space,
 					      new_index_def->iid);
 	assert(new_index != NULL);
-	space_build_secondary_key_xc(new_index_def->iid != 0 ?
-				     alter->new_space : alter->old_space,
+	space_build_secondary_key_xc(alter->old_space,
 				     alter->new_space, new_index);
 }
 
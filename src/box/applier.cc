@@ -47,9 +47,50 @@
 #include "xrow_io.h"
 #include "error.h"
 #include "session.h"
+#include "schema.h"
+#include "space.h"
+#include "rmean.h"
+#include "clock.h"
 
 STRS(applier_state, applier_STATE);
 
+const char *applier_stat_strs[] = {
+	"ROWS",
+};
+
+/**
+ * A row received by SUBSCRIBE and queued for an apply fiber.
+ * The row body is copied, because the input buffer may be
+ * reallocated or reset while the row is waiting in the queue.
+ */
+struct applier_row {
+	/** Link in applier::apply_queue. */
+	struct stailq_entry in_queue;
+	/** The row, its body points to the data member. */
+	struct xrow_header row;
+	/** Copy of the row body. */
+	char data[0];
+};
+
+static struct applier_row *
+applier_row_new(struct xrow_header *row)
+{
+	size_t size = sizeof(struct applier_row);
+	for (int i = 0; i < row->bodycnt; i++)
+		size += row->body[i].iov_len;
+	struct applier_row *r = (struct applier_row *) malloc(size);
+	if (r == NULL)
+		tnt_raise(OutOfMemory, size, "malloc", "struct applier_row");
+	r->row = *row;
+	char *data = r->data;
+	for (int i = 0; i < row->bodycnt; i++) {
+		memcpy(data, row->body[i].iov_base, row->body[i].iov_len);
+		r->row.body[i].iov_base = data;
+		data += row->body[i].iov_len;
+	}
+	return r;
+}
+
 static inline void
 applier_set_state(struct applier *applier, enum applier_state state)
 {
@@ -358,6 +399,284 @@ applier_join(struct applier *applier)
 	applier_set_state(applier, APPLIER_READY);
 }
 
+/**
+ * Update apply statistics after a row has been applied.
+ */
+static inline void
+applier_account_row(struct applier *applier, struct xrow_header *row)
+{
+	applier->apply_lag = ev_now(loop()) - row->tm;
+	rmean_collect(applier->stat, APPLIER_STAT_ROWS, 1);
+}
+
+/**
+ * Fiber function applying rows queued by the applier reader.
+ *
+ * A row is picked from the queue and applied without a yield
+ * until its transaction is submitted to WAL, so the rows are
+ * written in the order they were received and rows modifying
+ * the same key are applied in order, while many rows may be
+ * waiting for WAL at the same time.
+ */
+static int
+applier_apply_f(va_list ap)
+{
+	struct applier *applier = va_arg(ap, struct applier *);
+	/*
+	 * Set correct session type for use in on_replace()
+	 * triggers.
+	 */
+	current_session()->type = SESSION_TYPE_APPLIER;
+
+	while (true) {
+		if (stailq_empty(&applier->apply_queue)) {
+			/*
+			 * The master has already been told the rows
+			 * are received, so the queue is drained even
+			 * if the applier is stopping.
+			 */
+			if (applier->apply_stop)
+				break;
+			fiber_cond_wait(&applier->apply_cond);
+			continue;
+		}
+		struct applier_row *r =
+			stailq_shift_entry(&applier->apply_queue,
+					   struct applier_row, in_queue);
+		if (xstream_write(applier->subscribe_stream, &r->row) == 0) {
+			applier_account_row(applier, &r->row);
+		} else if (diag_is_empty(&applier->apply_diag)) {
+			/* Re-thrown by the reader fiber. */
+			diag_move(diag_get(), &applier->apply_diag);
+		} else {
+			diag_log();
+			diag_clear(diag_get());
+		}
+		free(r);
+		applier->apply_in_progress--;
+		fiber_cond_signal(&applier->apply_done_cond);
+		fiber_gc();
+	}
+	return 0;
+}
+
+/**
+ * Apply all queued rows and stop the apply fibers.
+ */
+static void
+applier_stop_apply(struct applier *applier)
+{
+	if (applier->apply_fibers == NULL)
+		return;
+	applier->apply_stop = true;
+	fiber_cond_broadcast(&applier->apply_cond);
+	for (int i = 0; i < applier->apply_fiber_count; i++)
+		fiber_join(applier->apply_fibers[i]);
+	assert(stailq_empty(&applier->apply_queue));
+	assert(applier->apply_in_progress == 0);
+	free(applier->apply_fibers);
+	applier->apply_fibers = NULL;
+	applier->apply_fiber_count = 0;
+	if (!diag_is_empty(&applier->apply_diag)) {
+		/* The error wasn't re-thrown by the reader fiber. */
+		error_log(diag_last_error(&applier->apply_diag));
+		diag_clear(&applier->apply_diag);
+	}
+}
+
+/**
+ * Start replication_apply_fibers fibers applying rows
+ * received by SUBSCRIBE. Does nothing if rows are to be
+ * applied by the reader fiber.
+ */
+static void
+applier_start_apply(struct applier *applier)
+{
+	assert(applier->apply_fibers == NULL);
+	int count = replication_apply_fibers;
+	if (count <= 1)
+		return;
+
+	size_t size = count * sizeof(struct fiber *);
+	applier->apply_fibers = (struct fiber **) malloc(size);
+	if (applier->apply_fibers == NULL)
+		tnt_raise(OutOfMemory, size, "malloc", "apply fibers");
+	applier->apply_stop = false;
+
+	char name[FIBER_NAME_MAX];
+	int pos = snprintf(name, sizeof(name), "appliera/");
+	uri_format(name + pos, sizeof(name) - pos, &applier->uri, false);
+	for (int i = 0; i < count; i++) {
+		struct fiber *f = fiber_new(name, applier_apply_f);
+		if (f == NULL) {
+			applier_stop_apply(applier);
+			diag_raise();
+		}
+		fiber_set_joinable(f, true);
+		applier->apply_fibers[applier->apply_fiber_count++] = f;
+		fiber_start(f, applier);
+	}
+}
+
+/**
+ * Wait until no more than @a count rows are being applied by
+ * apply fibers. Re-throw the error if a row failed to apply.
+ */
+static void
+applier_wait_apply(struct applier *applier, int count)
+{
+	while (applier->apply_in_progress > count &&
+	       diag_is_empty(&applier->apply_diag)) {
+		fiber_cond_wait(&applier->apply_done_cond);
+		fiber_testcancel();
+	}
+	if (!diag_is_empty(&applier->apply_diag)) {
+		diag_move(&applier->apply_diag, diag_get());
+		diag_raise();
+	}
+}
+
+/**
+ * Return true if the row can be applied while other rows are
+ * in progress. Only DML on user memtx spaces qualifies: memtx
+ * doesn't yield before the transaction reaches WAL, which keeps
+ * the order of WAL writes. DDL and rows of other engines are
+ * applied after all rows in progress.
+ */
+static bool
+applier_row_is_parallel(struct xrow_header *row)
+{
+	if (!iproto_type_is_dml(row->type))
+		return false;
+	struct request request;
+	if (xrow_decode_dml(row, &request,
+			    dml_request_key_map(row->type)) != 0) {
+		/* Let the reader fiber raise the error. */
+		diag_clear(diag_get());
+		return false;
+	}
+	struct space *space = space_by_id(request.space_id);
+	return space != NULL && space_is_memtx(space) &&
+	       !space_is_system(space);
+}
+
+/**
+ * Apply a row received by SUBSCRIBE, either in the reader fiber
+ * or by passing it to an apply fiber.
+ */
+static void
+applier_apply_row(struct applier *applier, struct xrow_header *row)
+{
+	if (applier->apply_fibers == NULL) {
+		xstream_write_xc(applier->subscribe_stream, row);
+		applier_account_row(applier, row);
+		return;
+	}
+	if (!applier_row_is_parallel(row)) {
+		applier_wait_apply(applier, 0);
+		xstream_write_xc(applier->subscribe_stream, row);
+		applier_account_row(applier, row);
+		return;
+	}
+	/*
+	 * Keep a few rows queued for each fiber, so that a fiber
+	 * done with its row doesn't wait for the network.
+	 */
+	applier_wait_apply(applier, 2 * applier->apply_fiber_count - 1);
+	struct applier_row *r = applier_row_new(row);
+	stailq_add_tail_entry(&applier->apply_queue, r, in_queue);
+	applier->apply_in_progress++;
+	fiber_cond_signal(&applier->apply_cond);
+}
+
+/**
+ * Unpack a frame of rows compressed by the master
+ * into applier->zrows.
+ */
+static void
+applier_decompress(struct applier *applier, struct xrow_header *row)
+{
+	const char *data;
+	uint32_t size;
+	if (xrow_decode_compressed_rows(row, &data, &size) != 0)
+		diag_raise();
+	if (applier->zdctx == NULL) {
+		applier->zdctx = ZSTD_createDStream();
+		if (applier->zdctx == NULL) {
+			tnt_raise(OutOfMemory, sizeof(applier->zdctx),
+				  "ZSTD_createDStream", "zdctx");
+		}
+	}
+	struct ibuf *zrows = &applier->zrows;
+	assert(ibuf_used(zrows) == 0);
+	ibuf_reset(zrows);
+	double start = clock_thread();
+	ZSTD_initDStream(applier->zdctx);
+	ZSTD_inBuffer input = {data, size, 0};
+	while (true) {
+		ibuf_reserve_xc(zrows, ZSTD_DStreamOutSize());
+		ZSTD_outBuffer output = {zrows->wpos, ibuf_unused(zrows), 0};
+		size_t rc = ZSTD_decompressStream(applier->zdctx,
+						  &output, &input);
+		if (ZSTD_isError(rc)) {
+			tnt_raise(ClientError, ER_DECOMPRESSION,
+				  ZSTD_getErrorName(rc));
+		}
+		zrows->wpos += output.pos;
+		if (rc == 0)
+			break; /* the frame is complete */
+		if (input.pos == input.size && output.pos < output.size) {
+			tnt_raise(ClientError, ER_DECOMPRESSION,
+				  "truncated frame");
+		}
+	}
+	applier->compression_stat.time += clock_thread() - start;
+	applier->compression_stat.raw_size += ibuf_used(zrows);
+	applier->compression_stat.compressed_size += size;
+}
+
+/**
+ * Read the next row sent in response to SUBSCRIBE, unpacking
+ * compressed frames on the way.
+ */
+static void
+applier_read_row(struct applier *applier, struct xrow_header *row)
+{
+	struct ibuf *zrows = &applier->zrows;
+	if (ibuf_used(zrows) == 0) {
+		/*
+		 * Tarantool < 1.7.7 does not send periodic heartbeat
+		 * messages so we can't assume that if we haven't heard
+		 * from the master for quite a while the connection is
+		 * broken - the master might just be idle.
+		 */
+		if (applier->version_id < version_id(1, 7, 7)) {
+			coio_read_xrow(&applier->io, &applier->ibuf, row);
+		} else {
+			double timeout = replication_disconnect_timeout();
+			coio_read_xrow_timeout_xc(&applier->io, &applier->ibuf,
+						  row, timeout);
+		}
+		if (row->type != IPROTO_COMPRESSED_ROWS)
+			return;
+		applier_decompress(applier, row);
+	}
+	/* Rows are packed the same way as on the wire. */
+	const char *pos = zrows->rpos;
+	const char *end = zrows->wpos;
+	if (mp_typeof(*pos) != MP_UINT || mp_check_uint(pos, end) > 0) {
+		tnt_raise(ClientError, ER_INVALID_MSGPACK,
+			  "packet length");
+	}
+	uint32_t len = mp_decode_uint(&pos);
+	if (len > (size_t)(end - pos)) {
+		tnt_raise(ClientError, ER_INVALID_MSGPACK,
+			  "packet length");
+	}
+	xrow_header_decode_xc(row, &pos, pos + len);
+	zrows->rpos = (char *) pos;
+}
+
 /**
  * Execute and process SUBSCRIBE request (follow updates from a master).
  */
@@ -372,7 +691,10 @@ applier_subscribe(struct applier *applier)
 	struct xrow_header row;
 
 	xrow_encode_subscribe_xc(&row, &REPLICASET_UUID, &INSTANCE_UUID,
-				 &replicaset.vclock);
+				 &replicaset.vclock,
+				 replication_compression ?
+				 IPROTO_COMPRESSION_ZSTD :
+				 IPROTO_COMPRESSION_NONE);
 	coio_write_xrow(coio, &row);
 
 	if (applier->state == APPLIER_READY) {
@@ -439,6 +761,8 @@ applier_subscribe(struct applier *applier)
 	}
 
 	applier->lag = TIMEOUT_INFINITY;
+	applier->apply_lag = TIMEOUT_INFINITY;
+	applier_start_apply(applier);
 
 	/*
 	 * Process a stream of rows from the binary log.
@@ -458,18 +782,7 @@ applier_subscribe(struct applier *applier)
 			applier_set_state(applier, APPLIER_FOLLOW);
 		}
 
-		/*
-		 * Tarantool < 1.7.7 does not send periodic heartbeat
-		 * messages so we can't assume that if we haven't heard
-		 * from the master for quite a while the connection is
-		 * broken - the master might just be idle.
-		 */
-		if (applier->version_id < version_id(1, 7, 7)) {
-			coio_read_xrow(coio, ibuf, &row);
-		} else {
-			double timeout = replication_disconnect_timeout();
-			coio_read_xrow_timeout_xc(coio, ibuf, &row, timeout);
-		}
+		applier_read_row(applier, &row);
 
 		if (iproto_type_is_error(row.type))
 			xrow_decode_error_xc(&row);  /* error */
@@ -498,7 +811,7 @@ applier_subscribe(struct applier *applier)
 			 */
 			vclock_follow(&replicaset.vclock, row.replica_id,
 				      row.lsn);
-			xstream_write_xc(applier->subscribe_stream, &row);
+			applier_apply_row(applier, &row);
 		}
 		if (applier->state == APPLIER_SYNC ||
 		    applier->state == APPLIER_FOLLOW)
@@ -513,6 +826,7 @@ static inline void
 applier_disconnect(struct applier *applier, enum applier_state state)
 {
 	applier_set_state(applier, state);
+	applier_stop_apply(applier);
 	if (applier->writer != NULL) {
 		fiber_cancel(applier->writer);
 		fiber_join(applier->writer);
@@ -522,6 +836,7 @@ applier_disconnect(struct applier *applier, enum applier_state state)
 	coio_close(loop(), &applier->io);
 	/* Clear all unparsed input. */
 	ibuf_reinit(&applier->ibuf);
+	ibuf_reinit(&applier->zrows);
 	fiber_gc();
 }
 
@@ -660,8 +975,16 @@ applier_new(const char *uri, struct xstream *join_stream,
 			 "struct applier");
 		return NULL;
 	}
+	applier->stat = rmean_new(applier_stat_strs, APPLIER_STAT_LAST);
+	if (applier->stat == NULL) {
+		free(applier);
+		diag_set(OutOfMemory, sizeof(struct rmean), "rmean_new",
+			 "applier stat");
+		return NULL;
+	}
 	coio_create(&applier->io, -1);
 	ibuf_create(&applier->ibuf, &cord()->slabc, 1024);
+	ibuf_create(&applier->zrows, &cord()->slabc, 1024);
 
 	/* uri_parse() sets pointers to applier->source buffer */
 	snprintf(applier->source, sizeof(applier->source), "%s", uri);
@@ -676,6 +999,11 @@ applier_new(const char *uri, struct xstream *join_stream,
 	rlist_create(&applier->on_state);
 	fiber_cond_create(&applier->resume_cond);
 	fiber_cond_create(&applier->writer_cond);
+	stailq_create(&applier->apply_queue);
+	fiber_cond_create(&applier->apply_cond);
+	fiber_cond_create(&applier->apply_done_cond);
+	diag_create(&applier->apply_diag);
+	applier->apply_lag = TIMEOUT_INFINITY;
 
 	return applier;
 }
@@ -684,11 +1012,19 @@ void
 applier_delete(struct applier *applier)
 {
 	assert(applier->reader == NULL && applier->writer == NULL);
+	assert(applier->apply_fibers == NULL);
 	ibuf_destroy(&applier->ibuf);
+	ibuf_destroy(&applier->zrows);
+	if (applier->zdctx != NULL)
+		ZSTD_freeDStream(applier->zdctx);
 	assert(applier->io.fd == -1);
 	trigger_destroy(&applier->on_state);
 	fiber_cond_destroy(&applier->resume_cond);
 	fiber_cond_destroy(&applier->writer_cond);
+	fiber_cond_destroy(&applier->apply_cond);
+	fiber_cond_destroy(&applier->apply_done_cond);
+	diag_destroy(&applier->apply_diag);
+	rmean_delete(applier->stat);
 	free(applier);
 }
 
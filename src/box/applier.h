@@ -37,15 +37,20 @@
 
 #include <small/ibuf.h>
 
+#include "diag.h"
 #include "fiber_cond.h"
+#include "salad/stailq.h"
 #include "trigger.h"
 #include "trivia/util.h"
 #include "tt_uuid.h"
 #include "uri.h"
 
 #include "vclock.h"
+#include "xrow.h"
+#include "zstd.h"
 
 struct xstream;
+struct rmean;
 
 enum { APPLIER_SOURCE_MAXLEN = 1024 }; /* enough to fit URI with passwords */
 
@@ -67,6 +72,13 @@ enum { APPLIER_SOURCE_MAXLEN = 1024 }; /* enough to fit URI with passwords */
 ENUM(applier_state, applier_STATE);
 extern const char *applier_state_strs[];
 
+enum applier_stat_name {
+	APPLIER_STAT_ROWS,
+	APPLIER_STAT_LAST,
+};
+
+extern const char *applier_stat_strs[];
+
 /**
  * State of a replication connection to the master
  */
@@ -106,6 +118,15 @@ struct applier {
 	struct ev_io io;
 	/** Input buffer */
 	struct ibuf ibuf;
+	/**
+	 * Rows unpacked from the last compressed frame received
+	 * from the master, see box.cfg.replication_compression.
+	 */
+	struct ibuf zrows;
+	/** zstd context to unpack frames, created on demand. */
+	ZSTD_DStream *zdctx;
+	/** Row stream compression statistics. */
+	struct xrow_compression_stat compression_stat;
 	/** Triggers invoked on state change */
 	struct rlist on_state;
 	/**
@@ -119,6 +140,33 @@ struct applier {
 	struct xstream *join_stream;
 	/** xstream to process rows during final JOIN and SUBSCRIBE */
 	struct xstream *subscribe_stream;
+	/**
+	 * Fibers applying rows received by SUBSCRIBE in parallel,
+	 * see box.cfg.replication_apply_fibers. Empty if rows are
+	 * applied by the reader fiber itself.
+	 */
+	struct fiber **apply_fibers;
+	/** Number of fibers in apply_fibers array. */
+	int apply_fiber_count;
+	/** Rows waiting to be picked up by an apply fiber. */
+	struct stailq apply_queue;
+	/** Number of rows queued or being applied right now. */
+	int apply_in_progress;
+	/** Set when apply fibers must exit once the queue is empty. */
+	bool apply_stop;
+	/** Signaled when a row is queued or apply_stop is set. */
+	struct fiber_cond apply_cond;
+	/** Signaled when an apply fiber is done with a row. */
+	struct fiber_cond apply_done_cond;
+	/** Error of the first row that failed to apply in parallel. */
+	struct diag apply_diag;
+	/**
+	 * Number of seconds between the time a row was written
+	 * on the master and the time it was applied locally.
+	 */
+	ev_tstamp apply_lag;
+	/** Applied rows rate, see enum applier_stat_name. */
+	struct rmean *stat;
 };
 
 /**
@@ -160,6 +160,17 @@ box_check_memtx_min_tuple_size(ssize_t memtx_min_tuple_size)
 		  "specified value is out of bounds");
 }
 
+static int
+box_check_memtx_threads(void)
+{
+	int threads = cfg_geti("memtx_threads");
+	if (threads < 1) {
+		tnt_raise(ClientError, ER_CFG, "memtx_threads",
+			  "the value must be greater than 0");
+	}
+	return threads;
+}
+
 static int
 process_rw(struct request *request, struct space *space, struct tuple **result)
 {
@@ -421,6 +432,17 @@ box_check_replication_sync_lag(void)
 	return lag;
 }
 
+static int
+box_check_replication_apply_fibers(void)
+{
+	int count = cfg_geti("replication_apply_fibers");
+	if (count < 1) {
+		tnt_raise(ClientError, ER_CFG, "replication_apply_fibers",
+			  "the value must be greater than 0");
+	}
+	return count;
+}
+
 static void
 box_check_instance_uuid(struct tt_uuid *uuid)
 {
@@ -460,6 +482,76 @@ box_check_readahead(int readahead)
 	}
 }
 
+static int
+box_check_net_connection_msg_max(void)
+{
+	int msg_max = cfg_geti("net_connection_msg_max");
+	if (msg_max < 1) {
+		tnt_raise(ClientError, ER_CFG, "net_connection_msg_max",
+			  "the value must be greater than 0");
+	}
+	return msg_max;
+}
+
+static int
+box_check_net_cursor_max(void)
+{
+	int cursor_max = cfg_geti("net_cursor_max");
+	if (cursor_max < 1) {
+		tnt_raise(ClientError, ER_CFG, "net_cursor_max",
+			  "the value must be greater than 0");
+	}
+	return cursor_max;
+}
+
+static double
+box_check_net_cursor_timeout(void)
+{
+	double timeout = cfg_getd("net_cursor_timeout");
+	if (timeout <= 0) {
+		tnt_raise(ClientError, ER_CFG, "net_cursor_timeout",
+			  "the value must be greater than 0");
+	}
+	return timeout;
+}
+
+static int64_t
+box_check_net_msg_max_size(void)
+{
+	int64_t max_size = cfg_geti64("net_msg_max_size");
+	if (max_size <= 0) {
+		tnt_raise(ClientError, ER_CFG, "net_msg_max_size",
+			  "the value must be greater than 0");
+	}
+	return max_size;
+}
+
+static enum iproto_io_backend
+box_check_net_io_backend(void)
+{
+	const char *name = cfg_gets("net_io_backend");
+	assert(name != NULL); /* checked in Lua */
+	int backend = strindex(iproto_io_backend_STRS, name,
+			       IPROTO_IO_BACKEND_MAX);
+	if (backend == IPROTO_IO_BACKEND_MAX) {
+		tnt_raise(ClientError, ER_CFG, "net_io_backend",
+			  "expected 'libev' or 'io_uring'");
+	}
+	return (enum iproto_io_backend) backend;
+}
+
+static int
+box_check_iproto_threads(void)
+{
+	enum { IPROTO_THREADS_MAX = 64 };
+	int threads = cfg_geti("iproto_threads");
+	if (threads < 1 || threads > IPROTO_THREADS_MAX) {
+		tnt_raise(ClientError, ER_CFG, "iproto_threads",
+			  "the value must be in range [1, 64]");
+	}
+	return threads;
+}
+
 static void
 box_check_checkpoint_count(int checkpoint_count)
 {
@@ -547,12 +639,20 @@ box_check_config()
 	box_check_replication_connect_timeout();
 	box_check_replication_connect_quorum();
 	box_check_replication_sync_lag();
+	box_check_replication_apply_fibers();
 	box_check_readahead(cfg_geti("readahead"));
+	box_check_iproto_threads();
+	box_check_net_io_backend();
+	box_check_net_connection_msg_max();
+	box_check_net_cursor_max();
+	box_check_net_cursor_timeout();
+	box_check_net_msg_max_size();
 	box_check_checkpoint_count(cfg_geti("checkpoint_count"));
 	box_check_wal_max_rows(cfg_geti64("rows_per_wal"));
 	box_check_wal_max_size(cfg_geti64("wal_max_size"));
 	box_check_wal_mode(cfg_gets("wal_mode"));
 	box_check_memtx_min_tuple_size(cfg_geti64("memtx_min_tuple_size"));
+	box_check_memtx_threads();
 	box_check_vinyl_options();
 }
 
@@ -652,6 +752,20 @@ box_set_replication_connect_quorum(void)
 		replicaset_check_quorum();
 }
 
+void
+box_set_replication_apply_fibers(void)
+{
+	/* Takes effect when an applier (re)subscribes. */
+	replication_apply_fibers = box_check_replication_apply_fibers();
+}
+
+void
+box_set_replication_compression(void)
+{
+	/* Takes effect when an applier (re)subscribes. */
+	replication_compression = cfg_geti("replication_compression") != 0;
+}
+
 void
 box_bind(void)
 {
@@ -705,6 +819,15 @@ box_set_memtx_max_tuple_size(void)
 			cfg_geti("memtx_max_tuple_size"));
 }
 
+void
+box_set_memtx_threads(void)
+{
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_set_threads(memtx, box_check_memtx_threads());
+}
+
 void
 box_set_too_long_threshold(void)
 {
@@ -724,6 +847,36 @@ box_set_readahead(void)
 	iproto_readahead = readahead;
 }
 
+void
+box_set_net_connection_msg_max(void)
+{
+	iproto_connection_msg_max = box_check_net_connection_msg_max();
+}
+
+void
+box_set_net_cursor_max(void)
+{
+	iproto_cursor_max = box_check_net_cursor_max();
+}
+
+void
+box_set_net_cursor_timeout(void)
+{
+	iproto_cursor_timeout = box_check_net_cursor_timeout();
+}
+
+void
+box_set_net_msg_max_size(void)
+{
+	iproto_msg_max_size = box_check_net_msg_max_size();
+}
+
+void
+box_set_net_zero_copy_select(void)
+{
+	iproto_zero_copy_select = cfg_geti("net_zero_copy_select") != 0;
+}
+
 void
 box_set_checkpoint_count(void)
 {
@@ -751,6 +904,15 @@ box_set_vinyl_cache(void)
 	vinyl_engine_set_cache(vinyl, cfg_geti64("vinyl_cache"));
 }
 
+void
+box_set_vinyl_page_cache(void)
+{
+	struct vinyl_engine *vinyl;
+	vinyl = (struct vinyl_engine *)engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_page_cache(vinyl, cfg_geti64("vinyl_page_cache"));
+}
+
 void
 box_set_vinyl_timeout(void)
 {
@@ -1409,9 +1571,11 @@ box_process_subscribe(struct ev_io *io, struct xrow_header *header)
 	struct tt_uuid replicaset_uuid = uuid_nil, replica_uuid = uuid_nil;
 	struct vclock replica_clock;
 	uint32_t replica_version_id;
+	uint32_t compression = IPROTO_COMPRESSION_NONE;
 	vclock_create(&replica_clock);
 	xrow_decode_subscribe_xc(header, &replicaset_uuid, &replica_uuid,
-				 &replica_clock, &replica_version_id);
+				 &replica_clock, &replica_version_id,
+				 &compression);
 
 	/* Forbid connection to itself */
 	if (tt_uuid_is_equal(&replica_uuid, &INSTANCE_UUID))
@@ -1479,7 +1643,7 @@ box_process_subscribe(struct ev_io *io, struct xrow_header *header)
 	 * indefinitely).
 	 */
 	relay_subscribe(io->fd, header->sync, replica, &replica_clock,
-			replica_version_id);
+			replica_version_id, compression);
 }
 
 /** Insert a new cluster into _schema */
@@ -1543,6 +1707,7 @@ engine_init()
 				    cfg_getd("slab_alloc_factor"));
 	engine_register((struct engine *)memtx);
 	box_set_memtx_max_tuple_size();
+	box_set_memtx_threads();
 
 	struct sysview_engine *sysview = sysview_engine_new_xc();
 	engine_register((struct engine *)sysview);
@@ -1556,6 +1721,7 @@ engine_init()
 	engine_register((struct engine *)vinyl);
 	box_set_vinyl_max_tuple_size();
 	box_set_vinyl_cache();
+	box_set_vinyl_page_cache();
 	box_set_vinyl_timeout();
 }
 
@@ -1730,7 +1896,7 @@ box_cfg_xc(void)
 	schema_init();
 	replication_init();
 	port_init();
-	iproto_init();
+	iproto_init(box_check_iproto_threads(), box_check_net_io_backend());
 	wal_thread_start();
 
 	title("loading");
@@ -1745,6 +1911,8 @@ box_cfg_xc(void)
 	box_set_replication_connect_timeout();
 	box_set_replication_connect_quorum();
 	replication_sync_lag = box_check_replication_sync_lag();
+	box_set_replication_apply_fibers();
+	box_set_replication_compression();
 	xstream_create(&join_stream, apply_initial_join_row);
 	xstream_create(&subscribe_stream, apply_row);
 
@@ -1810,12 +1978,16 @@ box_cfg_xc(void)
 		 * recovery of system spaces issue DDL events in
 		 * other engines.
 		 */
+		double recovery_start = ev_monotonic_time();
 		memtx_engine_recover_snapshot_xc(memtx,
 				&last_checkpoint_vclock);
+		double snapshot_time = ev_monotonic_time() - recovery_start;
 
 		engine_begin_final_recovery_xc();
+		double wal_start = ev_monotonic_time();
 		recovery_follow_local(recovery, &wal_stream.base, "hot_standby",
 				      cfg_getd("wal_dir_rescan_delay"));
+		double wal_time = ev_monotonic_time() - wal_start;
 		title("hot_standby");
 
 		assert(!tt_uuid_is_nil(&INSTANCE_UUID));
@@ -1835,8 +2007,17 @@ box_cfg_xc(void)
 			}
 			box_bind();
 		}
+		wal_start = ev_monotonic_time();
 		recovery_finalize(recovery, &wal_stream.base);
+		wal_time += ev_monotonic_time() - wal_start;
+		double end_recovery_start = ev_monotonic_time();
 		engine_end_recovery_xc();
+		double end_recovery_time = ev_monotonic_time() -
+					   end_recovery_start;
+		say_info("recovery done: snapshot %.3f sec, xlogs %.3f sec, "
+			 "secondary keys %.3f sec, total %.3f sec",
+			 snapshot_time, wal_time, end_recovery_time,
+			 ev_monotonic_time() - recovery_start);
 
 		/* Check replica set and instance UUID. */
 		if (!tt_uuid_is_nil(&instance_uuid) &&
@@ -2044,6 +2225,7 @@ box_reset_stat(void)
 {
 	rmean_cleanup(rmean_box);
 	rmean_cleanup(rmean_error);
+	wal_reset_stat();
 	engine_reset_stat();
 	space_foreach(box_reset_space_stat, NULL);
 }
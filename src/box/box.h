@@ -174,13 +174,22 @@ void box_set_io_collect_interval(void);
 void box_set_snap_io_rate_limit(void);
 void box_set_too_long_threshold(void);
 void box_set_readahead(void);
+void box_set_net_connection_msg_max(void);
+void box_set_net_cursor_max(void);
+void box_set_net_cursor_timeout(void);
+void box_set_net_msg_max_size(void);
+void box_set_net_zero_copy_select(void);
 void box_set_checkpoint_count(void);
 void box_set_memtx_max_tuple_size(void);
+void box_set_memtx_threads(void);
 void box_set_vinyl_max_tuple_size(void);
 void box_set_vinyl_cache(void);
+void box_set_vinyl_page_cache(void);
 void box_set_vinyl_timeout(void);
 void box_set_replication_timeout(void);
 void box_set_replication_connect_quorum(void);
+void box_set_replication_apply_fibers(void);
+void box_set_replication_compression(void);
 
 extern "C" {
 #endif /* defined(__cplusplus) */
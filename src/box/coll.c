@@ -35,6 +35,7 @@
 #include "diag.h"
 #include <unicode/ucol.h>
 #include <trivia/config.h>
+#include <limits.h>
 
 enum {
 	MAX_HASH_BUFFER = 1024,
@@ -91,6 +92,31 @@ coll_icu_hash(const char *s, size_t s_len, uint32_t *ph, uint32_t *pcarry,
 	return total_size;
 }
 
+/**
+ * Get a comparison hint of a string using ICU collation: the
+ * first bytes of the string sort key, which is compared bytewise,
+ * as a big-endian number.
+ */
+static uint64_t
+coll_icu_hint(const char *s, size_t s_len, struct coll *coll)
+{
+	UCharIterator itr;
+	uiter_setUTF8(&itr, s, s_len);
+	uint8_t buf[sizeof(uint64_t)];
+	uint32_t state[2] = {0, 0};
+	UErrorCode status = U_ZERO_ERROR;
+	int32_t got = ucol_nextSortKeyPart(coll->icu.collator, &itr, state,
+					   buf, sizeof(buf), &status);
+	assert(!U_FAILURE(status));
+	uint64_t result = 0;
+	for (int32_t i = 0; i < (int32_t)sizeof(buf); i++) {
+		result <<= CHAR_BIT;
+		if (i < got)
+			result |= buf[i];
+	}
+	return result;
+}
+
 /**
  * Set up ICU collator and init cmp and hash members of collation.
  * @param coll - collation to set up.
@@ -220,6 +246,7 @@ coll_icu_init_cmp(struct coll *coll, const struct coll_def *def)
 
 	coll->cmp = coll_icu_cmp;
 	coll->hash = coll_icu_hash;
+	coll->hint = coll_icu_hint;
 	return 0;
 }
 
@@ -110,6 +110,12 @@ struct field_def {
 	enum on_conflict_action nullable_action;
 	/** Collation ID for string comparison. */
 	uint32_t coll_id;
+	/**
+	 * True, if the field is frequently read but not indexed.
+	 * Such a field gets an offset slot in the field map of
+	 * new tuples, like an indexed one.
+	 */
+	bool is_hot;
 };
 
 #if defined(__cplusplus)
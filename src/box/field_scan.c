@@ -0,0 +1,297 @@
+/*
+ * Copyright 2010-2018, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "field_scan.h"
+
+#include <trivia/config.h>
+#include <trivia/util.h>
+#include <msgpuck.h>
+#include <cpu_feature.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(HAVE_AVX2_TARGET)
+#include <immintrin.h>
+#endif
+
+/**
+ * Total size of a MessagePack value by its first byte or 0 if
+ * the size depends on the value payload (strings with a length
+ * header, binaries, extensions, arrays and maps).
+ */
+static const uint8_t field_scan_size[256] = {
+	/* 0x00 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0x08 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0x10 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0x18 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0x20 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0x28 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0x30 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0x38 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0x40 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0x48 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0x50 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0x58 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0x60 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0x68 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0x70 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0x78 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0x80 */  0,  0,  0,  0,  0,  0,  0,  0,
+	/* 0x88 */  0,  0,  0,  0,  0,  0,  0,  0,
+	/* 0x90 */  0,  0,  0,  0,  0,  0,  0,  0,
+	/* 0x98 */  0,  0,  0,  0,  0,  0,  0,  0,
+	/* 0xa0 */  1,  2,  3,  4,  5,  6,  7,  8,
+	/* 0xa8 */  9, 10, 11, 12, 13, 14, 15, 16,
+	/* 0xb0 */ 17, 18, 19, 20, 21, 22, 23, 24,
+	/* 0xb8 */ 25, 26, 27, 28, 29, 30, 31, 32,
+	/* 0xc0 */  1,  0,  1,  1,  0,  0,  0,  0,
+	/* 0xc8 */  0,  0,  5,  9,  2,  3,  5,  9,
+	/* 0xd0 */  2,  3,  5,  9,  3,  4,  6, 10,
+	/* 0xd8 */ 18,  0,  0,  0,  0,  0,  0,  0,
+	/* 0xe0 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0xe8 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0xf0 */  1,  1,  1,  1,  1,  1,  1,  1,
+	/* 0xf8 */  1,  1,  1,  1,  1,  1,  1,  1,
+};
+
+/**
+ * Skip a MessagePack value which size can't be determined by
+ * its first byte.
+ */
+static NOINLINE const char *
+field_scan_next_slow(const char *data)
+{
+	uint32_t len;
+	switch (mp_typeof(*data)) {
+	case MP_STR:
+		len = mp_decode_strl(&data);
+		return data + len;
+	case MP_BIN:
+		len = mp_decode_binl(&data);
+		return data + len;
+	default:
+		mp_next(&data);
+		return data;
+	}
+}
+
+/** Skip one MessagePack value of the given size. */
+static inline const char *
+field_scan_next(const char *data, uint8_t size)
+{
+	if (likely(size != 0))
+		return data + size;
+	return field_scan_next_slow(data);
+}
+
+/**
+ * Return the number of one-byte values (positive and negative
+ * fixints, nil, false, true, empty string) at the beginning of
+ * a block of bytes. The block size is defined by the
+ * implementation. Must agree with field_scan_size[] on which
+ * values take one byte.
+ */
+typedef uint32_t (*field_scan_run_f)(const char *data);
+
+/**
+ * Generic skip loop. Inlined into each implementation with
+ * a constant @a run function and block @a width, so that the
+ * compiler generates specialized code for every instruction set.
+ * The block is only classified if it starts with at least two
+ * one-byte values: a lone one is cheaper to skip as is.
+ */
+static inline __attribute__((always_inline)) const char *
+field_scan_skip_generic(const char *data, uint32_t count,
+			field_scan_run_f run, uint32_t width)
+{
+	while (width != 0 && count >= width) {
+		uint8_t size = field_scan_size[(uint8_t)data[0]];
+		if (size == 1 && field_scan_size[(uint8_t)data[1]] == 1) {
+			uint32_t n = run(data);
+			data += n;
+			count -= n;
+		} else {
+			data = field_scan_next(data, size);
+			count--;
+		}
+	}
+	for (; count > 0; count--)
+		data = field_scan_next(data, field_scan_size[(uint8_t)*data]);
+	return data;
+}
+
+/** @copydoc field_scan_skip_generic() */
+static inline __attribute__((always_inline)) const char *
+field_scan_offsets_generic(const char *data, uint32_t count,
+			   const char *base, uint32_t *offsets,
+			   field_scan_run_f run, uint32_t width)
+{
+	while (width != 0 && count >= width) {
+		uint32_t offset = data - base;
+		uint8_t size = field_scan_size[(uint8_t)data[0]];
+		if (size == 1 && field_scan_size[(uint8_t)data[1]] == 1) {
+			uint32_t n = run(data);
+			for (uint32_t i = 0; i < n; i++)
+				offsets[i] = offset + i;
+			offsets += n;
+			data += n;
+			count -= n;
+		} else {
+			*offsets++ = offset;
+			data = field_scan_next(data, size);
+			count--;
+		}
+	}
+	for (; count > 0; count--) {
+		*offsets++ = data - base;
+		data = field_scan_next(data, field_scan_size[(uint8_t)*data]);
+	}
+	*offsets = data - base;
+	return data;
+}
+
+#if !defined(__SSE2__)
+
+static const char *
+field_scan_skip_scalar(const char *data, uint32_t count)
+{
+	return field_scan_skip_generic(data, count, NULL, 0);
+}
+
+static const char *
+field_scan_offsets_scalar(const char *data, uint32_t count, const char *base,
+			  uint32_t *offsets)
+{
+	return field_scan_offsets_generic(data, count, base, offsets,
+					  NULL, 0);
+}
+
+#endif /* !defined(__SSE2__) */
+
+#if defined(__SSE2__)
+
+static inline uint32_t
+field_scan_run_sse2(const char *data)
+{
+	__m128i v = _mm_loadu_si128((const __m128i *)data);
+	/* 0x00..0x7f and 0xe0..0xff are fixints. */
+	__m128i m = _mm_cmpgt_epi8(v, _mm_set1_epi8(-33));
+	/* 0xc0 is nil. */
+	m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8((char)0xc0)));
+	/* 0xa0 is an empty string. */
+	m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8((char)0xa0)));
+	/* 0xc2 and 0xc3 are false and true. */
+	m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_or_si128(v, _mm_set1_epi8(1)),
+					   _mm_set1_epi8((char)0xc3)));
+	uint32_t mask = _mm_movemask_epi8(m);
+	return __builtin_ctz(~mask);
+}
+
+static const char *
+field_scan_skip_sse2(const char *data, uint32_t count)
+{
+	return field_scan_skip_generic(data, count, field_scan_run_sse2,
+				       sizeof(__m128i));
+}
+
+static const char *
+field_scan_offsets_sse2(const char *data, uint32_t count, const char *base,
+			uint32_t *offsets)
+{
+	return field_scan_offsets_generic(data, count, base, offsets,
+					  field_scan_run_sse2,
+					  sizeof(__m128i));
+}
+
+#endif /* defined(__SSE2__) */
+
+#if defined(HAVE_AVX2_TARGET)
+
+static inline __attribute__((target("avx2"))) uint32_t
+field_scan_run_avx2(const char *data)
+{
+	__m256i v = _mm256_loadu_si256((const __m256i *)data);
+	__m256i m = _mm256_cmpgt_epi8(v, _mm256_set1_epi8(-33));
+	m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v,
+				_mm256_set1_epi8((char)0xc0)));
+	m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v,
+				_mm256_set1_epi8((char)0xa0)));
+	m = _mm256_or_si256(m, _mm256_cmpeq_epi8(
+				_mm256_or_si256(v, _mm256_set1_epi8(1)),
+				_mm256_set1_epi8((char)0xc3)));
+	uint32_t mask = _mm256_movemask_epi8(m);
+	return __builtin_ctzll(~(uint64_t)mask);
+}
+
+static __attribute__((target("avx2"))) const char *
+field_scan_skip_avx2(const char *data, uint32_t count)
+{
+	return field_scan_skip_generic(data, count, field_scan_run_avx2,
+				       sizeof(__m256i));
+}
+
+static __attribute__((target("avx2"))) const char *
+field_scan_offsets_avx2(const char *data, uint32_t count, const char *base,
+			uint32_t *offsets)
+{
+	return field_scan_offsets_generic(data, count, base, offsets,
+					  field_scan_run_avx2,
+					  sizeof(__m256i));
+}
+
+#endif /* defined(HAVE_AVX2_TARGET) */
+
+#if defined(__SSE2__)
+field_scan_skip_f field_scan_skip_impl = field_scan_skip_sse2;
+field_scan_offsets_f field_scan_offsets_impl = field_scan_offsets_sse2;
+#else
+field_scan_skip_f field_scan_skip_impl = field_scan_skip_scalar;
+field_scan_offsets_f field_scan_offsets_impl = field_scan_offsets_scalar;
+#endif
+
+void
+field_scan_init(void)
+{
+#if defined(HAVE_AVX2_TARGET) && defined(HAVE_CPUID)
+	if (avx2_enabled_cpu()) {
+		field_scan_skip_impl = field_scan_skip_avx2;
+		field_scan_offsets_impl = field_scan_offsets_avx2;
+		return;
+	}
+#endif
+#if defined(__SSE2__)
+	field_scan_skip_impl = field_scan_skip_sse2;
+	field_scan_offsets_impl = field_scan_offsets_sse2;
+#else
+	field_scan_skip_impl = field_scan_skip_scalar;
+	field_scan_offsets_impl = field_scan_offsets_scalar;
+#endif
+}
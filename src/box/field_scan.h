@@ -0,0 +1,108 @@
+#ifndef TARANTOOL_BOX_FIELD_SCAN_H_INCLUDED
+#define TARANTOOL_BOX_FIELD_SCAN_H_INCLUDED
+/*
+ * Copyright 2010-2018, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Bulk scanning of consecutive MessagePack values, e.g. tuple
+ * fields that have no offset in the tuple field map.
+ *
+ * Skipping a value with mp_next() requires decoding its header
+ * first, so the cost of reaching the N-th field is N dependent
+ * header decodes. Scalars that fit in one byte (small integers,
+ * nil, booleans) are very common in wide tuples, so the vector
+ * implementations classify 16 or 32 bytes at once and skip the
+ * whole run of one-byte values in one step, falling back on
+ * per-value decoding for everything else. The implementation
+ * is picked in field_scan_init() according to the CPU features.
+ *
+ * The input must be valid MessagePack containing at least
+ * @a count values: this guarantees that at least @a count bytes
+ * can be read, which is what makes wide loads safe.
+ */
+
+/** @copydoc field_scan_skip() */
+typedef const char *(*field_scan_skip_f)(const char *data, uint32_t count);
+
+/** @copydoc field_scan_offsets() */
+typedef const char *(*field_scan_offsets_f)(const char *data, uint32_t count,
+					    const char *base,
+					    uint32_t *offsets);
+
+extern field_scan_skip_f field_scan_skip_impl;
+extern field_scan_offsets_f field_scan_offsets_impl;
+
+/**
+ * Select the best implementation for the CPU we are running on.
+ * Until it is called, a portable implementation is used.
+ */
+void
+field_scan_init(void);
+
+/**
+ * Skip @a count MessagePack values.
+ * @param data the first value
+ * @param count number of values to skip
+ * @return pointer to the data following the last skipped value
+ */
+static inline const char *
+field_scan_skip(const char *data, uint32_t count)
+{
+	return field_scan_skip_impl(data, count);
+}
+
+/**
+ * Skip @a count MessagePack values storing their offsets.
+ * @param data the first value
+ * @param count number of values to scan
+ * @param base pointer offsets are calculated relative to
+ * @param[out] offsets array of @a count + 1 elements: the
+ *             offset of each value followed by the offset of
+ *             the data following the last value
+ * @return pointer to the data following the last value
+ */
+static inline const char *
+field_scan_offsets(const char *data, uint32_t count, const char *base,
+		   uint32_t *offsets)
+{
+	return field_scan_offsets_impl(data, count, base, offsets);
+}
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* TARANTOOL_BOX_FIELD_SCAN_H_INCLUDED */
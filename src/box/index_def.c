@@ -36,15 +36,23 @@ const char *index_type_strs[] = { "HASH", "TREE", "BITSET", "RTREE" };
 
 const char *rtree_index_distance_type_strs[] = { "EUCLID", "MANHATTAN" };
 
+const char *index_compaction_policy_strs[] = {
+	"TIERED", "LEVELED", "TIME_WINDOW"
+};
+
 const struct index_opts index_opts_default = {
 	/* .unique              = */ true,
 	/* .dimension           = */ 2,
 	/* .distance            = */ RTREE_INDEX_DISTANCE_TYPE_EUCLID,
+	/* .hint                = */ true,
 	/* .range_size          = */ 1073741824,
 	/* .page_size           = */ 8192,
 	/* .run_count_per_level = */ 2,
 	/* .run_size_ratio      = */ 3.5,
 	/* .bloom_fpr           = */ 0.05,
+	/* .bloom_prefix_parts  = */ 0,
+	/* .compaction_policy   = */ INDEX_COMPACTION_POLICY_TIERED,
+	/* .compaction_time_window = */ 86400,
 	/* .lsn                 = */ 0,
 	/* .sql                 = */ NULL,
 };
@@ -54,11 +62,18 @@ const struct opt_def index_opts_reg[] = {
 	OPT_DEF("dimension", OPT_INT64, struct index_opts, dimension),
 	OPT_DEF_ENUM("distance", rtree_index_distance_type, struct index_opts,
 		     distance, NULL),
+	OPT_DEF("hint", OPT_BOOL, struct index_opts, hint),
 	OPT_DEF("range_size", OPT_INT64, struct index_opts, range_size),
 	OPT_DEF("page_size", OPT_INT64, struct index_opts, page_size),
 	OPT_DEF("run_count_per_level", OPT_INT64, struct index_opts, run_count_per_level),
 	OPT_DEF("run_size_ratio", OPT_FLOAT, struct index_opts, run_size_ratio),
 	OPT_DEF("bloom_fpr", OPT_FLOAT, struct index_opts, bloom_fpr),
+	OPT_DEF("bloom_prefix_parts", OPT_UINT32, struct index_opts,
+		bloom_prefix_parts),
+	OPT_DEF_ENUM("compaction_policy", index_compaction_policy,
+		     struct index_opts, compaction_policy, NULL),
+	OPT_DEF("compaction_time_window", OPT_FLOAT, struct index_opts,
+		compaction_time_window),
 	OPT_DEF("lsn", OPT_INT64, struct index_opts, lsn),
 	OPT_DEF("sql", OPT_STRPTR, struct index_opts, sql),
 	OPT_END,
@@ -240,6 +255,14 @@ index_def_is_valid(struct index_def *index_def, const char *space_name)
 			 space_name, "too many key parts");
 		return false;
 	}
+	if (index_def->opts.bloom_prefix_parts >=
+	    index_def->key_def->part_count &&
+	    index_def->opts.bloom_prefix_parts != 0) {
+		diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+			 space_name, "bloom_prefix_parts must be less than "
+			 "part count");
+		return false;
+	}
 	for (uint32_t i = 0; i < index_def->key_def->part_count; i++) {
 		assert(index_def->key_def->parts[i].type < field_type_MAX);
 		if (index_def->key_def->parts[i].fieldno > BOX_INDEX_FIELD_MAX) {
@@ -58,6 +58,18 @@ enum rtree_index_distance_type {
 };
 extern const char *rtree_index_distance_type_strs[];
 
+/** Vinyl compaction policy. */
+enum index_compaction_policy {
+	/* Size-tiered levels, see vy_range_update_compact_priority(). */
+	INDEX_COMPACTION_POLICY_TIERED,
+	/* One run per level, each run_size_ratio times larger. */
+	INDEX_COMPACTION_POLICY_LEVELED,
+	/* Runs are grouped by time windows, for TTL-style data. */
+	INDEX_COMPACTION_POLICY_TIME_WINDOW,
+	index_compaction_policy_MAX
+};
+extern const char *index_compaction_policy_strs[];
+
 /** Index options */
 struct index_opts {
 	/**
@@ -73,6 +85,11 @@ struct index_opts {
 	 * RTREE distance type.
 	 */
 	enum rtree_index_distance_type distance;
+	/**
+	 * Store comparison hints next to tuples in a memtx
+	 * TREE index. Ignored by other index types.
+	 */
+	bool hint;
 	/**
 	 * Vinyl index options.
 	 */
@@ -91,6 +108,21 @@ struct index_opts {
 	double run_size_ratio;
 	/* Bloom filter false positive rate. */
 	double bloom_fpr;
+	/**
+	 * Number of leading key parts to build an additional
+	 * bloom filter over, so that lookups by a partial key
+	 * can skip runs. 0 if disabled.
+	 */
+	uint32_t bloom_prefix_parts;
+	/**
+	 * The policy used to pick runs for compaction.
+	 */
+	enum index_compaction_policy compaction_policy;
+	/**
+	 * Width of a time window, in seconds, used by the
+	 * time window compaction policy.
+	 */
+	double compaction_time_window;
 	/**
 	 * LSN from the time of index creation.
 	 */
@@ -132,6 +164,8 @@ index_opts_cmp(const struct index_opts *o1, const struct index_opts *o2)
 		return o1->dimension < o2->dimension ? -1 : 1;
 	if (o1->distance != o2->distance)
 		return o1->distance < o2->distance ? -1 : 1;
+	if (o1->hint != o2->hint)
+		return o1->hint < o2->hint ? -1 : 1;
 	if (o1->range_size != o2->range_size)
 		return o1->range_size < o2->range_size ? -1 : 1;
 	if (o1->page_size != o2->page_size)
@@ -143,6 +177,14 @@ index_opts_cmp(const struct index_opts *o1, const struct index_opts *o2)
 		return o1->run_size_ratio < o2->run_size_ratio ? -1 : 1;
 	if (o1->bloom_fpr != o2->bloom_fpr)
 		return o1->bloom_fpr < o2->bloom_fpr ? -1 : 1;
+	if (o1->bloom_prefix_parts != o2->bloom_prefix_parts)
+		return o1->bloom_prefix_parts < o2->bloom_prefix_parts ?
+		       -1 : 1;
+	if (o1->compaction_policy != o2->compaction_policy)
+		return o1->compaction_policy < o2->compaction_policy ? -1 : 1;
+	if (o1->compaction_time_window != o2->compaction_time_window)
+		return o1->compaction_time_window <
+		       o2->compaction_time_window ? -1 : 1;
 	return 0;
 }
 
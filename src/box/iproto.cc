@@ -40,28 +40,45 @@
 
 #include "version.h"
 #include "fiber.h"
+#include "fiber_pool.h"
 #include "cbus.h"
 #include "say.h"
 #include "sio.h"
 #include "evio.h"
+#include "evio_uring.h"
 #include "coio.h"
 #include "scoped_guard.h"
 #include "memory.h"
 
 #include "port.h"
+#include "tuple.h"
+#include "index.h"
+#include "txn.h" /* rmean_box */
 #include "box.h"
 #include "call.h"
 #include "tuple_convert.h"
 #include "session.h"
 #include "xrow.h"
 #include "schema.h" /* schema_version */
+#include "space.h"
 #include "replication.h" /* instance_uuid */
 #include "iproto_constants.h"
 #include "rmean.h"
+#include "histogram.h"
+#include "clock.h"
+#include "assoc.h"
+#include "info.h"
 #include "execute.h"
 
-/* The number of iproto messages in flight */
-enum { IPROTO_MSG_MAX = 768 };
+/*
+ * The max number of iproto messages in flight. Requests are
+ * normally throttled by size (iproto_msg_max_size) and by
+ * connection (iproto_connection_msg_max), this only makes sure
+ * a flood of tiny requests doesn't deplete the tx fiber pool.
+ */
+enum { IPROTO_MSG_MAX = FIBER_POOL_SIZE / 2 };
+/* The minimal number of messages in flight per network thread */
+enum { IPROTO_THREAD_MSG_MIN = 64 };
 
 /**
  * Network readahead. A signed integer to avoid
@@ -80,6 +97,61 @@ enum { IPROTO_MSG_MAX = 768 };
  */
 unsigned iproto_readahead = 16320;
 
+/**
+ * The max number of requests of a single connection being
+ * processed by the tx thread, box.cfg.net_connection_msg_max.
+ * When it is reached, the connection input is stalled until
+ * a reply is sent, so that a single pipelining client can't
+ * occupy all tx fibers. Assigned without locks like readahead.
+ */
+int iproto_connection_msg_max = 768;
+
+/**
+ * The max total size of requests, in bytes, being processed
+ * by the tx thread, box.cfg.net_msg_max_size. Divided evenly
+ * between network threads. Assigned without locks like
+ * readahead.
+ */
+size_t iproto_msg_max_size = 64 * 1024 * 1024;
+
+/**
+ * If set, bodies of big tuples in SELECT replies are sent from
+ * tuple memory instead of being copied to the output buffer,
+ * box.cfg.net_zero_copy_select. Used by the tx thread only.
+ */
+bool iproto_zero_copy_select = false;
+
+/**
+ * The max number of open cursors of a session,
+ * box.cfg.net_cursor_max. Used by the tx thread only.
+ */
+int iproto_cursor_max = 16;
+
+/**
+ * A cursor which hasn't been fetched from for this many
+ * seconds is closed, box.cfg.net_cursor_timeout. Used by the
+ * tx thread only.
+ */
+double iproto_cursor_timeout = 60;
+
+/**
+ * Tuples smaller than this are copied to the output buffer
+ * even in zero-copy mode: an extra iovec and a tuple reference
+ * are more expensive than memcpy() for them.
+ */
+enum { IPROTO_SPLICE_MIN_SIZE = 512 };
+
+/** The max number of splices sent with a single writev(). */
+enum { IPROTO_SPLICE_IOV_MAX = 64 };
+
+/** Submission queue size of a network thread io_uring. */
+enum { IPROTO_URING_ENTRIES = 4096 };
+
+const char *iproto_io_backend_STRS[] = { "libev", "io_uring", NULL };
+
+/** box.cfg.net_io_backend, set at startup. */
+static enum iproto_io_backend iproto_io_backend = IPROTO_IO_LIBEV;
+
 /**
  * How big is a buffer which needs to be shrunk before
  * it is put back into buffer cache.
@@ -125,6 +197,49 @@ iproto_wpos_create(struct iproto_wpos *wpos, struct obuf *out)
 	wpos->svp = obuf_create_svp(out);
 }
 
+/* {{{ iproto_splice - zero-copy output */
+
+/**
+ * A tuple body which is sent to the network directly from
+ * tuple memory rather than from the output buffer. In the
+ * output stream it is inserted before the byte of the output
+ * buffer it refers to.
+ */
+struct iproto_splice {
+	/** Position in the output buffer to insert the data at. */
+	size_t used;
+	/** The tuple pinned until the data is sent. */
+	struct tuple *tuple;
+	/** Tuple data to send. */
+	const char *data;
+	uint32_t size;
+};
+
+/**
+ * All splices of a single reply. Created by the tx thread,
+ * queued to the connection by the network thread and sent
+ * back to tx to unreference the tuples once all of them are
+ * written to the socket or the connection is closed.
+ */
+struct iproto_splice_batch {
+	struct cmsg base;
+	/** Link in iproto_connection::splices. */
+	struct stailq_entry in_queue;
+	/** The output buffer the splices refer to. */
+	struct obuf *obuf;
+	/** Number of splices in the batch. */
+	uint32_t count;
+	struct iproto_splice splices[0];
+};
+
+static struct iproto_splice_batch *
+iproto_splice_batch_new(struct obuf *obuf, uint32_t capacity);
+
+static void
+tx_splice_batch_delete(struct cmsg *m);
+
+/* }}} */
+
 /* {{{ iproto_msg - declaration */
 
 /**
@@ -184,81 +299,336 @@ struct iproto_msg
 	 * and the connection must be closed.
 	 */
 	bool close_connection;
+	/**
+	 * Tuples referenced by the reply instead of being copied
+	 * to the output buffer, NULL if none.
+	 */
+	struct iproto_splice_batch *splices;
+	/**
+	 * Request timeline, clock_monotonic(): when the request
+	 * was decoded in the network thread, when tx started and
+	 * finished processing it. See box.stat.latency().
+	 */
+	double decode_time;
+	double tx_start;
+	double tx_end;
+	/** Time tx spent waiting for WAL writes of the request. */
+	double wal_wait;
 };
 
-static struct mempool iproto_msg_pool;
+enum rmean_net_name {
+	IPROTO_SENT,
+	IPROTO_RECEIVED,
+	/** How many times connection input was throttled. */
+	IPROTO_STALLS,
+	IPROTO_LAST,
+};
 
-static struct iproto_msg *
-iproto_msg_new(struct iproto_connection *con)
-{
-	struct iproto_msg *msg =
-		(struct iproto_msg *) mempool_alloc_xc(&iproto_msg_pool);
-	msg->connection = con;
-	return msg;
-}
+const char *rmean_net_strings[IPROTO_LAST] = {
+	"SENT", "RECEIVED", "STALLS"
+};
+
+/* {{{ Request latency statistics */
+
+/** Stages of a request the latency is measured for. */
+enum iproto_latency_stage {
+	/**
+	 * From the moment the request is decoded till its reply
+	 * is passed back to the network thread for sending.
+	 */
+	IPROTO_LATENCY_TOTAL,
+	/** Waiting in the queue to the tx thread. */
+	IPROTO_LATENCY_QUEUE,
+	/** Execution in the tx thread, WAL wait excluded. */
+	IPROTO_LATENCY_EXECUTE,
+	/** Waiting for the request changes to be written to WAL. */
+	IPROTO_LATENCY_WAL,
+	iproto_latency_stage_MAX,
+};
+
+static const char *iproto_latency_stage_strs[] = {
+	"total", "queue", "execute", "wal",
+};
 
 /**
- * Resume stopped connections, if any.
+ * Latency histograms of the request stages, in microseconds.
+ * Histograms are created on the first observation.
  */
+struct iproto_latency {
+	struct histogram *hist[iproto_latency_stage_MAX];
+};
+
+/**
+ * Request latency by request type and by space, the latter
+ * for DML and SELECT only. Every network thread collects its
+ * own statistics, box.stat.latency() merges them.
+ */
+struct iproto_latency_stat {
+	struct iproto_latency by_type[IPROTO_TYPE_STAT_MAX];
+	/** Space id -> struct iproto_latency. */
+	struct mh_i32ptr_t *by_space;
+};
+
+static struct histogram *
+iproto_latency_histogram_new(void)
+{
+	enum { US = 1, MS = 1000, S = 1000000 };
+	static const int64_t buckets[] = {
+		  1 * US,   2 * US,   3 * US,   4 * US,   5 * US,   6 * US,
+		  7 * US,   8 * US,   9 * US,
+		 10 * US,  20 * US,  30 * US,  40 * US,  50 * US,  60 * US,
+		 70 * US,  80 * US,  90 * US,
+		100 * US, 200 * US, 300 * US, 400 * US, 500 * US, 600 * US,
+		700 * US, 800 * US, 900 * US,
+		  1 * MS,   2 * MS,   3 * MS,   4 * MS,   5 * MS,   6 * MS,
+		  7 * MS,   8 * MS,   9 * MS,
+		 10 * MS,  20 * MS,  30 * MS,  40 * MS,  50 * MS,  60 * MS,
+		 70 * MS,  80 * MS,  90 * MS,
+		100 * MS, 200 * MS, 300 * MS, 400 * MS, 500 * MS, 600 * MS,
+		700 * MS, 800 * MS, 900 * MS,
+		  1 * S,    2 * S,    3 * S,    4 * S,    5 * S,    6 * S,
+		  7 * S,    8 * S,    9 * S,   10 * S,
+	};
+	return histogram_new(buckets, lengthof(buckets));
+}
+
 static void
-iproto_resume();
+iproto_latency_destroy(struct iproto_latency *latency)
+{
+	for (int i = 0; i < iproto_latency_stage_MAX; i++) {
+		if (latency->hist[i] != NULL)
+			histogram_delete(latency->hist[i]);
+		latency->hist[i] = NULL;
+	}
+}
+
+/** Create the histograms if they haven't been created yet. */
+static int
+iproto_latency_prepare(struct iproto_latency *latency)
+{
+	if (latency->hist[0] != NULL)
+		return 0;
+	for (int i = 0; i < iproto_latency_stage_MAX; i++) {
+		latency->hist[i] = iproto_latency_histogram_new();
+		if (latency->hist[i] == NULL) {
+			iproto_latency_destroy(latency);
+			diag_set(OutOfMemory, sizeof(struct histogram),
+				 "malloc", "struct histogram");
+			return -1;
+		}
+	}
+	return 0;
+}
 
 static void
-iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
-		  bool *stop_input);
+iproto_latency_collect(struct iproto_latency *latency,
+		       const double *value)
+{
+	if (iproto_latency_prepare(latency) != 0)
+		return;
+	for (int i = 0; i < iproto_latency_stage_MAX; i++)
+		histogram_collect(latency->hist[i], value[i] * 1000000);
+}
 
-static inline void
-iproto_msg_delete(struct iproto_msg *msg)
+static int
+iproto_latency_merge(struct iproto_latency *dst,
+		     const struct iproto_latency *src)
+{
+	if (src->hist[0] == NULL)
+		return 0;
+	if (iproto_latency_prepare(dst) != 0)
+		return -1;
+	for (int i = 0; i < iproto_latency_stage_MAX; i++)
+		histogram_merge(dst->hist[i], src->hist[i]);
+	return 0;
+}
+
+static int
+iproto_latency_stat_create(struct iproto_latency_stat *stat)
+{
+	memset(stat->by_type, 0, sizeof(stat->by_type));
+	stat->by_space = mh_i32ptr_new();
+	if (stat->by_space == NULL) {
+		diag_set(OutOfMemory, sizeof(*stat->by_space),
+			 "malloc", "latency by space");
+		return -1;
+	}
+	return 0;
+}
+
+/** Forget all observations. */
+static void
+iproto_latency_stat_reset(struct iproto_latency_stat *stat)
+{
+	for (int type = 0; type < IPROTO_TYPE_STAT_MAX; type++)
+		iproto_latency_destroy(&stat->by_type[type]);
+	mh_int_t k;
+	mh_foreach(stat->by_space, k) {
+		struct iproto_latency *latency = (struct iproto_latency *)
+			mh_i32ptr_node(stat->by_space, k)->val;
+		iproto_latency_destroy(latency);
+		free(latency);
+	}
+	mh_i32ptr_clear(stat->by_space);
+}
+
+static void
+iproto_latency_stat_destroy(struct iproto_latency_stat *stat)
+{
+	iproto_latency_stat_reset(stat);
+	mh_i32ptr_delete(stat->by_space);
+}
+
+/** Find or create the latency of requests to a space. */
+static struct iproto_latency *
+iproto_latency_stat_space(struct iproto_latency_stat *stat,
+			  uint32_t space_id)
+{
+	mh_int_t k = mh_i32ptr_find(stat->by_space, space_id, NULL);
+	if (k != mh_end(stat->by_space)) {
+		return (struct iproto_latency *)
+			mh_i32ptr_node(stat->by_space, k)->val;
+	}
+	struct iproto_latency *latency = (struct iproto_latency *)
+		calloc(1, sizeof(*latency));
+	if (latency == NULL) {
+		diag_set(OutOfMemory, sizeof(*latency), "calloc",
+			 "struct iproto_latency");
+		return NULL;
+	}
+	struct mh_i32ptr_node_t node = { space_id, latency };
+	if (mh_i32ptr_put(stat->by_space, &node, NULL, NULL) ==
+	    mh_end(stat->by_space)) {
+		free(latency);
+		diag_set(OutOfMemory, sizeof(node), "malloc",
+			 "latency by space");
+		return NULL;
+	}
+	return latency;
+}
+
+static int
+iproto_latency_stat_merge(struct iproto_latency_stat *dst,
+			  struct iproto_latency_stat *src)
 {
-	mempool_free(&iproto_msg_pool, msg);
-	iproto_resume();
+	for (int type = 0; type < IPROTO_TYPE_STAT_MAX; type++) {
+		if (iproto_latency_merge(&dst->by_type[type],
+					 &src->by_type[type]) != 0)
+			return -1;
+	}
+	mh_int_t k;
+	mh_foreach(src->by_space, k) {
+		struct mh_i32ptr_node_t *node =
+			mh_i32ptr_node(src->by_space, k);
+		struct iproto_latency *latency =
+			iproto_latency_stat_space(dst, node->key);
+		if (latency == NULL ||
+		    iproto_latency_merge(latency,
+			    (struct iproto_latency *) node->val) != 0)
+			return -1;
+	}
+	return 0;
 }
 
+/* }}} */
+
 /**
- * A single global queue for all requests in all connections. All
- * requests from all connections are processed concurrently.
- * Is also used as a queue for just established connections and to
- * execute disconnect triggers. A few notes about these triggers:
- * - they need to be run in a fiber
- * - unlike an ordinary request failure, on_connect trigger
- *   failure must lead to connection close.
- * - on_connect trigger must be processed before any other
- *   request on this connection.
+ * A network thread. Each thread serves its own set of
+ * connections, accepted from the listening socket shared by all
+ * threads, and has its own queue to the tx thread.
  */
-static struct cpipe tx_pipe;
-static struct cpipe net_pipe;
+struct iproto_thread {
+	/** Thread number, 0 .. iproto_thread_count - 1. */
+	int id;
+	/** Network thread. */
+	struct cord net_cord;
+	/**
+	 * A queue for all requests in all connections of the
+	 * thread. All requests from all connections are
+	 * processed concurrently.
+	 * Is also used as a queue for just established
+	 * connections and to execute disconnect triggers. A few
+	 * notes about these triggers:
+	 * - they need to be run in a fiber
+	 * - unlike an ordinary request failure, on_connect trigger
+	 *   failure must lead to connection close.
+	 * - on_connect trigger must be processed before any other
+	 *   request on this connection.
+	 */
+	struct cpipe tx_pipe;
+	/** A pipe from the tx thread to this thread. */
+	struct cpipe net_pipe;
+	/**
+	 * Slab cache used for allocating memory for output
+	 * network buffers in the tx thread.
+	 */
+	struct slab_cache net_slabc;
+	/** Messages sent by connections of this thread. */
+	struct mempool iproto_msg_pool;
+	/** Connections served by this thread. */
+	struct mempool iproto_connection_pool;
+	/**
+	 * Connections with input stopped because the thread
+	 * has too much input in flight. Resumed in FIFO order.
+	 */
+	struct rlist stopped_connections;
+	/**
+	 * Total size of requests sent to tx and not yet
+	 * discarded from input buffers.
+	 */
+	size_t input_size;
+	/**
+	 * Socket I/O of the thread connections, if io_uring
+	 * backend is used, NULL otherwise.
+	 */
+	struct evio_uring *uring;
+	/** Asynchronous writes in progress (struct iproto_flush). */
+	struct mempool iproto_flush_pool;
+	/** Binary protocol listener. */
+	struct evio_service binary;
+	/** Network statistics of the thread. */
+	struct rmean *rmean;
+	/** Latency of requests served by the thread. */
+	struct iproto_latency_stat latency;
+	/*
+	 * Message routes. A route is bound to the pipe of the
+	 * thread the message came from, hence every thread has
+	 * its own copy.
+	 */
+	struct cmsg_hop disconnect_route[2];
+	struct cmsg_hop misc_route[2];
+	struct cmsg_hop call_route[2];
+	struct cmsg_hop select_route[2];
+	struct cmsg_hop fetch_route[2];
+	struct cmsg_hop process1_route[2];
+	struct cmsg_hop sql_route[2];
+	struct cmsg_hop join_route[2];
+	struct cmsg_hop subscribe_route[2];
+	struct cmsg_hop error_route[2];
+	struct cmsg_hop connect_route[2];
+	const struct cmsg_hop *dml_route[IPROTO_TYPE_STAT_MAX];
+};
+
+/** Network threads, box.cfg.iproto_threads. */
+static struct iproto_thread *iproto_threads;
+static int iproto_thread_count;
 
 /**
- * Network thread.
+ * The number of iproto messages in flight a single thread may
+ * have. IPROTO_MSG_MAX is split evenly between threads, so
+ * that they don't deplete the tx fiber pool together.
  */
-static struct cord net_cord;
+static int iproto_thread_msg_max;
 
 /**
- * Slab cache used for allocating memory for output network buffers
- * in the tx thread.
+ * Resume stopped connections, if any.
  */
-static struct slab_cache net_slabc;
-
-struct rmean *rmean_net;
-
-enum rmean_net_name {
-	IPROTO_SENT,
-	IPROTO_RECEIVED,
-	IPROTO_LAST,
-};
-
-const char *rmean_net_strings[IPROTO_LAST] = { "SENT", "RECEIVED" };
-
 static void
-tx_process_disconnect(struct cmsg *m);
+iproto_resume(struct iproto_thread *iproto_thread);
 
 static void
-net_finish_disconnect(struct cmsg *m);
-
-static const struct cmsg_hop disconnect_route[] = {
-	{ tx_process_disconnect, &net_pipe },
-	{ net_finish_disconnect, NULL },
-};
+iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
+		  bool *stop_input);
 
 /* }}} */
 
@@ -330,6 +700,15 @@ struct iproto_connection
 	 * output is available (see iproto_msg::wpos).
 	 */
 	struct iproto_wpos wend;
+	/**
+	 * Splice batches of replies written to the output buffers
+	 * but not sent yet, in the output order.
+	 */
+	struct stailq splices;
+	/** Index of the first unsent splice in the first batch. */
+	uint32_t splice_pos;
+	/** How many bytes of the first unsent splice are sent. */
+	size_t splice_sent;
 	/*
 	 * Size of readahead which is not parsed yet, i.e. size of
 	 * a piece of request which is not fully read. Is always
@@ -348,11 +727,32 @@ struct iproto_connection
 	 * connections.
 	 */
 	int long_poll_requests;
+	/** Number of requests sent to tx and not replied yet. */
+	int msg_count;
+	/**
+	 * True if parsing of input was stopped, because the
+	 * connection has too many requests in flight. The rest
+	 * of the input is parsed when a reply is sent.
+	 */
+	bool is_stalled;
 	struct ev_io input;
 	struct ev_io output;
+	/** io_uring recv() of the input. */
+	struct evio_uring_req recv_req;
+	/** True if recv_req is in progress. */
+	bool is_recv_pending;
+	/** io_uring writev() of the output in progress, or NULL. */
+	struct iproto_flush *flush;
+	/**
+	 * Socket of a closed connection which close() is put off
+	 * until io_uring requests on it complete, or -1.
+	 */
+	int uring_fd;
 	/** Logical session. */
 	struct session *session;
 	ev_loop *loop;
+	/** The network thread serving the connection. */
+	struct iproto_thread *iproto_thread;
 	/* Pre-allocated disconnect msg. */
 	struct iproto_msg *disconnect;
 	struct rlist in_stop_list;
@@ -364,23 +764,63 @@ struct iproto_connection
 		alignas(CACHELINE_SIZE)
 		/** Pointer to the current output buffer. */
 		struct obuf *p_obuf;
+		/** Open cursors of streamed SELECTs. */
+		struct rlist cursors;
+		/** The number of open cursors. */
+		int cursor_count;
 	} tx;
 };
 
-static struct mempool iproto_connection_pool;
-static RLIST_HEAD(stopped_connections);
+static struct iproto_msg *
+iproto_msg_new(struct iproto_connection *con)
+{
+	struct iproto_thread *iproto_thread = con->iproto_thread;
+	struct iproto_msg *msg = (struct iproto_msg *)
+		mempool_alloc_xc(&iproto_thread->iproto_msg_pool);
+	msg->connection = con;
+	msg->splices = NULL;
+	msg->tx_end = 0;
+	return msg;
+}
+
+static inline void
+iproto_msg_delete(struct iproto_msg *msg)
+{
+	struct iproto_thread *iproto_thread = msg->connection->iproto_thread;
+	mempool_free(&iproto_thread->iproto_msg_pool, msg);
+	iproto_resume(iproto_thread);
+}
 
 /**
- * Return true if we have not enough spare messages
- * in the message pool. Disconnect messages are
- * discounted: they are mostly reserved and idle.
+ * Return true if the thread has too much input in flight or
+ * not enough spare messages in the message pool. Disconnect
+ * messages are discounted: they are mostly reserved and idle.
  */
 static inline bool
-iproto_must_stop_input()
+iproto_must_stop_input(struct iproto_thread *iproto_thread)
 {
-	size_t connection_count = mempool_count(&iproto_connection_pool);
-	size_t request_count = mempool_count(&iproto_msg_pool);
-	return request_count > connection_count + IPROTO_MSG_MAX;
+	size_t connection_count =
+		mempool_count(&iproto_thread->iproto_connection_pool);
+	size_t request_count = mempool_count(&iproto_thread->iproto_msg_pool);
+	if (request_count > connection_count + iproto_thread_msg_max)
+		return true;
+	return iproto_thread->input_size >
+	       iproto_msg_max_size / iproto_thread_count;
+}
+
+/**
+ * Discard the input of a request from the input buffer,
+ * after the request has been processed or its arguments
+ * are no longer needed.
+ */
+static inline void
+iproto_msg_discard_input(struct iproto_msg *msg)
+{
+	struct iproto_thread *iproto_thread = msg->connection->iproto_thread;
+	assert(iproto_thread->input_size >= msg->len);
+	iproto_thread->input_size -= msg->len;
+	msg->p_ibuf->rpos += msg->len;
+	msg->len = 0;
 }
 
 /**
@@ -390,20 +830,20 @@ iproto_must_stop_input()
  * object in the message pool.
  */
 static void
-iproto_resume()
+iproto_resume(struct iproto_thread *iproto_thread)
 {
 	/*
 	 * Most of the time we have nothing to do here: throttling
 	 * is not active.
 	 */
-	if (rlist_empty(&stopped_connections))
+	if (rlist_empty(&iproto_thread->stopped_connections))
 		return;
-	if (iproto_must_stop_input())
+	if (iproto_must_stop_input(iproto_thread))
 		return;
 
 	struct iproto_connection *con;
-	con = rlist_first_entry(&stopped_connections, struct iproto_connection,
-				in_stop_list);
+	con = rlist_first_entry(&iproto_thread->stopped_connections,
+				struct iproto_connection, in_stop_list);
 	ev_feed_event(con->loop, &con->input, EV_READ);
 }
 
@@ -425,7 +865,12 @@ iproto_resume()
 static inline bool
 iproto_connection_is_idle(struct iproto_connection *con)
 {
+	/*
+	 * io_uring requests in progress refer to the connection
+	 * buffers, so they have to complete first.
+	 */
 	return con->long_poll_requests == 0 &&
+	       ! con->is_recv_pending && con->flush == NULL &&
 	       ibuf_used(&con->ibuf[0]) == 0 &&
 	       ibuf_used(&con->ibuf[1]) == 0;
 }
@@ -436,8 +881,42 @@ iproto_connection_stop(struct iproto_connection *con)
 	say_warn("readahead limit reached, stopping input on connection %s",
 		 sio_socketname(con->input.fd));
 	assert(rlist_empty(&con->in_stop_list));
+	rmean_collect(con->iproto_thread->rmean, IPROTO_STALLS, 1);
 	ev_io_stop(con->loop, &con->input);
-	rlist_add_tail(&stopped_connections, &con->in_stop_list);
+	rlist_add_tail(&con->iproto_thread->stopped_connections,
+		       &con->in_stop_list);
+}
+
+/**
+ * Give up sending the queued splices of a connection which
+ * output is closed and let tx unreference their tuples.
+ */
+static void
+iproto_connection_drop_splices(struct iproto_connection *con)
+{
+	while (! stailq_empty(&con->splices)) {
+		struct iproto_splice_batch *batch =
+			stailq_shift_entry(&con->splices,
+					   struct iproto_splice_batch,
+					   in_queue);
+		cpipe_push(&con->iproto_thread->tx_pipe, &batch->base);
+	}
+	con->splice_pos = 0;
+	con->splice_sent = 0;
+}
+
+/**
+ * Close the socket of a closed connection as soon as there are
+ * no io_uring requests on it left.
+ */
+static inline void
+iproto_connection_close_uring_fd(struct iproto_connection *con)
+{
+	if (con->uring_fd >= 0 && ! con->is_recv_pending &&
+	    con->flush == NULL) {
+		close(con->uring_fd);
+		con->uring_fd = -1;
+	}
 }
 
 /**
@@ -456,7 +935,22 @@ iproto_connection_close(struct iproto_connection *con)
 		int fd = con->input.fd;
 		/* Make evio_has_fd() happy */
 		con->input.fd = con->output.fd = -1;
-		close(fd);
+		if (con->is_recv_pending || con->flush != NULL) {
+			/*
+			 * An io_uring request may still be queued,
+			 * not submitted yet. If we closed the socket
+			 * now, its number could be reused by a new
+			 * client before the request is submitted and
+			 * the request would run on a wrong socket.
+			 * Requests never block, so hand them to the
+			 * kernel and close the socket once they
+			 * complete, see iproto_connection_close_uring_fd().
+			 */
+			con->uring_fd = fd;
+			evio_uring_submit(con->iproto_thread->uring);
+		} else {
+			close(fd);
+		}
 		/*
 		 * Discard unparsed data, to recycle the
 		 * connection in net_send_msg() as soon as all
@@ -464,6 +958,12 @@ iproto_connection_close(struct iproto_connection *con)
 		 * is done only once.
 		 */
 		con->p_ibuf->wpos -= con->parse_size;
+		/*
+		 * A write in progress may refer to spliced data,
+		 * see iproto_connection_on_writev().
+		 */
+		if (con->flush == NULL)
+			iproto_connection_drop_splices(con);
 	}
 	/*
 	 * If the connection has no outstanding requests in the
@@ -481,7 +981,7 @@ iproto_connection_close(struct iproto_connection *con)
 		assert(con->disconnect != NULL);
 		struct iproto_msg *msg = con->disconnect;
 		con->disconnect = NULL;
-		cpipe_push(&tx_pipe, &msg->base);
+		cpipe_push(&con->iproto_thread->tx_pipe, &msg->base);
 	}
 	rlist_del(&con->in_stop_list);
 }
@@ -579,14 +1079,25 @@ iproto_connection_input_buffer(struct iproto_connection *con)
 static inline void
 iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 {
+	struct iproto_thread *iproto_thread = con->iproto_thread;
+	struct cpipe *tx_pipe = &iproto_thread->tx_pipe;
 	int n_requests = 0;
 	bool stop_input = false;
 	while (con->parse_size && stop_input == false) {
+		if (con->msg_count >= iproto_connection_msg_max) {
+			/*
+			 * Leave the rest of the input in the
+			 * buffer until a reply is sent.
+			 */
+			con->is_stalled = true;
+			rmean_collect(iproto_thread->rmean, IPROTO_STALLS, 1);
+			break;
+		}
 		const char *reqstart = in->wpos - con->parse_size;
 		const char *pos = reqstart;
 		/* Read request length. */
 		if (mp_typeof(*pos) != MP_UINT) {
-			cpipe_flush_input(&tx_pipe);
+			cpipe_flush_input(tx_pipe);
 			tnt_raise(ClientError, ER_INVALID_MSGPACK,
 				  "packet length");
 		}
@@ -601,13 +1112,15 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 		msg->wpos = con->wpos;
 
 		msg->len = reqend - reqstart; /* total request length */
+		iproto_thread->input_size += msg->len;
+		con->msg_count++;
 
 		iproto_msg_decode(msg, &pos, reqend, &stop_input);
 		/*
 		 * This can't throw, but should not be
 		 * done in case of exception.
 		 */
-		cpipe_push_input(&tx_pipe, &msg->base);
+		cpipe_push_input(tx_pipe, &msg->base);
 		n_requests++;
 		/* Request is parsed */
 		assert(reqend > reqstart);
@@ -625,6 +1138,9 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 		 */
 		ev_io_stop(con->loop, &con->output);
 		ev_io_stop(con->loop, &con->input);
+	} else if (con->is_stalled) {
+		/* Resumed by net_send_msg(). */
+		ev_io_stop(con->loop, &con->input);
 	} else if (n_requests != 1 || con->parse_size != 0) {
 		assert(rlist_empty(&con->in_stop_list));
 		/*
@@ -646,7 +1162,64 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 		 */
 		ev_feed_event(con->loop, &con->input, EV_READ);
 	}
-	cpipe_flush_input(&tx_pipe);
+	cpipe_flush_input(tx_pipe);
+}
+
+/**
+ * Handle @a nrd bytes of input read into @a in: advance the
+ * buffer and enqueue the requests which are fully read up.
+ * A negative @a nrd means the socket is not ready.
+ */
+static void
+iproto_connection_on_read(struct iproto_connection *con, struct ibuf *in,
+			  ssize_t nrd)
+{
+	if (nrd < 0) {                  /* Socket is not ready. */
+		ev_io_start(con->loop, &con->input);
+		return;
+	}
+	if (nrd == 0) {                 /* EOF */
+		iproto_connection_close(con);
+		return;
+	}
+	/* Count statistics */
+	rmean_collect(con->iproto_thread->rmean, IPROTO_RECEIVED, nrd);
+
+	/* Update the read position and connection state. */
+	in->wpos += nrd;
+	con->parse_size += nrd;
+	/* Enqueue all requests which are fully read up. */
+	iproto_enqueue_batch(con, in);
+}
+
+/** Complete an io_uring recv() of the connection input. */
+static void
+iproto_connection_on_recv(struct evio_uring_req *req, int res)
+{
+	struct iproto_connection *con =
+		container_of(req, struct iproto_connection, recv_req);
+	assert(con->is_recv_pending);
+	con->is_recv_pending = false;
+	if (! evio_has_fd(&con->input)) {
+		/* The connection was closed meanwhile. */
+		iproto_connection_close_uring_fd(con);
+		if (iproto_connection_is_idle(con))
+			iproto_connection_close(con);
+		return;
+	}
+	int fd = con->input.fd;
+	try {
+		if (res < 0 && res != -EAGAIN && res != -EINTR) {
+			errno = -res;
+			tnt_raise(SocketError, fd, "recv(%d)", fd);
+		}
+		iproto_connection_on_read(con, con->p_ibuf, res);
+	} catch (Exception *e) {
+		/* Best effort at sending the error message to the client. */
+		iproto_write_error(fd, e, ::schema_version, 0);
+		e->log();
+		iproto_connection_close(con);
+	}
 }
 
 static void
@@ -655,8 +1228,13 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 {
 	struct iproto_connection *con =
 		(struct iproto_connection *) watcher->data;
+	struct iproto_thread *iproto_thread = con->iproto_thread;
 	int fd = con->input.fd;
 	assert(fd >= 0);
+	if (con->is_recv_pending) {
+		/* Continued by iproto_connection_on_recv(). */
+		return;
+	}
 	if (! rlist_empty(&con->in_stop_list)) {
 		/* Resumed stopped connection. */
 		rlist_del(&con->in_stop_list);
@@ -665,7 +1243,7 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 		 * resume one more connection which might have
 		 * input.
 		 */
-		iproto_resume();
+		iproto_resume(iproto_thread);
 	}
 	/*
 	 * Throttle if there are too many pending requests,
@@ -674,12 +1252,24 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 	 * another fiber waiting for write to complete).
 	 * Ignore iproto_connection->disconnect messages.
 	 */
-	if (iproto_must_stop_input()) {
+	if (iproto_must_stop_input(iproto_thread)) {
 		iproto_connection_stop(con);
 		return;
 	}
 
 	try {
+		if (con->is_stalled) {
+			if (con->msg_count >= iproto_connection_msg_max)
+				return;
+			/*
+			 * Parse requests left in the buffer
+			 * before reading more.
+			 */
+			con->is_stalled = false;
+			ev_io_start(loop, &con->input);
+			iproto_enqueue_batch(con, con->p_ibuf);
+			return;
+		}
 		/* Ensure we have sufficient space for the next round.  */
 		struct ibuf *in = iproto_connection_input_buffer(con);
 		if (in == NULL) {
@@ -687,23 +1277,14 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 			return;
 		}
 		/* Read input. */
-		int nrd = sio_read(fd, in->wpos, ibuf_unused(in));
-		if (nrd < 0) {                  /* Socket is not ready. */
-			ev_io_start(loop, &con->input);
+		if (iproto_thread->uring != NULL &&
+		    evio_uring_recv(iproto_thread->uring, &con->recv_req, fd,
+				    in->wpos, ibuf_unused(in)) == 0) {
+			con->is_recv_pending = true;
 			return;
 		}
-		if (nrd == 0) {                 /* EOF */
-			iproto_connection_close(con);
-			return;
-		}
-		/* Count statistics */
-		rmean_collect(rmean_net, IPROTO_RECEIVED, nrd);
-
-		/* Update the read position and connection state. */
-		in->wpos += nrd;
-		con->parse_size += nrd;
-		/* Enqueue all requests which are fully read up. */
-		iproto_enqueue_batch(con, in);
+		int nrd = sio_read(fd, in->wpos, ibuf_unused(in));
+		iproto_connection_on_read(con, in, nrd);
 	} catch (Exception *e) {
 		/* Best effort at sending the error message to the client. */
 		iproto_write_error(fd, e, ::schema_version, 0);
@@ -712,63 +1293,260 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 	}
 }
 
-/** writev() to the socket and handle the result. */
+/**
+ * Return the first splice batch of the connection if it refers
+ * to the given output buffer, NULL otherwise.
+ */
+static inline struct iproto_splice_batch *
+iproto_connection_splices(struct iproto_connection *con, struct obuf *obuf)
+{
+	if (stailq_empty(&con->splices))
+		return NULL;
+	struct iproto_splice_batch *batch =
+		stailq_first_entry(&con->splices, struct iproto_splice_batch,
+				   in_queue);
+	return batch->obuf == obuf ? batch : NULL;
+}
 
+/**
+ * Fill @a iov with the output buffer data from @a pos up to
+ * the @a to offset, not going past @a end, and advance @a pos.
+ * Remember the buffer position of each iovec in @a iov_pos.
+ * Return the number of iovecs filled.
+ */
 static int
-iproto_flush(struct iproto_connection *con)
+iproto_obuf_to_iov(struct obuf *obuf, struct obuf_svp *pos, size_t to,
+		   const struct obuf_svp *end, struct iovec *iov,
+		   struct obuf_svp *iov_pos)
+{
+	int iovcnt = 0;
+	while (pos->used < to) {
+		/*
+		 * iov[i].iov_len may be concurrently modified in
+		 * tx thread, but only for the last position.
+		 */
+		size_t len = pos->pos == end->pos ? end->iov_len :
+			     obuf->iov[pos->pos].iov_len;
+		if (len == pos->iov_len) {
+			pos->pos++;
+			pos->iov_len = 0;
+			continue;
+		}
+		len = MIN(len - pos->iov_len, to - pos->used);
+		iov[iovcnt].iov_base = (char *) obuf->iov[pos->pos].iov_base +
+				       pos->iov_len;
+		iov[iovcnt].iov_len = len;
+		iov_pos[iovcnt++] = *pos;
+		pos->used += len;
+		pos->iov_len += len;
+	}
+	return iovcnt;
+}
+
+/**
+ * The max number of iovecs written at once: the whole output
+ * buffer and IPROTO_SPLICE_IOV_MAX splices, each of which may
+ * split an output buffer iovec in two.
+ */
+enum {
+	IPROTO_FLUSH_IOV_MAX = SMALL_OBUF_IOV_MAX + 1 +
+			       2 * IPROTO_SPLICE_IOV_MAX
+};
+
+/**
+ * A portion of the connection output written with a single
+ * writev(): output buffer data interleaved with spliced
+ * tuple data.
+ */
+struct iproto_flush {
+	/** io_uring request, if the write is asynchronous. */
+	struct evio_uring_req req;
+	struct iproto_connection *connection;
+	int iovcnt;
+	/** Total size of the data. */
+	size_t size;
+	struct iovec iov[IPROTO_FLUSH_IOV_MAX];
+	/** Output buffer position of each iovec, unused for splices. */
+	struct obuf_svp iov_pos[IPROTO_FLUSH_IOV_MAX];
+	bool is_splice[IPROTO_FLUSH_IOV_MAX];
+};
+
+/**
+ * Collect the connection output awaiting to be flushed.
+ * At most IPROTO_SPLICE_IOV_MAX splices are collected.
+ * Return false if there is nothing to flush.
+ */
+static bool
+iproto_flush_prepare(struct iproto_connection *con,
+		     struct iproto_flush *flush)
 {
-	int fd = con->output.fd;
 	struct obuf *obuf = con->wpos.obuf;
 	struct obuf_svp obuf_end = obuf_create_svp(obuf);
 	struct obuf_svp *begin = &con->wpos.svp;
 	struct obuf_svp *end = &con->wend.svp;
+	struct iproto_splice_batch *batch =
+		iproto_connection_splices(con, obuf);
 	if (con->wend.obuf != obuf) {
 		/*
 		 * Flush the current buffer before
 		 * advancing to the next one.
 		 */
-		if (begin->used == obuf_end.used) {
+		if (begin->used == obuf_end.used && batch == NULL) {
 			obuf = con->wpos.obuf = con->wend.obuf;
 			obuf_svp_reset(begin);
+			batch = iproto_connection_splices(con, obuf);
 		} else {
 			end = &obuf_end;
 		}
 	}
-	if (begin->used == end->used) {
+	if (begin->used == end->used && batch == NULL) {
 		/* Nothing to do. */
-		return 1;
+		return false;
 	}
-	assert(begin->used < end->used);
-	struct iovec iov[SMALL_OBUF_IOV_MAX+1];
-	struct iovec *src = obuf->iov;
-	int iovcnt = end->pos - begin->pos + 1;
-	/*
-	 * iov[i].iov_len may be concurrently modified in tx thread,
-	 * but only for the last position.
-	 */
-	memcpy(iov, src + begin->pos, iovcnt * sizeof(struct iovec));
-	sio_add_to_iov(iov, -begin->iov_len);
-	/* *Overwrite* iov_len of the last pos as it may be garbage. */
-	iov[iovcnt-1].iov_len = end->iov_len - begin->iov_len * (iovcnt == 1);
-
-	ssize_t nwr = sio_writev(fd, iov, iovcnt);
+	assert(begin->used <= end->used);
+	memset(flush->is_splice, 0, sizeof(flush->is_splice));
+	struct iovec *iov = flush->iov;
+	int iovcnt = 0;
+	struct obuf_svp pos = *begin;
+	uint32_t i = con->splice_pos;
+	size_t sent = con->splice_sent;
+	for (int n = 0; batch != NULL; n++) {
+		struct iproto_splice *splice = &batch->splices[i];
+		assert(splice->used >= pos.used && splice->used <= end->used);
+		iovcnt += iproto_obuf_to_iov(obuf, &pos, splice->used, end,
+					     iov + iovcnt,
+					     flush->iov_pos + iovcnt);
+		if (n == IPROTO_SPLICE_IOV_MAX)
+			break;
+		iov[iovcnt].iov_base = (char *) splice->data + sent;
+		iov[iovcnt].iov_len = splice->size - sent;
+		flush->is_splice[iovcnt++] = true;
+		sent = 0;
+		if (++i < batch->count)
+			continue;
+		i = 0;
+		struct stailq_entry *next = stailq_next(&batch->in_queue);
+		batch = next == NULL ? NULL :
+			stailq_entry(next, struct iproto_splice_batch,
+				     in_queue);
+		if (batch != NULL && batch->obuf != obuf)
+			batch = NULL;
+	}
+	if (batch == NULL) {
+		iovcnt += iproto_obuf_to_iov(obuf, &pos, end->used, end,
+					     iov + iovcnt,
+					     flush->iov_pos + iovcnt);
+	}
+	assert(iovcnt > 0);
+	flush->iovcnt = iovcnt;
+	flush->size = 0;
+	for (int k = 0; k < iovcnt; k++)
+		flush->size += iov[k].iov_len;
+	return true;
+}
 
+/**
+ * Advance the connection output position past @a nwr bytes
+ * of @a flush written to the socket.
+ * @retval  0 Everything is written, but there may be more
+ *            output than fits in a single flush.
+ * @retval -1 The socket is not ready to accept the rest.
+ */
+static int
+iproto_flush_complete(struct iproto_connection *con,
+		      struct iproto_flush *flush, ssize_t nwr)
+{
+	if (nwr <= 0)
+		return -1;
 	/* Count statistics */
-	rmean_collect(rmean_net, IPROTO_SENT, nwr);
-	if (nwr > 0) {
-		if (begin->used + nwr == end->used) {
-			*begin = *end;
-			return 0;
+	rmean_collect(con->iproto_thread->rmean, IPROTO_SENT, nwr);
+	bool is_done = (size_t) nwr == flush->size;
+	for (int k = 0; k < flush->iovcnt && nwr > 0; k++) {
+		size_t len = MIN((size_t) nwr, flush->iov[k].iov_len);
+		nwr -= len;
+		if (! flush->is_splice[k]) {
+			/* Advance write position. */
+			struct obuf_svp *begin = &con->wpos.svp;
+			*begin = flush->iov_pos[k];
+			begin->used += len;
+			begin->iov_len += len;
+			continue;
+		}
+		if (len < flush->iov[k].iov_len) {
+			con->splice_sent += len;
+			break;
+		}
+		/* The splice is sent, move on to the next one. */
+		con->splice_sent = 0;
+		struct iproto_splice_batch *batch =
+			stailq_first_entry(&con->splices,
+					   struct iproto_splice_batch,
+					   in_queue);
+		if (++con->splice_pos == batch->count) {
+			con->splice_pos = 0;
+			stailq_shift(&con->splices);
+			cpipe_push(&con->iproto_thread->tx_pipe, &batch->base);
 		}
-		size_t offset = 0;
-		int advance = 0;
-		advance = sio_move_iov(iov, nwr, &offset);
-		begin->used += nwr;             /* advance write position */
-		begin->iov_len = advance == 0 ? begin->iov_len + offset: offset;
-		begin->pos += advance;
-		assert(begin->pos <= end->pos);
 	}
-	return -1;
+	return is_done ? 0 : -1;
+}
+
+/** iproto_flush() queued the output to io_uring. */
+enum { IPROTO_FLUSH_IN_PROGRESS = 2 };
+
+static void
+iproto_connection_on_writev(struct evio_uring_req *req, int res);
+
+/**
+ * writev() to the socket and handle the result.
+ * @retval  1 Nothing to flush.
+ * @retval  0 The output is written, there may be more.
+ * @retval -1 The socket is not ready.
+ * @retval IPROTO_FLUSH_IN_PROGRESS The write is queued to
+ *         io_uring, it is continued by
+ *         iproto_connection_on_writev().
+ */
+static int
+iproto_flush(struct iproto_connection *con)
+{
+	struct iproto_thread *iproto_thread = con->iproto_thread;
+	if (iproto_thread->uring == NULL) {
+		struct iproto_flush flush;
+		if (! iproto_flush_prepare(con, &flush))
+			return 1;
+		ssize_t nwr = sio_writev(con->output.fd, flush.iov,
+					 flush.iovcnt);
+		return iproto_flush_complete(con, &flush, nwr);
+	}
+	struct iproto_flush *flush = (struct iproto_flush *)
+		mempool_alloc_xc(&iproto_thread->iproto_flush_pool);
+	auto flush_guard = make_scoped_guard([=] {
+		mempool_free(&iproto_thread->iproto_flush_pool, flush);
+	});
+	if (! iproto_flush_prepare(con, flush))
+		return 1;
+	flush->connection = con;
+	flush->req.cb = iproto_connection_on_writev;
+	if (evio_uring_writev(iproto_thread->uring, &flush->req,
+			      con->output.fd, flush->iov,
+			      flush->iovcnt) == 0) {
+		flush_guard.is_active = false;
+		con->flush = flush;
+		return IPROTO_FLUSH_IN_PROGRESS;
+	}
+	/* The ring is full, write synchronously. */
+	ssize_t nwr = sio_writev(con->output.fd, flush->iov, flush->iovcnt);
+	return iproto_flush_complete(con, flush, nwr);
+}
+
+/** Resume reading input as the output is flushed. */
+static inline void
+iproto_connection_feed_input(struct iproto_connection *con)
+{
+	if (! ev_is_active(&con->input) &&
+	    rlist_empty(&con->in_stop_list)) {
+		ev_feed_event(con->loop, &con->input, EV_READ);
+	}
 }
 
 static void
@@ -776,6 +1554,10 @@ iproto_connection_on_output(ev_loop *loop, struct ev_io *watcher,
 			    int /* revents */)
 {
 	struct iproto_connection *con = (struct iproto_connection *) watcher->data;
+	if (con->flush != NULL) {
+		/* Continued by iproto_connection_on_writev(). */
+		return;
+	}
 
 	try {
 		int rc;
@@ -784,10 +1566,7 @@ iproto_connection_on_output(ev_loop *loop, struct ev_io *watcher,
 				ev_io_start(loop, &con->output);
 				return;
 			}
-			if (! ev_is_active(&con->input) &&
-			    rlist_empty(&con->in_stop_list)) {
-				ev_feed_event(loop, &con->input, EV_READ);
-			}
+			iproto_connection_feed_input(con);
 		}
 		if (ev_is_active(&con->output))
 			ev_io_stop(con->loop, &con->output);
@@ -797,57 +1576,328 @@ iproto_connection_on_output(ev_loop *loop, struct ev_io *watcher,
 	}
 }
 
+/** Complete an io_uring writev() of the connection output. */
+static void
+iproto_connection_on_writev(struct evio_uring_req *req, int res)
+{
+	struct iproto_flush *flush = container_of(req, struct iproto_flush,
+						  req);
+	struct iproto_connection *con = flush->connection;
+	struct iproto_thread *iproto_thread = con->iproto_thread;
+	assert(con->flush == flush);
+	con->flush = NULL;
+	auto flush_guard = make_scoped_guard([=] {
+		mempool_free(&iproto_thread->iproto_flush_pool, flush);
+	});
+	if (! evio_has_fd(&con->output)) {
+		/* The connection was closed meanwhile. */
+		iproto_connection_drop_splices(con);
+		iproto_connection_close_uring_fd(con);
+		if (iproto_connection_is_idle(con))
+			iproto_connection_close(con);
+		return;
+	}
+	if (res < 0 && res != -EAGAIN && res != -EINTR) {
+		errno = -res;
+		say_syserror("writev(%d)", con->output.fd);
+		iproto_connection_close(con);
+		return;
+	}
+	if (iproto_flush_complete(con, flush, res) != 0) {
+		ev_io_start(con->loop, &con->output);
+		return;
+	}
+	iproto_connection_feed_input(con);
+	/* Flush the rest of the output, if any. */
+	ev_feed_event(con->loop, &con->output, EV_WRITE);
+}
+
 static struct iproto_connection *
-iproto_connection_new(int fd)
+iproto_connection_new(struct iproto_thread *iproto_thread, int fd)
 {
 	struct iproto_connection *con = (struct iproto_connection *)
-		mempool_alloc_xc(&iproto_connection_pool);
+		mempool_alloc_xc(&iproto_thread->iproto_connection_pool);
 	con->input.data = con->output.data = con;
 	con->loop = loop();
+	con->iproto_thread = iproto_thread;
 	ev_io_init(&con->input, iproto_connection_on_input, fd, EV_READ);
 	ev_io_init(&con->output, iproto_connection_on_output, fd, EV_WRITE);
 	ibuf_create(&con->ibuf[0], cord_slab_cache(), iproto_readahead);
 	ibuf_create(&con->ibuf[1], cord_slab_cache(), iproto_readahead);
-	obuf_create(&con->obuf[0], &net_slabc, iproto_readahead);
-	obuf_create(&con->obuf[1], &net_slabc, iproto_readahead);
+	obuf_create(&con->obuf[0], &iproto_thread->net_slabc,
+		    iproto_readahead);
+	obuf_create(&con->obuf[1], &iproto_thread->net_slabc,
+		    iproto_readahead);
 	con->p_ibuf = &con->ibuf[0];
 	con->tx.p_obuf = &con->obuf[0];
 	iproto_wpos_create(&con->wpos, con->tx.p_obuf);
 	iproto_wpos_create(&con->wend, con->tx.p_obuf);
 	con->parse_size = 0;
 	con->long_poll_requests = 0;
+	con->msg_count = 0;
+	con->is_stalled = false;
+	con->recv_req.cb = iproto_connection_on_recv;
+	con->is_recv_pending = false;
+	con->flush = NULL;
+	con->uring_fd = -1;
+	stailq_create(&con->splices);
+	con->splice_pos = 0;
+	con->splice_sent = 0;
 	con->session = NULL;
 	rlist_create(&con->in_stop_list);
+	rlist_create(&con->tx.cursors);
+	con->tx.cursor_count = 0;
 	/* It may be very awkward to allocate at close. */
 	con->disconnect = iproto_msg_new(con);
-	cmsg_init(&con->disconnect->base, disconnect_route);
+	cmsg_init(&con->disconnect->base, iproto_thread->disconnect_route);
 	return con;
 }
 
-/** Recycle a connection. Never throws. */
-static inline void
-iproto_connection_delete(struct iproto_connection *con)
+/** Recycle a connection. Never throws. */
+static inline void
+iproto_connection_delete(struct iproto_connection *con)
+{
+	assert(iproto_connection_is_idle(con));
+	assert(!evio_has_fd(&con->output));
+	assert(!evio_has_fd(&con->input));
+	assert(con->session == NULL);
+	assert(stailq_empty(&con->splices));
+	assert(rlist_empty(&con->tx.cursors));
+	assert(! con->is_recv_pending && con->flush == NULL);
+	assert(con->uring_fd < 0);
+	/*
+	 * The output buffers must have been deleted
+	 * in tx thread.
+	 */
+	ibuf_destroy(&con->ibuf[0]);
+	ibuf_destroy(&con->ibuf[1]);
+	assert(con->obuf[0].pos == 0 &&
+	       con->obuf[0].iov[0].iov_base == NULL);
+	assert(con->obuf[1].pos == 0 &&
+	       con->obuf[1].iov[0].iov_base == NULL);
+	if (con->disconnect)
+		iproto_msg_delete(con->disconnect);
+	mempool_free(&con->iproto_thread->iproto_connection_pool, con);
+}
+
+/* }}} iproto_connection */
+
+/* {{{ iproto_cursor - cursors of streamed SELECTs */
+
+/**
+ * A server-side cursor of a SELECT with IPROTO_FETCH_SIZE.
+ * Keeps the index iterator open between IPROTO_FETCH requests,
+ * so that a client paging through a big result set doesn't
+ * pay for a tree descent and an access check per page. Lives
+ * in the tx thread.
+ */
+struct iproto_cursor {
+	/** Cursor id, unique within the instance. */
+	uint64_t id;
+	/** The connection which opened the cursor. */
+	struct iproto_connection *connection;
+	/** Iterator of the SELECT. */
+	struct iterator *it;
+	/**
+	 * The next tuple of the result set, referenced, or NULL
+	 * if the result set is exhausted. Reading one tuple ahead
+	 * lets us tell the client there is nothing more to fetch
+	 * together with the last chunk.
+	 */
+	struct tuple *next;
+	/** How many tuples the SELECT limit allows to read. */
+	uint32_t limit;
+	/** Set while a FETCH is reading from the cursor. */
+	bool is_busy;
+	/** ev_monotonic_now() of the last use, for the timeout. */
+	double last_used;
+	/** Link in iproto_connection::tx.cursors. */
+	struct rlist in_connection;
+	/** Link in iproto_cursors, ordered by the last use. */
+	struct rlist in_lru;
+};
+
+static struct mempool iproto_cursor_pool;
+/** All open cursors, the least recently used first. */
+static RLIST_HEAD(iproto_cursors);
+/** Closes the cursors which have timed out. */
+static struct ev_timer iproto_cursor_timer;
+static uint64_t iproto_cursor_next_id = 1;
+
+/** Check the cursor timeouts at least this often, in seconds. */
+static const double IPROTO_CURSOR_TIMER_PERIOD = 1;
+
+static void
+iproto_cursor_delete(struct iproto_cursor *cursor)
+{
+	assert(! cursor->is_busy);
+	if (cursor->next != NULL)
+		tuple_unref(cursor->next);
+	iterator_delete(cursor->it);
+	rlist_del_entry(cursor, in_connection);
+	rlist_del_entry(cursor, in_lru);
+	cursor->connection->tx.cursor_count--;
+	mempool_free(&iproto_cursor_pool, cursor);
+}
+
+/** Close all cursors of a connection. */
+static void
+iproto_cursor_delete_all(struct iproto_connection *con)
+{
+	struct iproto_cursor *cursor, *tmp;
+	rlist_foreach_entry_safe(cursor, &con->tx.cursors, in_connection, tmp)
+		iproto_cursor_delete(cursor);
+	assert(con->tx.cursor_count == 0);
+}
+
+static void
+iproto_cursor_timer_cb(ev_loop *loop, struct ev_timer *timer, int events)
+{
+	(void) events;
+	double deadline = ev_monotonic_now(loop) - iproto_cursor_timeout;
+	struct iproto_cursor *cursor, *tmp;
+	rlist_foreach_entry_safe(cursor, &iproto_cursors, in_lru, tmp) {
+		if (cursor->last_used > deadline)
+			break;
+		/* Will be closed once the FETCH is done. */
+		if (cursor->is_busy)
+			continue;
+		say_debug("closing idle cursor %llu",
+			  (unsigned long long) cursor->id);
+		iproto_cursor_delete(cursor);
+	}
+	if (rlist_empty(&iproto_cursors)) {
+		ev_timer_stop(loop, timer);
+		return;
+	}
+	/* The timeout is dynamic. */
+	timer->repeat = MIN(iproto_cursor_timeout,
+			    IPROTO_CURSOR_TIMER_PERIOD);
+	ev_timer_again(loop, timer);
+}
+
+/** Mark a cursor as used just now. */
+static void
+iproto_cursor_touch(struct iproto_cursor *cursor)
+{
+	cursor->last_used = ev_monotonic_now(loop());
+	rlist_move_tail_entry(&iproto_cursors, cursor, in_lru);
+	if (! ev_is_active(&iproto_cursor_timer)) {
+		iproto_cursor_timer.repeat = MIN(iproto_cursor_timeout,
+						 IPROTO_CURSOR_TIMER_PERIOD);
+		ev_timer_again(loop(), &iproto_cursor_timer);
+	}
+}
+
+/**
+ * Read the next tuple of the result set to cursor->next.
+ * @retval  0 Success, cursor->next is NULL at the end.
+ * @retval -1 Error, see diag.
+ */
+static int
+iproto_cursor_advance(struct iproto_cursor *cursor)
+{
+	if (cursor->next != NULL) {
+		tuple_unref(cursor->next);
+		cursor->next = NULL;
+	}
+	if (cursor->limit == 0)
+		return 0;
+	struct tuple *tuple;
+	if (iterator_next(cursor->it, &tuple) != 0)
+		return -1;
+	if (tuple == NULL)
+		return 0;
+	if (tuple_ref(tuple) != 0)
+		return -1;
+	cursor->next = tuple;
+	cursor->limit--;
+	return 0;
+}
+
+/**
+ * Open a cursor for a SELECT request: create the iterator, skip
+ * the request offset and read the first tuple.
+ */
+static struct iproto_cursor *
+iproto_cursor_new(struct iproto_connection *con, struct request *req)
+{
+	struct iterator *it = box_index_iterator(req->space_id,
+						 req->index_id, req->iterator,
+						 req->key, req->key_end);
+	if (it == NULL)
+		return NULL;
+	struct iproto_cursor *cursor = (struct iproto_cursor *)
+		mempool_alloc(&iproto_cursor_pool);
+	if (cursor == NULL) {
+		iterator_delete(it);
+		diag_set(OutOfMemory, sizeof(*cursor), "mempool_alloc",
+			 "struct iproto_cursor");
+		return NULL;
+	}
+	cursor->id = iproto_cursor_next_id++;
+	cursor->connection = con;
+	cursor->it = it;
+	cursor->next = NULL;
+	cursor->limit = req->limit;
+	cursor->is_busy = true;
+	rlist_add_tail_entry(&con->tx.cursors, cursor, in_connection);
+	rlist_add_tail_entry(&iproto_cursors, cursor, in_lru);
+	con->tx.cursor_count++;
+	iproto_cursor_touch(cursor);
+
+	struct tuple *tuple;
+	for (uint32_t offset = req->offset; offset > 0; offset--) {
+		if (iterator_next(it, &tuple) != 0)
+			goto error;
+		if (tuple == NULL)
+			break;
+	}
+	if (iproto_cursor_advance(cursor) != 0)
+		goto error;
+	cursor->is_busy = false;
+	return cursor;
+error:
+	cursor->is_busy = false;
+	iproto_cursor_delete(cursor);
+	return NULL;
+}
+
+/** Find an open cursor of a connection by id. */
+static struct iproto_cursor *
+iproto_cursor_find(struct iproto_connection *con, uint64_t id)
 {
-	assert(iproto_connection_is_idle(con));
-	assert(!evio_has_fd(&con->output));
-	assert(!evio_has_fd(&con->input));
-	assert(con->session == NULL);
-	/*
-	 * The output buffers must have been deleted
-	 * in tx thread.
-	 */
-	ibuf_destroy(&con->ibuf[0]);
-	ibuf_destroy(&con->ibuf[1]);
-	assert(con->obuf[0].pos == 0 &&
-	       con->obuf[0].iov[0].iov_base == NULL);
-	assert(con->obuf[1].pos == 0 &&
-	       con->obuf[1].iov[0].iov_base == NULL);
-	if (con->disconnect)
-		iproto_msg_delete(con->disconnect);
-	mempool_free(&iproto_connection_pool, con);
+	struct iproto_cursor *cursor;
+	rlist_foreach_entry(cursor, &con->tx.cursors, in_connection) {
+		if (cursor->id == id)
+			return cursor;
+	}
+	diag_set(ClientError, ER_ILLEGAL_PARAMS,
+		 tt_sprintf("cursor %llu is closed or does not exist",
+			    (unsigned long long) id));
+	return NULL;
 }
 
-/* }}} iproto_connection */
+/**
+ * Read up to @a size tuples from a cursor to @a port.
+ * The caller closes the cursor once cursor->next is NULL.
+ */
+static int
+iproto_cursor_fetch(struct iproto_cursor *cursor, uint32_t size,
+		    struct port *port)
+{
+	port_tuple_create(port);
+	for (uint32_t i = 0; i < size && cursor->next != NULL; i++) {
+		if (port_tuple_add(port, cursor->next) != 0 ||
+		    iproto_cursor_advance(cursor) != 0) {
+			port_destroy(port);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/* }}} iproto_cursor */
 
 /* {{{ iproto_msg - methods and routes */
 
@@ -863,6 +1913,9 @@ tx_process1(struct cmsg *msg);
 static void
 tx_process_select(struct cmsg *msg);
 
+static void
+tx_process_fetch(struct cmsg *msg);
+
 static void
 tx_process_sql(struct cmsg *msg);
 
@@ -887,68 +1940,14 @@ net_end_join(struct cmsg *msg);
 static void
 net_end_subscribe(struct cmsg *msg);
 
-static const struct cmsg_hop misc_route[] = {
-	{ tx_process_misc, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop call_route[] = {
-	{ tx_process_call, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop select_route[] = {
-	{ tx_process_select, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop process1_route[] = {
-	{ tx_process1, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop sql_route[] = {
-	{ tx_process_sql, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop *dml_route[IPROTO_TYPE_STAT_MAX] = {
-	NULL,                                   /* IPROTO_OK */
-	select_route,                           /* IPROTO_SELECT */
-	process1_route,                         /* IPROTO_INSERT */
-	process1_route,                         /* IPROTO_REPLACE */
-	process1_route,                         /* IPROTO_UPDATE */
-	process1_route,                         /* IPROTO_DELETE */
-	call_route,                             /* IPROTO_CALL_16 */
-	misc_route,                             /* IPROTO_AUTH */
-	call_route,                             /* IPROTO_EVAL */
-	process1_route,                         /* IPROTO_UPSERT */
-	call_route,                             /* IPROTO_CALL */
-	sql_route,                              /* IPROTO_EXECUTE */
-	NULL,                                   /* IPROTO_NOP */
-};
-
-static const struct cmsg_hop join_route[] = {
-	{ tx_process_join_subscribe, &net_pipe },
-	{ net_end_join, NULL },
-};
-
-static const struct cmsg_hop subscribe_route[] = {
-	{ tx_process_join_subscribe, &net_pipe },
-	{ net_end_subscribe, NULL },
-};
-
-static const struct cmsg_hop error_route[] = {
-	{ tx_reply_iproto_error, &net_pipe },
-	{ net_send_error, NULL },
-};
-
 static void
 iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 		  bool *stop_input)
 {
+	struct iproto_thread *iproto_thread = msg->connection->iproto_thread;
 	uint8_t type;
 
+	msg->decode_time = clock_monotonic();
 	if (xrow_header_decode(&msg->header, pos, reqend))
 		goto error;
 	assert(*pos == reqend);
@@ -970,39 +1969,46 @@ iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 		if (xrow_decode_dml(&msg->header, &msg->dml,
 				    dml_request_key_map(type)))
 			goto error;
-		assert(type < sizeof(dml_route)/sizeof(*dml_route));
-		cmsg_init(&msg->base, dml_route[type]);
+		assert(type < lengthof(iproto_thread->dml_route));
+		cmsg_init(&msg->base, iproto_thread->dml_route[type]);
+		break;
+	case IPROTO_FETCH:
+		if (xrow_decode_dml(&msg->header, &msg->dml,
+				    iproto_key_bit(IPROTO_CURSOR_ID) |
+				    iproto_key_bit(IPROTO_FETCH_SIZE)))
+			goto error;
+		cmsg_init(&msg->base, iproto_thread->fetch_route);
 		break;
 	case IPROTO_CALL_16:
 	case IPROTO_CALL:
 	case IPROTO_EVAL:
 		if (xrow_decode_call(&msg->header, &msg->call))
 			goto error;
-		cmsg_init(&msg->base, call_route);
+		cmsg_init(&msg->base, iproto_thread->call_route);
 		break;
 	case IPROTO_EXECUTE:
 		if (xrow_decode_sql(&msg->header, &msg->sql, &fiber()->gc))
 			goto error;
-		cmsg_init(&msg->base, sql_route);
+		cmsg_init(&msg->base, iproto_thread->sql_route);
 		break;
 	case IPROTO_PING:
-		cmsg_init(&msg->base, misc_route);
+		cmsg_init(&msg->base, iproto_thread->misc_route);
 		break;
 	case IPROTO_JOIN:
-		cmsg_init(&msg->base, join_route);
+		cmsg_init(&msg->base, iproto_thread->join_route);
 		*stop_input = true;
 		break;
 	case IPROTO_SUBSCRIBE:
-		cmsg_init(&msg->base, subscribe_route);
+		cmsg_init(&msg->base, iproto_thread->subscribe_route);
 		*stop_input = true;
 		break;
 	case IPROTO_REQUEST_VOTE:
-		cmsg_init(&msg->base, misc_route);
+		cmsg_init(&msg->base, iproto_thread->misc_route);
 		break;
 	case IPROTO_AUTH:
 		if (xrow_decode_auth(&msg->header, &msg->auth))
 			goto error;
-		cmsg_init(&msg->base, misc_route);
+		cmsg_init(&msg->base, iproto_thread->misc_route);
 		break;
 	default:
 		diag_set(ClientError, ER_UNKNOWN_REQUEST_TYPE,
@@ -1015,7 +2021,7 @@ error:
 	diag_log();
 	diag_create(&msg->diag);
 	diag_move(&fiber()->diag, &msg->diag);
-	cmsg_init(&msg->base, error_route);
+	cmsg_init(&msg->base, iproto_thread->error_route);
 }
 
 static void
@@ -1046,6 +2052,7 @@ tx_process_disconnect(struct cmsg *m)
 {
 	struct iproto_msg *msg = (struct iproto_msg *) m;
 	struct iproto_connection *con = msg->connection;
+	iproto_cursor_delete_all(con);
 	if (con->session) {
 		tx_fiber_init(con->session, 0);
 		/*
@@ -1074,9 +2081,10 @@ static void
 net_finish_disconnect(struct cmsg *m)
 {
 	struct iproto_msg *msg = (struct iproto_msg *) m;
-	/* Runs the trigger, which may yield. */
-	iproto_connection_delete(msg->connection);
+	struct iproto_connection *con = msg->connection;
+	/* The message refers to the connection, delete it first. */
 	iproto_msg_delete(msg);
+	iproto_connection_delete(con);
 }
 
 
@@ -1096,10 +2104,9 @@ net_discard_input(struct cmsg *m)
 {
 	struct iproto_msg *msg = container_of(m, struct iproto_msg,
 					      discard_input);
-	msg->p_ibuf->rpos += msg->len;
-	msg->len = 0;
+	iproto_msg_discard_input(msg);
 	msg->connection->long_poll_requests++;
-	iproto_resume();
+	iproto_resume(msg->connection->iproto_thread);
 }
 
 static void
@@ -1109,7 +2116,8 @@ tx_discard_input(struct iproto_msg *msg)
 		{ net_discard_input, NULL },
 	};
 	cmsg_init(&msg->discard_input, discard_input_route);
-	cpipe_push(&net_pipe, &msg->discard_input);
+	cpipe_push(&msg->connection->iproto_thread->net_pipe,
+		   &msg->discard_input);
 }
 
 /**
@@ -1148,9 +2156,22 @@ tx_accept_msg(struct cmsg *m)
 		 */
 		con->tx.p_obuf = prev;
 	}
+	msg->tx_start = clock_monotonic();
+	msg->wal_wait = 0;
 	return msg;
 }
 
+/**
+ * Let iproto know where the reply to a request ends in the
+ * output buffer. This completes the tx part of the request.
+ */
+static inline void
+tx_end_msg(struct iproto_msg *msg, struct obuf *out)
+{
+	iproto_wpos_create(&msg->wpos, out);
+	msg->tx_end = clock_monotonic();
+}
+
 /**
  * Write error message to the output buffer and advance
  * write position. Doesn't throw.
@@ -1161,7 +2182,7 @@ tx_reply_error(struct iproto_msg *msg)
 	struct obuf *out = msg->connection->tx.p_obuf;
 	iproto_reply_error(out, diag_last_error(&fiber()->diag),
 			   msg->header.sync, ::schema_version);
-	iproto_wpos_create(&msg->wpos, out);
+	tx_end_msg(msg, out);
 }
 
 /**
@@ -1175,7 +2196,7 @@ tx_reply_iproto_error(struct cmsg *m)
 	struct obuf *out = msg->connection->tx.p_obuf;
 	iproto_reply_error(out, diag_last_error(&msg->diag),
 			   msg->header.sync, ::schema_version);
-	iproto_wpos_create(&msg->wpos, out);
+	tx_end_msg(msg, out);
 }
 
 static void
@@ -1190,27 +2211,158 @@ tx_process1(struct cmsg *m)
 
 	struct tuple *tuple;
 	struct obuf_svp svp;
-	if (box_process1(&msg->dml, &tuple) ||
-	    iproto_prepare_select(out, &svp))
+	int rc;
+	fiber_set_key(fiber(), FIBER_KEY_WAL_WAIT, &msg->wal_wait);
+	rc = box_process1(&msg->dml, &tuple);
+	fiber_set_key(fiber(), FIBER_KEY_WAL_WAIT, NULL);
+	if (rc != 0 || iproto_prepare_select(out, &svp))
 		goto error;
 	if (tuple && tuple_to_obuf(tuple, out))
 		goto error;
 	iproto_reply_select(out, &svp, msg->header.sync, ::schema_version,
 			    tuple != 0);
-	iproto_wpos_create(&msg->wpos, out);
+	tx_end_msg(msg, out);
 	return;
 error:
 	tx_reply_error(msg);
 }
 
+static struct iproto_splice_batch *
+iproto_splice_batch_new(struct obuf *obuf, uint32_t capacity)
+{
+	static const struct cmsg_hop splice_release_route[] = {
+		{ tx_splice_batch_delete, NULL },
+	};
+	size_t size = sizeof(struct iproto_splice_batch) +
+		      capacity * sizeof(struct iproto_splice);
+	struct iproto_splice_batch *batch =
+		(struct iproto_splice_batch *) malloc(size);
+	if (batch == NULL) {
+		diag_set(OutOfMemory, size, "malloc", "batch");
+		return NULL;
+	}
+	cmsg_init(&batch->base, splice_release_route);
+	batch->obuf = obuf;
+	batch->count = 0;
+	return batch;
+}
+
+/**
+ * Unreference the tuples of a splice batch, once they are sent
+ * or the connection is closed, and free the batch.
+ */
 static void
-tx_process_select(struct cmsg *m)
+tx_splice_batch_delete(struct cmsg *m)
+{
+	struct iproto_splice_batch *batch = (struct iproto_splice_batch *) m;
+	for (uint32_t i = 0; i < batch->count; i++)
+		tuple_unref(batch->splices[i].tuple);
+	free(batch);
+}
+
+/**
+ * Dump a SELECT result set to the output buffer, like
+ * port_dump_16() does, but reference bodies of big tuples
+ * rather than copy them. The tuples stay pinned until the
+ * network thread writes them to the socket.
+ *
+ * @param[out] spliced_size Size of the referenced data.
+ * @retval >=0 The number of dumped tuples.
+ * @retval  -1 Memory error.
+ */
+static int
+tx_dump_select_spliced(struct iproto_msg *msg, struct port *base,
+		       struct obuf *out, size_t *spliced_size)
+{
+	struct port_tuple *port = port_tuple(base);
+	struct iproto_splice_batch *batch = NULL;
+	*spliced_size = 0;
+	for (struct port_tuple_entry *pe = port->first; pe != NULL;
+	     pe = pe->next) {
+		uint32_t size;
+		const char *data = tuple_data_range(pe->tuple, &size);
+		if (size < IPROTO_SPLICE_MIN_SIZE) {
+			if (obuf_dup(out, data, size) != size) {
+				diag_set(OutOfMemory, size, "obuf_dup",
+					 "data");
+				goto error;
+			}
+			continue;
+		}
+		if (batch == NULL) {
+			batch = iproto_splice_batch_new(out, port->size);
+			if (batch == NULL)
+				goto error;
+		}
+		if (tuple_ref(pe->tuple) != 0)
+			goto error;
+		struct iproto_splice *splice = &batch->splices[batch->count++];
+		splice->used = obuf_size(out);
+		splice->tuple = pe->tuple;
+		splice->data = data;
+		splice->size = size;
+		*spliced_size += size;
+	}
+	msg->splices = batch;
+	return port->size;
+error:
+	if (batch != NULL)
+		tx_splice_batch_delete(&batch->base);
+	return -1;
+}
+
+/**
+ * Write a SELECT result set, or a chunk of it if @a cursor is
+ * not NULL, to the connection output buffer.
+ */
+static int
+tx_reply_select(struct iproto_msg *msg, struct port *port,
+		struct iproto_cursor *cursor)
 {
-	struct iproto_msg *msg = tx_accept_msg(m);
 	struct obuf *out = msg->connection->tx.p_obuf;
 	struct obuf_svp svp;
-	struct port port;
+	size_t spliced_size = 0;
 	int count;
+	if (iproto_prepare_select(out, &svp) != 0)
+		return -1;
+	/*
+	 * SELECT output format has not changed since Tarantool 1.6
+	 */
+	if (iproto_zero_copy_select) {
+		count = tx_dump_select_spliced(msg, port, out,
+					       &spliced_size);
+	} else {
+		count = port_dump_16(port, out);
+	}
+	if (count < 0)
+		goto error;
+	if (cursor == NULL) {
+		iproto_reply_select_spliced(out, &svp, msg->header.sync,
+					    ::schema_version, count,
+					    spliced_size);
+	} else if (iproto_reply_select_cursor(out, &svp, msg->header.sync,
+					      ::schema_version, count,
+					      spliced_size, cursor->id) != 0) {
+		if (msg->splices != NULL) {
+			tx_splice_batch_delete(&msg->splices->base);
+			msg->splices = NULL;
+		}
+		goto error;
+	}
+	tx_end_msg(msg, out);
+	return 0;
+error:
+	/* Discard the prepared select. */
+	obuf_rollback_to_svp(out, &svp);
+	return -1;
+}
+
+static void
+tx_process_select(struct cmsg *m)
+{
+	struct iproto_msg *msg = tx_accept_msg(m);
+	struct iproto_cursor *cursor = NULL;
+	struct port port;
 	int rc;
 	struct request *req = &msg->dml;
 
@@ -1219,28 +2371,102 @@ tx_process_select(struct cmsg *m)
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
 
-	rc = box_select(req->space_id, req->index_id,
-			req->iterator, req->offset, req->limit,
-			req->key, req->key_end, &port);
+	if (req->fetch_size == 0) {
+		rc = box_select(req->space_id, req->index_id,
+				req->iterator, req->offset, req->limit,
+				req->key, req->key_end, &port);
+	} else {
+		/* A streamed SELECT, see IPROTO_FETCH. */
+		rmean_collect(rmean_box, IPROTO_SELECT, 1);
+		cursor = iproto_cursor_new(msg->connection, req);
+		if (cursor == NULL)
+			goto error;
+		cursor->is_busy = true;
+		rc = iproto_cursor_fetch(cursor, req->fetch_size, &port);
+		cursor->is_busy = false;
+		if (rc == 0 && cursor->next != NULL &&
+		    msg->connection->tx.cursor_count > iproto_cursor_max) {
+			/* Only cursors left open count. */
+			diag_set(ClientError, ER_ILLEGAL_PARAMS,
+				 tt_sprintf("too many open cursors, "
+					    "net_cursor_max is %d",
+					    iproto_cursor_max));
+			port_destroy(&port);
+			rc = -1;
+		}
+		if (rc != 0 || cursor->next == NULL) {
+			/* Failed or fits in one chunk. */
+			iproto_cursor_delete(cursor);
+			cursor = NULL;
+		}
+	}
 	if (rc < 0)
 		goto error;
-	if (iproto_prepare_select(out, &svp) != 0) {
-		port_destroy(&port);
+	rc = tx_reply_select(msg, &port, cursor);
+	port_destroy(&port);
+	if (rc != 0) {
+		if (cursor != NULL)
+			iproto_cursor_delete(cursor);
 		goto error;
 	}
-	/*
-	 * SELECT output format has not changed since Tarantool 1.6
-	 */
-	count = port_dump_16(&port, out);
+	return;
+error:
+	tx_reply_error(msg);
+}
+
+/**
+ * Send the next chunk of a streamed SELECT. The access to the
+ * space was checked when the cursor was opened, and schema
+ * changes are handled by the iterator, so neither is checked
+ * here.
+ */
+static void
+tx_process_fetch(struct cmsg *m)
+{
+	struct iproto_msg *msg = tx_accept_msg(m);
+	struct iproto_connection *con = msg->connection;
+	struct request *req = &msg->dml;
+	struct port port;
+	int rc;
+
+	tx_fiber_init(con->session, msg->header.sync);
+
+	rmean_collect(rmean_box, IPROTO_SELECT, 1);
+	struct iproto_cursor *cursor = iproto_cursor_find(con,
+							  req->cursor_id);
+	if (cursor == NULL)
+		goto error;
+	if (cursor->is_busy) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 tt_sprintf("cursor %llu is being fetched from",
+				    (unsigned long long) cursor->id));
+		goto error;
+	}
+	if (req->fetch_size == 0) {
+		/* Close the cursor. */
+		iproto_cursor_delete(cursor);
+		cursor = NULL;
+		port_tuple_create(&port);
+	} else {
+		iproto_cursor_touch(cursor);
+		cursor->is_busy = true;
+		rc = iproto_cursor_fetch(cursor, req->fetch_size, &port);
+		cursor->is_busy = false;
+		iproto_cursor_touch(cursor);
+		if (rc != 0 || cursor->next == NULL) {
+			iproto_cursor_delete(cursor);
+			cursor = NULL;
+		}
+		if (rc != 0)
+			goto error;
+	}
+	rc = tx_reply_select(msg, &port, cursor);
 	port_destroy(&port);
-	if (count < 0) {
-		/* Discard the prepared select. */
-		obuf_rollback_to_svp(out, &svp);
+	if (rc != 0) {
+		if (cursor != NULL)
+			iproto_cursor_delete(cursor);
 		goto error;
 	}
-	iproto_reply_select(out, &svp, msg->header.sync,
-			    ::schema_version, count);
-	iproto_wpos_create(&msg->wpos, out);
 	return;
 error:
 	tx_reply_error(msg);
@@ -1278,6 +2504,7 @@ tx_process_call(struct cmsg *m)
 	int rc;
 	struct port port;
 
+	fiber_set_key(fiber(), FIBER_KEY_WAL_WAIT, &msg->wal_wait);
 	switch (msg->header.type) {
 	case IPROTO_CALL:
 	case IPROTO_CALL_16:
@@ -1289,6 +2516,7 @@ tx_process_call(struct cmsg *m)
 	default:
 		unreachable();
 	}
+	fiber_set_key(fiber(), FIBER_KEY_WAL_WAIT, NULL);
 
 	trigger_clear(&fiber_on_yield);
 
@@ -1332,7 +2560,7 @@ tx_process_call(struct cmsg *m)
 
 	iproto_reply_select(out, &svp, msg->header.sync,
 			    ::schema_version, count);
-	iproto_wpos_create(&msg->wpos, out);
+	tx_end_msg(msg, out);
 	return;
 error:
 	tx_reply_error(msg);
@@ -1368,7 +2596,7 @@ tx_process_misc(struct cmsg *m)
 		default:
 			unreachable();
 		}
-		iproto_wpos_create(&msg->wpos, out);
+		tx_end_msg(msg, out);
 	} catch (Exception *e) {
 		tx_reply_error(msg);
 	}
@@ -1382,15 +2610,19 @@ tx_process_sql(struct cmsg *m)
 {
 	struct iproto_msg *msg = tx_accept_msg(m);
 	struct obuf *out = msg->connection->tx.p_obuf;
+	int rc;
 
 	tx_fiber_init(msg->connection->session, msg->header.sync);
 
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
 	assert(msg->header.type == IPROTO_EXECUTE);
-	if (sql_prepare_and_execute(&msg->sql, out, &fiber()->gc) != 0)
+	fiber_set_key(fiber(), FIBER_KEY_WAL_WAIT, &msg->wal_wait);
+	rc = sql_prepare_and_execute(&msg->sql, out, &fiber()->gc);
+	fiber_set_key(fiber(), FIBER_KEY_WAL_WAIT, NULL);
+	if (rc != 0)
 		goto error;
-	iproto_wpos_create(&msg->wpos, out);
+	tx_end_msg(msg, out);
 	return;
 error:
 	tx_reply_error(msg);
@@ -1434,21 +2666,68 @@ tx_process_join_subscribe(struct cmsg *m)
 	}
 }
 
+/** Account the latency of a request the reply is ready for. */
+static void
+net_collect_latency(struct iproto_msg *msg)
+{
+	uint32_t type = msg->header.type;
+	if (type == IPROTO_FETCH)
+		type = IPROTO_SELECT;
+	else if (type == IPROTO_CALL_16)
+		type = IPROTO_CALL;
+	if (type >= IPROTO_TYPE_STAT_MAX || iproto_type_strs[type] == NULL ||
+	    msg->tx_end == 0)
+		return;
+	double value[iproto_latency_stage_MAX];
+	value[IPROTO_LATENCY_TOTAL] = clock_monotonic() - msg->decode_time;
+	value[IPROTO_LATENCY_QUEUE] = msg->tx_start - msg->decode_time;
+	value[IPROTO_LATENCY_EXECUTE] = MAX(msg->tx_end - msg->tx_start -
+					    msg->wal_wait, 0.0);
+	value[IPROTO_LATENCY_WAL] = msg->wal_wait;
+
+	struct iproto_latency_stat *stat =
+		&msg->connection->iproto_thread->latency;
+	iproto_latency_collect(&stat->by_type[type], value);
+	/* The space of a cursor is unknown in the network thread. */
+	if (!iproto_type_is_dml(type) || msg->header.type == IPROTO_FETCH)
+		return;
+	struct iproto_latency *latency =
+		iproto_latency_stat_space(stat, msg->dml.space_id);
+	if (latency != NULL)
+		iproto_latency_collect(latency, value);
+}
+
 static void
 net_send_msg(struct cmsg *m)
 {
 	struct iproto_msg *msg = (struct iproto_msg *) m;
 	struct iproto_connection *con = msg->connection;
 
+	net_collect_latency(msg);
+
 	if (msg->len != 0) {
 		/* Discard request (see iproto_enqueue_batch()). */
-		msg->p_ibuf->rpos += msg->len;
+		iproto_msg_discard_input(msg);
 	} else {
 		/* Already discarded by net_discard_input(). */
 		assert(con->long_poll_requests > 0);
 		con->long_poll_requests--;
 	}
+	if (msg->splices != NULL) {
+		if (evio_has_fd(&con->output)) {
+			stailq_add_tail_entry(&con->splices, msg->splices,
+					      in_queue);
+		} else {
+			cpipe_push(&con->iproto_thread->tx_pipe,
+				   &msg->splices->base);
+		}
+	}
 	con->wend = msg->wpos;
+	assert(con->msg_count > 0);
+	con->msg_count--;
+	if (con->is_stalled && evio_has_fd(&con->input) &&
+	    con->msg_count < iproto_connection_msg_max)
+		ev_feed_event(con->loop, &con->input, EV_READ);
 
 	if (evio_has_fd(&con->output)) {
 		if (! ev_is_active(&con->output))
@@ -1477,8 +2756,10 @@ net_end_join(struct cmsg *m)
 {
 	struct iproto_msg *msg = (struct iproto_msg *) m;
 	struct iproto_connection *con = msg->connection;
+	struct ibuf *ibuf = msg->p_ibuf;
 
-	msg->p_ibuf->rpos += msg->len;
+	iproto_msg_discard_input(msg);
+	con->msg_count--;
 	iproto_msg_delete(msg);
 
 	assert(! ev_is_active(&con->input));
@@ -1486,7 +2767,7 @@ net_end_join(struct cmsg *m)
 	 * Enqueue any messages if they are in the readahead
 	 * queue. Will simply start input otherwise.
 	 */
-	iproto_enqueue_batch(con, msg->p_ibuf);
+	iproto_enqueue_batch(con, ibuf);
 }
 
 static void
@@ -1495,7 +2776,8 @@ net_end_subscribe(struct cmsg *m)
 	struct iproto_msg *msg = (struct iproto_msg *) m;
 	struct iproto_connection *con = msg->connection;
 
-	msg->p_ibuf->rpos += msg->len;
+	iproto_msg_discard_input(msg);
+	con->msg_count--;
 	iproto_msg_delete(msg);
 
 	assert(! ev_is_active(&con->input));
@@ -1552,7 +2834,8 @@ net_send_greeting(struct cmsg *m)
 						 obuf_iovcnt(out));
 
 			/* Count statistics */
-			rmean_collect(rmean_net, IPROTO_SENT, nwr);
+			rmean_collect(con->iproto_thread->rmean,
+				      IPROTO_SENT, nwr);
 		} catch (Exception *e) {
 			e->log();
 		}
@@ -1573,98 +2856,203 @@ net_send_greeting(struct cmsg *m)
 	iproto_msg_delete(msg);
 }
 
-static const struct cmsg_hop connect_route[] = {
-	{ tx_process_connect, &net_pipe },
-	{ net_send_greeting, NULL },
-};
-
 /** }}} */
 
 /**
  * Create a connection and start input.
  */
 static void
-iproto_on_accept(struct evio_service * /* service */, int fd,
+iproto_on_accept(struct evio_service *service, int fd,
 		 struct sockaddr *addr, socklen_t addrlen)
 {
 	(void) addr;
 	(void) addrlen;
+	struct iproto_thread *iproto_thread =
+		(struct iproto_thread *) service->on_accept_param;
 	struct iproto_connection *con;
 
-	con = iproto_connection_new(fd);
+	con = iproto_connection_new(iproto_thread, fd);
 	/*
 	 * Ignore msg allocation failure - the queue size is
 	 * fixed so there is a limited number of msgs in
 	 * use, all stored in just a few blocks of the memory pool.
 	 */
 	struct iproto_msg *msg = iproto_msg_new(con);
-	cmsg_init(&msg->base, connect_route);
+	cmsg_init(&msg->base, iproto_thread->connect_route);
 	msg->p_ibuf = con->p_ibuf;
 	msg->wpos = con->wpos;
 	msg->close_connection = false;
-	cpipe_push(&tx_pipe, &msg->base);
+	cpipe_push(&iproto_thread->tx_pipe, &msg->base);
 }
 
-static struct evio_service binary; /* iproto binary listener */
+/** Name of the cbus endpoint of a network thread. */
+static const char *
+iproto_thread_endpoint_name(struct iproto_thread *iproto_thread)
+{
+	if (iproto_thread->id == 0)
+		return "net";
+	return tt_sprintf("net%d", iproto_thread->id);
+}
 
 /**
  * The network io thread main function:
  * begin serving the message bus.
  */
 static int
-net_cord_f(va_list /* ap */)
+net_cord_f(va_list ap)
 {
-	mempool_create(&iproto_msg_pool, &cord()->slabc,
+	struct iproto_thread *iproto_thread = va_arg(ap, struct iproto_thread *);
+
+	mempool_create(&iproto_thread->iproto_msg_pool, &cord()->slabc,
 		       sizeof(struct iproto_msg));
-	mempool_create(&iproto_connection_pool, &cord()->slabc,
+	mempool_create(&iproto_thread->iproto_connection_pool, &cord()->slabc,
 		       sizeof(struct iproto_connection));
+	mempool_create(&iproto_thread->iproto_flush_pool, &cord()->slabc,
+		       sizeof(struct iproto_flush));
+	if (iproto_io_backend == IPROTO_IO_URING) {
+		iproto_thread->uring = (struct evio_uring *)
+			malloc(sizeof(struct evio_uring));
+		if (iproto_thread->uring == NULL) {
+			tnt_raise(OutOfMemory, sizeof(struct evio_uring),
+				  "malloc", "struct evio_uring");
+		}
+		if (evio_uring_create(iproto_thread->uring, loop(),
+				      IPROTO_URING_ENTRIES) != 0) {
+			diag_log();
+			say_warn("io_uring is not available, "
+				 "falling back to libev");
+			free(iproto_thread->uring);
+			iproto_thread->uring = NULL;
+		}
+	}
 
-	evio_service_init(loop(), &binary, "binary",
-			  iproto_on_accept, NULL);
+	evio_service_init(loop(), &iproto_thread->binary, "binary",
+			  iproto_on_accept, iproto_thread);
 
 
 	/* Init statistics counter */
-	rmean_net = rmean_new(rmean_net_strings, IPROTO_LAST);
+	iproto_thread->rmean = rmean_new(rmean_net_strings, IPROTO_LAST);
 
-	if (rmean_net == NULL) {
+	if (iproto_thread->rmean == NULL) {
 		tnt_raise(OutOfMemory, sizeof(struct rmean),
 			  "rmean", "struct rmean");
 	}
+	if (iproto_latency_stat_create(&iproto_thread->latency) != 0)
+		diag_raise();
 
 	struct cbus_endpoint endpoint;
 	/* Create "net" endpoint. */
-	cbus_endpoint_create(&endpoint, "net", fiber_schedule_cb, fiber());
+	cbus_endpoint_create(&endpoint,
+			     iproto_thread_endpoint_name(iproto_thread),
+			     fiber_schedule_cb, fiber());
 	/* Create a pipe to "tx" thread. */
-	cpipe_create(&tx_pipe, "tx");
-	cpipe_set_max_input(&tx_pipe, IPROTO_MSG_MAX/2);
+	cpipe_create(&iproto_thread->tx_pipe, "tx");
+	cpipe_set_max_input(&iproto_thread->tx_pipe, iproto_thread_msg_max / 2);
 	/* Process incomming messages. */
 	cbus_loop(&endpoint);
 
-	cpipe_destroy(&tx_pipe);
+	cpipe_destroy(&iproto_thread->tx_pipe);
 	/*
 	 * Nothing to do in the fiber so far, the service
 	 * will take care of creating events for incoming
 	 * connections.
 	 */
-	if (evio_service_is_active(&binary))
-		evio_service_stop(&binary);
-
-	rmean_delete(rmean_net);
+	if (evio_service_is_active(&iproto_thread->binary))
+		evio_service_stop(&iproto_thread->binary);
+
+	rmean_delete(iproto_thread->rmean);
+	iproto_latency_stat_destroy(&iproto_thread->latency);
+	if (iproto_thread->uring != NULL) {
+		evio_uring_destroy(iproto_thread->uring);
+		free(iproto_thread->uring);
+	}
 	return 0;
 }
 
-/** Initialize the iproto subsystem and start network io thread */
-void
-iproto_init()
+/** Bind message routes to the pipe of the thread. */
+static void
+iproto_thread_init_routes(struct iproto_thread *iproto_thread)
 {
-	slab_cache_create(&net_slabc, &runtime);
-
-	if (cord_costart(&net_cord, "iproto", net_cord_f, NULL))
-		panic("failed to initialize iproto thread");
+	struct cpipe *net_pipe = &iproto_thread->net_pipe;
+
+	iproto_thread->disconnect_route[0] = { tx_process_disconnect, net_pipe };
+	iproto_thread->disconnect_route[1] = { net_finish_disconnect, NULL };
+	iproto_thread->misc_route[0] = { tx_process_misc, net_pipe };
+	iproto_thread->misc_route[1] = { net_send_msg, NULL };
+	iproto_thread->call_route[0] = { tx_process_call, net_pipe };
+	iproto_thread->call_route[1] = { net_send_msg, NULL };
+	iproto_thread->select_route[0] = { tx_process_select, net_pipe };
+	iproto_thread->select_route[1] = { net_send_msg, NULL };
+	iproto_thread->fetch_route[0] = { tx_process_fetch, net_pipe };
+	iproto_thread->fetch_route[1] = { net_send_msg, NULL };
+	iproto_thread->process1_route[0] = { tx_process1, net_pipe };
+	iproto_thread->process1_route[1] = { net_send_msg, NULL };
+	iproto_thread->sql_route[0] = { tx_process_sql, net_pipe };
+	iproto_thread->sql_route[1] = { net_send_msg, NULL };
+	iproto_thread->join_route[0] = { tx_process_join_subscribe, net_pipe };
+	iproto_thread->join_route[1] = { net_end_join, NULL };
+	iproto_thread->subscribe_route[0] =
+		{ tx_process_join_subscribe, net_pipe };
+	iproto_thread->subscribe_route[1] = { net_end_subscribe, NULL };
+	iproto_thread->error_route[0] = { tx_reply_iproto_error, net_pipe };
+	iproto_thread->error_route[1] = { net_send_error, NULL };
+	iproto_thread->connect_route[0] = { tx_process_connect, net_pipe };
+	iproto_thread->connect_route[1] = { net_send_greeting, NULL };
+
+	const struct cmsg_hop **dml_route = iproto_thread->dml_route;
+	memset(dml_route, 0, sizeof(iproto_thread->dml_route));
+	dml_route[IPROTO_SELECT] = iproto_thread->select_route;
+	dml_route[IPROTO_INSERT] = iproto_thread->process1_route;
+	dml_route[IPROTO_REPLACE] = iproto_thread->process1_route;
+	dml_route[IPROTO_UPDATE] = iproto_thread->process1_route;
+	dml_route[IPROTO_DELETE] = iproto_thread->process1_route;
+	dml_route[IPROTO_CALL_16] = iproto_thread->call_route;
+	dml_route[IPROTO_AUTH] = iproto_thread->misc_route;
+	dml_route[IPROTO_EVAL] = iproto_thread->call_route;
+	dml_route[IPROTO_UPSERT] = iproto_thread->process1_route;
+	dml_route[IPROTO_CALL] = iproto_thread->call_route;
+	dml_route[IPROTO_EXECUTE] = iproto_thread->sql_route;
+}
 
-	/* Create a pipe to "net" thread. */
-	cpipe_create(&net_pipe, "net");
-	cpipe_set_max_input(&net_pipe, IPROTO_MSG_MAX/2);
+/** Initialize the iproto subsystem and start network io threads */
+void
+iproto_init(int thread_count, enum iproto_io_backend io_backend)
+{
+	assert(thread_count > 0);
+	iproto_io_backend = io_backend;
+	iproto_threads = (struct iproto_thread *)
+		calloc(thread_count, sizeof(struct iproto_thread));
+	if (iproto_threads == NULL) {
+		tnt_raise(OutOfMemory, thread_count *
+			  sizeof(struct iproto_thread), "calloc",
+			  "struct iproto_thread");
+	}
+	iproto_thread_count = thread_count;
+	iproto_thread_msg_max = MAX(IPROTO_MSG_MAX / thread_count,
+				    IPROTO_THREAD_MSG_MIN);
+	mempool_create(&iproto_cursor_pool, &cord()->slabc,
+		       sizeof(struct iproto_cursor));
+	ev_timer_init(&iproto_cursor_timer, iproto_cursor_timer_cb,
+		      0, IPROTO_CURSOR_TIMER_PERIOD);
+
+	for (int i = 0; i < thread_count; i++) {
+		struct iproto_thread *iproto_thread = &iproto_threads[i];
+		iproto_thread->id = i;
+		rlist_create(&iproto_thread->stopped_connections);
+		iproto_thread_init_routes(iproto_thread);
+		slab_cache_create(&iproto_thread->net_slabc, &runtime);
+
+		const char *name = i == 0 ? "iproto" : tt_sprintf("iproto%d", i);
+		if (cord_costart(&iproto_thread->net_cord, name, net_cord_f,
+				 iproto_thread))
+			panic("failed to initialize iproto thread");
+
+		/* Create a pipe to "net" thread. */
+		cpipe_create(&iproto_thread->net_pipe,
+			     iproto_thread_endpoint_name(iproto_thread));
+		cpipe_set_max_input(&iproto_thread->net_pipe,
+				    iproto_thread_msg_max / 2);
+	}
 }
 
 /**
@@ -1675,18 +3063,30 @@ iproto_init()
  */
 struct iproto_bind_msg: public cbus_call_msg
 {
+	struct iproto_thread *iproto_thread;
 	const char *uri;
 };
 
 static int
 iproto_do_bind(struct cbus_call_msg *m)
 {
-	const char *uri  = ((struct iproto_bind_msg *) m)->uri;
+	struct iproto_bind_msg *msg = (struct iproto_bind_msg *) m;
+	struct evio_service *binary = &msg->iproto_thread->binary;
 	try {
-		if (evio_service_is_active(&binary))
-			evio_service_stop(&binary);
-		if (uri != NULL)
-			evio_service_bind(&binary, uri);
+		if (evio_service_is_active(binary))
+			evio_service_stop(binary);
+		if (msg->uri == NULL)
+			return 0;
+		/*
+		 * The first thread binds the socket, the rest
+		 * share it and accept connections from it as
+		 * well: the kernel hands every new connection
+		 * to one of the threads waiting on the socket.
+		 */
+		if (msg->iproto_thread == &iproto_threads[0])
+			evio_service_bind(binary, msg->uri);
+		else
+			evio_service_attach(binary, &iproto_threads[0].binary);
 	} catch (Exception *e) {
 		return -1;
 	}
@@ -1696,44 +3096,184 @@ iproto_do_bind(struct cbus_call_msg *m)
 static int
 iproto_do_listen(struct cbus_call_msg *m)
 {
-	(void) m;
+	struct iproto_bind_msg *msg = (struct iproto_bind_msg *) m;
+	struct evio_service *binary = &msg->iproto_thread->binary;
 	try {
-		if (evio_service_is_active(&binary))
-			evio_service_listen(&binary);
+		if (evio_service_is_active(binary))
+			evio_service_listen(binary);
 	} catch (Exception *e) {
 		return -1;
 	}
 	return 0;
 }
 
+/** Run @a func in every network thread, in order. */
+static void
+iproto_send_bind_msg(cbus_call_f func, const char *uri, bool reverse)
+{
+	/* Declare static to avoid stack corruption on fiber cancel. */
+	static struct iproto_bind_msg m;
+	for (int i = 0; i < iproto_thread_count; i++) {
+		int id = reverse ? iproto_thread_count - 1 - i : i;
+		struct iproto_thread *iproto_thread = &iproto_threads[id];
+		m.iproto_thread = iproto_thread;
+		m.uri = uri;
+		if (cbus_call(&iproto_thread->net_pipe,
+			      &iproto_thread->tx_pipe, &m, func,
+			      NULL, TIMEOUT_INFINITY))
+			diag_raise();
+	}
+}
+
 void
 iproto_bind(const char *uri)
 {
-	static struct iproto_bind_msg m;
-	m.uri = uri;
-	if (cbus_call(&net_pipe, &tx_pipe, &m, iproto_do_bind,
-		      NULL, TIMEOUT_INFINITY))
-		diag_raise();
+	/*
+	 * All threads must release the shared socket before
+	 * the first one binds a new one.
+	 */
+	iproto_send_bind_msg(iproto_do_bind, NULL, true);
+	if (uri != NULL)
+		iproto_send_bind_msg(iproto_do_bind, uri, false);
 }
 
 void
 iproto_listen()
 {
-	/* Declare static to avoid stack corruption on fiber cancel. */
-	static struct cbus_call_msg m;
-	if (cbus_call(&net_pipe, &tx_pipe, &m, iproto_do_listen,
-		      NULL, TIMEOUT_INFINITY))
-		diag_raise();
+	iproto_send_bind_msg(iproto_do_listen, NULL, false);
 }
 
 size_t
 iproto_mem_used(void)
 {
-	return slab_cache_used(&net_cord.slabc) + slab_cache_used(&net_slabc);
+	size_t mem = 0;
+	for (int i = 0; i < iproto_thread_count; i++) {
+		struct iproto_thread *iproto_thread = &iproto_threads[i];
+		mem += slab_cache_used(&iproto_thread->net_cord.slabc) +
+		       slab_cache_used(&iproto_thread->net_slabc);
+	}
+	return mem;
+}
+
+int
+iproto_rmean_foreach(rmean_cb cb, void *cb_ctx)
+{
+	for (int name = 0; name < IPROTO_LAST; name++) {
+		int64_t mean = 0;
+		int64_t total = 0;
+		for (int i = 0; i < iproto_thread_count; i++) {
+			struct rmean *rmean = iproto_threads[i].rmean;
+			mean += rmean_mean(rmean, name);
+			total += rmean_total(rmean, name);
+		}
+		int rc = cb(rmean_net_strings[name], mean, total, cb_ctx);
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
+}
+
+struct iproto_latency_msg: public cbus_call_msg
+{
+	struct iproto_thread *iproto_thread;
+	/** Where to merge statistics of the thread to. */
+	struct iproto_latency_stat *stat;
+};
+
+static int
+iproto_do_merge_latency(struct cbus_call_msg *m)
+{
+	struct iproto_latency_msg *msg = (struct iproto_latency_msg *) m;
+	return iproto_latency_stat_merge(msg->stat,
+					 &msg->iproto_thread->latency);
+}
+
+static int
+iproto_do_reset_latency(struct cbus_call_msg *m)
+{
+	struct iproto_latency_msg *msg = (struct iproto_latency_msg *) m;
+	iproto_latency_stat_reset(&msg->iproto_thread->latency);
+	return 0;
+}
+
+/** Run @a func in every network thread, in order. */
+static int
+iproto_send_latency_msg(cbus_call_f func, struct iproto_latency_stat *stat)
+{
+	struct iproto_latency_msg msg;
+	msg.stat = stat;
+	bool cancellable = fiber_set_cancellable(false);
+	int rc = 0;
+	for (int i = 0; i < iproto_thread_count && rc == 0; i++) {
+		struct iproto_thread *iproto_thread = &iproto_threads[i];
+		msg.iproto_thread = iproto_thread;
+		rc = cbus_call(&iproto_thread->net_pipe,
+			       &iproto_thread->tx_pipe, &msg, func,
+			       NULL, TIMEOUT_INFINITY);
+	}
+	fiber_set_cancellable(cancellable);
+	return rc;
+}
+
+static void
+iproto_latency_info(struct info_handler *h, const char *name,
+		    struct iproto_latency *latency)
+{
+	struct histogram *total = latency->hist[IPROTO_LATENCY_TOTAL];
+	info_table_begin(h, name);
+	info_append_int(h, "count", total->total);
+	for (int i = 0; i < iproto_latency_stage_MAX; i++) {
+		struct histogram *hist = latency->hist[i];
+		info_table_begin(h, iproto_latency_stage_strs[i]);
+		info_append_int(h, "p50", histogram_percentile(hist, 50));
+		info_append_int(h, "p99", histogram_percentile(hist, 99));
+		info_append_int(h, "p999", histogram_permille(hist, 999));
+		info_table_end(h);
+	}
+	char buf[1024];
+	histogram_snprint(buf, sizeof(buf), total);
+	info_append_str(h, "histogram", buf);
+	info_table_end(h);
+}
+
+int
+iproto_latency_stat(struct info_handler *h)
+{
+	struct iproto_latency_stat stat;
+	if (iproto_latency_stat_create(&stat) != 0)
+		return -1;
+	if (iproto_send_latency_msg(iproto_do_merge_latency, &stat) != 0) {
+		iproto_latency_stat_destroy(&stat);
+		return -1;
+	}
+	info_begin(h);
+	for (int type = 0; type < IPROTO_TYPE_STAT_MAX; type++) {
+		if (stat.by_type[type].hist[0] == NULL)
+			continue;
+		iproto_latency_info(h, iproto_type_strs[type],
+				    &stat.by_type[type]);
+	}
+	info_table_begin(h, "space");
+	mh_int_t k;
+	mh_foreach(stat.by_space, k) {
+		struct mh_i32ptr_node_t *node =
+			mh_i32ptr_node(stat.by_space, k);
+		struct space *space = space_by_id(node->key);
+		if (space == NULL)
+			continue; /* dropped */
+		iproto_latency_info(h, space_name(space),
+				    (struct iproto_latency *) node->val);
+	}
+	info_table_end(h);
+	info_end(h);
+	iproto_latency_stat_destroy(&stat);
+	return 0;
 }
 
 void
 iproto_reset_stat(void)
 {
-	rmean_cleanup(rmean_net);
+	for (int i = 0; i < iproto_thread_count; i++)
+		rmean_cleanup(iproto_threads[i].rmean);
+	iproto_send_latency_msg(iproto_do_reset_latency, NULL);
 }
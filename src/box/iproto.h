@@ -32,12 +32,24 @@
  */
 
 #include <stddef.h>
+#include <stdbool.h>
+#include "rmean.h"
 
 #if defined(__cplusplus)
 extern "C" {
 #endif /* defined(__cplusplus) */
 
 extern unsigned iproto_readahead;
+/** box.cfg.net_connection_msg_max */
+extern int iproto_connection_msg_max;
+/** box.cfg.net_msg_max_size */
+extern size_t iproto_msg_max_size;
+/** box.cfg.net_zero_copy_select */
+extern bool iproto_zero_copy_select;
+/** box.cfg.net_cursor_max */
+extern int iproto_cursor_max;
+/** box.cfg.net_cursor_timeout */
+extern double iproto_cursor_timeout;
 
 /**
  * Return size of memory used for storing network buffers.
@@ -51,11 +63,45 @@ iproto_mem_used(void);
 void
 iproto_reset_stat(void);
 
+/**
+ * Invoke @a cb for every network statistics counter, summed
+ * over all network threads. Same as rmean_foreach().
+ */
+int
+iproto_rmean_foreach(rmean_cb cb, void *cb_ctx);
+
+struct info_handler;
+
+/**
+ * Latency of requests by request type and by space, merged
+ * across all network threads, see box.stat.latency().
+ * Return -1 on OOM.
+ */
+int
+iproto_latency_stat(struct info_handler *h);
+
+/** How network threads do socket I/O, box.cfg.net_io_backend. */
+enum iproto_io_backend {
+	/** A syscall per read or write of a ready socket. */
+	IPROTO_IO_LIBEV = 0,
+	/** Reads and writes are batched with io_uring. */
+	IPROTO_IO_URING,
+	IPROTO_IO_BACKEND_MAX
+};
+
+extern const char *iproto_io_backend_STRS[];
+
 #if defined(__cplusplus)
 } /* extern "C" */
 
+/**
+ * Start @a thread_count network threads
+ * (box.cfg.iproto_threads) using the given I/O backend
+ * (box.cfg.net_io_backend). If io_uring is not supported by
+ * the system, libev is used.
+ */
 void
-iproto_init();
+iproto_init(int thread_count, enum iproto_io_backend io_backend);
 
 void
 iproto_bind(const char *uri);
@@ -61,11 +61,11 @@ const unsigned char iproto_key_type[IPROTO_KEY_MAX] =
 		/* 0x13 */	MP_UINT, /* IPROTO_OFFSET */
 		/* 0x14 */	MP_UINT, /* IPROTO_ITERATOR */
 		/* 0x15 */	MP_UINT, /* IPROTO_INDEX_BASE */
+		/* 0x16 */	MP_UINT, /* IPROTO_FETCH_SIZE */
+		/* 0x17 */	MP_UINT, /* IPROTO_CURSOR_ID */
 	/* }}} */
 
 	/* {{{ unused */
-		/* 0x16 */	MP_UINT,
-		/* 0x17 */	MP_UINT,
 		/* 0x18 */	MP_UINT,
 		/* 0x19 */	MP_UINT,
 		/* 0x1a */	MP_UINT,
@@ -87,6 +87,7 @@ const unsigned char iproto_key_type[IPROTO_KEY_MAX] =
 	/* 0x27 */	MP_STR, /* IPROTO_EXPR */
 	/* 0x28 */	MP_ARRAY, /* IPROTO_OPS */
 	/* 0x29 */	MP_STR, /* IPROTO_FIELD_NAME */
+	/* 0x2a */	MP_UINT, /* IPROTO_COMPRESSION */
 	/* }}} */
 };
 
@@ -105,6 +106,7 @@ const char *iproto_type_strs[] =
 	"CALL",
 	"EXECUTE",
 	NULL, /* NOP */
+	NULL, /* FETCH, accounted as SELECT */
 };
 
 #define bit(c) (1ULL<<IPROTO_##c)
@@ -122,6 +124,7 @@ const uint64_t iproto_body_key_map[IPROTO_TYPE_STAT_MAX] = {
 	0,                                                     /* CALL */
 	0,                                                     /* EXECUTE */
 	bit(SPACE_ID),                                         /* NOP */
+	0,                                                     /* FETCH */
 };
 #undef bit
 
@@ -148,8 +151,8 @@ const char *iproto_key_strs[IPROTO_KEY_MAX] = {
 	"offset",           /* 0x13 */
 	"iterator",         /* 0x14 */
 	"index base",       /* 0x15 */
-	NULL,               /* 0x16 */
-	NULL,               /* 0x17 */
+	"fetch size",       /* 0x16 */
+	"cursor id",        /* 0x17 */
 	NULL,               /* 0x18 */
 	NULL,               /* 0x19 */
 	NULL,               /* 0x1a */
@@ -168,7 +171,7 @@ const char *iproto_key_strs[IPROTO_KEY_MAX] = {
 	"expression",       /* 0x27 */
 	"operations",       /* 0x28 */
 	"field name",       /* 0x29 */
-	NULL,               /* 0x2a */
+	"compression",      /* 0x2a */
 	NULL,               /* 0x2b */
 	NULL,               /* 0x2c */
 	NULL,               /* 0x2d */
@@ -204,7 +207,8 @@ const char *vy_page_info_key_strs[VY_PAGE_INFO_KEY_MAX] = {
 	"unpacked size",
 	"row count",
 	"min key",
-	"row index offset"
+	"row index offset",
+	"max key",
 };
 
 const char *vy_run_info_key_strs[VY_RUN_INFO_KEY_MAX] = {
@@ -214,7 +218,9 @@ const char *vy_run_info_key_strs[VY_RUN_INFO_KEY_MAX] = {
 	"min lsn",
 	"max lsn",
 	"page count",
-	"bloom filter"
+	"bloom filter",
+	"prefix bloom filter",
+	"dump time",
 };
 
 const char *vy_row_index_key_strs[VY_ROW_INDEX_KEY_MAX] = {
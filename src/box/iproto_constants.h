@@ -66,6 +66,18 @@ enum iproto_key {
 	IPROTO_OFFSET = 0x13,
 	IPROTO_ITERATOR = 0x14,
 	IPROTO_INDEX_BASE = 0x15,
+	/**
+	 * SELECT: stream the result set in chunks of this many
+	 * tuples. FETCH: the size of the next chunk, 0 closes
+	 * the cursor.
+	 */
+	IPROTO_FETCH_SIZE = 0x16,
+	/**
+	 * Id of a server-side cursor: in a response to a streamed
+	 * SELECT or FETCH if the result set is not exhausted yet,
+	 * and in a FETCH request.
+	 */
+	IPROTO_CURSOR_ID = 0x17,
 
 	/* Leave a gap between integer values and other keys */
 	IPROTO_KEY = 0x20,
@@ -88,6 +100,13 @@ enum iproto_key {
 	IPROTO_EXPR = 0x27, /* EVAL */
 	IPROTO_OPS = 0x28, /* UPSERT but not UPDATE ops, because of legacy */
 	IPROTO_FIELD_NAME = 0x29,
+	/**
+	 * SUBSCRIBE: the replica asks the master to compress
+	 * the row stream with this algorithm, see enum
+	 * iproto_compression. COMPRESSED_ROWS: the algorithm
+	 * used to compress IPROTO_DATA.
+	 */
+	IPROTO_COMPRESSION = 0x2a,
 
 	/* Leave a gap between request keys and response keys */
 	IPROTO_DATA = 0x30,
@@ -121,6 +140,7 @@ enum iproto_key {
 			  bit(LSN) | bit(SCHEMA_VERSION))
 #define IPROTO_DML_BODY_BMAP (bit(SPACE_ID) | bit(INDEX_ID) | bit(LIMIT) |\
 			      bit(OFFSET) | bit(ITERATOR) | bit(INDEX_BASE) |\
+			      bit(FETCH_SIZE) | bit(CURSOR_ID) |\
 			      bit(KEY) | bit(TUPLE) | bit(OPS))
 
 static inline bool
@@ -178,6 +198,8 @@ enum iproto_type {
 	IPROTO_EXECUTE = 11,
 	/** No operation. Treated as DML, used to bump LSN. */
 	IPROTO_NOP = 12,
+	/** Fetch the next chunk of a streamed SELECT. */
+	IPROTO_FETCH = 13,
 	/** The maximum typecode used for box.stat() */
 	IPROTO_TYPE_STAT_MAX,
 
@@ -189,6 +211,8 @@ enum iproto_type {
 	IPROTO_SUBSCRIBE = 66,
 	/** Vote request command for master election */
 	IPROTO_REQUEST_VOTE = 67,
+	/** A batch of replicated rows compressed by the relay */
+	IPROTO_COMPRESSED_ROWS = 68,
 
 	/** Vinyl run info stored in .index file */
 	VY_INDEX_RUN_INFO = 100,
@@ -203,6 +227,12 @@ enum iproto_type {
 	IPROTO_TYPE_ERROR = 1 << 15
 };
 
+/** Replication stream compression algorithms. */
+enum iproto_compression {
+	IPROTO_COMPRESSION_NONE = 0,
+	IPROTO_COMPRESSION_ZSTD = 1,
+};
+
 /** IPROTO type name by code */
 extern const char *iproto_type_strs[];
 
@@ -214,11 +244,14 @@ static inline const char *
 iproto_type_name(uint32_t type)
 {
 	/*
-	 * Sic: iptoto_type_strs[IPROTO_NOP] is NULL
+	 * Sic: iptoto_type_strs[IPROTO_NOP] and
+	 * iproto_type_strs[IPROTO_FETCH] are NULL
 	 * to suppress box.stat() output.
 	 */
 	if (type == IPROTO_NOP)
 		return "NOP";
+	if (type == IPROTO_FETCH)
+		return "FETCH";
 
 	if (type < IPROTO_TYPE_STAT_MAX)
 		return iproto_type_strs[type];
@@ -331,6 +364,10 @@ enum vy_run_info_key {
 	VY_RUN_INFO_PAGE_COUNT = 5,
 	/** Bloom filter for keys. */
 	VY_RUN_INFO_BLOOM = 6,
+	/** Bloom filter for key prefixes. */
+	VY_RUN_INFO_PREFIX_BLOOM = 7,
+	/** Time when the most recent data of the run was dumped. */
+	VY_RUN_INFO_DUMP_TIME = 8,
 	/** The last key in this enum + 1 */
 	VY_RUN_INFO_KEY_MAX
 };
@@ -365,6 +402,8 @@ enum vy_page_info_key {
 	VY_PAGE_INFO_MIN_KEY = 5,
 	/** Offset of the row index in the page. */
 	VY_PAGE_INFO_ROW_INDEX_OFFSET = 6,
+	/** Maximal key stored in the page. Optional. */
+	VY_PAGE_INFO_MAX_KEY = 7,
 	/** The last key in this enum + 1 */
 	VY_PAGE_INFO_KEY_MAX
 };
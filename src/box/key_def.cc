@@ -116,6 +116,7 @@ key_def_set_cmp(struct key_def *def)
 	def->tuple_compare = tuple_compare_create(def);
 	def->tuple_compare_with_key = tuple_compare_with_key_create(def);
 	tuple_hash_func_set(def);
+	tuple_hint_func_set(def);
 	tuple_extract_key_set(def);
 }
 
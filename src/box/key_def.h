@@ -116,6 +116,23 @@ typedef uint32_t (*tuple_hash_t)(const struct tuple *tuple,
 typedef uint32_t (*key_hash_t)(const char *key,
 				const struct key_def *key_def);
 
+/**
+ * Comparison hint: a 64-bit value derived from the first key
+ * part such that hint(a) < hint(b) implies a < b. Equal hints
+ * tell nothing and the full comparison is needed then.
+ */
+typedef uint64_t hint_t;
+
+/** A hint that is not comparable with any other hint. */
+#define HINT_NONE ((hint_t)UINT64_MAX)
+
+/** @copydoc tuple_hint() */
+typedef hint_t (*tuple_hint_t)(const struct tuple *tuple,
+			       const struct key_def *key_def);
+/** @copydoc key_hint() */
+typedef hint_t (*key_hint_t)(const char *key, uint32_t part_count,
+			     const struct key_def *key_def);
+
 /* Definition of a multipart key. */
 struct key_def {
 	/** @see tuple_compare() */
@@ -130,6 +147,10 @@ struct key_def {
 	tuple_hash_t tuple_hash;
 	/** @see key_hash() */
 	key_hash_t key_hash;
+	/** @see tuple_hint() */
+	tuple_hint_t tuple_hint;
+	/** @see key_hint() */
+	key_hint_t key_hint;
 	/**
 	 * Minimal part count which always is unique. For example,
 	 * if a secondary index is unique, then
@@ -517,6 +538,48 @@ tuple_compare_with_key(const struct tuple *tuple, const char *key,
 	return key_def->tuple_compare_with_key(tuple, key, part_count, key_def);
 }
 
+/**
+ * Compute a comparison hint for a tuple.
+ * @param tuple tuple
+ * @param key_def key definition
+ * @retval hint of the first key part of the tuple or HINT_NONE
+ *         if the key part type doesn't support hints
+ */
+static inline hint_t
+tuple_hint(const struct tuple *tuple, const struct key_def *key_def)
+{
+	return key_def->tuple_hint(tuple, key_def);
+}
+
+/**
+ * Compute a comparison hint for a key.
+ * @param key key parts without MessagePack array header
+ * @param part_count the number of parts in @a key
+ * @param key_def key definition
+ * @retval hint of the first key part or HINT_NONE if the key
+ *         is empty or the key part type doesn't support hints
+ */
+static inline hint_t
+key_hint(const char *key, uint32_t part_count, const struct key_def *key_def)
+{
+	return key_def->key_hint(key, part_count, key_def);
+}
+
+/**
+ * Compare two comparison hints.
+ * @retval 0 if the hints are equal or any of them is HINT_NONE,
+ *         i.e. the full comparison is needed to order the keys
+ * @retval <0 if hint_a < hint_b
+ * @retval >0 if hint_a > hint_b
+ */
+static inline int
+hint_cmp(hint_t hint_a, hint_t hint_b)
+{
+	if (hint_a == hint_b || hint_a == HINT_NONE || hint_b == HINT_NONE)
+		return 0;
+	return hint_a < hint_b ? -1 : 1;
+}
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
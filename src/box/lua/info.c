@@ -48,11 +48,13 @@
 #include "box/info.h"
 #include "box/engine.h"
 #include "box/vinyl.h"
+#include "box/memtx_engine.h"
 #include "main.h"
 #include "version.h"
 #include "box/box.h"
 #include "lua/utils.h"
 #include "fiber.h"
+#include "rmean.h"
 
 static void
 lbox_pushvclock(struct lua_State *L, const struct vclock *vclock)
@@ -68,6 +70,27 @@ lbox_pushvclock(struct lua_State *L, const struct vclock *vclock)
 	luaL_setmaphint(L, -1); /* compact flow */
 }
 
+/**
+ * Push replication stream compression statistics: the size
+ * of compressed frames, the ratio of the size of rows to it,
+ * and the CPU time spent on (de)compression.
+ */
+static void
+lbox_pushcompression(struct lua_State *L,
+		     const struct xrow_compression_stat *stat)
+{
+	lua_createtable(L, 0, 3);
+	lua_pushstring(L, "bytes");
+	luaL_pushuint64(L, stat->compressed_size);
+	lua_settable(L, -3);
+	lua_pushstring(L, "ratio");
+	lua_pushnumber(L, (double) stat->raw_size / stat->compressed_size);
+	lua_settable(L, -3);
+	lua_pushstring(L, "time");
+	lua_pushnumber(L, stat->time);
+	lua_settable(L, -3);
+}
+
 static void
 lbox_pushapplier(lua_State *L, struct applier *applier)
 {
@@ -93,6 +116,32 @@ lbox_pushapplier(lua_State *L, struct applier *applier)
 			       applier->last_row_time);
 		lua_settable(L, -3);
 
+		lua_pushstring(L, "apply_lag");
+		lua_pushnumber(L, applier->apply_lag);
+		lua_settable(L, -3);
+
+		lua_pushstring(L, "apply_queue");
+		lua_pushinteger(L, applier->apply_in_progress);
+		lua_settable(L, -3);
+
+		lua_pushstring(L, "applied");
+		lua_newtable(L);
+		lua_pushstring(L, "rps");
+		lua_pushnumber(L, rmean_mean(applier->stat,
+					     APPLIER_STAT_ROWS));
+		lua_settable(L, -3);
+		lua_pushstring(L, "total");
+		luaL_pushuint64(L, rmean_total(applier->stat,
+					       APPLIER_STAT_ROWS));
+		lua_settable(L, -3);
+		lua_settable(L, -3);
+
+		if (applier->compression_stat.compressed_size > 0) {
+			lua_pushstring(L, "compression");
+			lbox_pushcompression(L, &applier->compression_stat);
+			lua_settable(L, -3);
+		}
+
 		char name[FIBER_NAME_MAX];
 		int total = uri_format(name, sizeof(name), &applier->uri, false);
 
@@ -116,6 +165,14 @@ lbox_pushrelay(lua_State *L, struct relay *relay)
 	lua_pushstring(L, "vclock");
 	lbox_pushvclock(L, relay_vclock(relay));
 	lua_settable(L, -3);
+
+	const struct xrow_compression_stat *stat =
+		relay_compression_stat(relay);
+	if (stat->compressed_size > 0) {
+		lua_pushstring(L, "compression");
+		lbox_pushcompression(L, stat);
+		lua_settable(L, -3);
+	}
 }
 
 static void
@@ -410,6 +467,34 @@ luaT_info_handler_create(struct info_handler *h, struct lua_State *L)
 	h->ctx = L;
 }
 
+static int
+lbox_info_memtx_call(struct lua_State *L)
+{
+	struct info_handler h;
+	luaT_info_handler_create(&h, L);
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_info(memtx, &h);
+	return 1;
+}
+
+static int
+lbox_info_memtx(struct lua_State *L)
+{
+	lua_newtable(L);
+
+	lua_newtable(L); /* metatable */
+
+	lua_pushstring(L, "__call");
+	lua_pushcfunction(L, lbox_info_memtx_call);
+	lua_settable(L, -3);
+
+	lua_setmetatable(L, -2);
+
+	return 1;
+}
+
 static int
 lbox_info_vinyl_call(struct lua_State *L)
 {
@@ -451,6 +536,7 @@ static const struct luaL_Reg lbox_info_dynamic_meta[] = {
 	{"pid", lbox_info_pid},
 	{"cluster", lbox_info_cluster},
 	{"memory", lbox_info_memory},
+	{"memtx", lbox_info_memtx},
 	{"vinyl", lbox_info_vinyl},
 	{NULL, NULL}
 };
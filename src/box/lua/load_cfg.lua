@@ -12,6 +12,7 @@ local default_cfg = {
     memtx_memory        = 256 * 1024 *1024,
     memtx_min_tuple_size = 16,
     memtx_max_tuple_size = 1024 * 1024,
+    memtx_threads       = 1,
     slab_alloc_factor   = 1.05,
     work_dir            = nil,
     memtx_dir           = ".",
@@ -20,6 +21,7 @@ local default_cfg = {
     vinyl_dir           = '.',
     vinyl_memory        = 128 * 1024 * 1024,
     vinyl_cache         = 128 * 1024 * 1024,
+    vinyl_page_cache    = 128 * 1024 * 1024,
     vinyl_max_tuple_size = 1024 * 1024,
     vinyl_read_threads  = 1,
     vinyl_write_threads = 2,
@@ -35,6 +37,13 @@ local default_cfg = {
     log_format          = "plain",
     io_collect_interval = nil,
     readahead           = 16320,
+    iproto_threads      = 1,
+    net_connection_msg_max = 768,
+    net_cursor_max      = 16,
+    net_cursor_timeout  = 60,
+    net_msg_max_size    = 64 * 1024 * 1024,
+    net_zero_copy_select = false,
+    net_io_backend      = 'libev',
     snap_io_rate_limit  = nil, -- no limit
     too_long_threshold  = 0.5,
     wal_mode            = "write",
@@ -59,6 +68,8 @@ local default_cfg = {
     replication_sync_lag = 10,
     replication_connect_timeout = 4,
     replication_connect_quorum = nil, -- connect all
+    replication_apply_fibers = 1,
+    replication_compression = false,
 }
 
 -- types of available options
@@ -68,6 +79,7 @@ local template_cfg = {
     memtx_memory        = 'number',
     memtx_min_tuple_size  = 'number',
     memtx_max_tuple_size  = 'number',
+    memtx_threads         = 'number',
     slab_alloc_factor   = 'number',
     work_dir            = 'string',
     memtx_dir            = 'string',
@@ -75,6 +87,7 @@ local template_cfg = {
     vinyl_dir           = 'string',
     vinyl_memory        = 'number',
     vinyl_cache               = 'number',
+    vinyl_page_cache          = 'number',
     vinyl_max_tuple_size      = 'number',
     vinyl_read_threads        = 'number',
     vinyl_write_threads       = 'number',
@@ -91,6 +104,13 @@ local template_cfg = {
     log_format          = 'string',
     io_collect_interval = 'number',
     readahead           = 'number',
+    iproto_threads      = 'number',
+    net_connection_msg_max = 'number',
+    net_cursor_max      = 'number',
+    net_cursor_timeout  = 'number',
+    net_msg_max_size    = 'number',
+    net_zero_copy_select = 'boolean',
+    net_io_backend      = 'string',
     snap_io_rate_limit  = 'number',
     too_long_threshold  = 'number',
     wal_mode            = 'string',
@@ -115,6 +135,8 @@ local template_cfg = {
     replication_sync_lag = 'number',
     replication_connect_timeout = 'number',
     replication_connect_quorum = 'number',
+    replication_apply_fibers = 'number',
+    replication_compression = 'boolean',
 }
 
 local function normalize_uri(port)
@@ -165,12 +187,19 @@ local dynamic_cfg = {
     log_format              = private.cfg_set_log_format,
     io_collect_interval     = private.cfg_set_io_collect_interval,
     readahead               = private.cfg_set_readahead,
+    net_connection_msg_max  = private.cfg_set_net_connection_msg_max,
+    net_cursor_max          = private.cfg_set_net_cursor_max,
+    net_cursor_timeout      = private.cfg_set_net_cursor_timeout,
+    net_msg_max_size        = private.cfg_set_net_msg_max_size,
+    net_zero_copy_select    = private.cfg_set_net_zero_copy_select,
     too_long_threshold      = private.cfg_set_too_long_threshold,
     snap_io_rate_limit      = private.cfg_set_snap_io_rate_limit,
     read_only               = private.cfg_set_read_only,
     memtx_max_tuple_size    = private.cfg_set_memtx_max_tuple_size,
+    memtx_threads           = private.cfg_set_memtx_threads,
     vinyl_max_tuple_size    = private.cfg_set_vinyl_max_tuple_size,
     vinyl_cache             = private.cfg_set_vinyl_cache,
+    vinyl_page_cache        = private.cfg_set_vinyl_page_cache,
     vinyl_timeout           = private.cfg_set_vinyl_timeout,
     checkpoint_count        = private.cfg_set_checkpoint_count,
     checkpoint_interval     = private.checkpoint_daemon.set_checkpoint_interval,
@@ -183,6 +212,8 @@ local dynamic_cfg = {
     force_recovery          = function() end,
     replication_timeout     = private.cfg_set_replication_timeout,
     replication_connect_quorum = private.cfg_set_replication_connect_quorum,
+    replication_apply_fibers = private.cfg_set_replication_apply_fibers,
+    replication_compression = private.cfg_set_replication_compression,
 }
 
 local dynamic_cfg_skip_at_load = {
@@ -191,6 +222,8 @@ local dynamic_cfg_skip_at_load = {
     replication             = true,
     replication_timeout     = true,
     replication_connect_quorum = true,
+    replication_apply_fibers = true,
+    replication_compression = true,
     wal_dir_rescan_delay    = true,
     custom_proc_title       = true,
     force_recovery          = true,
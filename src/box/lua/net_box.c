@@ -227,18 +227,19 @@ netbox_encode_select(lua_State *L)
 	if (lua_gettop(L) < 9)
 		return luaL_error(L, "Usage netbox.encode_select(ibuf, sync, "
 				  "schema_version, space_id, index_id, iterator, "
-				  "offset, limit, key)");
+				  "offset, limit, key[, fetch_size])");
 
 	struct mpstream stream;
 	size_t svp = netbox_prepare_request(L, &stream, IPROTO_SELECT);
 
-	luamp_encode_map(cfg, &stream, 6);
-
 	uint32_t space_id = lua_tonumber(L, 4);
 	uint32_t index_id = lua_tonumber(L, 5);
 	int iterator = lua_tointeger(L, 6);
 	uint32_t offset = lua_tonumber(L, 7);
 	uint32_t limit = lua_tonumber(L, 8);
+	uint32_t fetch_size = lua_tonumber(L, 10);
+
+	luamp_encode_map(cfg, &stream, fetch_size != 0 ? 7 : 6);
 
 	/* encode space_id */
 	luamp_encode_uint(cfg, &stream, IPROTO_SPACE_ID);
@@ -264,6 +265,39 @@ netbox_encode_select(lua_State *L)
 	luamp_encode_uint(cfg, &stream, IPROTO_KEY);
 	luamp_convert_key(L, cfg, &stream, 9);
 
+	/* encode fetch_size, the result set is streamed if set */
+	if (fetch_size != 0) {
+		luamp_encode_uint(cfg, &stream, IPROTO_FETCH_SIZE);
+		luamp_encode_uint(cfg, &stream, fetch_size);
+	}
+
+	netbox_encode_request(&stream, svp);
+	return 0;
+}
+
+static int
+netbox_encode_fetch(lua_State *L)
+{
+	if (lua_gettop(L) < 5)
+		return luaL_error(L, "Usage netbox.encode_fetch(ibuf, sync, "
+				  "schema_version, cursor_id, fetch_size)");
+
+	struct mpstream stream;
+	size_t svp = netbox_prepare_request(L, &stream, IPROTO_FETCH);
+
+	uint64_t cursor_id = luaL_touint64(L, 4);
+	uint32_t fetch_size = lua_tonumber(L, 5);
+
+	luamp_encode_map(cfg, &stream, 2);
+
+	/* encode cursor_id */
+	luamp_encode_uint(cfg, &stream, IPROTO_CURSOR_ID);
+	luamp_encode_uint(cfg, &stream, cursor_id);
+
+	/* encode fetch_size, 0 closes the cursor */
+	luamp_encode_uint(cfg, &stream, IPROTO_FETCH_SIZE);
+	luamp_encode_uint(cfg, &stream, fetch_size);
+
 	netbox_encode_request(&stream, svp);
 	return 0;
 }
@@ -590,6 +624,7 @@ luaopen_net_box(struct lua_State *L)
 		{ "encode_call",    netbox_encode_call },
 		{ "encode_eval",    netbox_encode_eval },
 		{ "encode_select",  netbox_encode_select },
+		{ "encode_fetch",   netbox_encode_fetch },
 		{ "encode_insert",  netbox_encode_insert },
 		{ "encode_replace", netbox_encode_replace },
 		{ "encode_delete",  netbox_encode_delete },
@@ -5,6 +5,7 @@ local buffer   = require('buffer')
 local socket   = require('socket')
 local fiber    = require('fiber')
 local msgpack  = require('msgpack')
+local fun      = require('fun')
 local errno    = require('errno')
 local urilib   = require('uri')
 local internal = require('net.box.lib')
@@ -29,6 +30,8 @@ local decode_greeting = internal.decode_greeting
 
 local sequence_mt      = { __serialize = 'sequence' }
 local TIMEOUT_INFINITY = 500 * 365 * 86400
+-- the default number of tuples index:pairs() fetches at once
+local FETCH_SIZE_DEFAULT = 1000
 local VSPACE_ID        = 281
 local VINDEX_ID        = 289
 
@@ -36,6 +39,7 @@ local IPROTO_STATUS_KEY    = 0x00
 local IPROTO_ERRNO_MASK    = 0x7FFF
 local IPROTO_SYNC_KEY      = 0x01
 local IPROTO_SCHEMA_VERSION_KEY = 0x05
+local IPROTO_CURSOR_ID_KEY = 0x17
 local IPROTO_METADATA_KEY = 0x32
 local IPROTO_SQL_INFO_KEY = 0x43
 local IPROTO_SQL_ROW_COUNT_KEY = 0x44
@@ -64,6 +68,7 @@ local method_codec           = {
     update  = internal.encode_update,
     upsert  = internal.encode_upsert,
     select  = internal.encode_select,
+    fetch   = internal.encode_fetch,
     execute = internal.encode_execute,
     -- inject raw data into connection, used by console and tests
     inject = function(buf, id, schema_version, bytes)
@@ -77,7 +82,9 @@ local function next_id(id) return band(id + 1, 0x7FFFFFFF) end
 
 -- function create_transport(host, port, user, password, callback)
 --
--- Transport methods: connect(), close(), perfrom_request(), wait_state()
+-- Transport methods: connect(), close(), perfrom_request(), wait_state(),
+-- perform_async_request(), is_request_ready(), wait_request(),
+-- discard_request(), cursor_closer()
 --
 -- Basically, *transport* is a TCP connection speaking one of
 -- Tarantool network protocols. This is a low-level interface.
@@ -149,6 +156,11 @@ local function create_transport(host, port, user, password, callback)
     local requests         = setmetatable({}, { __mode = 'v' })
     local next_request_id  = 1
 
+    -- closed_cursors: ids of server cursors abandoned by their
+    -- iterators. GC hooks only append to the list, close requests
+    -- are encoded and sent by the worker fiber.
+    local closed_cursors   = {}
+
     local worker_fiber
     local connection
     local send_buf         = buffer.ibuf(buffer.READAHEAD)
@@ -176,6 +188,9 @@ local function create_transport(host, port, user, password, callback)
                     requests[id] = nil -- this marks the request as completed
                     request.errno  = new_errno
                     request.response = new_error
+                    if request.cond ~= nil then
+                        request.cond:broadcast()
+                    end
                 end
             end
         end
@@ -234,11 +249,13 @@ local function create_transport(host, port, user, password, callback)
     end
 
     -- REQUEST/RESPONSE --
-    local function perform_request(timeout, buffer, method, schema_version, ...)
-        if state ~= 'active' then
-            return last_errno or E_NO_CONNECTION, last_error
-        end
-        local deadline = fiber_clock() + (timeout or TIMEOUT_INFINITY)
+
+    -- Encode a request into the send buffer and register it as
+    -- in flight. The request is written to the socket by the
+    -- worker fiber together with everything else queued so far,
+    -- so a fiber can submit many requests before waiting for
+    -- any of the responses and pay for a single write.
+    local function register_request(buffer, method, schema_version, ...)
         -- alert worker to notify it of the queued outgoing data;
         -- if the buffer wasn't empty, assume the worker was already alerted
         if send_buf:size() == 0 then
@@ -247,15 +264,26 @@ local function create_transport(host, port, user, password, callback)
         local id = next_request_id
         method_codec[method](send_buf, id, schema_version, ...)
         next_request_id = next_id(id)
-        -- reserve space for 8 keys: client, method,
+        -- reserve space for 11 keys: id, client, cond, method,
         -- schema_version, buffer, errno, response, metadata,
-        -- sql_info.
-        local request = table_new(0, 8)
-        request.client = fiber_self()
+        -- sql_info, cursor.
+        local request = table_new(0, 11)
+        request.id = id
         request.method = method
         request.schema_version = schema_version
         request.buffer = buffer
         requests[id] = request
+        return request
+    end
+
+    local function perform_request(timeout, buffer, method, schema_version, ...)
+        if state ~= 'active' then
+            return last_errno or E_NO_CONNECTION, last_error
+        end
+        local deadline = fiber_clock() + (timeout or TIMEOUT_INFINITY)
+        local request = register_request(buffer, method, schema_version, ...)
+        local id = request.id
+        request.client = fiber_self()
         repeat
             local timeout = max(0, deadline - fiber_clock())
             if not state_cond:wait(timeout) then
@@ -263,13 +291,98 @@ local function create_transport(host, port, user, password, callback)
                 return E_TIMEOUT, 'Timeout exceeded'
             end
         until requests[id] == nil -- i.e. completed (beware spurious wakeups)
-        return request.errno, request.response, request.metadata, request.info
+        return request.errno, request.response, request.metadata,
+               request.info, request.cursor
+    end
+
+    -- Submit a request and return it without waiting for the
+    -- response, see is_request_ready() and wait_request(). If
+    -- the connection isn't active, the returned request is
+    -- already completed with an error.
+    local function perform_async_request(buffer, method, schema_version, ...)
+        if state ~= 'active' then
+            return {errno = last_errno or E_NO_CONNECTION,
+                    response = last_error}
+        end
+        return register_request(buffer, method, schema_version, ...)
+    end
+
+    local function is_request_ready(request)
+        return requests[request.id] ~= request
+    end
+
+    -- Wait for an asynchronous request to complete. Any number
+    -- of fibers may wait for the same request. Return false on
+    -- timeout.
+    local function wait_request(request, timeout)
+        local deadline = fiber_clock() + (timeout or TIMEOUT_INFINITY)
+        local cond = request.cond
+        if cond == nil then
+            cond = fiber.cond()
+            request.cond = cond
+        end
+        while requests[request.id] == request do
+            if not cond:wait(max(0, deadline - fiber_clock())) then
+                return false
+            end
+        end
+        return true
+    end
+
+    -- Forget an asynchronous request: its response, if it ever
+    -- arrives, is dropped.
+    local function discard_request(request)
+        if requests[request.id] == request then
+            requests[request.id] = nil
+            request.errno = E_PROC_LUA
+            request.response = 'Response is discarded'
+            if request.cond ~= nil then
+                request.cond:broadcast()
+            end
+        end
+    end
+
+    local function new_request_id()
+        local id = next_request_id;
+        next_request_id = next_id(id)
+        return id
+    end
+
+    -- Return a function closing the server cursor with the given
+    -- id. The function neither yields nor touches the send buffer,
+    -- hence can be used in a GC hook. The cursor is closed when
+    -- the worker fiber wakes up next time, i.e. on a response to
+    -- any request. Until then, the cursor counts towards the
+    -- session limit on the server.
+    local function cursor_closer(id)
+        return function()
+            closed_cursors[#closed_cursors + 1] = id
+        end
+    end
+
+    -- Send close requests for the cursors abandoned so far,
+    -- see cursor_closer(). Their responses are ignored.
+    local function close_cursors()
+        local n = #closed_cursors
+        while n > 0 do
+            local id = closed_cursors[n]
+            closed_cursors[n] = nil
+            method_codec.fetch(send_buf, new_request_id(), nil, id, 0)
+            n = #closed_cursors
+        end
     end
 
-    local function wakeup_client(client)
-        if client:status() ~= 'dead' then
+    -- Notify whoever waits for the request that it is completed:
+    -- the fiber blocked in perform_request() or the fibers
+    -- blocked in wait_request().
+    local function wakeup_client(request)
+        local client = request.client
+        if client ~= nil and client:status() ~= 'dead' then
             client:wakeup()
         end
+        if request.cond ~= nil then
+            request.cond:broadcast()
+        end
     end
 
     local function dispatch_response_iproto(hdr, body_rpos, body_end)
@@ -288,7 +401,7 @@ local function create_transport(host, port, user, password, callback)
             assert(body_end == body_end_check, "invalid xrow length")
             request.errno = band(status, IPROTO_ERRNO_MASK)
             request.response = body[IPROTO_ERROR_KEY]
-            wakeup_client(request.client)
+            wakeup_client(request)
             return
         end
 
@@ -299,7 +412,7 @@ local function create_transport(host, port, user, password, callback)
             local wpos = buffer:alloc(body_len)
             ffi.copy(wpos, body_rpos, body_len)
             request.response = tonumber(body_len)
-            wakeup_client(request.client)
+            wakeup_client(request)
             return
         end
 
@@ -309,13 +422,8 @@ local function create_transport(host, port, user, password, callback)
         request.response = body[IPROTO_DATA_KEY]
         request.metadata = body[IPROTO_METADATA_KEY]
         request.info = body[IPROTO_SQL_INFO_KEY]
-        wakeup_client(request.client)
-    end
-
-    local function new_request_id()
-        local id = next_request_id;
-        next_request_id = next_id(id)
-        return id
+        request.cursor = body[IPROTO_CURSOR_ID_KEY]
+        wakeup_client(request)
     end
 
     -- IO (WORKER FIBER) --
@@ -428,7 +536,7 @@ local function create_transport(host, port, user, password, callback)
             end
             requests[rid] = nil
             request.response = response
-            wakeup_client(request.client)
+            wakeup_client(request)
             return console_sm(next_id(rid))
         end
     end
@@ -501,6 +609,7 @@ local function create_transport(host, port, user, password, callback)
     end
 
     iproto_sm = function(schema_version)
+        close_cursors()
         local err, hdr, body_rpos, body_end = send_and_recv_iproto()
         if err then return error_sm(err, hdr) end
         dispatch_response_iproto(hdr, body_rpos, body_end)
@@ -522,6 +631,8 @@ local function create_transport(host, port, user, password, callback)
 
     error_sm = function(err, msg)
         if connection then connection:close(); connection = nil end
+        -- The server closes cursors on disconnect.
+        for i = #closed_cursors, 1, -1 do closed_cursors[i] = nil end
         send_buf:recycle()
         recv_buf:recycle()
         if state ~= 'closed' then
@@ -537,7 +648,12 @@ local function create_transport(host, port, user, password, callback)
         close           = close,
         connect         = connect,
         wait_state      = wait_state,
-        perform_request = perform_request
+        perform_request = perform_request,
+        perform_async_request = perform_async_request,
+        is_request_ready = is_request_ready,
+        wait_request    = wait_request,
+        discard_request = discard_request,
+        cursor_closer   = cursor_closer
     }
 end
 
@@ -760,9 +876,145 @@ function remote_methods:request_timeout(request_opts)
     return timeout
 end
 
-function remote_methods:_request(method, opts, ...)
+-- Convert xrow.body[DATA] in place: tuples for DML and SELECT,
+-- plain Lua objects for CALL and EVAL. If the body was copied to
+-- a user buffer, the response is its length and is left as is.
+local function decode_response(method, buffer, res)
+    if buffer == nil then
+        setmetatable(res, sequence_mt)
+        local postproc = method ~= 'eval' and method ~= 'call_17'
+        if postproc then
+            local tnew = box.tuple.new
+            for i, v in pairs(res) do
+                res[i] = tnew(v)
+            end
+        end
+    end
+    return res
+end
+
+--
+-- A future is what a request method called with {is_async = true}
+-- returns instead of the result. The request is only encoded into
+-- the send buffer, so a fiber can issue a whole batch of requests
+-- which the worker fiber then sends with a single write, and wait
+-- for the results afterwards.
+--
+local future_methods = {}
+local future_mt = { __index = future_methods }
+
+local function future_error(code, reason)
+    local _, err = pcall(box.error, {code = code, reason = reason})
+    return err
+end
+
+-- Resend the request if it failed because the schema changed,
+-- the same way _request() does it. Return true if the future
+-- isn't resolved yet because of that.
+function future_methods:_check_schema()
+    local request = self.request
+    if request.errno ~= E_WRONG_SCHEMA_VERSION then
+        return false
+    end
+    local remote = self.remote
+    if remote.state ~= 'fetch_schema' then
+        self.request = remote._transport.perform_async_request(
+            self.buffer, self.method, remote.schema_version,
+            unpack(self.args, 1, self.args.n))
+    end
+    return true
+end
+
+function future_methods:is_ready()
+    local transport = self.remote._transport
+    return transport.is_request_ready(self.request) and
+           not self:_check_schema()
+end
+
+local function future_result(ok, ...)
+    if not ok then
+        return nil, ...
+    end
+    return ...
+end
+
+-- Apply the method specific post-processing, e.g. one_tuple(),
+-- to a successful response. The response is converted to tuples
+-- only once, no matter how many times the result is requested.
+function future_methods:_decode()
+    local request = self.request
+    if not request.is_decoded then
+        decode_response(self.method, self.buffer, request.response)
+        request.is_decoded = true
+    end
+    local decode = self.decode
+    if decode ~= nil then
+        return decode(request.response)
+    end
+    return request.response
+end
+
+-- Return the result if the response has arrived, nil and an
+-- error object otherwise. Never yields.
+function future_methods:result()
+    if not self:is_ready() then
+        return nil, future_error(E_PROC_LUA, 'Response is not ready')
+    end
+    local request = self.request
+    if request.errno then
+        return nil, future_error(request.errno, request.response)
+    end
+    return future_result(pcall(self._decode, self))
+end
+
+-- Wait for the response and return the result. Raise an error
+-- if the request failed or the timeout expired.
+function future_methods:wait_result(timeout)
+    local deadline = fiber_clock() + (timeout or TIMEOUT_INFINITY)
+    local remote = self.remote
+    local transport = remote._transport
+    while true do
+        local timeout = max(0, deadline - fiber_clock())
+        if not transport.wait_request(self.request, timeout) then
+            box.error(E_TIMEOUT)
+        end
+        if not self:_check_schema() then
+            break
+        end
+        if remote.state == 'fetch_schema' then
+            timeout = max(0, deadline - fiber_clock())
+            if not transport.wait_state('active', timeout) and
+               remote.state == 'fetch_schema' then
+                box.error(E_TIMEOUT)
+            end
+        end
+    end
+    local request = self.request
+    if request.errno then
+        box.error({code = request.errno, reason = request.response})
+    end
+    return self:_decode()
+end
+
+-- Drop the request: the response is ignored when it arrives,
+-- result() and wait_result() report an error.
+function future_methods:discard()
+    self.remote._transport.discard_request(self.request)
+end
+
+function remote_methods:_request(method, opts, decode, ...)
     local this_fiber = fiber_self()
     local transport = self._transport
+    local buffer = opts and opts.buffer
+    if opts and opts.is_async then
+        local request = transport.perform_async_request(buffer, method,
+                                                self.schema_version, ...)
+        return setmetatable({
+            remote = self, request = request, method = method,
+            buffer = buffer, decode = decode,
+            args = {n = select('#', ...), ...},
+        }, future_mt)
+    end
     local perform_request = transport.perform_request
     local wait_state = transport.wait_state
     local deadline = nil
@@ -774,7 +1026,6 @@ function remote_methods:_request(method, opts, ...)
         -- @deprecated since 1.7.4
         deadline = self._deadlines[this_fiber]
     end
-    local buffer = opts and opts.buffer
     local err, res
     repeat
         local timeout = deadline and max(0, deadline - fiber_clock())
@@ -784,16 +1035,10 @@ function remote_methods:_request(method, opts, ...)
         end
         err, res = perform_request(timeout, buffer, method,
                                    self.schema_version, ...)
-        if not err and buffer ~= nil then
-            return res -- the length of xrow.body
-        elseif not err then
-            setmetatable(res, sequence_mt)
-            local postproc = method ~= 'eval' and method ~= 'call_17'
-            if postproc then
-                local tnew = box.tuple.new
-                for i, v in pairs(res) do
-                    res[i] = tnew(v)
-                end
+        if not err then
+            res = decode_response(method, buffer, res)
+            if decode ~= nil then
+                return decode(res)
             end
             return res
         elseif err == E_WRONG_SCHEMA_VERSION then
@@ -803,6 +1048,32 @@ function remote_methods:_request(method, opts, ...)
     box.error({code = err, reason = res})
 end
 
+-- Perform a streamed SELECT or a FETCH. Return the tuples and
+-- the id of the cursor to fetch the rest of the result set from,
+-- or nil if there is nothing more.
+function remote_methods:_request_cursor(method, opts, ...)
+    local transport = self._transport
+    local deadline = opts and opts.timeout and fiber_clock() + opts.timeout
+    local err, res, cursor, _
+    repeat
+        local timeout = deadline and max(0, deadline - fiber_clock())
+        if self.state ~= 'active' then
+            transport.wait_state('active', timeout)
+            timeout = deadline and max(0, deadline - fiber_clock())
+        end
+        err, res, _, _, cursor = transport.perform_request(timeout, nil,
+                                    method, self.schema_version, ...)
+        if not err then
+            local tnew = box.tuple.new
+            for i, v in pairs(res) do
+                res[i] = tnew(v)
+            end
+            return res, cursor
+        end
+    until err ~= E_WRONG_SCHEMA_VERSION
+    box.error({code = err, reason = res})
+end
+
 function remote_methods:ping(opts)
     check_remote_arg(self, 'ping')
     local timeout = self:request_timeout(opts)
@@ -813,42 +1084,44 @@ end
 
 function remote_methods:reload_schema()
     check_remote_arg(self, 'reload_schema')
-    self:_request('select', nil, VSPACE_ID, 0, box.index.GE, 0, 0xFFFFFFFF,
-                  nil)
+    self:_request('select', nil, nil, VSPACE_ID, 0, box.index.GE, 0,
+                  0xFFFFFFFF, nil)
 end
 
 -- @deprecated since 1.7.4
 function remote_methods:call_16(func_name, ...)
     check_remote_arg(self, 'call')
-    return self:_request('call_16', nil, tostring(func_name), {...})
+    return self:_request('call_16', nil, nil, tostring(func_name), {...})
 end
 
-function remote_methods:call(func_name, args, opts)
-    check_remote_arg(self, 'call')
-    check_call_args(args)
-    args = args or {}
-    local res = self:_request('call_17', opts, tostring(func_name), args)
+-- A CALL or EVAL result is the list of the values the function
+-- returned, unless the body was copied to a user buffer.
+local function unpack_result(res)
     if type(res) ~= 'table' then
         return res
     end
     return unpack(res)
 end
 
+function remote_methods:call(func_name, args, opts)
+    check_remote_arg(self, 'call')
+    check_call_args(args)
+    args = args or {}
+    return self:_request('call_17', opts, unpack_result, tostring(func_name),
+                         args)
+end
+
 -- @deprecated since 1.7.4
 function remote_methods:eval_16(code, ...)
     check_remote_arg(self, 'eval')
-    return unpack(self:_request('eval', nil, code, {...}))
+    return self:_request('eval', nil, unpack, code, {...})
 end
 
 function remote_methods:eval(code, args, opts)
     check_remote_arg(self, 'eval')
     check_eval_args(args)
     args = args or {}
-    local res = self:_request('eval', opts, code, args)
-    if type(res) ~= 'table' then
-        return res
-    end
-    return unpack(res)
+    return self:_request('eval', opts, unpack_result, code, args)
 end
 
 function remote_methods:execute(query, parameters, sql_opts, netbox_opts)
@@ -856,6 +1129,9 @@ function remote_methods:execute(query, parameters, sql_opts, netbox_opts)
     if sql_opts ~= nil then
         box.error(box.error.UNSUPPORTED, "execute", "options")
     end
+    if netbox_opts and netbox_opts.is_async then
+        error("execute() doesn't support `is_async` argument")
+    end
     local timeout = self:request_timeout(netbox_opts)
     local buffer = netbox_opts and netbox_opts.buffer
     parameters = parameters or {}
@@ -1035,17 +1311,29 @@ local function one_tuple(tab)
     end
 end
 
+local function no_result()
+end
+
+local function get_result(res)
+    if res[2] ~= nil then box.error(box.error.MORE_THAN_ONE_TUPLE) end
+    if res[1] ~= nil then return res[1] end
+end
+
+local function count_result(res)
+    return res[1][1]
+end
+
 space_metatable = function(remote)
     local methods = {}
 
     function methods:insert(tuple, opts)
         check_space_arg(self, 'insert')
-        return one_tuple(remote:_request('insert', opts, self.id, tuple))
+        return remote:_request('insert', opts, one_tuple, self.id, tuple)
     end
 
     function methods:replace(tuple, opts)
         check_space_arg(self, 'replace')
-        return one_tuple(remote:_request('replace', opts, self.id, tuple))
+        return remote:_request('replace', opts, one_tuple, self.id, tuple)
     end
 
     function methods:select(key, opts)
@@ -1053,6 +1341,11 @@ space_metatable = function(remote)
         return check_primary_index(self):select(key, opts)
     end
 
+    function methods:pairs(key, opts)
+        check_space_arg(self, 'pairs')
+        return check_primary_index(self):pairs(key, opts)
+    end
+
     function methods:delete(key, opts)
         check_space_arg(self, 'delete')
         return check_primary_index(self):delete(key, opts)
@@ -1065,8 +1358,8 @@ space_metatable = function(remote)
 
     function methods:upsert(key, oplist, opts)
         check_space_arg(self, 'upsert')
-        remote:_request('upsert', opts, self.id, key, oplist)
-        return
+        return remote:_request('upsert', opts, no_result, self.id, key,
+                               oplist)
     end
 
     function methods:get(key, opts)
@@ -1095,19 +1388,73 @@ index_metatable = function(remote)
         local iterator = check_iterator_type(opts, key_is_nil)
         local offset = tonumber(opts and opts.offset) or 0
         local limit = tonumber(opts and opts.limit) or 0xFFFFFFFF
-        return remote:_request('select', opts, self.space.id, self.id,
+        return remote:_request('select', opts, nil, self.space.id, self.id,
                                iterator, offset, limit, key)
     end
 
+    -- Iterate over the result set of a SELECT fetching it in
+    -- chunks of opts.fetch_size tuples. The server keeps the
+    -- index iterator open between the chunks, see IPROTO_FETCH.
+    function methods:pairs(key, opts)
+        check_index_arg(self, 'pairs')
+        if opts and opts.buffer then
+            error("index:pairs() doesn't support `buffer` argument")
+        end
+        if opts and opts.is_async then
+            error("index:pairs() doesn't support `is_async` argument")
+        end
+        local key_is_nil = (key == nil or
+                            (type(key) == 'table' and #key == 0))
+        local iterator = check_iterator_type(opts, key_is_nil)
+        local offset = tonumber(opts and opts.offset) or 0
+        local limit = tonumber(opts and opts.limit) or 0xFFFFFFFF
+        local fetch_size = tonumber(opts and opts.fetch_size) or
+                           FETCH_SIZE_DEFAULT
+        if fetch_size <= 0 then
+            error("index:pairs() fetch_size must be greater than 0")
+        end
+        local chunk, id = remote:_request_cursor('select', opts,
+                                self.space.id, self.id, iterator, offset,
+                                limit, key, fetch_size)
+        local cursor = {id = id, chunk = chunk, pos = 0}
+        if id ~= nil then
+            -- Close the cursor if the loop is abandoned. The hook
+            -- must not reference the cursor, which references the
+            -- hook, or it would never be collected.
+            cursor.gc_hook = ffi.gc(ffi.new('char[1]'),
+                                    remote._transport.cursor_closer(id))
+        end
+        local function gen(cursor)
+            local pos = cursor.pos + 1
+            if cursor.chunk[pos] == nil then
+                if cursor.id == nil then
+                    return nil
+                end
+                cursor.chunk, cursor.id = remote:_request_cursor('fetch',
+                                            opts, cursor.id, fetch_size)
+                if cursor.id == nil then
+                    -- The server has closed the cursor.
+                    ffi.gc(cursor.gc_hook, nil)
+                    cursor.gc_hook = nil
+                end
+                pos = 1
+                if cursor.chunk[pos] == nil then
+                    return nil
+                end
+            end
+            cursor.pos = pos
+            return cursor, cursor.chunk[pos]
+        end
+        return fun.wrap(gen, cursor, cursor)
+    end
+
     function methods:get(key, opts)
         check_index_arg(self, 'get')
         if opts and opts.buffer then
             error("index:get() doesn't support `buffer` argument")
         end
-        local res = remote:_request('select', opts, self.space.id, self.id,
-                                    box.index.EQ, 0, 2, key)
-        if res[2] ~= nil then box.error(box.error.MORE_THAN_ONE_TUPLE) end
-        if res[1] ~= nil then return res[1] end
+        return remote:_request('select', opts, get_result, self.space.id,
+                               self.id, box.index.EQ, 0, 2, key)
     end
 
     function methods:min(key, opts)
@@ -1115,9 +1462,8 @@ index_metatable = function(remote)
         if opts and opts.buffer then
             error("index:min() doesn't support `buffer` argument")
         end
-        local res = remote:_request('select', opts, self.space.id, self.id,
-                                    box.index.GE, 0, 1, key)
-        return one_tuple(res)
+        return remote:_request('select', opts, one_tuple, self.space.id,
+                               self.id, box.index.GE, 0, 1, key)
     end
 
     function methods:max(key, opts)
@@ -1125,9 +1471,8 @@ index_metatable = function(remote)
         if opts and opts.buffer then
             error("index:max() doesn't support `buffer` argument")
         end
-        local res = remote:_request('select', opts, self.space.id, self.id,
-                                    box.index.LE, 0, 1, key)
-        return one_tuple(res)
+        return remote:_request('select', opts, one_tuple, self.space.id,
+                               self.id, box.index.LE, 0, 1, key)
     end
 
     function methods:count(key, opts)
@@ -1137,21 +1482,19 @@ index_metatable = function(remote)
         end
         local code = string.format('box.space.%s.index.%s:count',
                                    self.space.name, self.name)
-        return remote:_request('call_16', opts, code, { key })[1][1]
+        return remote:_request('call_16', opts, count_result, code, { key })
     end
 
     function methods:delete(key, opts)
         check_index_arg(self, 'delete')
-        local res = remote:_request('delete', opts, self.space.id, self.id,
-                                    key)
-        return one_tuple(res)
+        return remote:_request('delete', opts, one_tuple, self.space.id,
+                               self.id, key)
     end
 
     function methods:update(key, oplist, opts)
         check_index_arg(self, 'update')
-        local res = remote:_request('update', opts, self.space.id, self.id,
-                                    key, oplist)
-        return one_tuple(res)
+        return remote:_request('update', opts, one_tuple, self.space.id,
+                               self.id, key, oplist)
     end
 
     return { __index = methods, __metatable = false }
@@ -632,11 +632,15 @@ local index_options = {
     unique = 'boolean',
     dimension = 'number',
     distance = 'string',
+    hint = 'boolean',
     run_count_per_level = 'number',
     run_size_ratio = 'number',
     range_size = 'number',
     page_size = 'number',
     bloom_fpr = 'number',
+    bloom_prefix_parts = 'number',
+    compaction_policy = 'string',
+    compaction_time_window = 'number',
 }
 
 --
@@ -736,11 +740,15 @@ box.schema.index.create = function(space_id, name, options)
             dimension = options.dimension,
             unique = options.unique,
             distance = options.distance,
+            hint = options.hint,
             page_size = options.page_size,
             range_size = options.range_size,
             run_count_per_level = options.run_count_per_level,
             run_size_ratio = options.run_size_ratio,
             bloom_fpr = options.bloom_fpr,
+            bloom_prefix_parts = options.bloom_prefix_parts,
+            compaction_policy = options.compaction_policy,
+            compaction_time_window = options.compaction_time_window,
     }
     local field_type_aliases = {
         num = 'unsigned'; -- Deprecated since 1.7.2
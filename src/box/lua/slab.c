@@ -44,6 +44,7 @@
 
 extern struct small_alloc memtx_alloc;
 extern struct mempool memtx_index_extent_pool;
+extern size_t memtx_hot_field_map_used;
 
 static int
 small_stats_noop_cb(const struct mempool_stats *stats, void *cb_ctx)
@@ -225,6 +226,15 @@ lbox_slab_info(struct lua_State *L)
 	lua_pushstring(L, ratio_buf);
 	lua_settable(L, -3);
 
+	/*
+	 * Part of items_used spent on offsets of hot fields,
+	 * i.e. the price of declaring fields hot in space
+	 * formats.
+	 */
+	lua_pushstring(L, "hot_field_map_used");
+	luaL_pushuint64(L, memtx_hot_field_map_used);
+	lua_settable(L, -3);
+
 	return 1;
 }
 
@@ -40,12 +40,13 @@
 
 #include "box/box.h"
 #include "box/iproto.h"
+#include "box/wal.h"
+#include "box/info.h"
+#include "box/lua/info.h"
 #include "lua/utils.h"
 
 extern struct rmean *rmean_box;
 extern struct rmean *rmean_error;
-/** network statistics (iproto & cbus) */
-extern struct rmean *rmean_net;
 extern struct rmean *rmean_tx_wal_bus;
 
 static void
@@ -124,14 +125,33 @@ static int
 lbox_stat_net_index(struct lua_State *L)
 {
 	luaL_checkstring(L, -1);
-	return rmean_foreach(rmean_net, seek_stat_item, L);
+	return iproto_rmean_foreach(seek_stat_item, L);
 }
 
 static int
 lbox_stat_net_call(struct lua_State *L)
 {
 	lua_newtable(L);
-	rmean_foreach(rmean_net, set_stat_item, L);
+	iproto_rmean_foreach(set_stat_item, L);
+	return 1;
+}
+
+static int
+lbox_stat_wal(struct lua_State *L)
+{
+	struct info_handler info;
+	luaT_info_handler_create(&info, L);
+	wal_stat(&info);
+	return 1;
+}
+
+static int
+lbox_stat_latency(struct lua_State *L)
+{
+	struct info_handler info;
+	luaT_info_handler_create(&info, L);
+	if (iproto_latency_stat(&info) != 0)
+		return luaT_error(L);
 	return 1;
 }
 
@@ -156,7 +176,14 @@ box_lua_stat_init(struct lua_State *L)
 		{NULL, NULL}
 	};
 
-	luaL_register_module(L, "box.stat", statlib);
+	static const struct luaL_Reg boxstatlib [] = {
+		{"reset", lbox_stat_reset},
+		{"wal", lbox_stat_wal},
+		{"latency", lbox_stat_latency},
+		{NULL, NULL}
+	};
+
+	luaL_register_module(L, "box.stat", boxstatlib);
 
 	lua_newtable(L);
 	luaL_register(L, NULL, lbox_stat_meta);
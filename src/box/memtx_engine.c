@@ -35,7 +35,10 @@
 #include <small/small.h>
 #include <small/mempool.h>
 
+#include "cbus.h"
 #include "coio_file.h"
+#include "fiber_cond.h"
+#include "tt_pthread.h"
 #include "tuple.h"
 #include "txn.h"
 #include "memtx_tree.h"
@@ -46,6 +49,7 @@
 #include "replication.h"
 #include "schema.h"
 #include "gc.h"
+#include "info.h"
 
 /** For all memory used by all indexes.
  * If you decide to use memtx_index_arena or
@@ -89,6 +93,124 @@ memtx_end_build_primary_key(struct space *space, void *param)
 	return 0;
 }
 
+/**
+ * A job shared by threads sorting tree index build arrays.
+ */
+struct memtx_sort_job {
+	struct memtx_tree_index **indexes;
+	int index_count;
+	/** Index of the next build array to sort. */
+	int next;
+	pthread_mutex_t mutex;
+};
+
+static void
+memtx_sort_job_run(struct memtx_sort_job *job)
+{
+	while (true) {
+		tt_pthread_mutex_lock(&job->mutex);
+		int i = job->next++;
+		tt_pthread_mutex_unlock(&job->mutex);
+		if (i >= job->index_count)
+			break;
+		memtx_tree_index_sort_build_array(job->indexes[i]);
+	}
+}
+
+static int
+memtx_sort_job_f(va_list ap)
+{
+	struct memtx_sort_job *job = va_arg(ap, struct memtx_sort_job *);
+	memtx_sort_job_run(job);
+	return 0;
+}
+
+/**
+ * Build all secondary keys of a space using a single scan of
+ * the primary key. The most expensive part of the build, which
+ * is sorting of tree index build arrays, is done concurrently
+ * in up to memtx->threads threads. Index memory is only ever
+ * allocated in tx.
+ */
+static int
+memtx_build_secondary_keys_parallel(struct memtx_engine *memtx,
+				    struct space *space, ssize_t n_tuples)
+{
+	struct index *pk = space->index[0];
+	uint32_t estimated_tuples = n_tuples * 1.2;
+	for (uint32_t j = 1; j < space->index_count; j++) {
+		struct index *index = space->index[j];
+		index_begin_build(index);
+		if (index_reserve(index, estimated_tuples) < 0)
+			return -1;
+		if (n_tuples > 0) {
+			say_info("Adding %zd keys to %s index '%s' ...",
+				 n_tuples, index_type_strs[index->def->type],
+				 index->def->name);
+		}
+	}
+
+	struct iterator *it = index_create_iterator(pk, ITER_ALL, NULL, 0);
+	if (it == NULL)
+		return -1;
+	int rc = 0;
+	struct tuple *tuple;
+	while ((rc = iterator_next(it, &tuple)) == 0 && tuple != NULL) {
+		for (uint32_t j = 1; j < space->index_count; j++) {
+			rc = index_build_next(space->index[j], tuple);
+			if (rc != 0)
+				break;
+		}
+		if (rc != 0)
+			break;
+	}
+	iterator_delete(it);
+	if (rc != 0)
+		return -1;
+
+	struct memtx_tree_index *indexes[BOX_INDEX_MAX];
+	struct memtx_sort_job job;
+	job.indexes = indexes;
+	job.index_count = 0;
+	job.next = 0;
+	for (uint32_t j = 1; j < space->index_count; j++) {
+		struct index *index = space->index[j];
+		if (index->def->type == TREE)
+			indexes[job.index_count++] = (void *)index;
+	}
+	int thread_count = MIN(memtx->threads, job.index_count);
+	if (thread_count > 1) {
+		struct cord *cords = calloc(thread_count - 1, sizeof(*cords));
+		if (cords == NULL) {
+			diag_set(OutOfMemory, (thread_count - 1) *
+				 sizeof(*cords), "calloc", "struct cord");
+			return -1;
+		}
+		tt_pthread_mutex_init(&job.mutex, NULL);
+		int started = 0;
+		for (; started < thread_count - 1; started++) {
+			char name[FIBER_NAME_MAX];
+			snprintf(name, sizeof(name), "index_sort.%d",
+				 started + 1);
+			if (cord_costart(&cords[started], name,
+					 memtx_sort_job_f, &job) != 0) {
+				/* Make do with the threads we have. */
+				diag_log();
+				break;
+			}
+		}
+		memtx_sort_job_run(&job);
+		for (int i = 0; i < started; i++)
+			cord_join(&cords[i]);
+		tt_pthread_mutex_destroy(&job.mutex);
+		free(cords);
+	}
+	/* Build arrays sorted above are not sorted again. */
+	for (uint32_t j = 1; j < space->index_count; j++)
+		index_end_build(space->index[j]);
+	return 0;
+}
+
 /**
  * Secondary indexes are built in bulk after all data is
  * recovered. This function enables secondary keys on a space.
@@ -113,9 +235,16 @@ memtx_build_secondary_keys(struct space *space, void *param)
 				 space_name(space));
 		}
 
-		for (uint32_t j = 1; j < space->index_count; j++) {
-			if (index_build(space->index[j], pk) < 0)
+		struct memtx_engine *memtx = (struct memtx_engine *)param;
+		if (memtx->threads > 1 && space->index_count > 2) {
+			if (memtx_build_secondary_keys_parallel(memtx, space,
+								n_tuples) != 0)
 				return -1;
+		} else {
+			for (uint32_t j = 1; j < space->index_count; j++) {
+				if (index_build(space->index[j], pk) < 0)
+					return -1;
+			}
 		}
 
 		if (n_tuples > 0) {
@@ -147,6 +276,223 @@ static int
 memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 				  struct xrow_header *row);
 
+enum {
+	/** Max number of rows sent by the snapshot reader at once. */
+	SNAP_READ_BATCH_ROWS = 1024,
+	/** Max number of batches the snapshot reader has in flight. */
+	SNAP_READ_BATCH_MAX = 8,
+};
+
+/**
+ * Snapshot rows decoded by the snapshot reader thread and
+ * passed to tx for recovery.
+ */
+struct snap_read_batch {
+	struct cmsg base;
+	struct snap_reader *reader;
+	/** Link in snap_reader::free or snap_reader::queue. */
+	struct stailq_entry in_queue;
+	struct xrow_header rows[SNAP_READ_BATCH_ROWS];
+	int row_count;
+	/** Row bodies. */
+	char *data;
+	size_t data_size;
+	size_t data_capacity;
+	/** Set for the last batch sent by the reader. */
+	bool is_last;
+	/** Last batch: the status of reading and the error, if any. */
+	int rc;
+	struct diag diag;
+	/** Last batch: set if the snapshot has the EOF marker. */
+	bool is_eof;
+	/** Set by tx if it doesn't need more rows. */
+	bool is_stopped;
+};
+
+/**
+ * The snapshot reader reads, decompresses and decodes snapshot
+ * rows in a separate thread while tx is busy applying rows read
+ * before.
+ */
+struct snap_reader {
+	const char *filename;
+	bool force_recovery;
+	struct cord cord;
+	/** Reader thread endpoint. */
+	struct cbus_endpoint endpoint;
+	/** Pipe from the reader thread to tx. */
+	struct cpipe tx_pipe;
+	/** Pipe from tx to the reader thread. */
+	struct cpipe reader_pipe;
+	/** Instance UUID from the snapshot meta. */
+	struct tt_uuid instance_uuid;
+	/** Reader thread: batches returned by tx. */
+	struct stailq free;
+	/** Reader thread: number of batches in the free list. */
+	int free_count;
+	/** Reader thread: set if tx doesn't need more rows. */
+	bool is_stopped;
+	/** Tx: batches received from the reader thread. */
+	struct stailq queue;
+	/** Tx: signalled when a batch is received. */
+	struct fiber_cond cond;
+	struct snap_read_batch batches[SNAP_READ_BATCH_MAX];
+};
+
+static void
+snap_read_batch_deliver(struct cmsg *msg)
+{
+	struct snap_read_batch *batch = (struct snap_read_batch *)msg;
+	struct snap_reader *reader = batch->reader;
+	stailq_add_tail_entry(&reader->queue, batch, in_queue);
+	fiber_cond_signal(&reader->cond);
+}
+
+static void
+snap_read_batch_return(struct cmsg *msg)
+{
+	struct snap_read_batch *batch = (struct snap_read_batch *)msg;
+	struct snap_reader *reader = batch->reader;
+	if (batch->is_stopped)
+		reader->is_stopped = true;
+	stailq_add_tail_entry(&reader->free, batch, in_queue);
+	reader->free_count++;
+}
+
+static const struct cmsg_hop snap_read_batch_route[] = {
+	{snap_read_batch_deliver, NULL},
+	/* Passed back by tx when the rows are applied. */
+	{snap_read_batch_return, NULL},
+};
+
+/** Reader thread: get a batch not used by tx. */
+static struct snap_read_batch *
+snap_reader_get_batch(struct snap_reader *reader)
+{
+	while (stailq_empty(&reader->free)) {
+		cbus_process(&reader->endpoint);
+		if (!stailq_empty(&reader->free))
+			break;
+		fiber_yield();
+	}
+	struct snap_read_batch *batch;
+	batch = stailq_shift_entry(&reader->free, struct snap_read_batch,
+				   in_queue);
+	reader->free_count--;
+	cmsg_init(&batch->base, snap_read_batch_route);
+	batch->row_count = 0;
+	batch->data_size = 0;
+	batch->is_last = false;
+	batch->rc = 0;
+	batch->is_eof = false;
+	batch->is_stopped = false;
+	return batch;
+}
+
+/** Reader thread: copy a row to a batch. */
+static int
+snap_read_batch_add(struct snap_read_batch *batch, struct xrow_header *row)
+{
+	assert(batch->row_count < SNAP_READ_BATCH_ROWS);
+	assert(row->bodycnt <= 1);
+	size_t size = row->bodycnt > 0 ? row->body[0].iov_len : 0;
+	if (batch->data_size + size > batch->data_capacity) {
+		size_t capacity = MAX(batch->data_capacity * 2,
+				      batch->data_size + size);
+		char *data = realloc(batch->data, capacity);
+		if (data == NULL) {
+			diag_set(OutOfMemory, capacity, "realloc",
+				 "snapshot read batch");
+			return -1;
+		}
+		batch->data = data;
+		batch->data_capacity = capacity;
+	}
+	struct xrow_header *copy = &batch->rows[batch->row_count++];
+	*copy = *row;
+	if (row->bodycnt > 0) {
+		memcpy(batch->data + batch->data_size,
+		       row->body[0].iov_base, size);
+		/*
+		 * The buffer may be reallocated, so store offsets
+		 * until the batch is complete.
+		 */
+		copy->body[0].iov_base = (void *)(uintptr_t)batch->data_size;
+		batch->data_size += size;
+	}
+	return 0;
+}
+
+/** Reader thread: pass a complete batch to tx. */
+static void
+snap_reader_send(struct snap_reader *reader, struct snap_read_batch *batch)
+{
+	for (int i = 0; i < batch->row_count; i++) {
+		struct xrow_header *row = &batch->rows[i];
+		if (row->bodycnt > 0) {
+			row->body[0].iov_base = batch->data +
+				(uintptr_t)row->body[0].iov_base;
+		}
+	}
+	cpipe_push(&reader->tx_pipe, &batch->base);
+}
+
+static int
+snap_reader_f(va_list ap)
+{
+	struct snap_reader *reader = va_arg(ap, struct snap_reader *);
+
+	cbus_endpoint_create(&reader->endpoint, cord_name(cord()),
+			     fiber_schedule_cb, fiber());
+	cbus_pair("tx", cord_name(cord()), &reader->tx_pipe,
+		  &reader->reader_pipe, NULL, NULL, cbus_process);
+	/*
+	 * The reader doesn't yield while it has free batches,
+	 * so deliver each batch to tx as soon as it is pushed.
+	 */
+	cpipe_set_max_input(&reader->tx_pipe, 1);
+
+	struct snap_read_batch *batch = snap_reader_get_batch(reader);
+	struct xlog_cursor cursor;
+	int rc = xlog_cursor_open(&cursor, reader->filename);
+	if (rc < 0)
+		goto done;
+	reader->instance_uuid = cursor.meta.instance_uuid;
+
+	struct xrow_header row;
+	while (!reader->is_stopped &&
+	       (rc = xlog_cursor_next(&cursor, &row,
+				      reader->force_recovery)) == 0) {
+		if (batch->row_count == SNAP_READ_BATCH_ROWS) {
+			snap_reader_send(reader, batch);
+			batch = snap_reader_get_batch(reader);
+		}
+		rc = snap_read_batch_add(batch, &row);
+		if (rc < 0)
+			break;
+	}
+	xlog_cursor_close(&cursor, false);
+	batch->is_eof = xlog_cursor_is_eof(&cursor);
+done:
+	batch->is_last = true;
+	batch->rc = rc < 0 ? -1 : 0;
+	if (rc < 0)
+		diag_move(diag_get(), &batch->diag);
+	snap_reader_send(reader, batch);
+
+	/* Wait for tx to return all batches. */
+	while (reader->free_count < SNAP_READ_BATCH_MAX) {
+		cbus_process(&reader->endpoint);
+		if (reader->free_count == SNAP_READ_BATCH_MAX)
+			break;
+		fiber_yield();
+	}
+	cbus_unpair(&reader->tx_pipe, &reader->reader_pipe,
+		    NULL, NULL, cbus_process);
+	cbus_endpoint_destroy(&reader->endpoint, cbus_process);
+	return 0;
+}
+
 int
 memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 			      const struct vclock *vclock)
@@ -158,32 +504,90 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 						    signature, NONE);
 
 	say_info("recovering from `%s'", filename);
-	struct xlog_cursor cursor;
-	if (xlog_cursor_open(&cursor, filename) < 0)
+	struct snap_reader *reader = calloc(1, sizeof(*reader));
+	if (reader == NULL) {
+		diag_set(OutOfMemory, sizeof(*reader),
+			 "calloc", "struct snap_reader");
+		return -1;
+	}
+	reader->filename = filename;
+	reader->force_recovery = memtx->force_recovery;
+	stailq_create(&reader->free);
+	stailq_create(&reader->queue);
+	fiber_cond_create(&reader->cond);
+	for (int i = 0; i < SNAP_READ_BATCH_MAX; i++) {
+		struct snap_read_batch *batch = &reader->batches[i];
+		batch->reader = reader;
+		diag_create(&batch->diag);
+		stailq_add_tail_entry(&reader->free, batch, in_queue);
+	}
+	reader->free_count = SNAP_READ_BATCH_MAX;
+	/*
+	 * Reading and decoding the snapshot is pipelined with
+	 * applying rows: the former is done by a separate thread.
+	 */
+	if (cord_costart(&reader->cord, "snap_reader",
+			 snap_reader_f, reader) != 0) {
+		free(reader);
 		return -1;
-	INSTANCE_UUID = cursor.meta.instance_uuid;
+	}
 
-	int rc;
-	struct xrow_header row;
+	int rc = 0;
+	bool is_eof = false;
+	bool is_first = true;
 	uint64_t row_count = 0;
-	while ((rc = xlog_cursor_next(&cursor, &row,
-				      memtx->force_recovery)) == 0) {
-		row.lsn = signature;
-		rc = memtx_engine_recover_snapshot_row(memtx, &row);
-		if (rc < 0) {
-			if (!memtx->force_recovery)
-				break;
-			say_error("can't apply row: ");
-			diag_log();
+	struct snap_read_batch *batch;
+	do {
+		while (stailq_empty(&reader->queue))
+			fiber_cond_wait(&reader->cond);
+		batch = stailq_shift_entry(&reader->queue,
+					   struct snap_read_batch, in_queue);
+		if (is_first) {
+			INSTANCE_UUID = reader->instance_uuid;
+			is_first = false;
 		}
-		++row_count;
-		if (row_count % 100000 == 0) {
-			say_info("%.1fM rows processed",
-				 row_count / 1000000.);
-			fiber_yield_timeout(0);
+		for (int i = 0; rc == 0 && i < batch->row_count; i++) {
+			struct xrow_header *row = &batch->rows[i];
+			row->lsn = signature;
+			if (memtx_engine_recover_snapshot_row(memtx, row) < 0) {
+				if (!memtx->force_recovery) {
+					rc = -1;
+					break;
+				}
+				say_error("can't apply row: ");
+				diag_log();
+			}
+			++row_count;
+			if (row_count % 100000 == 0) {
+				say_info("%.1fM rows processed",
+					 row_count / 1000000.);
+				fiber_yield_timeout(0);
+			}
+		}
+		bool is_last = batch->is_last;
+		if (is_last) {
+			is_eof = batch->is_eof;
+			if (rc == 0 && batch->rc != 0) {
+				diag_move(&batch->diag, diag_get());
+				rc = -1;
+			}
 		}
+		/* Stop reading on error. */
+		batch->is_stopped = rc != 0;
+		batch->base.hop++;
+		cpipe_push(&reader->reader_pipe, &batch->base);
+		if (is_last)
+			break;
+	} while (true);
+
+	if (cord_cojoin(&reader->cord) != 0)
+		rc = -1;
+	for (int i = 0; i < SNAP_READ_BATCH_MAX; i++) {
+		free(reader->batches[i].data);
+		diag_destroy(&reader->batches[i].diag);
 	}
-	xlog_cursor_close(&cursor, false);
+	fiber_cond_destroy(&reader->cond);
+	free(reader);
 	if (rc < 0)
 		return -1;
 
@@ -192,7 +596,7 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 	 * marker - such snapshots are very likely corrupted and
 	 * should not be trusted.
 	 */
-	if (!xlog_cursor_is_eof(&cursor))
+	if (!is_eof)
 		panic("snapshot `%s' has no EOF marker", filename);
 
 	return 0;
@@ -402,6 +806,10 @@ memtx_engine_rollback_statement(struct engine *engine, struct txn *txn,
 	if (stmt->engine_savepoint != NULL)
 		memtx_space_update_bsize(space, stmt->new_tuple,
 					 stmt->old_tuple);
+	/* Let an index being built know about the rollback. */
+	if (index_count > 0 && memtx_space->build != NULL)
+		memtx_index_build_log(memtx_space->build, stmt->new_tuple,
+				      stmt->old_tuple);
 
 	if (stmt->new_tuple)
 		tuple_unref(stmt->new_tuple);
@@ -473,7 +881,8 @@ checkpoint_write_row(struct xlog *l, struct xrow_header *row)
 	 * This makes streaming such rows to a replica or
 	 * to recovery look similar to streaming a normal
 	 * WAL. @sa the place which skips old rows in
-	 * recovery_apply_row().
+	 * recovery_apply_row(). If the snapshot is written
+	 * by several threads, rows are numbered per thread.
 	 */
 	row->lsn = l->rows + l->tx_rows;
 	row->sync = 0; /* don't write sync to wal */
@@ -525,6 +934,16 @@ struct checkpoint {
 	 */
 	struct rlist entries;
 	uint64_t snap_io_rate_limit;
+	/** Number of threads writing the snapshot. */
+	int threads;
+	/**
+	 * Link of the next entry to be written by a snapshot
+	 * thread, protected by the mutex.
+	 */
+	struct rlist *next_entry;
+	/** Set if a snapshot thread failed. */
+	bool is_failed;
+	pthread_mutex_t mutex;
 	struct cord cord;
 	bool waiting_for_snap_thread;
 	/** The vclock of the snapshot file. */
@@ -539,9 +958,12 @@ struct checkpoint {
 
 static int
 checkpoint_init(struct checkpoint *ckpt, const char *snap_dirname,
-		uint64_t snap_io_rate_limit)
+		uint64_t snap_io_rate_limit, int threads)
 {
 	rlist_create(&ckpt->entries);
+	ckpt->threads = threads;
+	ckpt->next_entry = &ckpt->entries;
+	ckpt->is_failed = false;
 	ckpt->waiting_for_snap_thread = false;
 	xdir_create(&ckpt->dir, snap_dirname, SNAP, &INSTANCE_UUID);
 	ckpt->snap_io_rate_limit = snap_io_rate_limit;
@@ -550,10 +972,12 @@ checkpoint_init(struct checkpoint *ckpt, const char *snap_dirname,
 	if (ckpt->vclock == NULL) {
 		diag_set(OutOfMemory, sizeof(*ckpt->vclock),
 			 "malloc", "vclock");
+		xdir_destroy(&ckpt->dir);
 		return -1;
 	}
 	vclock_create(ckpt->vclock);
 	ckpt->touch = false;
+	tt_pthread_mutex_init(&ckpt->mutex, NULL);
 	return 0;
 }
 
@@ -567,6 +991,7 @@ checkpoint_destroy(struct checkpoint *ckpt)
 	rlist_create(&ckpt->entries);
 	xdir_destroy(&ckpt->dir);
 	free(ckpt->vclock);
+	tt_pthread_mutex_destroy(&ckpt->mutex);
 }
 
 
@@ -598,6 +1023,133 @@ checkpoint_add_space(struct space *sp, void *data)
 	return 0;
 };
 
+/** Write all tuples of a space to a snapshot. */
+static int
+checkpoint_write_space(struct xlog *l, struct checkpoint_entry *entry)
+{
+	uint32_t size;
+	const char *data;
+	struct snapshot_iterator *it = entry->iterator;
+	for (data = it->next(it, &size); data != NULL;
+	     data = it->next(it, &size)) {
+		if (checkpoint_write_tuple(l, space_id(entry->space),
+					   data, size) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+/**
+ * Take the next space to be written by a snapshot thread.
+ * Returns NULL if there are no spaces left or a snapshot
+ * thread failed.
+ */
+static struct checkpoint_entry *
+checkpoint_next_entry(struct checkpoint *ckpt)
+{
+	struct checkpoint_entry *entry = NULL;
+	tt_pthread_mutex_lock(&ckpt->mutex);
+	if (!ckpt->is_failed && ckpt->next_entry->next != &ckpt->entries) {
+		ckpt->next_entry = ckpt->next_entry->next;
+		entry = rlist_entry(ckpt->next_entry,
+				    struct checkpoint_entry, link);
+	}
+	tt_pthread_mutex_unlock(&ckpt->mutex);
+	return entry;
+}
+
+struct checkpoint_worker {
+	struct checkpoint *ckpt;
+	/** The snapshot file. */
+	struct xlog *snap;
+	struct cord cord;
+};
+
+/**
+ * Write spaces taken from the checkpoint one by one until
+ * there are none left.
+ */
+static int
+checkpoint_worker_write(struct checkpoint_worker *worker)
+{
+	struct checkpoint *ckpt = worker->ckpt;
+
+	struct xlog part;
+	if (xlog_create_shared(&part, worker->snap) != 0)
+		goto fail;
+
+	struct checkpoint_entry *entry;
+	while ((entry = checkpoint_next_entry(ckpt)) != NULL) {
+		if (checkpoint_write_space(&part, entry) != 0)
+			goto fail_close;
+	}
+	if (xlog_flush(&part) < 0)
+		goto fail_close;
+	xlog_close(&part, false);
+	return 0;
+fail_close:
+	xlog_close(&part, false);
+fail:
+	tt_pthread_mutex_lock(&ckpt->mutex);
+	ckpt->is_failed = true;
+	tt_pthread_mutex_unlock(&ckpt->mutex);
+	return -1;
+}
+
+static int
+checkpoint_worker_f(va_list ap)
+{
+	struct checkpoint_worker *worker =
+		va_arg(ap, struct checkpoint_worker *);
+	return checkpoint_worker_write(worker);
+}
+
+/**
+ * Write user spaces to the snapshot using ckpt->threads
+ * threads, the calling one included. Each thread takes the
+ * next space not written yet, so that big spaces don't stall
+ * the others, and compresses rows in its own buffers. Rows
+ * of different spaces are interleaved in the file by tx
+ * blocks, which is fine for recovery since it doesn't depend
+ * on the order of rows of different user spaces.
+ */
+static int
+checkpoint_write_parallel(struct checkpoint *ckpt, struct xlog *snap)
+{
+	int n_workers = ckpt->threads - 1;
+	struct checkpoint_worker *workers = calloc(n_workers + 1,
+						   sizeof(*workers));
+	if (workers == NULL) {
+		diag_set(OutOfMemory, (n_workers + 1) * sizeof(*workers),
+			 "malloc", "struct checkpoint_worker");
+		return -1;
+	}
+	for (int i = 0; i <= n_workers; i++) {
+		workers[i].ckpt = ckpt;
+		workers[i].snap = snap;
+	}
+	int n_started;
+	for (n_started = 0; n_started < n_workers; n_started++) {
+		char name[FIBER_NAME_MAX];
+		snprintf(name, sizeof(name), "snapshot.%d", n_started + 1);
+		if (cord_costart(&workers[n_started].cord, name,
+				 checkpoint_worker_f,
+				 &workers[n_started]) != 0) {
+			/* Make do with the threads we have. */
+			diag_log();
+			break;
+		}
+	}
+	/* Do our share of work. */
+	int rc = checkpoint_worker_write(&workers[n_workers]);
+	for (int i = 0; i < n_started; i++) {
+		if (cord_join(&workers[i].cord) != 0)
+			rc = -1;
+	}
+	free(workers);
+	return rc;
+}
+
 static int
 checkpoint_f(va_list ap)
 {
@@ -620,28 +1172,30 @@ checkpoint_f(va_list ap)
 	snap.rate_limit = ckpt->snap_io_rate_limit;
 
 	say_info("saving snapshot `%s'", snap.filename);
+	/*
+	 * System spaces must precede user spaces in the
+	 * snapshot, since the latter are created on recovery
+	 * of the former. Write them from this thread.
+	 */
 	struct checkpoint_entry *entry;
 	rlist_foreach_entry(entry, &ckpt->entries, link) {
-		uint32_t size;
-		const char *data;
-		struct snapshot_iterator *it = entry->iterator;
-		for (data = it->next(it, &size); data != NULL;
-		     data = it->next(it, &size)) {
-			if (checkpoint_write_tuple(&snap,
-					space_id(entry->space),
-					data, size) != 0) {
-				xlog_close(&snap, false);
-				return -1;
-			}
-		}
-	}
-	if (xlog_flush(&snap) < 0) {
-		xlog_close(&snap, false);
-		return -1;
+		if (ckpt->threads > 1 && !space_is_system(entry->space))
+			break;
+		if (checkpoint_write_space(&snap, entry) != 0)
+			goto fail;
+		ckpt->next_entry = &entry->link;
 	}
+	if (xlog_flush(&snap) < 0)
+		goto fail;
+	if (ckpt->threads > 1 &&
+	    checkpoint_write_parallel(ckpt, &snap) != 0)
+		goto fail;
 	xlog_close(&snap, false);
 	say_info("done");
 	return 0;
+fail:
+	xlog_close(&snap, false);
+	return -1;
 }
 
 static int
@@ -658,7 +1212,7 @@ memtx_engine_begin_checkpoint(struct engine *engine)
 	}
 
 	if (checkpoint_init(memtx->checkpoint, memtx->snap_dir.dirname,
-			    memtx->snap_io_rate_limit) != 0)
+			    memtx->snap_io_rate_limit, memtx->threads) != 0)
 		return -1;
 
 	if (space_foreach(checkpoint_add_space, memtx->checkpoint) != 0) {
@@ -953,18 +1507,44 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 
 	memtx->state = MEMTX_INITIALIZED;
 	memtx->force_recovery = force_recovery;
+	memtx->threads = 1;
+	rlist_create(&memtx->index_builds);
 
 	memtx->base.vtab = &memtx_engine_vtab;
 	memtx->base.name = "memtx";
 	return memtx;
 }
 
+void
+memtx_engine_info(struct memtx_engine *memtx, struct info_handler *h)
+{
+	info_begin(h);
+	info_table_begin(h, "index_build");
+	struct memtx_index_build *build;
+	rlist_foreach_entry(build, &memtx->index_builds, in_engine) {
+		info_table_begin(h, tt_sprintf("%s.%s",
+						space_name(build->space),
+						build->index->def->name));
+		info_append_int(h, "processed", build->processed);
+		info_append_int(h, "total", build->total);
+		info_table_end(h);
+	}
+	info_table_end(h);
+	info_end(h);
+}
+
 void
 memtx_engine_set_snap_io_rate_limit(struct memtx_engine *memtx, double limit)
 {
 	memtx->snap_io_rate_limit = limit * 1024 * 1024;
 }
 
+void
+memtx_engine_set_threads(struct memtx_engine *memtx, int threads)
+{
+	memtx->threads = threads;
+}
+
 void
 memtx_engine_set_max_tuple_size(struct memtx_engine *memtx, size_t max_size)
 {
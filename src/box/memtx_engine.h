@@ -42,6 +42,8 @@
 extern "C" {
 #endif /* defined(__cplusplus) */
 
+struct info_handler;
+
 /**
  * The state of memtx recovery process.
  * There is a global state of the entire engine state of each
@@ -89,6 +91,8 @@ struct memtx_engine {
 	struct xdir snap_dir;
 	/** Limit disk usage of checkpointing (bytes per second). */
 	uint64_t snap_io_rate_limit;
+	/** Number of threads used for writing snapshots. */
+	int threads;
 	/** Skip invalid snapshot records if this flag is set. */
 	bool force_recovery;
 	/** Memory pool for tree index iterator. */
@@ -99,6 +103,11 @@ struct memtx_engine {
 	struct mempool hash_iterator_pool;
 	/** Memory pool for bitset index iterator. */
 	struct mempool bitset_iterator_pool;
+	/**
+	 * Non-blocking index builds in progress, linked by
+	 * memtx_index_build::in_engine.
+	 */
+	struct rlist index_builds;
 };
 
 struct memtx_engine *
@@ -110,9 +119,18 @@ int
 memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 			      const struct vclock *vclock);
 
+/**
+ * Engine introspection (box.info.memtx())
+ */
+void
+memtx_engine_info(struct memtx_engine *memtx, struct info_handler *h);
+
 void
 memtx_engine_set_snap_io_rate_limit(struct memtx_engine *memtx, double limit);
 
+void
+memtx_engine_set_threads(struct memtx_engine *memtx, int threads);
+
 void
 memtx_engine_set_max_tuple_size(struct memtx_engine *memtx, size_t max_size);
 
@@ -237,6 +237,7 @@ memtx_space_replace_all_keys(struct space *space, struct tuple *old_tuple,
 			     enum dup_replace_mode mode,
 			     struct tuple **result)
 {
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
 	/*
 	 * Ensure we have enough slack memory to guarantee
 	 * successful statement-level rollback.
@@ -271,6 +272,8 @@ memtx_space_replace_all_keys(struct space *space, struct tuple *old_tuple,
 	}
 
 	memtx_space_update_bsize(space, old_tuple, new_tuple);
+	if (memtx_space->build != NULL)
+		memtx_index_build_log(memtx_space->build, old_tuple, new_tuple);
 	*result = old_tuple;
 	return 0;
 
@@ -847,6 +850,180 @@ memtx_init_ephemeral_space(struct space *space)
 	memtx_space_do_add_primary_key(space, MEMTX_OK);
 }
 
+enum {
+	/**
+	 * Number of tuples scanned by a non-blocking index
+	 * build between yields.
+	 */
+	MEMTX_BUILD_YIELD_LOOPS = 1000,
+};
+
+void
+memtx_index_build_log(struct memtx_index_build *build,
+		      struct tuple *old_tuple, struct tuple *new_tuple)
+{
+	if (build->is_failed || build->cursor == NULL)
+		return;
+	struct tuple *tuple = new_tuple != NULL ? new_tuple : old_tuple;
+	if (tuple_compare(tuple, build->cursor, build->pk_def) > 0)
+		return;
+	if (build->log_size == build->log_capacity) {
+		size_t capacity = MAX(build->log_capacity * 2, 64);
+		struct memtx_build_change *log =
+			realloc(build->log, capacity * sizeof(*log));
+		if (log == NULL) {
+			diag_set(OutOfMemory, capacity * sizeof(*log),
+				 "realloc", "index build log");
+			goto fail;
+		}
+		build->log = log;
+		build->log_capacity = capacity;
+	}
+	if (old_tuple != NULL && tuple_ref(old_tuple) != 0)
+		goto fail;
+	if (new_tuple != NULL && tuple_ref(new_tuple) != 0) {
+		if (old_tuple != NULL)
+			tuple_unref(old_tuple);
+		goto fail;
+	}
+	struct memtx_build_change *change = &build->log[build->log_size++];
+	change->old_tuple = old_tuple;
+	change->new_tuple = new_tuple;
+	return;
+fail:
+	/* The change is lost, so the index can't be built. */
+	diag_move(diag_get(), &build->diag);
+	build->is_failed = true;
+}
+
+/** Forget logged changes, releasing the tuples. */
+static void
+memtx_index_build_clear_log(struct memtx_index_build *build)
+{
+	for (size_t i = 0; i < build->log_size; i++) {
+		struct memtx_build_change *change = &build->log[i];
+		if (change->old_tuple != NULL)
+			tuple_unref(change->old_tuple);
+		if (change->new_tuple != NULL)
+			tuple_unref(change->new_tuple);
+	}
+	build->log_size = 0;
+}
+
+/**
+ * Apply logged changes to an index built tuple by tuple.
+ * Done after each yield, so that the index reflects the
+ * current state of the scanned part of the space and the
+ * scan never hits a duplicate that has already gone.
+ */
+static int
+memtx_index_build_apply_log(struct memtx_index_build *build)
+{
+	int rc = 0;
+	for (size_t i = 0; i < build->log_size; i++) {
+		struct memtx_build_change *change = &build->log[i];
+		if (change->new_tuple != NULL &&
+		    tuple_validate(build->format, change->new_tuple) != 0) {
+			rc = -1;
+			break;
+		}
+		struct tuple *unused;
+		if (index_replace(build->index, change->old_tuple,
+				  change->new_tuple, DUP_INSERT,
+				  &unused) != 0) {
+			rc = -1;
+			break;
+		}
+	}
+	memtx_index_build_clear_log(build);
+	return rc;
+}
+
+struct memtx_build_delta {
+	struct tuple *tuple;
+	int delta;
+};
+
+static int
+memtx_build_delta_cmp(const void *a, const void *b)
+{
+	const struct memtx_build_delta *da = a, *db = b;
+	return da->tuple < db->tuple ? -1 : da->tuple > db->tuple;
+}
+
+/**
+ * Apply logged changes to the build array of a tree index.
+ * Changes are squashed first: a tuple which ends up deleted is
+ * removed from the array, a tuple which ends up inserted is
+ * appended to it. This way a key that was deleted and then
+ * inserted again with a different tuple isn't mistaken for
+ * a duplicate.
+ */
+static int
+memtx_index_build_apply_log_tree(struct memtx_index_build *build)
+{
+	if (build->log_size == 0)
+		return 0;
+	size_t size = 2 * build->log_size * sizeof(struct memtx_build_delta);
+	struct memtx_build_delta *deltas = malloc(size);
+	if (deltas == NULL) {
+		diag_set(OutOfMemory, size, "malloc", "index build log");
+		return -1;
+	}
+	size_t count = 0;
+	for (size_t i = 0; i < build->log_size; i++) {
+		struct memtx_build_change *change = &build->log[i];
+		if (change->old_tuple != NULL) {
+			deltas[count].tuple = change->old_tuple;
+			deltas[count++].delta = -1;
+		}
+		if (change->new_tuple != NULL) {
+			deltas[count].tuple = change->new_tuple;
+			deltas[count++].delta = 1;
+		}
+	}
+	qsort(deltas, count, sizeof(*deltas), memtx_build_delta_cmp);
+	/* Sum up deltas of each tuple. */
+	size_t n = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (n > 0 && deltas[n - 1].tuple == deltas[i].tuple)
+			deltas[n - 1].delta += deltas[i].delta;
+		else
+			deltas[n++] = deltas[i];
+	}
+	struct tuple **removed = malloc(n * sizeof(*removed));
+	if (removed == NULL) {
+		diag_set(OutOfMemory, n * sizeof(*removed),
+			 "malloc", "index build log");
+		free(deltas);
+		memtx_index_build_clear_log(build);
+		return -1;
+	}
+	size_t removed_count = 0;
+	int rc = 0;
+	for (size_t i = 0; i < n; i++) {
+		assert(deltas[i].delta >= -1 && deltas[i].delta <= 1);
+		if (deltas[i].delta < 0) {
+			/* Sorted by address, since deltas are. */
+			removed[removed_count++] = deltas[i].tuple;
+		} else if (deltas[i].delta > 0 && rc == 0) {
+			struct tuple *tuple = deltas[i].tuple;
+			rc = tuple_validate(build->format, tuple);
+			if (rc == 0)
+				rc = index_build_next(build->index, tuple);
+		}
+	}
+	if (rc == 0) {
+		memtx_tree_index_build_array_remove(
+			(struct memtx_tree_index *)build->index,
+			removed, removed_count);
+	}
+	free(removed);
+	free(deltas);
+	memtx_index_build_clear_log(build);
+	return rc;
+}
+
 static int
 memtx_space_build_secondary_key(struct space *old_space,
 				struct space *new_space,
@@ -872,20 +1049,63 @@ memtx_space_build_secondary_key(struct space *old_space,
 		return -1;
 	}
 
+	ssize_t n_tuples = index_size(pk);
+	if (n_tuples < 0)
+		return -1;
+	/*
+	 * A tree index is built in bulk: tuples are collected,
+	 * sorted and loaded into the tree, which is much faster
+	 * than inserting them one by one, since the tree is never
+	 * rebalanced and its blocks are filled up completely.
+	 * Other indexes have to be built tuple by tuple.
+	 */
+	bool is_bulk = new_index->def->type == TREE;
+	if (is_bulk) {
+		index_begin_build(new_index);
+		if (index_reserve(new_index, n_tuples) < 0)
+			return -1;
+	}
+	/*
+	 * Don't block tx while scanning the space, unless it's
+	 * recovery or a multi-statement transaction, which is
+	 * aborted by a yield. A tree iterator survives concurrent
+	 * changes, a hash iterator doesn't.
+	 */
+	struct memtx_engine *memtx = (struct memtx_engine *)old_space->engine;
+	struct txn *txn = in_txn();
+	bool can_yield = memtx->state == MEMTX_OK &&
+			 pk->def->type == TREE &&
+			 (txn == NULL || txn->is_autocommit);
+
+	struct memtx_space *memtx_space = (struct memtx_space *)old_space;
+	struct memtx_index_build build;
+	memset(&build, 0, sizeof(build));
+	build.space = old_space;
+	build.index = new_index;
+	build.format = new_space->format;
+	build.pk_def = pk->def->key_def;
+	build.total = n_tuples;
+	diag_create(&build.diag);
+	if (can_yield) {
+		assert(memtx_space->build == NULL);
+		memtx_space->build = &build;
+		rlist_add_tail_entry(&memtx->index_builds, &build, in_engine);
+	}
+
+	int rc = 0;
 	/* Now deal with any kind of add index during normal operation. */
 	struct iterator *it = index_create_iterator(pk, ITER_ALL, NULL, 0);
-	if (it == NULL)
-		return -1;
+	if (it == NULL) {
+		rc = -1;
+		goto out;
+	}
 
 	/*
-	 * The index has to be built tuple by tuple, since
-	 * there is no guarantee that all tuples satisfy
-	 * new index' constraints. If any tuple can not be
-	 * added to the index (insufficient number of fields,
-	 * etc., the build is aborted.
+	 * There is no guarantee that all tuples satisfy new
+	 * index' constraints. If any tuple can not be added to
+	 * the index (insufficient number of fields, etc.), the
+	 * build is aborted.
 	 */
-	/* Build the new index. */
-	int rc;
 	struct tuple *tuple;
 	while ((rc = iterator_next(it, &tuple)) == 0 && tuple != NULL) {
 		/*
@@ -895,18 +1115,79 @@ memtx_space_build_secondary_key(struct space *old_space,
 		rc = tuple_validate(new_space->format, tuple);
 		if (rc != 0)
 			break;
+		if (is_bulk) {
+			rc = index_build_next(new_index, tuple);
+		} else {
+			/*
+			 * @todo: better message if there is a duplicate.
+			 */
+			struct tuple *old_tuple;
+			rc = index_replace(new_index, NULL, tuple,
+					   DUP_INSERT, &old_tuple);
+			/* Guaranteed by DUP_INSERT. */
+			assert(rc != 0 || old_tuple == NULL);
+			(void) old_tuple;
+		}
+		if (rc != 0)
+			break;
+		if (!can_yield ||
+		    ++build.processed % MEMTX_BUILD_YIELD_LOOPS != 0)
+			continue;
 		/*
-		 * @todo: better message if there is a duplicate.
+		 * Let other fibers work. Changes of the tuples
+		 * scanned so far are logged while we are away.
 		 */
-		struct tuple *old_tuple;
-		rc = index_replace(new_index, NULL, tuple,
-				   DUP_INSERT, &old_tuple);
+		rc = tuple_ref(tuple);
 		if (rc != 0)
 			break;
-		assert(old_tuple == NULL); /* Guaranteed by DUP_INSERT. */
-		(void) old_tuple;
+		if (build.cursor != NULL)
+			tuple_unref(build.cursor);
+		build.cursor = tuple;
+		fiber_sleep(0);
+		if (fiber_is_cancelled()) {
+			diag_set(FiberIsCancelled);
+			rc = -1;
+			break;
+		}
+		if (build.is_failed) {
+			diag_move(&build.diag, diag_get());
+			rc = -1;
+			break;
+		}
+		if (!is_bulk) {
+			rc = memtx_index_build_apply_log(&build);
+			if (rc != 0)
+				break;
+		}
 	}
 	iterator_delete(it);
+	if (rc != 0)
+		goto out;
+	/* No yields from now on: catch up and publish. */
+	if (is_bulk) {
+		rc = memtx_index_build_apply_log_tree(&build);
+		/*
+		 * Sorting is done with qsort_arg(), which switches
+		 * to the multi-threaded implementation for big
+		 * arrays.
+		 */
+		if (rc == 0) {
+			rc = memtx_tree_index_end_build_checked(
+				(struct memtx_tree_index *)new_index);
+		}
+	} else {
+		rc = memtx_index_build_apply_log(&build);
+	}
+out:
+	if (can_yield) {
+		memtx_space->build = NULL;
+		rlist_del_entry(&build, in_engine);
+	}
+	memtx_index_build_clear_log(&build);
+	free(build.log);
+	if (build.cursor != NULL)
+		tuple_unref(build.cursor);
+	diag_destroy(&build.diag);
 	return rc;
 }
 
@@ -1064,5 +1345,6 @@ memtx_space_new(struct memtx_engine *memtx,
 
 	memtx_space->bsize = 0;
 	memtx_space->replace = memtx_space_replace_no_keys;
+	memtx_space->build = NULL;
 	return (struct space *)memtx_space;
 }
@@ -37,6 +37,7 @@ extern "C" {
 #endif /* defined(__cplusplus) */
 
 struct memtx_engine;
+struct memtx_index_build;
 
 struct memtx_space {
 	struct space base;
@@ -48,8 +49,63 @@ struct memtx_space {
 	 */
 	int (*replace)(struct space *, struct tuple *, struct tuple *,
 		       enum dup_replace_mode, struct tuple **);
+	/**
+	 * Non-blocking build of a new index of the space in
+	 * progress, or NULL.
+	 */
+	struct memtx_index_build *build;
+};
+
+/** A change of a tuple made while an index is being built. */
+struct memtx_build_change {
+	struct tuple *old_tuple;
+	struct tuple *new_tuple;
+};
+
+/**
+ * State of a non-blocking build of an index on a populated
+ * space. The primary key is scanned with periodic yields,
+ * and the space remains available for writes meanwhile.
+ * Changes of tuples that have already been scanned are logged
+ * and applied to the new index before it is published.
+ */
+struct memtx_index_build {
+	/** Link in memtx_engine::index_builds. */
+	struct rlist in_engine;
+	/** Space being scanned. */
+	struct space *space;
+	/** Index being built. */
+	struct index *index;
+	/** Format of the new space. */
+	struct tuple_format *format;
+	/** Primary key definition, defines the scan order. */
+	struct key_def *pk_def;
+	/** The last scanned tuple, referenced, or NULL. */
+	struct tuple *cursor;
+	/** Number of tuples scanned so far. */
+	size_t processed;
+	/** Size of the space when the build started. */
+	size_t total;
+	/** Changes of scanned tuples not applied yet. */
+	struct memtx_build_change *log;
+	size_t log_size;
+	size_t log_capacity;
+	/** Set if a change could not be logged. */
+	bool is_failed;
+	/** The error which failed the build. */
+	struct diag diag;
 };
 
+/**
+ * Log a change of a space being scanned by a non-blocking
+ * index build. Changes of tuples that haven't been scanned
+ * yet are ignored, since the scan will see them. Used both
+ * for changes and rollbacks, with tuples swapped for the latter.
+ */
+void
+memtx_index_build_log(struct memtx_index_build *build,
+		      struct tuple *old_tuple, struct tuple *new_tuple);
+
 /**
  * Change binary size of a space subtracting old tuple's size and
  * adding new tuple's size. Used also for rollback by swaping old
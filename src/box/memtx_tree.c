@@ -44,8 +44,22 @@
 static int
 memtx_tree_qcompare(const void* a, const void *b, void *c)
 {
-	return tuple_compare(*(struct tuple **)a,
-		*(struct tuple **)b, (struct key_def *)c);
+	return memtx_tree_compare((struct memtx_tree_data *)a,
+		(struct memtx_tree_data *)b, (struct key_def *)c);
+}
+
+/**
+ * Make a tree element for a tuple: compute the tuple
+ * comparison hint unless hints are disabled for the index.
+ */
+static inline struct memtx_tree_data
+memtx_tree_elem(const struct memtx_tree *tree, const struct index_def *def,
+		struct tuple *tuple)
+{
+	struct memtx_tree_data data;
+	data.tuple = tuple;
+	data.hint = def->opts.hint ? tuple_hint(tuple, tree->arg) : HINT_NONE;
+	return data;
 }
 
 /* {{{ MemtxTree Iterators ****************************************/
@@ -91,14 +105,16 @@ tree_iterator_dummie(struct iterator *iterator, struct tuple **ret)
 static int
 tree_iterator_next(struct iterator *iterator, struct tuple **ret)
 {
-	struct tuple **res;
+	struct memtx_tree_data *res;
 	struct tree_iterator *it = tree_iterator(iterator);
 	assert(it->current_tuple != NULL);
-	struct tuple **check = memtx_tree_iterator_get_elem(it->tree, &it->tree_iterator);
-	if (check == NULL || *check != it->current_tuple)
+	struct memtx_tree_data *check =
+		memtx_tree_iterator_get_elem(it->tree, &it->tree_iterator);
+	if (check == NULL || check->tuple != it->current_tuple)
 		it->tree_iterator =
-			memtx_tree_upper_bound_elem(it->tree, it->current_tuple,
-						    NULL);
+			memtx_tree_upper_bound_elem(it->tree,
+				memtx_tree_elem(it->tree, it->index_def,
+						it->current_tuple), NULL);
 	else
 		memtx_tree_iterator_next(it->tree, &it->tree_iterator);
 	tuple_unref(it->current_tuple);
@@ -108,7 +124,7 @@ tree_iterator_next(struct iterator *iterator, struct tuple **ret)
 		iterator->next = tree_iterator_dummie;
 		*ret = NULL;
 	} else {
-		*ret = it->current_tuple = *res;
+		*ret = it->current_tuple = res->tuple;
 		tuple_ref(it->current_tuple);
 	}
 	return 0;
@@ -119,20 +135,23 @@ tree_iterator_prev(struct iterator *iterator, struct tuple **ret)
 {
 	struct tree_iterator *it = tree_iterator(iterator);
 	assert(it->current_tuple != NULL);
-	struct tuple **check = memtx_tree_iterator_get_elem(it->tree, &it->tree_iterator);
-	if (check == NULL || *check != it->current_tuple)
+	struct memtx_tree_data *check =
+		memtx_tree_iterator_get_elem(it->tree, &it->tree_iterator);
+	if (check == NULL || check->tuple != it->current_tuple)
 		it->tree_iterator =
-			memtx_tree_lower_bound_elem(it->tree, it->current_tuple,
-						    NULL);
+			memtx_tree_lower_bound_elem(it->tree,
+				memtx_tree_elem(it->tree, it->index_def,
+						it->current_tuple), NULL);
 	memtx_tree_iterator_prev(it->tree, &it->tree_iterator);
 	tuple_unref(it->current_tuple);
 	it->current_tuple = NULL;
-	struct tuple **res = memtx_tree_iterator_get_elem(it->tree, &it->tree_iterator);
+	struct memtx_tree_data *res =
+		memtx_tree_iterator_get_elem(it->tree, &it->tree_iterator);
 	if (!res) {
 		iterator->next = tree_iterator_dummie;
 		*ret = NULL;
 	} else {
-		*ret = it->current_tuple = *res;
+		*ret = it->current_tuple = res->tuple;
 		tuple_ref(it->current_tuple);
 	}
 	return 0;
@@ -143,25 +162,26 @@ tree_iterator_next_equal(struct iterator *iterator, struct tuple **ret)
 {
 	struct tree_iterator *it = tree_iterator(iterator);
 	assert(it->current_tuple != NULL);
-	struct tuple **check = memtx_tree_iterator_get_elem(it->tree,
-						&it->tree_iterator);
-	if (check == NULL || *check != it->current_tuple)
+	struct memtx_tree_data *check =
+		memtx_tree_iterator_get_elem(it->tree, &it->tree_iterator);
+	if (check == NULL || check->tuple != it->current_tuple)
 		it->tree_iterator =
-			memtx_tree_upper_bound_elem(it->tree, it->current_tuple,
-						    NULL);
+			memtx_tree_upper_bound_elem(it->tree,
+				memtx_tree_elem(it->tree, it->index_def,
+						it->current_tuple), NULL);
 	else
 		memtx_tree_iterator_next(it->tree, &it->tree_iterator);
 	tuple_unref(it->current_tuple);
 	it->current_tuple = NULL;
-	struct tuple **res = memtx_tree_iterator_get_elem(it->tree,
-						&it->tree_iterator);
+	struct memtx_tree_data *res =
+		memtx_tree_iterator_get_elem(it->tree, &it->tree_iterator);
 	/* Use user key def to save a few loops. */
-	if (!res || memtx_tree_compare_key(*res, &it->key_data,
+	if (!res || memtx_tree_compare_key(res, &it->key_data,
 					   it->index_def->key_def) != 0) {
 		iterator->next = tree_iterator_dummie;
 		*ret = NULL;
 	} else {
-		*ret = it->current_tuple = *res;
+		*ret = it->current_tuple = res->tuple;
 		tuple_ref(it->current_tuple);
 	}
 	return 0;
@@ -172,24 +192,25 @@ tree_iterator_prev_equal(struct iterator *iterator, struct tuple **ret)
 {
 	struct tree_iterator *it = tree_iterator(iterator);
 	assert(it->current_tuple != NULL);
-	struct tuple **check = memtx_tree_iterator_get_elem(it->tree,
-						&it->tree_iterator);
-	if (check == NULL || *check != it->current_tuple)
+	struct memtx_tree_data *check =
+		memtx_tree_iterator_get_elem(it->tree, &it->tree_iterator);
+	if (check == NULL || check->tuple != it->current_tuple)
 		it->tree_iterator =
-			memtx_tree_lower_bound_elem(it->tree, it->current_tuple,
-						    NULL);
+			memtx_tree_lower_bound_elem(it->tree,
+				memtx_tree_elem(it->tree, it->index_def,
+						it->current_tuple), NULL);
 	memtx_tree_iterator_prev(it->tree, &it->tree_iterator);
 	tuple_unref(it->current_tuple);
 	it->current_tuple = NULL;
-	struct tuple **res = memtx_tree_iterator_get_elem(it->tree,
-						&it->tree_iterator);
+	struct memtx_tree_data *res =
+		memtx_tree_iterator_get_elem(it->tree, &it->tree_iterator);
 	/* Use user key def to save a few loops. */
-	if (!res || memtx_tree_compare_key(*res, &it->key_data,
+	if (!res || memtx_tree_compare_key(res, &it->key_data,
 					   it->index_def->key_def) != 0) {
 		iterator->next = tree_iterator_dummie;
 		*ret = NULL;
 	} else {
-		*ret = it->current_tuple = *res;
+		*ret = it->current_tuple = res->tuple;
 		tuple_ref(it->current_tuple);
 	}
 	return 0;
@@ -269,11 +290,11 @@ tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 		}
 	}
 
-	struct tuple **res = memtx_tree_iterator_get_elem(it->tree,
-						&it->tree_iterator);
+	struct memtx_tree_data *res =
+		memtx_tree_iterator_get_elem(it->tree, &it->tree_iterator);
 	if (!res)
 		return 0;
-	*ret = it->current_tuple = *res;
+	*ret = it->current_tuple = res->tuple;
 	tuple_ref(it->current_tuple);
 	tree_iterator_set_next_method(it);
 	return 0;
@@ -334,8 +355,8 @@ static int
 memtx_tree_index_random(struct index *base, uint32_t rnd, struct tuple **result)
 {
 	struct memtx_tree_index *index = (struct memtx_tree_index *)base;
-	struct tuple **res = memtx_tree_random(&index->tree, rnd);
-	*result = res != NULL ? *res : NULL;
+	struct memtx_tree_data *res = memtx_tree_random(&index->tree, rnd);
+	*result = res != NULL ? res->tuple : NULL;
 	return 0;
 }
 
@@ -358,8 +379,10 @@ memtx_tree_index_get(struct index *base, const char *key,
 	struct memtx_tree_key_data key_data;
 	key_data.key = key;
 	key_data.part_count = part_count;
-	struct tuple **res = memtx_tree_find(&index->tree, &key_data);
-	*result = res != NULL ? *res : NULL;
+	key_data.hint = base->def->opts.hint ?
+			key_hint(key, part_count, index->tree.arg) : HINT_NONE;
+	struct memtx_tree_data *res = memtx_tree_find(&index->tree, &key_data);
+	*result = res != NULL ? res->tuple : NULL;
 	return 0;
 }
 
@@ -370,11 +393,14 @@ memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
 {
 	struct memtx_tree_index *index = (struct memtx_tree_index *)base;
 	if (new_tuple) {
-		struct tuple *dup_tuple = NULL;
+		struct memtx_tree_data new_data =
+			memtx_tree_elem(&index->tree, base->def, new_tuple);
+		struct memtx_tree_data dup_data;
+		dup_data.tuple = NULL;
 
 		/* Try to optimistically replace the new_tuple. */
 		int tree_res = memtx_tree_insert(&index->tree,
-						 new_tuple, &dup_tuple);
+						 new_data, &dup_data);
 		if (tree_res) {
 			diag_set(OutOfMemory, MEMTX_EXTENT_SIZE,
 				 "memtx_tree_index", "replace");
@@ -382,24 +408,26 @@ memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
 		}
 
 		uint32_t errcode = replace_check_dup(old_tuple,
-						     dup_tuple, mode);
+						     dup_data.tuple, mode);
 		if (errcode) {
-			memtx_tree_delete(&index->tree, new_tuple);
-			if (dup_tuple)
-				memtx_tree_insert(&index->tree, dup_tuple, 0);
+			memtx_tree_delete(&index->tree, new_data);
+			if (dup_data.tuple != NULL)
+				memtx_tree_insert(&index->tree, dup_data, NULL);
 			struct space *sp = space_cache_find(base->def->space_id);
 			if (sp != NULL)
 				diag_set(ClientError, errcode, base->def->name,
 					 space_name(sp));
 			return -1;
 		}
-		if (dup_tuple) {
-			*result = dup_tuple;
+		if (dup_data.tuple != NULL) {
+			*result = dup_data.tuple;
 			return 0;
 		}
 	}
 	if (old_tuple) {
-		memtx_tree_delete(&index->tree, old_tuple);
+		memtx_tree_delete(&index->tree,
+				  memtx_tree_elem(&index->tree, base->def,
+						  old_tuple));
 	}
 	*result = old_tuple;
 	return 0;
@@ -441,6 +469,9 @@ memtx_tree_index_create_iterator(struct index *base, enum iterator_type type,
 	it->type = type;
 	it->key_data.key = key;
 	it->key_data.part_count = part_count;
+	it->key_data.hint = key != NULL && base->def->opts.hint ?
+			    key_hint(key, part_count, index->tree.arg) :
+			    HINT_NONE;
 	it->index_def = base->def;
 	it->tree = &index->tree;
 	it->tree_iterator = memtx_tree_invalid_iterator();
@@ -462,8 +493,8 @@ memtx_tree_index_reserve(struct index *base, uint32_t size_hint)
 	struct memtx_tree_index *index = (struct memtx_tree_index *)base;
 	if (size_hint < index->build_array_alloc_size)
 		return 0;
-	struct tuple **tmp = (struct tuple **)realloc(index->build_array,
-						      size_hint * sizeof(*tmp));
+	struct memtx_tree_data *tmp = (struct memtx_tree_data *)
+		realloc(index->build_array, size_hint * sizeof(*tmp));
 	if (tmp == NULL) {
 		diag_set(OutOfMemory, size_hint * sizeof(*tmp),
 			 "memtx_tree_index", "reserve");
@@ -479,20 +510,21 @@ memtx_tree_index_build_next(struct index *base, struct tuple *tuple)
 {
 	struct memtx_tree_index *index = (struct memtx_tree_index *)base;
 	if (index->build_array == NULL) {
-		index->build_array = (struct tuple **)malloc(MEMTX_EXTENT_SIZE);
+		index->build_array =
+			(struct memtx_tree_data *)malloc(MEMTX_EXTENT_SIZE);
 		if (index->build_array == NULL) {
 			diag_set(OutOfMemory, MEMTX_EXTENT_SIZE,
 				 "memtx_tree_index", "build_next");
 			return -1;
 		}
 		index->build_array_alloc_size =
-			MEMTX_EXTENT_SIZE / sizeof(struct tuple*);
+			MEMTX_EXTENT_SIZE / sizeof(struct memtx_tree_data);
 	}
 	assert(index->build_array_size <= index->build_array_alloc_size);
 	if (index->build_array_size == index->build_array_alloc_size) {
 		index->build_array_alloc_size = index->build_array_alloc_size +
 					index->build_array_alloc_size / 2;
-		struct tuple **tmp = (struct tuple **)
+		struct memtx_tree_data *tmp = (struct memtx_tree_data *)
 			realloc(index->build_array,
 				index->build_array_alloc_size * sizeof(*tmp));
 		if (tmp == NULL) {
@@ -502,18 +534,95 @@ memtx_tree_index_build_next(struct index *base, struct tuple *tuple)
 		}
 		index->build_array = tmp;
 	}
-	index->build_array[index->build_array_size++] = tuple;
+	index->build_array[index->build_array_size++] =
+		memtx_tree_elem(&index->tree, base->def, tuple);
+	index->build_array_is_sorted = false;
 	return 0;
 }
 
-static void
-memtx_tree_index_end_build(struct index *base)
+void
+memtx_tree_index_sort_build_array(struct memtx_tree_index *index)
 {
-	struct memtx_tree_index *index = (struct memtx_tree_index *)base;
 	struct key_def *cmp_def = memtx_tree_index_cmp_def(index);
 	qsort_arg(index->build_array, index->build_array_size,
-		  sizeof(struct tuple *),
+		  sizeof(struct memtx_tree_data),
 		  memtx_tree_qcompare, cmp_def);
+	index->build_array_is_sorted = true;
+}
+
+static int
+memtx_tree_ptr_cmp(const void *a, const void *b)
+{
+	const struct tuple *ta = *(struct tuple **)a;
+	const struct tuple *tb = *(struct tuple **)b;
+	return ta < tb ? -1 : ta > tb;
+}
+
+void
+memtx_tree_index_build_array_remove(struct memtx_tree_index *index,
+				    struct tuple **tuples, size_t count)
+{
+	if (count == 0)
+		return;
+	size_t n = 0;
+	for (size_t i = 0; i < index->build_array_size; i++) {
+		struct tuple *tuple = index->build_array[i].tuple;
+		if (bsearch(&tuple, tuples, count, sizeof(*tuples),
+			    memtx_tree_ptr_cmp) == NULL)
+			index->build_array[n++] = index->build_array[i];
+	}
+	assert(index->build_array_size - n == count);
+	index->build_array_size = n;
+}
+
+int
+memtx_tree_index_end_build_checked(struct memtx_tree_index *index)
+{
+	if (!index->build_array_is_sorted)
+		memtx_tree_index_sort_build_array(index);
+	struct key_def *cmp_def = memtx_tree_index_cmp_def(index);
+	for (size_t i = 1; i < index->build_array_size; i++) {
+		if (memtx_tree_compare(&index->build_array[i - 1],
+				       &index->build_array[i], cmp_def) != 0)
+			continue;
+		struct index_def *def = index->base.def;
+		struct space *sp = space_cache_find(def->space_id);
+		if (sp != NULL)
+			diag_set(ClientError, ER_TUPLE_FOUND, def->name,
+				 space_name(sp));
+		return -1;
+	}
+	/*
+	 * Stream the sorted tuples into the tree: leaves and
+	 * inner blocks are filled up as they go.
+	 */
+	struct memtx_tree_loader loader;
+	memtx_tree_load_begin(&index->tree, &loader,
+			      index->build_array_size);
+	for (size_t i = 0; i < index->build_array_size; i++) {
+		if (memtx_tree_load_next(&loader,
+					 index->build_array[i]) != 0) {
+			diag_set(OutOfMemory, MEMTX_EXTENT_SIZE,
+				 "memtx_tree_index", "build");
+			return -1;
+		}
+	}
+	memtx_tree_load_end(&loader);
+
+	free(index->build_array);
+	index->build_array = NULL;
+	index->build_array_size = 0;
+	index->build_array_alloc_size = 0;
+	index->build_array_is_sorted = false;
+	return 0;
+}
+
+static void
+memtx_tree_index_end_build(struct index *base)
+{
+	struct memtx_tree_index *index = (struct memtx_tree_index *)base;
+	if (!index->build_array_is_sorted)
+		memtx_tree_index_sort_build_array(index);
 	memtx_tree_build(&index->tree, index->build_array,
 			 index->build_array_size);
 
@@ -521,6 +630,7 @@ memtx_tree_index_end_build(struct index *base)
 	index->build_array = NULL;
 	index->build_array_size = 0;
 	index->build_array_alloc_size = 0;
+	index->build_array_is_sorted = false;
 }
 
 struct tree_snapshot_iterator {
@@ -546,12 +656,12 @@ tree_snapshot_iterator_next(struct snapshot_iterator *iterator, uint32_t *size)
 	assert(iterator->free == tree_snapshot_iterator_free);
 	struct tree_snapshot_iterator *it =
 		(struct tree_snapshot_iterator *)iterator;
-	struct tuple **res = memtx_tree_iterator_get_elem(it->tree,
-						&it->tree_iterator);
+	struct memtx_tree_data *res =
+		memtx_tree_iterator_get_elem(it->tree, &it->tree_iterator);
 	if (res == NULL)
 		return NULL;
 	memtx_tree_iterator_next(it->tree, &it->tree_iterator);
-	return tuple_data_range(*res, size);
+	return tuple_data_range(res->tuple, size);
 }
 
 /**
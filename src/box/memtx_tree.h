@@ -42,6 +42,19 @@ extern "C" {
 
 struct memtx_engine;
 
+/**
+ * Struct that is used as an element in BPS tree definition.
+ */
+struct memtx_tree_data {
+	/** Indexed tuple. */
+	struct tuple *tuple;
+	/**
+	 * Comparison hint of the tuple, see tuple_hint().
+	 * HINT_NONE if hints are disabled for the index.
+	 */
+	hint_t hint;
+};
+
 /**
  * Struct that is used as a key in BPS tree definition.
  */
@@ -51,12 +64,36 @@ struct memtx_tree_key_data
 	const char *key;
 	/** Number of msgpacked search fields */
 	uint32_t part_count;
+	/** Comparison hint of the key, see key_hint(). */
+	hint_t hint;
 };
 
+/**
+ * BPS tree element comparator.
+ * Compares hints first and falls back on comparing tuples
+ * only if the hints are equal or not available.
+ * @param a - first element to compare.
+ * @param b - second element to compare.
+ * @param def - key definition.
+ * @retval 0  if a == b in terms of def.
+ * @retval <0 if a < b in terms of def.
+ * @retval >0 if a > b in terms of def.
+ */
+static inline int
+memtx_tree_compare(const struct memtx_tree_data *a,
+		   const struct memtx_tree_data *b,
+		   struct key_def *def)
+{
+	int rc = hint_cmp(a->hint, b->hint);
+	if (rc != 0)
+		return rc;
+	return tuple_compare(a->tuple, b->tuple, def);
+}
+
 /**
  * BPS tree element vs key comparator.
  * Defined in header in order to allow compiler to inline it.
- * @param tuple - tuple to compare.
+ * @param element - tree element to compare.
  * @param key_data - key to compare with.
  * @param def - key definition.
  * @retval 0  if tuple == key in terms of def.
@@ -64,20 +101,24 @@ struct memtx_tree_key_data
  * @retval >0 if tuple > key in terms of def.
  */
 static inline int
-memtx_tree_compare_key(const struct tuple *tuple,
+memtx_tree_compare_key(const struct memtx_tree_data *element,
 		       const struct memtx_tree_key_data *key_data,
 		       struct key_def *def)
 {
-	return tuple_compare_with_key(tuple, key_data->key,
+	int rc = hint_cmp(element->hint, key_data->hint);
+	if (rc != 0)
+		return rc;
+	return tuple_compare_with_key(element->tuple, key_data->key,
 				      key_data->part_count, def);
 }
 
 #define BPS_TREE_NAME memtx_tree
 #define BPS_TREE_BLOCK_SIZE (512)
 #define BPS_TREE_EXTENT_SIZE MEMTX_EXTENT_SIZE
-#define BPS_TREE_COMPARE(a, b, arg) tuple_compare(a, b, arg)
-#define BPS_TREE_COMPARE_KEY(a, b, arg) memtx_tree_compare_key(a, b, arg)
-#define bps_tree_elem_t struct tuple *
+#define BPS_TREE_COMPARE(a, b, arg) memtx_tree_compare(&(a), &(b), arg)
+#define BPS_TREE_COMPARE_KEY(a, b, arg) memtx_tree_compare_key(&(a), b, arg)
+#define BPS_TREE_IS_IDENTICAL(a, b) ((a).tuple == (b).tuple)
+#define bps_tree_elem_t struct memtx_tree_data
 #define bps_tree_key_t struct memtx_tree_key_data *
 #define bps_tree_arg_t struct key_def *
 
@@ -88,6 +129,7 @@ memtx_tree_compare_key(const struct tuple *tuple,
 #undef BPS_TREE_EXTENT_SIZE
 #undef BPS_TREE_COMPARE
 #undef BPS_TREE_COMPARE_KEY
+#undef BPS_TREE_IS_IDENTICAL
 #undef bps_tree_elem_t
 #undef bps_tree_key_t
 #undef bps_tree_arg_t
@@ -95,13 +137,43 @@ memtx_tree_compare_key(const struct tuple *tuple,
 struct memtx_tree_index {
 	struct index base;
 	struct memtx_tree tree;
-	struct tuple **build_array;
+	struct memtx_tree_data *build_array;
 	size_t build_array_size, build_array_alloc_size;
+	/** Set if build_array is already sorted. */
+	bool build_array_is_sorted;
 };
 
 struct memtx_tree_index *
 memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def);
 
+/**
+ * Sort tuples added to the index with build_next(), so that
+ * end_build() only has to bulk load them into the tree.
+ * Neither allocates index memory nor yields, so may be called
+ * from any thread, e.g. to sort several indexes in parallel.
+ */
+void
+memtx_tree_index_sort_build_array(struct memtx_tree_index *index);
+
+/**
+ * Remove tuples from those added with build_next().
+ * @a tuples must be sorted by address.
+ */
+void
+memtx_tree_index_build_array_remove(struct memtx_tree_index *index,
+				    struct tuple **tuples, size_t count);
+
+/**
+ * Finish building the index like end_build() does, but fail
+ * if the index is unique and there are duplicate keys among
+ * the tuples added with build_next() or if there's not enough
+ * memory for the tree. Used to create an index on a populated
+ * space, where there is no guarantee that tuples satisfy the
+ * new index constraints.
+ */
+int
+memtx_tree_index_end_build_checked(struct memtx_tree_index *index);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
@@ -60,6 +60,8 @@ struct small_alloc memtx_alloc; /* used box box.slab.info() */
 /* The maximal allowed tuple size, box.cfg.memtx_max_tuple_size */
 size_t memtx_max_tuple_size = 1 * 1024 * 1024; /* set dynamically */
 uint32_t snapshot_version;
+/** Field map bytes used by hot fields of live memtx tuples. */
+size_t memtx_hot_field_map_used;
 
 enum {
 	/** Lowest allowed slab_alloc_minimal */
@@ -133,6 +135,7 @@ memtx_tuple_new(struct tuple_format *format, const char *data, const char *end)
 	tuple->bsize = tuple_len;
 	tuple->format_id = tuple_format_id(format);
 	tuple_format_ref(format);
+	memtx_hot_field_map_used += format->hot_field_map_size;
 	/*
 	 * Data offset is calculated from the begin of the struct
 	 * tuple base, not from memtx_tuple, because the struct
@@ -157,6 +160,7 @@ memtx_tuple_delete(struct tuple_format *format, struct tuple *tuple)
 	assert(tuple->refs == 0);
 	size_t total = sizeof(struct memtx_tuple) +
 		       tuple_format_meta_size(format) + tuple->bsize;
+	memtx_hot_field_map_used -= format->hot_field_map_size;
 	tuple_format_unref(format);
 	struct memtx_tuple *memtx_tuple =
 		container_of(tuple, struct memtx_tuple, base);
@@ -69,6 +69,12 @@ memtx_tuple_delete(struct tuple_format *format, struct tuple *tuple);
 /** Maximal allowed tuple size (box.cfg.memtx_max_tuple_size) */
 extern size_t memtx_max_tuple_size;
 
+/**
+ * How much of memtx tuple field maps is spent on offsets of
+ * hot fields, in bytes. Reported in box.slab.info().
+ */
+extern size_t memtx_hot_field_map_used;
+
 /** tuple format vtab for memtx engine. */
 extern struct tuple_format_vtab memtx_tuple_format_vtab;
 
@@ -82,6 +82,15 @@ recovery_stop_local(struct recovery *r);
 void
 recovery_finalize(struct recovery *r, struct xstream *stream);
 
+/**
+ * Close the WAL file being read, if any, without reading it
+ * up to EOF. The position is kept in r->vclock, so the next
+ * call to recover_remaining_wals() reopens the file and skips
+ * rows which have already been read. Runs on_close_log triggers.
+ */
+void
+recovery_release_log(struct recovery *r);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
@@ -34,6 +34,7 @@
 #include "trivia/util.h"
 #include "cbus.h"
 #include "cfg.h"
+#include "clock.h"
 #include "errinj.h"
 #include "fiber.h"
 #include "say.h"
@@ -52,6 +53,22 @@
 #include "xrow_io.h"
 #include "xstream.h"
 #include "wal.h"
+#include "zstd.h"
+
+enum {
+	/**
+	 * Compress and send rows once this many bytes of them
+	 * are accumulated or there are no more rows to send.
+	 */
+	RELAY_COMPRESS_BATCH_SIZE = 64 * 1024,
+	/** zstd compression level of the row stream. */
+	RELAY_COMPRESSION_LEVEL = 3,
+	/**
+	 * Copy at most this many bytes of rows from the WAL
+	 * ring at once, see relay_recover_ring().
+	 */
+	RELAY_RING_READ_SIZE = 256 * 1024,
+};
 
 /**
  * Cbus message to send status updates from relay to tx thread.
@@ -63,6 +80,8 @@ struct relay_status_msg {
 	struct relay *relay;
 	/** Replica vclock. */
 	struct vclock vclock;
+	/** Row stream compression statistics. */
+	struct xrow_compression_stat compression_stat;
 };
 
 /**
@@ -110,6 +129,27 @@ struct relay {
 	struct vclock recv_vclock;
 	/** Replicatoin slave version. */
 	uint32_t version_id;
+	/**
+	 * Compression of the row stream requested by the
+	 * replica, see enum iproto_compression.
+	 */
+	uint32_t compression;
+	/** zstd context, NULL if the row stream isn't compressed. */
+	ZSTD_CCtx *zctx;
+	/** Encoded rows waiting to be compressed and sent. */
+	struct ibuf zrows;
+	/** Row stream compression statistics. */
+	struct xrow_compression_stat compression_stat;
+	/**
+	 * Set if the relay has caught up with xlog files and
+	 * sends rows from the ring of rows recently written to
+	 * the WAL, see wal_ring_read().
+	 */
+	bool in_ring;
+	/** Position of the relay in the WAL ring. */
+	uint64_t ring_pos;
+	/** Rows copied from the WAL ring. */
+	struct ibuf ring_rows;
 
 	/** Relay endpoint */
 	struct cbus_endpoint endpoint;
@@ -132,6 +172,8 @@ struct relay {
 		alignas(CACHELINE_SIZE)
 		/** Known relay vclock. */
 		struct vclock vclock;
+		/** Known row stream compression statistics. */
+		struct xrow_compression_stat compression_stat;
 	} tx;
 };
 
@@ -141,9 +183,17 @@ relay_vclock(const struct relay *relay)
 	return &relay->tx.vclock;
 }
 
+const struct xrow_compression_stat *
+relay_compression_stat(const struct relay *relay)
+{
+	return &relay->tx.compression_stat;
+}
+
 static void
 relay_send(struct relay *relay, struct xrow_header *packet);
 static void
+relay_flush(struct relay *relay);
+static void
 relay_send_initial_join_row(struct xstream *stream, struct xrow_header *row);
 static void
 relay_send_row(struct xstream *stream, struct xrow_header *row);
@@ -261,6 +311,7 @@ tx_status_update(struct cmsg *msg)
 {
 	struct relay_status_msg *status = (struct relay_status_msg *)msg;
 	vclock_copy(&status->relay->tx.vclock, &status->vclock);
+	status->relay->tx.compression_stat = status->compression_stat;
 	static const struct cmsg_hop route[] = {
 		{relay_status_update, NULL}
 	};
@@ -279,13 +330,17 @@ tx_gc_advance(struct cmsg *msg)
 	free(m);
 }
 
+/**
+ * Add a garbage collection message for the rows sent so far.
+ * It is scheduled once the replica confirms it has received
+ * them, see relay_schedule_pending_gc().
+ */
 static void
-relay_on_close_log_f(struct trigger *trigger, void * /* event */)
+relay_add_pending_gc(struct relay *relay)
 {
 	static const struct cmsg_hop route[] = {
 		{tx_gc_advance, NULL}
 	};
-	struct relay *relay = (struct relay *)trigger->data;
 	struct relay_gc_msg *m = (struct relay_gc_msg *)malloc(sizeof(*m));
 	if (m == NULL) {
 		say_warn("failed to allocate relay gc message");
@@ -302,6 +357,13 @@ relay_on_close_log_f(struct trigger *trigger, void * /* event */)
 	stailq_add_tail_entry(&relay->pending_gc, m, in_pending);
 }
 
+static void
+relay_on_close_log_f(struct trigger *trigger, void * /* event */)
+{
+	struct relay *relay = (struct relay *)trigger->data;
+	relay_add_pending_gc(relay);
+}
+
 /**
  * Invoke pending garbage collection requests.
  *
@@ -325,6 +387,49 @@ relay_schedule_pending_gc(struct relay *relay, int64_t signature)
 		cpipe_push(&relay->tx_pipe, &gc_msg->msg);
 }
 
+/**
+ * Send rows from the ring of rows recently written to the WAL,
+ * starting at the relay position in the ring.
+ *
+ * @retval 0 the relay has caught up with the WAL
+ * @retval -1 the relay lags behind the ring and must read
+ *            rows from xlog files
+ */
+static int
+relay_recover_ring(struct relay *relay)
+{
+	struct recovery *r = relay->r;
+	while (true) {
+		ibuf_reset(&relay->ring_rows);
+		ssize_t size = wal_ring_read(&relay->ring_pos,
+					     &relay->ring_rows,
+					     RELAY_RING_READ_SIZE);
+		if (size < 0) {
+			diag_clear(diag_get());
+			return -1;
+		}
+		if (size == 0)
+			return 0;
+		const char *data = relay->ring_rows.rpos;
+		const char *end = relay->ring_rows.wpos;
+		while (data < end) {
+			struct wal_ring_row hdr;
+			memcpy(&hdr, data, sizeof(hdr));
+			data += sizeof(hdr);
+			const char *row_end = data + hdr.size;
+			if (hdr.lsn <= vclock_get(&r->vclock, hdr.replica_id)) {
+				/* Already sent, skip. */
+				data = row_end;
+				continue;
+			}
+			struct xrow_header row;
+			xrow_header_decode_xc(&row, &data, row_end);
+			vclock_follow(&r->vclock, row.replica_id, row.lsn);
+			xstream_write_xc(&relay->stream, &row);
+		}
+	}
+}
+
 static void
 relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 {
@@ -337,8 +442,39 @@ relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 		return;
 	}
 	try {
-		recover_remaining_wals(relay->r, &relay->stream, NULL,
-				       (events & WAL_EVENT_ROTATE) != 0);
+		bool rotate = (events & WAL_EVENT_ROTATE) != 0;
+		if (relay->in_ring && relay_recover_ring(relay) == 0) {
+			/*
+			 * Xlog files aren't read, so the on_close_log
+			 * trigger doesn't fire. Let the garbage collector
+			 * know about the sent rows on WAL rotation.
+			 */
+			if (rotate)
+				relay_add_pending_gc(relay);
+		} else {
+			if (relay->in_ring) {
+				say_info("relay fell behind the WAL ring, "
+					 "reading rows from xlog files");
+			}
+			/*
+			 * New xlog files might have been created while
+			 * the relay was reading the WAL ring.
+			 */
+			recover_remaining_wals(relay->r, &relay->stream, NULL,
+					       rotate || relay->in_ring);
+			relay->in_ring = false;
+			/* Switch to the ring once caught up with xlogs. */
+			if (wal_ring_seek(&relay->r->vclock,
+					  &relay->ring_pos) == 0) {
+				relay->in_ring = true;
+				recovery_release_log(relay->r);
+				if (relay_recover_ring(relay) == 0)
+					say_info("relay switched to the WAL ring");
+				else
+					relay->in_ring = false;
+			}
+		}
+		relay_flush(relay);
 	} catch (Exception *e) {
 		e->log();
 		diag_move(diag_get(), &relay->diag);
@@ -397,6 +533,7 @@ relay_send_heartbeat(struct relay *relay)
 	xrow_encode_timestamp(&row, instance_id, ev_now(loop()));
 	try {
 		relay_send(relay, &row);
+		relay_flush(relay);
 	} catch (Exception *e) {
 		e->log();
 	}
@@ -414,6 +551,17 @@ relay_subscribe_f(va_list ap)
 	struct recovery *r = relay->r;
 
 	coio_enable();
+	if (relay->compression == IPROTO_COMPRESSION_ZSTD) {
+		relay->zctx = ZSTD_createCCtx();
+		if (relay->zctx == NULL) {
+			/* The replica accepts plain rows as well. */
+			say_warn("failed to create zstd context, "
+				 "replication stream isn't compressed");
+		}
+		ibuf_create(&relay->zrows, &cord()->slabc,
+			    RELAY_COMPRESS_BATCH_SIZE);
+	}
+	ibuf_create(&relay->ring_rows, &cord()->slabc, RELAY_RING_READ_SIZE);
 	cbus_endpoint_create(&relay->endpoint, cord_name(cord()),
 			     fiber_schedule_cb, fiber());
 	cbus_pair("tx", cord_name(cord()), &relay->tx_pipe, &relay->relay_pipe,
@@ -480,6 +628,7 @@ relay_subscribe_f(va_list ap)
 		};
 		cmsg_init(&relay->status_msg.msg, route);
 		vclock_copy(&relay->status_msg.vclock, send_vclock);
+		relay->status_msg.compression_stat = relay->compression_stat;
 		relay->status_msg.relay = relay;
 		cpipe_push(&relay->tx_pipe, &relay->status_msg.msg);
 		/* Collect xlog files received by the replica. */
@@ -496,6 +645,12 @@ relay_subscribe_f(va_list ap)
 	cbus_unpair(&relay->tx_pipe, &relay->relay_pipe,
 		    NULL, NULL, cbus_process);
 	cbus_endpoint_destroy(&relay->endpoint, cbus_process);
+	ibuf_destroy(&relay->ring_rows);
+	if (relay->compression == IPROTO_COMPRESSION_ZSTD) {
+		ZSTD_freeCCtx(relay->zctx);
+		relay->zctx = NULL;
+		ibuf_destroy(&relay->zrows);
+	}
 	if (!diag_is_empty(&relay->diag)) {
 		/* An error has occured while ACKs of xlog reading */
 		diag_move(&relay->diag, diag_get());
@@ -510,7 +665,8 @@ relay_subscribe_f(va_list ap)
 /** Replication acceptor fiber handler. */
 void
 relay_subscribe(int fd, uint64_t sync, struct replica *replica,
-		struct vclock *replica_clock, uint32_t replica_version_id)
+		struct vclock *replica_clock, uint32_t replica_version_id,
+		uint32_t compression)
 {
 	assert(replica->id != REPLICA_ID_NIL);
 	/* Don't allow multiple relays for the same replica */
@@ -539,6 +695,7 @@ relay_subscribe(int fd, uint64_t sync, struct replica *replica,
 			       replica_clock);
 	vclock_copy(&relay.tx.vclock, replica_clock);
 	relay.version_id = replica_version_id;
+	relay.compression = compression;
 	relay.replica = replica;
 	replica_set_relay(replica, &relay);
 
@@ -554,12 +711,63 @@ relay_subscribe(int fd, uint64_t sync, struct replica *replica,
 		diag_raise();
 }
 
+/**
+ * Compress rows staged by relay_send() and send them
+ * to the replica in a single frame.
+ */
+static void
+relay_flush(struct relay *relay)
+{
+	struct ibuf *zrows = &relay->zrows;
+	if (relay->zctx == NULL || ibuf_used(zrows) == 0)
+		return;
+	size_t size = ibuf_used(zrows);
+	size_t bound = ZSTD_compressBound(size);
+	char *buf = (char *) region_alloc_xc(&fiber()->gc, bound);
+	double start = clock_thread();
+	size_t zsize = ZSTD_compressCCtx(relay->zctx, buf, bound,
+					 zrows->rpos, size,
+					 RELAY_COMPRESSION_LEVEL);
+	relay->compression_stat.time += clock_thread() - start;
+	ibuf_reset(zrows);
+	if (ZSTD_isError(zsize)) {
+		tnt_raise(ClientError, ER_COMPRESSION,
+			  ZSTD_getErrorName(zsize));
+	}
+	relay->compression_stat.raw_size += size;
+	relay->compression_stat.compressed_size += zsize;
+
+	struct xrow_header row;
+	if (xrow_encode_compressed_rows(&row, buf, zsize) != 0)
+		diag_raise();
+	row.sync = relay->sync;
+	coio_write_xrow(&relay->io, &row);
+	fiber_gc();
+}
+
 static void
 relay_send(struct relay *relay, struct xrow_header *packet)
 {
 	packet->sync = relay->sync;
 	relay->last_row_tm = ev_monotonic_now(loop());
-	coio_write_xrow(&relay->io, packet);
+	if (relay->zctx != NULL) {
+		/*
+		 * Stage the row to be compressed along with
+		 * its neighbours, see relay_flush().
+		 */
+		struct iovec iov[XROW_IOVMAX];
+		int iovcnt = xrow_to_iovec_xc(packet, iov);
+		for (int i = 0; i < iovcnt; i++) {
+			ibuf_reserve_xc(&relay->zrows, iov[i].iov_len);
+			memcpy(relay->zrows.wpos, iov[i].iov_base,
+			       iov[i].iov_len);
+			relay->zrows.wpos += iov[i].iov_len;
+		}
+		if (ibuf_used(&relay->zrows) >= RELAY_COMPRESS_BATCH_SIZE)
+			relay_flush(relay);
+	} else {
+		coio_write_xrow(&relay->io, packet);
+	}
 	fiber_gc();
 
 	struct errinj *inj = errinj(ERRINJ_RELAY_TIMEOUT, ERRINJ_DOUBLE);
@@ -41,6 +41,7 @@ struct relay;
 struct replica;
 struct tt_uuid;
 struct vclock;
+struct xrow_compression_stat;
 
 /**
  * Returns relay's vclock
@@ -50,6 +51,13 @@ struct vclock;
 const struct vclock *
 relay_vclock(const struct relay *relay);
 
+/**
+ * Returns statistics of the row stream compression
+ * as last reported by the relay thread.
+ */
+const struct xrow_compression_stat *
+relay_compression_stat(const struct relay *relay);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
@@ -77,10 +85,14 @@ relay_final_join(int fd, uint64_t sync, struct vclock *start_vclock,
 /**
  * Subscribe a replica to updates.
  *
+ * @param compression  compression of the row stream requested
+ *                     by the replica, see enum iproto_compression
+ *
  * @return none.
  */
 void
 relay_subscribe(int fd, uint64_t sync, struct replica *replica,
-		struct vclock *replica_vclock, uint32_t replica_version_id);
+		struct vclock *replica_vclock, uint32_t replica_version_id,
+		uint32_t compression);
 
 #endif /* TARANTOOL_REPLICATION_RELAY_H_INCLUDED */
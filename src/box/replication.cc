@@ -50,6 +50,8 @@ double replication_timeout = 1.0; /* seconds */
 double replication_connect_timeout = 4.0; /* seconds */
 int replication_connect_quorum = REPLICATION_CONNECT_QUORUM_ALL;
 double replication_sync_lag = 10.0; /* seconds */
+int replication_apply_fibers = 1;
+bool replication_compression = false;
 
 struct replicaset replicaset;
 
@@ -124,6 +124,19 @@ extern int replication_connect_quorum;
  */
 extern double replication_sync_lag;
 
+/**
+ * Number of fibers an applier uses to apply rows received
+ * from the master in parallel. If set to 1, rows are applied
+ * one by one by the applier fiber itself.
+ */
+extern int replication_apply_fibers;
+
+/**
+ * Set if appliers ask masters to compress the row stream,
+ * see box.cfg.replication_compression.
+ */
+extern bool replication_compression;
+
 /**
  * Wait for the given period of time before trying to reconnect
  * to a master.
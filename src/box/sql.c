@@ -1054,11 +1054,7 @@ int tarantoolSqlite3IdxKeyCompare(BtCursor *pCur, UnpackedRecord *pUnpacked,
 			    format->fields[fieldno].offset_slot ==
 			    TUPLE_OFFSET_SLOT_NIL) {
 				/* Outdated field_map. */
-				uint32_t j = 0;
-
-				p = field0;
-				while (j++ != fieldno)
-					mp_next(&p);
+				p = field_scan_skip(field0, fieldno);
 			} else {
 				p = base + field_map[
 					format->fields[fieldno].offset_slot
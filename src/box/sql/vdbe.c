@@ -50,6 +50,7 @@
 #include "box/schema.h"
 #include "box/space.h"
 #include "box/sequence.h"
+#include "box/field_scan.h"
 
 /*
  * Invoke this macro on memory cells just prior to changing the
@@ -2618,10 +2619,11 @@ case OP_Column: {
 			 * Fill in aOffset[i] values through the
 			 * p2-th field.
 			 */
-			do{
-				mp_next((const char **) &zParse);
-				aOffset[++i] = (u32)(zParse-zData);
-			}while( i<=p2);
+			zParse = (u8 *)field_scan_offsets((const char *)zParse,
+							  p2 + 1 - i,
+							  (const char *)zData,
+							  &aOffset[i]);
+			i = p2 + 1;
 			assert((u32)p2 != pC->nRowField || zParse == zEnd);
 			pC->nHdrParsed = i;
 		}
@@ -188,6 +188,7 @@ int
 tuple_init(field_name_hash_f hash)
 {
 	field_name_hash = hash;
+	field_scan_init();
 	/*
 	 * Create a format for runtime tuples
 	 */
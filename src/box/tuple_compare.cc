@@ -426,197 +426,6 @@ tuple_compare_field_with_hint(const char *field_a, enum mp_type a_type,
 	}
 }
 
-template<bool is_nullable, bool has_optional_parts>
-static inline int
-tuple_compare_slowpath(const struct tuple *tuple_a, const struct tuple *tuple_b,
-		       const struct key_def *key_def)
-{
-	assert(!has_optional_parts || is_nullable);
-	assert(is_nullable == key_def->is_nullable);
-	assert(has_optional_parts == key_def->has_optional_parts);
-	const struct key_part *part = key_def->parts;
-	const char *tuple_a_raw = tuple_data(tuple_a);
-	const char *tuple_b_raw = tuple_data(tuple_b);
-	if (key_def->part_count == 1 && part->fieldno == 0) {
-		/*
-		 * First field can not be optional - empty tuples
-		 * can not exist.
-		 */
-		assert(!has_optional_parts);
-		mp_decode_array(&tuple_a_raw);
-		mp_decode_array(&tuple_b_raw);
-		if (! is_nullable) {
-			return tuple_compare_field(tuple_a_raw, tuple_b_raw,
-						   part->type, part->coll);
-		}
-		enum mp_type a_type = mp_typeof(*tuple_a_raw);
-		enum mp_type b_type = mp_typeof(*tuple_b_raw);
-		if (a_type == MP_NIL)
-			return b_type == MP_NIL ? 0 : -1;
-		else if (b_type == MP_NIL)
-			return 1;
-		return tuple_compare_field_with_hint(tuple_a_raw,  a_type,
-						     tuple_b_raw, b_type,
-						     part->type, part->coll);
-	}
-
-	bool was_null_met = false;
-	const struct tuple_format *format_a = tuple_format(tuple_a);
-	const struct tuple_format *format_b = tuple_format(tuple_b);
-	const uint32_t *field_map_a = tuple_field_map(tuple_a);
-	const uint32_t *field_map_b = tuple_field_map(tuple_b);
-	const struct key_part *end;
-	const char *field_a, *field_b;
-	enum mp_type a_type, b_type;
-	int rc;
-	if (is_nullable)
-		end = part + key_def->unique_part_count;
-	else
-		end = part + key_def->part_count;
-
-	for (; part < end; part++) {
-		field_a = tuple_field_raw(format_a, tuple_a_raw, field_map_a,
-					  part->fieldno);
-		field_b = tuple_field_raw(format_b, tuple_b_raw, field_map_b,
-					  part->fieldno);
-		assert(has_optional_parts ||
-		       (field_a != NULL && field_b != NULL));
-		if (! is_nullable) {
-			rc = tuple_compare_field(field_a, field_b, part->type,
-						 part->coll);
-			if (rc != 0)
-				return rc;
-			else
-				continue;
-		}
-		if (has_optional_parts) {
-			a_type = field_a != NULL ? mp_typeof(*field_a) : MP_NIL;
-			b_type = field_b != NULL ? mp_typeof(*field_b) : MP_NIL;
-		} else {
-			a_type = mp_typeof(*field_a);
-			b_type = mp_typeof(*field_b);
-		}
-		if (a_type == MP_NIL) {
-			if (b_type != MP_NIL)
-				return -1;
-			was_null_met = true;
-		} else if (b_type == MP_NIL) {
-			return 1;
-		} else {
-			rc = tuple_compare_field_with_hint(field_a, a_type,
-							   field_b, b_type,
-							   part->type,
-							   part->coll);
-			if (rc != 0)
-				return rc;
-		}
-	}
-	/*
-	 * Do not use full parts set when no NULLs. It allows to
-	 * simulate a NULL != NULL logic in secondary keys,
-	 * because in them full parts set contains unique primary
-	 * key.
-	 */
-	if (!is_nullable || !was_null_met)
-		return 0;
-	/*
-	 * Inxex parts are equal and contain NULLs. So use
-	 * extended parts only.
-	 */
-	end = key_def->parts + key_def->part_count;
-	for (; part < end; ++part) {
-		field_a = tuple_field_raw(format_a, tuple_a_raw, field_map_a,
-					  part->fieldno);
-		field_b = tuple_field_raw(format_b, tuple_b_raw, field_map_b,
-					  part->fieldno);
-		/*
-		 * Extended parts are primary, and they can not
-		 * be absent or be NULLs.
-		 */
-		assert(field_a != NULL && field_b != NULL);
-		rc = tuple_compare_field(field_a, field_b, part->type,
-					 part->coll);
-		if (rc != 0)
-			return rc;
-	}
-	return 0;
-}
-
-template<bool is_nullable, bool has_optional_parts>
-static inline int
-tuple_compare_with_key_slowpath(const struct tuple *tuple, const char *key,
-				uint32_t part_count,
-				const struct key_def *key_def)
-{
-	assert(!has_optional_parts || is_nullable);
-	assert(is_nullable == key_def->is_nullable);
-	assert(has_optional_parts == key_def->has_optional_parts);
-	assert(key != NULL || part_count == 0);
-	assert(part_count <= key_def->part_count);
-	const struct key_part *part = key_def->parts;
-	const struct tuple_format *format = tuple_format(tuple);
-	const char *tuple_raw = tuple_data(tuple);
-	const uint32_t *field_map = tuple_field_map(tuple);
-	enum mp_type a_type, b_type;
-	if (likely(part_count == 1)) {
-		const char *field;
-		field = tuple_field_raw(format, tuple_raw, field_map,
-					part->fieldno);
-		if (! is_nullable) {
-			return tuple_compare_field(field, key, part->type,
-						   part->coll);
-		}
-		if (has_optional_parts)
-			a_type = field != NULL ? mp_typeof(*field) : MP_NIL;
-		else
-			a_type = mp_typeof(*field);
-		b_type = mp_typeof(*key);
-		if (a_type == MP_NIL) {
-			return b_type == MP_NIL ? 0 : -1;
-		} else if (b_type == MP_NIL) {
-			return 1;
-		} else {
-			return tuple_compare_field_with_hint(field, a_type, key,
-							     b_type, part->type,
-							     part->coll);
-		}
-	}
-
-	const struct key_part *end = part + part_count;
-	int rc;
-	for (; part < end; ++part, mp_next(&key)) {
-		const char *field;
-		field = tuple_field_raw(format, tuple_raw, field_map,
-					part->fieldno);
-		if (! is_nullable) {
-			rc = tuple_compare_field(field, key, part->type,
-						 part->coll);
-			if (rc != 0)
-				return rc;
-			else
-				continue;
-		}
-		if (has_optional_parts)
-			a_type = field != NULL ? mp_typeof(*field) : MP_NIL;
-		else
-			a_type = mp_typeof(*field);
-		b_type = mp_typeof(*key);
-		if (a_type == MP_NIL) {
-			if (b_type != MP_NIL)
-				return -1;
-		} else if (b_type == MP_NIL) {
-			return 1;
-		} else {
-			rc = tuple_compare_field_with_hint(field, a_type, key,
-							   b_type, part->type,
-							   part->coll);
-			if (rc != 0)
-				return rc;
-		}
-	}
-	return 0;
-}
-
 template<bool is_nullable>
 static inline int
 key_compare_parts(const char *key_a, const char *key_b, uint32_t part_count,
@@ -673,48 +482,6 @@ key_compare_parts(const char *key_a, const char *key_b, uint32_t part_count,
 	return 0;
 }
 
-template<bool is_nullable, bool has_optional_parts>
-static inline int
-tuple_compare_with_key_sequential(const struct tuple *tuple, const char *key,
-				  uint32_t part_count,
-				  const struct key_def *key_def)
-{
-	assert(!has_optional_parts || is_nullable);
-	assert(key_def_is_sequential(key_def));
-	assert(is_nullable == key_def->is_nullable);
-	assert(has_optional_parts == key_def->has_optional_parts);
-	const char *tuple_key = tuple_data(tuple);
-	uint32_t field_count = mp_decode_array(&tuple_key);
-	uint32_t cmp_part_count;
-	if (has_optional_parts && field_count < part_count) {
-		cmp_part_count = field_count;
-	} else {
-		assert(field_count >= part_count);
-		cmp_part_count = part_count;
-	}
-	int rc = key_compare_parts<is_nullable>(tuple_key, key, cmp_part_count,
-						key_def);
-	if (!has_optional_parts || rc != 0)
-		return rc;
-	/*
-	 * If some tuple indexed fields are absent, then check
-	 * corresponding key fields to be equal to NULL.
-	 */
-	if (field_count < part_count) {
-		/*
-		 * Key's and tuple's first field_count fields are
-		 * equal, and their bsize too.
-		 */
-		key += tuple->bsize - mp_sizeof_array(field_count);
-		for (uint32_t i = field_count; i < part_count;
-		     ++i, mp_next(&key)) {
-			if (mp_typeof(*key) != MP_NIL)
-				return -1;
-		}
-	}
-	return 0;
-}
-
 int
 key_compare(const char *key_a, const char *key_b,
 	    const struct key_def *key_def)
@@ -734,514 +501,541 @@ key_compare(const char *key_a, const char *key_b,
 	}
 }
 
-template <bool is_nullable, bool has_optional_parts>
-static int
-tuple_compare_sequential(const struct tuple *tuple_a,
-			 const struct tuple *tuple_b,
-			 const struct key_def *key_def)
+/**
+ * The longest key prefix compared by comparators specialized
+ * for key part types. Parts beyond it are compared with the
+ * generic tuple_compare_field_with_hint() switch. Each extra
+ * part multiplies the number of instantiated comparators by
+ * the number of specialized types, so keep it small.
+ */
+enum { TUPLE_COMPARE_TYPED_PART_MAX = 3 };
+
+/**
+ * Return the type a comparator of @a part is specialized for.
+ * Parts with a collation and types which are either rare in
+ * keys or too expensive to compare to benefit from inlining
+ * map to FIELD_TYPE_ANY, which stands for the generic switch.
+ */
+static inline enum field_type
+key_part_compare_type(const struct key_part *part)
 {
-	assert(!has_optional_parts || is_nullable);
-	assert(has_optional_parts == key_def->has_optional_parts);
-	assert(key_def_is_sequential(key_def));
-	assert(is_nullable == key_def->is_nullable);
-	const char *key_a = tuple_data(tuple_a);
-	uint32_t fc_a = mp_decode_array(&key_a);
-	const char *key_b = tuple_data(tuple_b);
-	uint32_t fc_b = mp_decode_array(&key_b);
-	if (!has_optional_parts && !is_nullable) {
-		assert(fc_a >= key_def->part_count);
-		assert(fc_b >= key_def->part_count);
-		return key_compare_parts<false>(key_a, key_b,
-						key_def->part_count, key_def);
-	}
-	bool was_null_met = false;
-	const struct key_part *part = key_def->parts;
-	const struct key_part *end = part + key_def->unique_part_count;
-	int rc;
-	uint32_t i = 0;
-	for (; part < end; ++part, ++i) {
-		enum mp_type a_type, b_type;
-		if (has_optional_parts) {
-			a_type = i >= fc_a ? MP_NIL : mp_typeof(*key_a);
-			b_type = i >= fc_b ? MP_NIL : mp_typeof(*key_b);
-		} else {
-			a_type = mp_typeof(*key_a);
-			b_type = mp_typeof(*key_b);
-		}
-		if (a_type == MP_NIL) {
-			if (b_type != MP_NIL)
-				return -1;
-			was_null_met = true;
-		} else if (b_type == MP_NIL) {
-			return 1;
-		} else {
-			rc = tuple_compare_field_with_hint(key_a, a_type, key_b,
-							   b_type, part->type,
-							   part->coll);
-			if (rc != 0)
-				return rc;
-		}
-		if (!has_optional_parts || i < fc_a)
-			mp_next(&key_a);
-		if (!has_optional_parts || i < fc_b)
-			mp_next(&key_b);
-	}
-	if (! was_null_met)
-		return 0;
-	end = key_def->parts + key_def->part_count;
-	for (; part < end; ++part, ++i, mp_next(&key_a), mp_next(&key_b)) {
-		/*
-		 * If tuples are equal by unique_part_count, then
-		 * the rest of parts are a primary key, which can
-		 * not be absent or be null.
-		 */
-		assert(i < fc_a && i < fc_b);
-		rc = tuple_compare_field(key_a, key_b, part->type,
-					 part->coll);
-		if (rc != 0)
-			return rc;
+	if (part->coll != NULL)
+		return FIELD_TYPE_ANY;
+	switch (part->type) {
+	case FIELD_TYPE_UNSIGNED:
+	case FIELD_TYPE_STRING:
+	case FIELD_TYPE_INTEGER:
+		return part->type;
+	default:
+		return FIELD_TYPE_ANY;
 	}
-	return 0;
 }
 
+/**
+ * Compare two not NULL fields of a key part, which type is
+ * known at compile time. Message pack types of the fields
+ * are passed as hints and are not used by the comparators
+ * which do not need them.
+ */
 template <int TYPE>
-static inline int
-field_compare(const char **field_a, const char **field_b);
+static inline __attribute__((always_inline)) int
+field_compare_typed(const char *field_a, enum mp_type a_type,
+		    const char *field_b, enum mp_type b_type,
+		    const struct key_part *part)
+{
+	return tuple_compare_field_with_hint(field_a, a_type, field_b, b_type,
+					     part->type, part->coll);
+}
 
 template <>
-inline int
-field_compare<FIELD_TYPE_UNSIGNED>(const char **field_a, const char **field_b)
+inline __attribute__((always_inline)) int
+field_compare_typed<FIELD_TYPE_UNSIGNED>(const char *field_a, enum mp_type,
+					 const char *field_b, enum mp_type,
+					 const struct key_part *)
 {
-	return mp_compare_uint(*field_a, *field_b);
+	return mp_compare_uint(field_a, field_b);
 }
 
 template <>
-inline int
-field_compare<FIELD_TYPE_STRING>(const char **field_a, const char **field_b)
+inline __attribute__((always_inline)) int
+field_compare_typed<FIELD_TYPE_STRING>(const char *field_a, enum mp_type,
+				       const char *field_b, enum mp_type,
+				       const struct key_part *)
 {
-	uint32_t size_a, size_b;
-	size_a = mp_decode_strl(field_a);
-	size_b = mp_decode_strl(field_b);
-	int r = memcmp(*field_a, *field_b, MIN(size_a, size_b));
-	if (r == 0)
-		r = size_a < size_b ? -1 : size_a > size_b;
-	return r;
+	return mp_compare_str(field_a, field_b);
 }
 
-template <int TYPE>
-static inline int
-field_compare_and_next(const char **field_a, const char **field_b);
-
 template <>
-inline int
-field_compare_and_next<FIELD_TYPE_UNSIGNED>(const char **field_a,
-					    const char **field_b)
+inline __attribute__((always_inline)) int
+field_compare_typed<FIELD_TYPE_INTEGER>(const char *field_a,
+					enum mp_type a_type,
+					const char *field_b,
+					enum mp_type b_type,
+					const struct key_part *)
 {
-	int r = mp_compare_uint(*field_a, *field_b);
-	mp_next(field_a);
-	mp_next(field_b);
-	return r;
+	return mp_compare_integer_with_hint(field_a, a_type, field_b, b_type);
 }
 
-template <>
-inline int
-field_compare_and_next<FIELD_TYPE_STRING>(const char **field_a,
-					  const char **field_b)
+/**
+ * Compare one key part of two tuples or of a tuple and a key.
+ * For nullable keys a field can be NULL, if it is absent in
+ * a tuple, which is the same as MP_NIL. @a was_null_met is
+ * set if both fields are NULLs.
+ */
+template <int TYPE, bool is_nullable>
+static inline __attribute__((always_inline)) int
+key_part_compare(const struct key_part *part, const char *field_a,
+		 const char *field_b, bool *was_null_met)
 {
-	uint32_t size_a, size_b;
-	size_a = mp_decode_strl(field_a);
-	size_b = mp_decode_strl(field_b);
-	int r = memcmp(*field_a, *field_b, MIN(size_a, size_b));
-	if (r == 0)
-		r = size_a < size_b ? -1 : size_a > size_b;
-	*field_a += size_a;
-	*field_b += size_b;
-	return r;
+	if (!is_nullable) {
+		assert(field_a != NULL && field_b != NULL);
+		return field_compare_typed<TYPE>(field_a, mp_typeof(*field_a),
+						 field_b, mp_typeof(*field_b),
+						 part);
+	}
+	enum mp_type a_type = field_a != NULL ? mp_typeof(*field_a) : MP_NIL;
+	enum mp_type b_type = field_b != NULL ? mp_typeof(*field_b) : MP_NIL;
+	if (a_type == MP_NIL) {
+		if (b_type != MP_NIL)
+			return -1;
+		*was_null_met = true;
+		return 0;
+	} else if (b_type == MP_NIL) {
+		return 1;
+	}
+	return field_compare_typed<TYPE>(field_a, a_type, field_b, b_type,
+					 part);
 }
 
-/* Tuple comparator */
 namespace /* local symbols */ {
 
-template <int IDX, int TYPE, int ...MORE_TYPES> struct FieldCompare { };
+/** Tuple data and field map decoded once per comparison. */
+struct tuple_fields {
+	const struct tuple_format *format;
+	const char *data;
+	const uint32_t *field_map;
+
+	tuple_fields(const struct tuple *tuple)
+		: format(tuple_format(tuple)), data(tuple_data(tuple)),
+		  field_map(tuple_field_map(tuple)) {}
+
+	const char *
+	get(uint32_t fieldno) const
+	{
+		return tuple_field_raw(format, data, field_map, fieldno);
+	}
+};
 
 /**
- * Common case.
+ * Compare key parts of two tuples starting from IDX. TYPES
+ * are the types the next parts are specialized for, the
+ * parts following them are compared generically.
  */
-template <int IDX, int TYPE, int IDX2, int TYPE2, int ...MORE_TYPES>
-struct FieldCompare<IDX, TYPE, IDX2, TYPE2, MORE_TYPES...>
+template <bool is_nullable, uint32_t IDX, int ...TYPES>
+struct TupleCompareParts;
+
+template <bool is_nullable, uint32_t IDX, int TYPE, int ...MORE_TYPES>
+struct TupleCompareParts<is_nullable, IDX, TYPE, MORE_TYPES...>
 {
-	inline static int compare(const struct tuple *tuple_a,
-				  const struct tuple *tuple_b,
-				  const struct tuple_format *format_a,
-				  const struct tuple_format *format_b,
-				  const char *field_a,
-				  const char *field_b)
+	static inline int
+	compare(const struct tuple_fields &a, const struct tuple_fields &b,
+		const struct key_def *def, bool was_null_met)
 	{
-		int r;
-		/* static if */
-		if (IDX + 1 == IDX2) {
-			if ((r = field_compare_and_next<TYPE>(&field_a,
-							      &field_b)) != 0)
-				return r;
-		} else {
-			if ((r = field_compare<TYPE>(&field_a, &field_b)) != 0)
-				return r;
-			field_a = tuple_field_raw(format_a, tuple_data(tuple_a),
-						  tuple_field_map(tuple_a),
-						  IDX2);
-			field_b = tuple_field_raw(format_b, tuple_data(tuple_b),
-						  tuple_field_map(tuple_b),
-						  IDX2);
-		}
-		return FieldCompare<IDX2, TYPE2, MORE_TYPES...>::
-			compare(tuple_a, tuple_b, format_a,
-				format_b, field_a, field_b);
+		assert(IDX < def->part_count);
+		/*
+		 * Do not use full parts set when no NULLs. It
+		 * allows to simulate a NULL != NULL logic in
+		 * secondary keys, because in them full parts set
+		 * contains unique primary key.
+		 */
+		if (is_nullable && IDX == def->unique_part_count &&
+		    !was_null_met)
+			return 0;
+		const struct key_part *part = &def->parts[IDX];
+		int rc = key_part_compare<TYPE, is_nullable>(part,
+				a.get(part->fieldno), b.get(part->fieldno),
+				&was_null_met);
+		if (rc != 0)
+			return rc;
+		return TupleCompareParts<is_nullable, IDX + 1, MORE_TYPES...>::
+			compare(a, b, def, was_null_met);
+	}
+};
+
+/**
+ * Compare the key parts of two tuples starting from @a i
+ * generically. Not inlined to keep the specialized
+ * comparators small, since it is only used for long keys.
+ */
+template <bool is_nullable>
+NOINLINE static int
+tuple_compare_tail(const struct tuple_fields &a, const struct tuple_fields &b,
+		   const struct key_def *def, uint32_t i, bool was_null_met)
+{
+	for (; i < def->part_count; i++) {
+		if (is_nullable && i == def->unique_part_count &&
+		    !was_null_met)
+			return 0;
+		const struct key_part *part = &def->parts[i];
+		int rc = key_part_compare<FIELD_TYPE_ANY, is_nullable>(part,
+				a.get(part->fieldno), b.get(part->fieldno),
+				&was_null_met);
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
+}
+
+template <bool is_nullable, uint32_t IDX>
+struct TupleCompareParts<is_nullable, IDX>
+{
+	static inline int
+	compare(const struct tuple_fields &a, const struct tuple_fields &b,
+		const struct key_def *def, bool was_null_met)
+	{
+		if (IDX == def->part_count)
+			return 0;
+		return tuple_compare_tail<is_nullable>(a, b, def, IDX,
+						       was_null_met);
 	}
 };
 
-template <int IDX, int TYPE>
-struct FieldCompare<IDX, TYPE>
+template <bool is_nullable, int ...TYPES>
+struct TupleCompare
 {
-	inline static int compare(const struct tuple *,
-				  const struct tuple *,
-				  const struct tuple_format *,
-				  const struct tuple_format *,
-				  const char *field_a,
-				  const char *field_b)
+	static int
+	compare(const struct tuple *tuple_a, const struct tuple *tuple_b,
+		const struct key_def *def)
 	{
-		return field_compare<TYPE>(&field_a, &field_b);
+		assert(is_nullable == def->is_nullable);
+		assert(is_nullable || !def->has_optional_parts);
+		struct tuple_fields a(tuple_a), b(tuple_b);
+		return TupleCompareParts<is_nullable, 0, TYPES...>::
+			compare(a, b, def, false);
 	}
 };
 
 /**
- * header
+ * Compare key parts of a tuple and a key starting from IDX.
+ * @a key points to the part IDX of the key.
  */
-template <int IDX, int TYPE, int ...MORE_TYPES>
-struct TupleCompare
+template <bool is_nullable, uint32_t IDX, int ...TYPES>
+struct TupleCompareWithKeyParts;
+
+template <bool is_nullable, uint32_t IDX, int TYPE, int ...MORE_TYPES>
+struct TupleCompareWithKeyParts<is_nullable, IDX, TYPE, MORE_TYPES...>
 {
-	static int compare(const struct tuple *tuple_a,
-			   const struct tuple *tuple_b,
-			   const struct key_def *)
+	static inline int
+	compare(const struct tuple_fields &tuple, const char *key,
+		uint32_t part_count, const struct key_def *def)
 	{
-		struct tuple_format *format_a = tuple_format(tuple_a);
-		struct tuple_format *format_b = tuple_format(tuple_b);
-		const char *field_a, *field_b;
-		field_a = tuple_field_raw(format_a, tuple_data(tuple_a),
-					  tuple_field_map(tuple_a), IDX);
-		field_b = tuple_field_raw(format_b, tuple_data(tuple_b),
-					  tuple_field_map(tuple_b), IDX);
-		return FieldCompare<IDX, TYPE, MORE_TYPES...>::
-			compare(tuple_a, tuple_b, format_a,
-				format_b, field_a, field_b);
+		if (IDX == part_count)
+			return 0;
+		const struct key_part *part = &def->parts[IDX];
+		/* NULLs in a key match NULLs in a tuple. */
+		bool was_null_met;
+		int rc = key_part_compare<TYPE, is_nullable>(part,
+				tuple.get(part->fieldno), key, &was_null_met);
+		if (rc != 0 || IDX + 1 == part_count)
+			return rc;
+		mp_next(&key);
+		return TupleCompareWithKeyParts<is_nullable, IDX + 1,
+						MORE_TYPES...>::
+			compare(tuple, key, part_count, def);
 	}
 };
 
-template <int TYPE, int ...MORE_TYPES>
-struct TupleCompare<0, TYPE, MORE_TYPES...> {
-	static int compare(const struct tuple *tuple_a,
-			   const struct tuple *tuple_b,
-			   const struct key_def *)
+/**
+ * Compare the key parts of a tuple and a key starting from
+ * @a i generically.
+ */
+template <bool is_nullable>
+NOINLINE static int
+tuple_compare_with_key_tail(const struct tuple_fields &tuple, const char *key,
+			    uint32_t part_count, const struct key_def *def,
+			    uint32_t i)
+{
+	bool was_null_met;
+	for (; i < part_count; i++, mp_next(&key)) {
+		const struct key_part *part = &def->parts[i];
+		int rc = key_part_compare<FIELD_TYPE_ANY, is_nullable>(part,
+				tuple.get(part->fieldno), key, &was_null_met);
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
+}
+
+template <bool is_nullable, uint32_t IDX>
+struct TupleCompareWithKeyParts<is_nullable, IDX>
+{
+	static inline int
+	compare(const struct tuple_fields &tuple, const char *key,
+		uint32_t part_count, const struct key_def *def)
 	{
-		struct tuple_format *format_a = tuple_format(tuple_a);
-		struct tuple_format *format_b = tuple_format(tuple_b);
-		const char *field_a = tuple_data(tuple_a);
-		const char *field_b = tuple_data(tuple_b);
-		mp_decode_array(&field_a);
-		mp_decode_array(&field_b);
-		return FieldCompare<0, TYPE, MORE_TYPES...>::compare(tuple_a, tuple_b,
-					format_a, format_b, field_a, field_b);
+		if (IDX == part_count)
+			return 0;
+		return tuple_compare_with_key_tail<is_nullable>(tuple, key,
+								part_count,
+								def, IDX);
 	}
 };
-} /* end of anonymous namespace */
 
-struct comparator_signature {
-	tuple_compare_t f;
-	uint32_t p[64];
+template <bool is_nullable, int ...TYPES>
+struct TupleCompareWithKey
+{
+	static int
+	compare(const struct tuple *tuple, const char *key,
+		uint32_t part_count, const struct key_def *def)
+	{
+		assert(is_nullable == def->is_nullable);
+		assert(is_nullable || !def->has_optional_parts);
+		assert(key != NULL || part_count == 0);
+		assert(part_count <= def->part_count);
+		/* Part count can be 0 in wildcard searches. */
+		struct tuple_fields fields(tuple);
+		return TupleCompareWithKeyParts<is_nullable, 0, TYPES...>::
+			compare(fields, key, part_count, def);
+	}
 };
-#define COMPARATOR(...) \
-	{ TupleCompare<__VA_ARGS__>::compare, { __VA_ARGS__, UINT32_MAX } },
 
 /**
- * field1 no, field1 type, field2 no, field2 type, ...
+ * Find a comparator instantiated for the types of the key
+ * parts. The types are appended to TYPES one by one while
+ * walking over the key definition, until either all the parts
+ * are seen or TUPLE_COMPARE_TYPED_PART_MAX types are
+ * collected, which is tracked by is_complete at compile time.
  */
-static const comparator_signature cmp_arr[] = {
-	COMPARATOR(0, FIELD_TYPE_UNSIGNED)
-	COMPARATOR(0, FIELD_TYPE_STRING)
-	COMPARATOR(0, FIELD_TYPE_UNSIGNED, 1, FIELD_TYPE_UNSIGNED)
-	COMPARATOR(0, FIELD_TYPE_STRING  , 1, FIELD_TYPE_UNSIGNED)
-	COMPARATOR(0, FIELD_TYPE_UNSIGNED, 1, FIELD_TYPE_STRING)
-	COMPARATOR(0, FIELD_TYPE_STRING  , 1, FIELD_TYPE_STRING)
-	COMPARATOR(0, FIELD_TYPE_UNSIGNED, 1, FIELD_TYPE_UNSIGNED, 2, FIELD_TYPE_UNSIGNED)
-	COMPARATOR(0, FIELD_TYPE_STRING  , 1, FIELD_TYPE_UNSIGNED, 2, FIELD_TYPE_UNSIGNED)
-	COMPARATOR(0, FIELD_TYPE_UNSIGNED, 1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_UNSIGNED)
-	COMPARATOR(0, FIELD_TYPE_STRING  , 1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_UNSIGNED)
-	COMPARATOR(0, FIELD_TYPE_UNSIGNED, 1, FIELD_TYPE_UNSIGNED, 2, FIELD_TYPE_STRING)
-	COMPARATOR(0, FIELD_TYPE_STRING  , 1, FIELD_TYPE_UNSIGNED, 2, FIELD_TYPE_STRING)
-	COMPARATOR(0, FIELD_TYPE_UNSIGNED, 1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_STRING)
-	COMPARATOR(0, FIELD_TYPE_STRING  , 1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_STRING)
+template <template <bool, int...> class Comparator, typename comparator_t,
+	  bool is_nullable, bool is_complete, int ...TYPES>
+struct ComparatorCreate
+{
+	template <int TYPE>
+	using next = ComparatorCreate<Comparator, comparator_t, is_nullable,
+		sizeof...(TYPES) + 1 == TUPLE_COMPARE_TYPED_PART_MAX,
+		TYPES..., TYPE>;
+
+	static comparator_t
+	create(const struct key_def *def)
+	{
+		uint32_t i = sizeof...(TYPES);
+		if (i == def->part_count)
+			return Comparator<is_nullable, TYPES...>::compare;
+		switch (key_part_compare_type(&def->parts[i])) {
+		case FIELD_TYPE_UNSIGNED:
+			return next<FIELD_TYPE_UNSIGNED>::create(def);
+		case FIELD_TYPE_STRING:
+			return next<FIELD_TYPE_STRING>::create(def);
+		case FIELD_TYPE_INTEGER:
+			return next<FIELD_TYPE_INTEGER>::create(def);
+		default:
+			return next<FIELD_TYPE_ANY>::create(def);
+		}
+	}
+};
+
+template <template <bool, int...> class Comparator, typename comparator_t,
+	  bool is_nullable, int ...TYPES>
+struct ComparatorCreate<Comparator, comparator_t, is_nullable, true, TYPES...>
+{
+	static comparator_t
+	create(const struct key_def *)
+	{
+		return Comparator<is_nullable, TYPES...>::compare;
+	}
 };
 
-#undef COMPARATOR
+} /* end of anonymous namespace */
 
 tuple_compare_t
 tuple_compare_create(const struct key_def *def)
 {
 	if (def->is_nullable) {
-		if (key_def_is_sequential(def)) {
-			if (def->has_optional_parts)
-				return tuple_compare_sequential<true, true>;
-			else
-				return tuple_compare_sequential<true, false>;
-		} else if (def->has_optional_parts) {
-			return tuple_compare_slowpath<true, true>;
-		} else {
-			return tuple_compare_slowpath<true, false>;
-		}
+		return ComparatorCreate<TupleCompare, tuple_compare_t,
+					true, false>::create(def);
 	}
 	assert(! def->has_optional_parts);
-	if (!key_def_has_collation(def)) {
-		/* Precalculated comparators don't use collation */
-		for (uint32_t k = 0;
-		     k < sizeof(cmp_arr) / sizeof(cmp_arr[0]); k++) {
-			uint32_t i = 0;
-			for (; i < def->part_count; i++)
-				if (def->parts[i].fieldno !=
-				    cmp_arr[k].p[i * 2] ||
-				    def->parts[i].type !=
-				    cmp_arr[k].p[i * 2 + 1])
-					break;
-			if (i == def->part_count &&
-			    cmp_arr[k].p[i * 2] == UINT32_MAX)
-				return cmp_arr[k].f;
-		}
-	}
-	if (key_def_is_sequential(def))
-		return tuple_compare_sequential<false, false>;
-	else
-		return tuple_compare_slowpath<false, false>;
+	return ComparatorCreate<TupleCompare, tuple_compare_t,
+				false, false>::create(def);
 }
 
 /* }}} tuple_compare */
 
 /* {{{ tuple_compare_with_key */
 
-template <int TYPE>
-static inline int field_compare_with_key(const char **field, const char **key);
-
-template <>
-inline int
-field_compare_with_key<FIELD_TYPE_UNSIGNED>(const char **field, const char **key)
-{
-	return mp_compare_uint(*field, *key);
-}
-
-template <>
-inline int
-field_compare_with_key<FIELD_TYPE_STRING>(const char **field, const char **key)
+tuple_compare_with_key_t
+tuple_compare_with_key_create(const struct key_def *def)
 {
-	uint32_t size_a, size_b;
-	size_a = mp_decode_strl(field);
-	size_b = mp_decode_strl(key);
-	int r = memcmp(*field, *key, MIN(size_a, size_b));
-	if (r == 0)
-		r = size_a < size_b ? -1 : size_a > size_b;
-	return r;
+	if (def->is_nullable) {
+		return ComparatorCreate<TupleCompareWithKey,
+					tuple_compare_with_key_t,
+					true, false>::create(def);
+	}
+	assert(! def->has_optional_parts);
+	return ComparatorCreate<TupleCompareWithKey, tuple_compare_with_key_t,
+				false, false>::create(def);
 }
 
-template <int TYPE>
-static inline int
-field_compare_with_key_and_next(const char **field_a, const char **field_b);
+/* }}} tuple_compare_with_key */
 
-template <>
-inline int
-field_compare_with_key_and_next<FIELD_TYPE_UNSIGNED>(const char **field_a,
-						     const char **field_b)
-{
-	int r = mp_compare_uint(*field_a, *field_b);
-	mp_next(field_a);
-	mp_next(field_b);
-	return r;
-}
+/* {{{ tuple_hint */
 
-template <>
-inline int
-field_compare_with_key_and_next<FIELD_TYPE_STRING>(const char **field_a,
-					const char **field_b)
+/**
+ * Convert a value to a hint. 0 is reserved for NULL, which is
+ * less than any other value, and values that would collide with
+ * HINT_NONE are clamped, which keeps the order of hints
+ * consistent with the order of values.
+ */
+static inline hint_t
+hint_value(uint64_t value)
 {
-	uint32_t size_a, size_b;
-	size_a = mp_decode_strl(field_a);
-	size_b = mp_decode_strl(field_b);
-	int r = memcmp(*field_a, *field_b, MIN(size_a, size_b));
-	if (r == 0)
-		r = size_a < size_b ? -1 : size_a > size_b;
-	*field_a += size_a;
-	*field_b += size_b;
-	return r;
+	return value < HINT_NONE - 1 ? value + 1 : HINT_NONE - 1;
 }
 
-/* Tuple with key comparator */
-namespace /* local symbols */ {
-
-template <int FLD_ID, int IDX, int TYPE, int ...MORE_TYPES>
-struct FieldCompareWithKey {};
 /**
- * common
+ * Hint of an integer field. The same mapping is used for
+ * 'unsigned' and 'integer' key parts, because an index part
+ * type may be changed between them without rebuilding the
+ * index, so the hints stored in the index must stay valid.
  */
-template <int FLD_ID, int IDX, int TYPE, int IDX2, int TYPE2, int ...MORE_TYPES>
-struct FieldCompareWithKey<FLD_ID, IDX, TYPE, IDX2, TYPE2, MORE_TYPES...>
+static inline hint_t
+field_hint_integer(const char *field)
 {
-	inline static int
-	compare(const struct tuple *tuple, const char *key,
-		uint32_t part_count, const struct key_def *key_def,
-		const struct tuple_format *format, const char *field)
-	{
-		int r;
-		/* static if */
-		if (IDX + 1 == IDX2) {
-			r = field_compare_with_key_and_next<TYPE>(&field, &key);
-			if (r || part_count == FLD_ID + 1)
-				return r;
-		} else {
-			r = field_compare_with_key<TYPE>(&field, &key);
-			if (r || part_count == FLD_ID + 1)
-				return r;
-			field = tuple_field_raw(format, tuple_data(tuple),
-						tuple_field_map(tuple), IDX2);
-			mp_next(&key);
-		}
-		return FieldCompareWithKey<FLD_ID + 1, IDX2, TYPE2, MORE_TYPES...>::
-				compare(tuple, key, part_count,
-					       key_def, format, field);
+	switch (mp_typeof(*field)) {
+	case MP_UINT: {
+		uint64_t value = mp_decode_uint(&field);
+		if (value > INT64_MAX)
+			return HINT_NONE - 1;
+		return hint_value(value + (1ULL << 63));
 	}
-};
-
-template <int FLD_ID, int IDX, int TYPE>
-struct FieldCompareWithKey<FLD_ID, IDX, TYPE> {
-	inline static int compare(const struct tuple *,
-					 const char *key,
-					 uint32_t,
-					 const struct key_def *,
-					 const struct tuple_format *,
-					 const char *field)
-	{
-		return field_compare_with_key<TYPE>(&field, &key);
+	case MP_INT: {
+		int64_t value = mp_decode_int(&field);
+		return hint_value((uint64_t)value + (1ULL << 63));
 	}
-};
+	default:
+		return HINT_NONE;
+	}
+}
 
 /**
- * header
+ * Hint of a string field: the first 8 bytes of the string or
+ * of its sort key if the key part has a collation, interpreted
+ * as a big-endian number.
  */
-template <int FLD_ID, int IDX, int TYPE, int ...MORE_TYPES>
-struct TupleCompareWithKey
+static inline hint_t
+field_hint_string(const char *field, struct coll *coll)
 {
-	static int
-	compare(const struct tuple *tuple, const char *key,
-		uint32_t part_count, const struct key_def *key_def)
-	{
-		/* Part count can be 0 in wildcard searches. */
-		if (part_count == 0)
-			return 0;
-		struct tuple_format *format = tuple_format(tuple);
-		const char *field = tuple_field_raw(format, tuple_data(tuple),
-						    tuple_field_map(tuple),
-						    IDX);
-		return FieldCompareWithKey<FLD_ID, IDX, TYPE, MORE_TYPES...>::
-				compare(tuple, key, part_count,
-					key_def, format, field);
+	if (mp_typeof(*field) != MP_STR)
+		return HINT_NONE;
+	uint32_t len;
+	const char *str = mp_decode_str(&field, &len);
+	if (coll != NULL)
+		return hint_value(coll->hint(str, len, coll));
+	uint64_t value = 0;
+	for (uint32_t i = 0; i < sizeof(value); i++) {
+		value <<= CHAR_BIT;
+		if (i < len)
+			value |= (unsigned char)str[i];
 	}
-};
+	return hint_value(value);
+}
 
-template <int TYPE, int ...MORE_TYPES>
-struct TupleCompareWithKey<0, 0, TYPE, MORE_TYPES...>
+template <enum field_type type, bool is_nullable>
+static inline hint_t
+field_hint(const char *field, struct coll *coll)
 {
-	static int compare(const struct tuple *tuple,
-				  const char *key,
-				  uint32_t part_count,
-				  const struct key_def *key_def)
-	{
-		/* Part count can be 0 in wildcard searches. */
-		if (part_count == 0)
-			return 0;
-		struct tuple_format *format = tuple_format(tuple);
-		const char *field = tuple_data(tuple);
-		mp_decode_array(&field);
-		return FieldCompareWithKey<0, 0, TYPE, MORE_TYPES...>::
-			compare(tuple, key, part_count,
-				key_def, format, field);
+	if (is_nullable && (field == NULL || mp_typeof(*field) == MP_NIL))
+		return 0;
+	switch (type) {
+	case FIELD_TYPE_UNSIGNED:
+	case FIELD_TYPE_INTEGER:
+		return field_hint_integer(field);
+	case FIELD_TYPE_STRING:
+		return field_hint_string(field, coll);
+	default:
+		unreachable();
+		return HINT_NONE;
 	}
-};
+}
 
-} /* end of anonymous namespace */
+template <enum field_type type, bool is_nullable>
+static hint_t
+tuple_hint_typed(const struct tuple *tuple, const struct key_def *key_def)
+{
+	const struct key_part *part = &key_def->parts[0];
+	const char *field = tuple_field_raw(tuple_format(tuple),
+					    tuple_data(tuple),
+					    tuple_field_map(tuple),
+					    part->fieldno);
+	return field_hint<type, is_nullable>(field, part->coll);
+}
 
-struct comparator_with_key_signature
+template <enum field_type type, bool is_nullable>
+static hint_t
+key_hint_typed(const char *key, uint32_t part_count,
+	       const struct key_def *key_def)
 {
-	tuple_compare_with_key_t f;
-	uint32_t p[64];
-};
+	if (part_count == 0)
+		return HINT_NONE;
+	return field_hint<type, is_nullable>(key, key_def->parts[0].coll);
+}
 
-#define KEY_COMPARATOR(...) \
-	{ TupleCompareWithKey<0, __VA_ARGS__>::compare, { __VA_ARGS__ } },
-
-static const comparator_with_key_signature cmp_wk_arr[] = {
-	KEY_COMPARATOR(0, FIELD_TYPE_UNSIGNED, 1, FIELD_TYPE_UNSIGNED, 2, FIELD_TYPE_UNSIGNED)
-	KEY_COMPARATOR(0, FIELD_TYPE_STRING  , 1, FIELD_TYPE_UNSIGNED, 2, FIELD_TYPE_UNSIGNED)
-	KEY_COMPARATOR(0, FIELD_TYPE_UNSIGNED, 1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_UNSIGNED)
-	KEY_COMPARATOR(0, FIELD_TYPE_STRING  , 1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_UNSIGNED)
-	KEY_COMPARATOR(0, FIELD_TYPE_UNSIGNED, 1, FIELD_TYPE_UNSIGNED, 2, FIELD_TYPE_STRING)
-	KEY_COMPARATOR(0, FIELD_TYPE_STRING  , 1, FIELD_TYPE_UNSIGNED, 2, FIELD_TYPE_STRING)
-	KEY_COMPARATOR(0, FIELD_TYPE_UNSIGNED, 1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_STRING)
-	KEY_COMPARATOR(0, FIELD_TYPE_STRING  , 1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_STRING)
-
-	KEY_COMPARATOR(1, FIELD_TYPE_UNSIGNED, 2, FIELD_TYPE_UNSIGNED)
-	KEY_COMPARATOR(1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_UNSIGNED)
-	KEY_COMPARATOR(1, FIELD_TYPE_UNSIGNED, 2, FIELD_TYPE_STRING)
-	KEY_COMPARATOR(1, FIELD_TYPE_STRING  , 2, FIELD_TYPE_STRING)
-};
+static hint_t
+tuple_hint_none(const struct tuple *tuple, const struct key_def *key_def)
+{
+	(void)tuple;
+	(void)key_def;
+	return HINT_NONE;
+}
 
-#undef KEY_COMPARATOR
+static hint_t
+key_hint_none(const char *key, uint32_t part_count,
+	      const struct key_def *key_def)
+{
+	(void)key;
+	(void)part_count;
+	(void)key_def;
+	return HINT_NONE;
+}
 
-tuple_compare_with_key_t
-tuple_compare_with_key_create(const struct key_def *def)
+template <enum field_type type, bool is_nullable>
+static void
+tuple_hint_func_set_typed(struct key_def *def)
 {
-	if (def->is_nullable) {
-		if (key_def_is_sequential(def)) {
-			if (def->has_optional_parts) {
-				return tuple_compare_with_key_sequential<true,
-									 true>;
-			} else {
-				return tuple_compare_with_key_sequential<true,
-									 false>;
-			}
-		} else if (def->has_optional_parts) {
-			return tuple_compare_with_key_slowpath<true, true>;
-		} else {
-			return tuple_compare_with_key_slowpath<true, false>;
-		}
-	}
-	assert(! def->has_optional_parts);
-	if (!key_def_has_collation(def)) {
-		/* Precalculated comparators don't use collation */
-		for (uint32_t k = 0;
-		     k < sizeof(cmp_wk_arr) / sizeof(cmp_wk_arr[0]);
-		     k++) {
-
-			uint32_t i = 0;
-			for (; i < def->part_count; i++) {
-				if (def->parts[i].fieldno !=
-				    cmp_wk_arr[k].p[i * 2] ||
-				    def->parts[i].type !=
-				    cmp_wk_arr[k].p[i * 2 + 1]) {
-					break;
-				}
-			}
-			if (i == def->part_count)
-				return cmp_wk_arr[k].f;
-		}
-	}
-	if (key_def_is_sequential(def))
-		return tuple_compare_with_key_sequential<false, false>;
+	def->tuple_hint = tuple_hint_typed<type, is_nullable>;
+	def->key_hint = key_hint_typed<type, is_nullable>;
+}
+
+template <enum field_type type>
+static void
+tuple_hint_func_set_typed(struct key_def *def)
+{
+	if (key_part_is_nullable(&def->parts[0]))
+		tuple_hint_func_set_typed<type, true>(def);
 	else
-		return tuple_compare_with_key_slowpath<false, false>;
+		tuple_hint_func_set_typed<type, false>(def);
 }
 
-/* }}} tuple_compare_with_key */
+void
+tuple_hint_func_set(struct key_def *def)
+{
+	def->tuple_hint = tuple_hint_none;
+	def->key_hint = key_hint_none;
+	if (def->part_count == 0)
+		return;
+	switch (def->parts[0].type) {
+	case FIELD_TYPE_UNSIGNED:
+		tuple_hint_func_set_typed<FIELD_TYPE_UNSIGNED>(def);
+		break;
+	case FIELD_TYPE_INTEGER:
+		tuple_hint_func_set_typed<FIELD_TYPE_INTEGER>(def);
+		break;
+	case FIELD_TYPE_STRING:
+		tuple_hint_func_set_typed<FIELD_TYPE_STRING>(def);
+		break;
+	default:
+		break;
+	}
+}
+
+/* }}} tuple_hint */
@@ -197,6 +197,89 @@ tuple_extract_key_slowpath(const struct tuple *tuple,
 	return key;
 }
 
+/**
+ * The longest key extracted by tuple_extract_key_short().
+ */
+enum { TUPLE_EXTRACT_KEY_SHORT_PART_MAX = 4 };
+
+/**
+ * Optimized version of tuple_extract_key() for short keys
+ * which are not sequential: every field is looked up in the
+ * tuple only once, and its size is remembered for copying.
+ * @copydoc tuple_extract_key()
+ */
+template <uint32_t part_count, bool has_optional_parts>
+static char *
+tuple_extract_key_short(const struct tuple *tuple,
+			const struct key_def *key_def, uint32_t *key_size)
+{
+	assert(part_count == key_def->part_count);
+	assert(!has_optional_parts || key_def->is_nullable);
+	assert(has_optional_parts == key_def->has_optional_parts);
+	assert(mp_sizeof_nil() == 1);
+	const char *data = tuple_data(tuple);
+	const struct tuple_format *format = tuple_format(tuple);
+	const uint32_t *field_map = tuple_field_map(tuple);
+	const char *fields[part_count];
+	uint32_t field_sizes[part_count];
+	uint32_t bsize = mp_sizeof_array(part_count);
+
+	for (uint32_t i = 0; i < part_count; ++i) {
+		const char *field =
+			tuple_field_raw(format, data, field_map,
+					key_def->parts[i].fieldno);
+		fields[i] = field;
+		if (has_optional_parts && field == NULL) {
+			field_sizes[i] = mp_sizeof_nil();
+		} else {
+			assert(field != NULL);
+			const char *end = field;
+			mp_next(&end);
+			field_sizes[i] = end - field;
+		}
+		bsize += field_sizes[i];
+	}
+
+	char *key = (char *) region_alloc(&fiber()->gc, bsize);
+	if (key == NULL) {
+		diag_set(OutOfMemory, bsize, "region", "tuple_extract_key");
+		return NULL;
+	}
+	char *key_buf = mp_encode_array(key, part_count);
+	for (uint32_t i = 0; i < part_count; ++i) {
+		if (has_optional_parts && fields[i] == NULL) {
+			key_buf = mp_encode_nil(key_buf);
+			continue;
+		}
+		memcpy(key_buf, fields[i], field_sizes[i]);
+		key_buf += field_sizes[i];
+	}
+	assert((uint32_t)(key_buf - key) == bsize);
+	if (key_size != NULL)
+		*key_size = bsize;
+	return key;
+}
+
+template <bool has_optional_parts>
+static tuple_extract_key_t
+tuple_extract_key_short_create(const struct key_def *key_def)
+{
+	assert(key_def->part_count <= TUPLE_EXTRACT_KEY_SHORT_PART_MAX);
+	switch (key_def->part_count) {
+	case 1:
+		return tuple_extract_key_short<1, has_optional_parts>;
+	case 2:
+		return tuple_extract_key_short<2, has_optional_parts>;
+	case 3:
+		return tuple_extract_key_short<3, has_optional_parts>;
+	case 4:
+		return tuple_extract_key_short<4, has_optional_parts>;
+	default:
+		unreachable();
+		return NULL;
+	}
+}
+
 /**
  * General-purpose version of tuple_extract_key_raw()
  * @copydoc tuple_extract_key_raw()
@@ -313,6 +396,15 @@ tuple_extract_key_set(struct key_def *key_def)
 			key_def->tuple_extract_key_raw =
 				tuple_extract_key_sequential_raw<false>;
 		}
+	} else if (key_def->part_count <= TUPLE_EXTRACT_KEY_SHORT_PART_MAX) {
+		if (key_def->has_optional_parts) {
+			assert(key_def->is_nullable);
+			key_def->tuple_extract_key =
+				tuple_extract_key_short_create<true>(key_def);
+		} else {
+			key_def->tuple_extract_key =
+				tuple_extract_key_short_create<false>(key_def);
+		}
 	} else {
 		if (key_def->has_optional_parts) {
 			assert(key_def->is_nullable);
@@ -55,6 +55,7 @@ tuple_format_create(struct tuple_format *format, struct key_def * const *keys,
 					     field_count);
 	if (format->field_count == 0) {
 		format->field_map_size = 0;
+		format->hot_field_map_size = 0;
 		return 0;
 	}
 	/* Initialize defined fields */
@@ -175,6 +176,24 @@ tuple_format_create(struct tuple_format *format, struct key_def * const *keys,
 		}
 	}
 
+	/*
+	 * Hot fields are accessed by offset as well. Allocate
+	 * their slots after the indexed ones, so that adding
+	 * or removing a hot field doesn't change slots of the
+	 * indexed fields.
+	 */
+	int hot_slot_count = 0;
+	for (uint32_t i = 1; i < field_count; ++i) {
+		struct tuple_field *field = &format->fields[i];
+		if (!fields[i].is_hot ||
+		    field->offset_slot != TUPLE_OFFSET_SLOT_NIL)
+			continue;
+		field->offset_slot = --current_slot;
+		format->offset_field_count =
+			MAX(format->offset_field_count, i + 1);
+		hot_slot_count++;
+	}
+
 	assert(format->fields[0].offset_slot == TUPLE_OFFSET_SLOT_NIL);
 	size_t field_map_size = -current_slot * sizeof(uint32_t);
 	if (field_map_size + format->extra_size > UINT16_MAX) {
@@ -184,6 +203,7 @@ tuple_format_create(struct tuple_format *format, struct key_def * const *keys,
 		return -1;
 	}
 	format->field_map_size = field_map_size;
+	format->hot_field_map_size = hot_slot_count * sizeof(uint32_t);
 	return 0;
 }
 
@@ -273,6 +293,7 @@ tuple_format_alloc(struct key_def * const *keys, uint16_t key_count,
 	format->id = FORMAT_ID_NIL;
 	format->field_count = field_count;
 	format->index_field_count = index_field_count;
+	format->offset_field_count = index_field_count;
 	format->exact_field_count = 0;
 	format->min_field_count = 0;
 	return format;
@@ -440,10 +461,11 @@ tuple_init_field_map(const struct tuple_format *format, uint32_t *field_map,
 	++field;
 	uint32_t i = 1;
 	uint32_t defined_field_count = MIN(field_count, format->field_count);
-	if (field_count < format->index_field_count) {
+	if (field_count < format->offset_field_count) {
 		/*
 		 * Nullify field map to be able to detect by 0,
-		 * which key fields are absent in tuple_field().
+		 * which key and hot fields are absent in
+		 * tuple_field().
 		 */
 		memset((char *)field_map - format->field_map_size, 0,
 		       format->field_map_size);
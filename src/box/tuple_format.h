@@ -36,6 +36,7 @@
 #include "errinj.h"
 #include "tuple_dictionary.h"
 #include "coll_cache.h"
+#include "field_scan.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -88,8 +89,9 @@ struct tuple_field {
 	 * in indexes. This allows quick access to most used
 	 * fields without parsing entire mspack. This member
 	 * stores position in the field map of tuple for current
-	 * field. If the field does not participate in indexes
-	 * then it has no offset in field map and INT_MAX is
+	 * field. If the field neither participates in indexes
+	 * nor is declared hot in the space format then it has
+	 * no offset in field map and INT_MAX is
 	 * stored in this member. Due to specific field map in
 	 * tuple (it is stored before tuple), the positions in
 	 * field map is negative.
@@ -137,6 +139,11 @@ struct tuple_format {
 	 * \sa struct tuple
 	 */
 	uint16_t field_map_size;
+	/**
+	 * Part of field_map_size occupied by offsets of
+	 * non-indexed fields declared hot in the space format.
+	 */
+	uint16_t hot_field_map_size;
 	/**
 	 * If not set (== 0), any tuple in the space can have any number of
 	 * fields. If set, each tuple must have exactly this number of fields.
@@ -147,6 +154,13 @@ struct tuple_format {
 	 * element is used by an index.
 	 */
 	uint32_t index_field_count;
+	/**
+	 * The longest field array prefix in which the last
+	 * element has an offset slot, i.e. is either used by an
+	 * index or declared hot in the space format.
+	 * index_field_count <= offset_field_count <= field_count.
+	 */
+	uint32_t offset_field_count;
 	/**
 	 * The minimal field count that must be specified.
 	 * index_field_count <= min_field_count <= field_count.
@@ -343,8 +357,8 @@ static inline const char *
 tuple_field_raw(const struct tuple_format *format, const char *tuple,
 		const uint32_t *field_map, uint32_t field_no)
 {
-	if (likely(field_no < format->index_field_count)) {
-		/* Indexed field */
+	if (likely(field_no < format->offset_field_count)) {
+		/* Indexed or hot field */
 
 		if (field_no == 0) {
 			mp_decode_array(&tuple);
@@ -363,9 +377,7 @@ tuple_field_raw(const struct tuple_format *format, const char *tuple,
 	uint32_t field_count = mp_decode_array(&tuple);
 	if (unlikely(field_no >= field_count))
 		return NULL;
-	for (uint32_t k = 0; k < field_no; k++)
-		mp_next(&tuple);
-	return tuple;
+	return field_scan_skip(tuple, field_no);
 }
 
 /**
@@ -308,11 +308,14 @@ tuple_hash_null(uint32_t *ph1, uint32_t *pcarry)
 	return mp_sizeof_nil();
 }
 
+/** Hash the first @a part_count key parts of a tuple. */
 template <bool has_optional_parts>
-uint32_t
-tuple_hash_slowpath(const struct tuple *tuple, const struct key_def *key_def)
+static inline uint32_t
+tuple_hash_parts(const struct tuple *tuple, const struct key_def *key_def,
+		 uint32_t part_count)
 {
 	assert(has_optional_parts == key_def->has_optional_parts);
+	assert(part_count > 0 && part_count <= key_def->part_count);
 	uint32_t h = HASH_SEED;
 	uint32_t carry = 0;
 	uint32_t total_size = 0;
@@ -325,7 +328,7 @@ tuple_hash_slowpath(const struct tuple *tuple, const struct key_def *key_def)
 		total_size += tuple_hash_field(&h, &carry, &field,
 					       key_def->parts[0].coll);
 	}
-	for (uint32_t part_id = 1; part_id < key_def->part_count; part_id++) {
+	for (uint32_t part_id = 1; part_id < part_count; part_id++) {
 		/* If parts of key_def are not sequential we need to call
 		 * tuple_field. Otherwise, tuple is hashed sequentially without
 		 * need of tuple_field
@@ -346,17 +349,43 @@ tuple_hash_slowpath(const struct tuple *tuple, const struct key_def *key_def)
 	return PMurHash32_Result(h, carry, total_size);
 }
 
+template <bool has_optional_parts>
 uint32_t
-key_hash_slowpath(const char *key, const struct key_def *key_def)
+tuple_hash_slowpath(const struct tuple *tuple, const struct key_def *key_def)
 {
+	return tuple_hash_parts<has_optional_parts>(tuple, key_def,
+						    key_def->part_count);
+}
+
+uint32_t
+tuple_hash_prefix(const struct tuple *tuple, const struct key_def *key_def,
+		  uint32_t part_count)
+{
+	if (key_def->has_optional_parts)
+		return tuple_hash_parts<true>(tuple, key_def, part_count);
+	else
+		return tuple_hash_parts<false>(tuple, key_def, part_count);
+}
+
+uint32_t
+key_hash_prefix(const char *key, const struct key_def *key_def,
+		uint32_t part_count)
+{
+	assert(part_count <= key_def->part_count);
 	uint32_t h = HASH_SEED;
 	uint32_t carry = 0;
 	uint32_t total_size = 0;
 
 	for (const struct key_part *part = key_def->parts;
-	     part < key_def->parts + key_def->part_count; part++) {
+	     part < key_def->parts + part_count; part++) {
 		total_size += tuple_hash_field(&h, &carry, &key, part->coll);
 	}
 
 	return PMurHash32_Result(h, carry, total_size);
 }
+
+uint32_t
+key_hash_slowpath(const char *key, const struct key_def *key_def)
+{
+	return key_hash_prefix(key, key_def, key_def->part_count);
+}
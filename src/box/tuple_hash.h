@@ -68,6 +68,28 @@ key_hash(const char *key, const struct key_def *key_def)
 	return key_def->key_hash(key, key_def);
 }
 
+/**
+ * Calculate a hash value of the first @a part_count key parts
+ * of a tuple. Unlike tuple_hash(), the value doesn't depend on
+ * the other parts of @a key_def and is equal to that returned
+ * by key_hash_prefix() for a key with the same @a part_count
+ * first parts.
+ */
+uint32_t
+tuple_hash_prefix(const struct tuple *tuple, const struct key_def *key_def,
+		  uint32_t part_count);
+
+/**
+ * Calculate a hash value of the first @a part_count parts
+ * of a key.
+ * @param key - key having at least @a part_count parts
+ *              (msgpack fields w/o array marker)
+ * @sa tuple_hash_prefix()
+ */
+uint32_t
+key_hash_prefix(const char *key, const struct key_def *key_def,
+		uint32_t part_count);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
@@ -43,6 +43,7 @@
 #include <bit/int96.h>
 #include <salad/rope.h>
 #include "column_mask.h"
+#include "field_scan.h"
 
 
 /** UPDATE request implementation.
@@ -786,9 +787,7 @@ update_field_split(void *split_ctx, void *data, size_t size, size_t offset)
 	const char *field = prev->tail;
 	const char *end = field + prev->tail_len;
 
-	for (uint32_t i = 1; i < offset; i++) {
-		mp_next(&field);
-	}
+	field = field_scan_skip(field, offset - 1);
 
 	prev->tail_len = field - prev->tail;
 	const char *f = field;
@@ -33,6 +33,7 @@
 #include "tuple.h"
 #include "journal.h"
 #include <fiber.h>
+#include "clock.h"
 #include "xrow.h"
 
 double too_long_threshold;
@@ -258,10 +259,21 @@ txn_write_to_wal(struct txn *txn)
 	}
 	assert(row == req->rows + req->n_rows);
 
+	/*
+	 * If the fiber serves a request, account the wait to the
+	 * request latency, see box.stat.latency().
+	 */
+	double *wal_wait = (double *) fiber_get_key(fiber(),
+						    FIBER_KEY_WAL_WAIT);
+	double wal_start = wal_wait != NULL ? clock_monotonic() : 0;
+
 	ev_tstamp start = ev_monotonic_now(loop());
 	int64_t res = journal_write(req);
 	ev_tstamp stop = ev_monotonic_now(loop());
 
+	if (wal_wait != NULL)
+		*wal_wait += clock_monotonic() - wal_start;
+
 	if (res < 0) {
 		/* Cascading rollback. */
 		txn_rollback(); /* Perform our part of cascading rollback. */
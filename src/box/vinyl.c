@@ -322,6 +322,18 @@ vy_info_append_cache(struct vy_env *env, struct info_handler *h)
 	info_table_end(h);
 }
 
+static void
+vy_info_append_page_cache(struct vy_env *env, struct info_handler *h)
+{
+	struct vy_page_cache *c = &env->run_env.page_cache;
+
+	info_table_begin(h, "page_cache");
+	info_append_int(h, "used", c->mem_used);
+	info_append_int(h, "limit", c->mem_quota);
+	info_append_int(h, "pages", c->page_count);
+	info_table_end(h);
+}
+
 static void
 vy_info_append_tx(struct vy_env *env, struct info_handler *h)
 {
@@ -354,6 +366,7 @@ vinyl_engine_info(struct vinyl_engine *vinyl, struct info_handler *h)
 	info_begin(h);
 	vy_info_append_quota(env, h);
 	vy_info_append_cache(env, h);
+	vy_info_append_page_cache(env, h);
 	vy_info_append_tx(env, h);
 	info_end(h);
 }
@@ -395,6 +408,40 @@ vy_info_append_compact_stat(struct info_handler *h, const char *name,
 	info_table_end(h);
 }
 
+static void
+vy_info_append_amplification(struct info_handler *h, struct vy_index *index)
+{
+	struct vy_index_stat *stat = &index->stat;
+	/*
+	 * Bytes stored in all runs and in the oldest run of each
+	 * range, the latter being the size of the data after full
+	 * compaction.
+	 */
+	int64_t total_bytes = 0;
+	int64_t last_level_bytes = 0;
+	for (struct vy_range *range = vy_range_tree_first(index->tree);
+	     range != NULL; range = vy_range_tree_next(index->tree, range)) {
+		total_bytes += range->count.bytes;
+		if (range->slice_count > 0) {
+			struct vy_slice *slice = rlist_last_entry(
+					&range->slices, struct vy_slice,
+					in_range);
+			last_level_bytes += slice->count.bytes;
+		}
+	}
+	int64_t dump_bytes = stat->disk.dump.out.bytes;
+	int64_t write_bytes = dump_bytes + stat->disk.compact.out.bytes;
+
+	info_table_begin(h, "amplification");
+	info_append_double(h, "write", dump_bytes == 0 ? 0 :
+			   (double)write_bytes / dump_bytes);
+	info_append_double(h, "read", stat->lookup == 0 ? 0 :
+			   (double)stat->disk.iterator.lookup / stat->lookup);
+	info_append_double(h, "space", last_level_bytes == 0 ? 0 :
+			   (double)total_bytes / last_level_bytes);
+	info_table_end(h);
+}
+
 static void
 vinyl_index_info(struct index *base, struct info_handler *h)
 {
@@ -438,6 +485,11 @@ vinyl_index_info(struct index *base, struct info_handler *h)
 	info_append_int(h, "hit", stat->disk.iterator.bloom_hit);
 	info_append_int(h, "miss", stat->disk.iterator.bloom_miss);
 	info_table_end(h);
+	info_table_begin(h, "page_cache");
+	info_append_int(h, "hit", stat->disk.iterator.page_cache_hit);
+	info_append_int(h, "miss", stat->disk.iterator.page_cache_miss);
+	info_table_end(h);
+	info_append_int(h, "skipped_pages", stat->disk.iterator.skipped_pages);
 	info_table_end(h);
 	vy_info_append_compact_stat(h, "dump", &stat->disk.dump);
 	vy_info_append_compact_stat(h, "compact", &stat->disk.compact);
@@ -470,6 +522,8 @@ vinyl_index_info(struct index *base, struct info_handler *h)
 	histogram_snprint(buf, sizeof(buf), index->run_hist);
 	info_append_str(h, "run_histogram", buf);
 
+	vy_info_append_amplification(h, index);
+
 	info_end(h);
 }
 
@@ -2859,6 +2913,12 @@ vinyl_engine_set_cache(struct vinyl_engine *vinyl, size_t quota)
 	vy_cache_env_set_quota(&vinyl->env->cache_env, quota);
 }
 
+void
+vinyl_engine_set_page_cache(struct vinyl_engine *vinyl, size_t quota)
+{
+	vy_run_env_set_page_cache_quota(&vinyl->env->run_env, quota);
+}
+
 void
 vinyl_engine_set_max_tuple_size(struct vinyl_engine *vinyl, size_t max_size)
 {
@@ -1029,6 +1029,7 @@ vy_index_split_range(struct vy_index *index, struct vy_range *range)
 				vy_range_add_slice(part, new_slice);
 		}
 		part->compact_priority = range->compact_priority;
+		part->compact_skip = range->compact_skip;
 	}
 
 	/*
@@ -1086,6 +1087,28 @@ fail:
 	return false;
 }
 
+/**
+ * Move run slices of @src to @dst keeping the slices of @dst
+ * sorted by the run dump LSN, newest first, as the time window
+ * compaction policy expects. Slices of either range are sorted
+ * that way already.
+ */
+static void
+vy_index_merge_slices(struct vy_range *dst, struct vy_range *src)
+{
+	struct rlist *pos = rlist_first(&dst->slices);
+	struct vy_slice *slice, *next_slice;
+	rlist_foreach_entry_safe(slice, &src->slices, in_range, next_slice) {
+		while (pos != &dst->slices &&
+		       rlist_entry(pos, struct vy_slice,
+				   in_range)->run->dump_lsn >=
+		       slice->run->dump_lsn)
+			pos = rlist_next(pos);
+		rlist_del_entry(slice, in_range);
+		rlist_add_tail(pos, &slice->in_range);
+	}
+}
+
 bool
 vy_index_coalesce_range(struct vy_index *index, struct vy_range *range)
 {
@@ -1132,7 +1155,11 @@ vy_index_coalesce_range(struct vy_index *index, struct vy_range *range)
 		struct vy_range *next = vy_range_tree_next(index->tree, it);
 		vy_index_unacct_range(index, it);
 		vy_index_remove_range(index, it);
-		rlist_splice(&result->slices, &it->slices);
+		if (index->opts.compaction_policy ==
+		    INDEX_COMPACTION_POLICY_TIME_WINDOW)
+			vy_index_merge_slices(result, it);
+		else
+			rlist_splice(&result->slices, &it->slices);
 		result->slice_count += it->slice_count;
 		vy_disk_stmt_counter_add(&result->count, &it->count);
 		vy_range_delete(it);
@@ -1142,9 +1169,17 @@ vy_index_coalesce_range(struct vy_index *index, struct vy_range *range)
 	 * Coalescing increases read amplification and breaks the log
 	 * structured layout of the run list, so, although we could
 	 * leave the resulting range as it is, we'd better compact it
-	 * as soon as we can.
+	 * as soon as we can. The time window policy is an exception:
+	 * compacting all runs would mix data of different windows,
+	 * so let the policy pick runs to compact.
 	 */
-	result->compact_priority = result->slice_count;
+	if (index->opts.compaction_policy ==
+	    INDEX_COMPACTION_POLICY_TIME_WINDOW) {
+		vy_range_update_compact_priority(result, &index->opts);
+	} else {
+		result->compact_priority = result->slice_count;
+		result->compact_skip = 0;
+	}
 	vy_index_acct_range(index, result);
 	vy_index_add_range(index, result);
 	index->range_tree_version++;
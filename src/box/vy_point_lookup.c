@@ -253,23 +253,11 @@ vy_point_lookup_scan_mems(struct vy_index *index,
  * was found.
  */
 static int
-vy_point_lookup_scan_slice(struct vy_index *index, struct vy_slice *slice,
-			   const struct vy_read_view **rv, struct tuple *key,
+vy_point_lookup_scan_slice(struct vy_run_iterator *run_itr,
 			   struct rlist *history, bool *terminal_found)
 {
-	int rc = 0;
-	/*
-	 * The format of the statement must be exactly the space
-	 * format with the same identifier to fully match the
-	 * format in vy_mem.
-	 */
-	struct vy_run_iterator run_itr;
-	vy_run_iterator_open(&run_itr, &index->stat.disk.iterator, slice,
-			     ITER_EQ, key, rv, index->cmp_def, index->key_def,
-			     index->disk_format, index->upsert_format,
-			     index->id == 0);
 	struct tuple *stmt;
-	rc = vy_run_iterator_next_key(&run_itr, &stmt);
+	int rc = vy_run_iterator_next_key(run_itr, &stmt);
 	while (rc == 0 && stmt != NULL) {
 		struct vy_stmt_history_node *node = vy_stmt_history_node_new();
 		if (node == NULL) {
@@ -284,9 +272,8 @@ vy_point_lookup_scan_slice(struct vy_index *index, struct vy_slice *slice,
 			*terminal_found = true;
 			break;
 		}
-		rc = vy_run_iterator_next_lsn(&run_itr, &stmt);
+		rc = vy_run_iterator_next_lsn(run_itr, &stmt);
 	}
-	vy_run_iterator_close(&run_itr);
 	return rc;
 }
 
@@ -295,6 +282,10 @@ vy_point_lookup_scan_slice(struct vy_index *index, struct vy_slice *slice,
  * Add found statements to the history list up to terminal statement.
  * All slices are pinned before first slice scan, so it's guaranteed
  * that complete history from runs will be extracted.
+ *
+ * Pages the slices are going to start from are read in one
+ * batch before scanning, so that the disk latency is paid
+ * once rather than once per run.
  */
 static int
 vy_point_lookup_scan_slices(struct vy_index *index,
@@ -312,19 +303,37 @@ vy_point_lookup_scan_slices(struct vy_index *index,
 			 "region", "slices array");
 		return -1;
 	}
+	struct vy_run_iterator *run_itrs = (struct vy_run_iterator *)
+		region_alloc(&fiber()->gc, slice_count * sizeof(*run_itrs));
+	if (run_itrs == NULL) {
+		diag_set(OutOfMemory, slice_count * sizeof(*run_itrs),
+			 "region", "run iterators array");
+		return -1;
+	}
 	int i = 0;
 	struct vy_slice *slice;
 	rlist_foreach_entry(slice, &range->slices, in_range) {
 		vy_slice_pin(slice);
-		slices[i++] = slice;
+		slices[i] = slice;
+		/*
+		 * The format of the statement must be exactly the
+		 * space format with the same identifier to fully
+		 * match the format in vy_mem.
+		 */
+		vy_run_iterator_open(&run_itrs[i], &index->stat.disk.iterator,
+				     slice, ITER_EQ, key, rv, index->cmp_def,
+				     index->key_def, index->disk_format,
+				     index->upsert_format, index->id == 0);
+		i++;
 	}
 	assert(i == slice_count);
-	int rc = 0;
+	int rc = vy_run_iterator_prefetch(run_itrs, slice_count);
 	bool terminal_found = false;
 	for (i = 0; i < slice_count; i++) {
 		if (rc == 0 && !terminal_found)
-			rc = vy_point_lookup_scan_slice(index, slices[i],
-					rv, key, history, &terminal_found);
+			rc = vy_point_lookup_scan_slice(&run_itrs[i],
+					history, &terminal_found);
+		vy_run_iterator_close(&run_itrs[i]);
 		vy_slice_unpin(slices[i]);
 	}
 	return rc;
@@ -282,17 +282,15 @@ vy_range_remove_slice(struct vy_range *range, struct vy_slice *slice)
  * ratio.
  *
  * Given a range, this function computes the maximal level that needs
- * to be compacted and sets @compact_priority to the number of runs in
- * this level and all preceding levels.
+ * to be compacted among the @max_run_count newest runs and returns
+ * the number of runs in this level and all preceding levels.
  */
-void
-vy_range_update_compact_priority(struct vy_range *range,
-				 const struct index_opts *opts)
+static int
+vy_range_compact_priority_tiered(struct vy_range *range,
+				 const struct index_opts *opts,
+				 int max_run_count)
 {
-	assert(opts->run_count_per_level > 0);
-	assert(opts->run_size_ratio > 1);
-
-	range->compact_priority = 0;
+	int compact_priority = 0;
 
 	/* Total number of checked runs. */
 	uint32_t total_run_count = 0;
@@ -312,6 +310,8 @@ vy_range_update_compact_priority(struct vy_range *range,
 
 	struct vy_slice *slice;
 	rlist_foreach_entry(slice, &range->slices, in_range) {
+		if ((int)total_run_count == max_run_count)
+			break;
 		uint64_t size = slice->count.bytes_compressed;
 		/*
 		 * The size of the first level is defined by
@@ -358,10 +358,121 @@ vy_range_update_compact_priority(struct vy_range *range,
 			 * for compaction. We compact all runs at
 			 * this level and upper levels.
 			 */
-			range->compact_priority = total_run_count;
+			compact_priority = total_run_count;
 			est_new_run_size = total_size;
 		}
 	}
+	return compact_priority;
+}
+
+/**
+ * Leveled compaction keeps at most one run per level, trading
+ * write amplification for lower read and space amplification.
+ * The newest run_count_per_level runs form the first level.
+ * Every older run must be run_size_ratio times larger than all
+ * runs newer than it taken together, otherwise it is compacted
+ * along with them. Returns the number of runs to compact.
+ */
+static int
+vy_range_compact_priority_leveled(struct vy_range *range,
+				  const struct index_opts *opts)
+{
+	int compact_priority = 0;
+	/* Total number of checked runs. */
+	int total_run_count = 0;
+	/* The total size of runs checked so far. */
+	uint64_t total_size = 0;
+
+	struct vy_slice *slice;
+	rlist_foreach_entry(slice, &range->slices, in_range) {
+		uint64_t size = slice->count.bytes_compressed;
+		total_run_count++;
+		if (total_run_count > opts->run_count_per_level &&
+		    size < total_size * opts->run_size_ratio)
+			compact_priority = total_run_count;
+		total_size += size;
+	}
+	return compact_priority;
+}
+
+/**
+ * Time window compaction is meant for data that is only
+ * appended and expires with time, e.g. time series. Runs are
+ * grouped by the time window their data was dumped in, and
+ * runs of different windows are never compacted together,
+ * so that the data of an old window is rewritten only once
+ * after the window is closed.
+ *
+ * A window is considered closed as soon as a run of a newer
+ * window is dumped. If a closed window has more than one run,
+ * we compact them into one. Otherwise we compact runs of the
+ * newest window following the tiered policy.
+ */
+static void
+vy_range_update_compact_priority_time_window(struct vy_range *range,
+					     const struct index_opts *opts)
+{
+	assert(opts->compaction_time_window > 0);
+
+	/* Window of the group of runs checked so far. */
+	int64_t window = -1;
+	/* Number of runs in the current window. */
+	int window_run_count = 0;
+	/* Number of runs newer than the current window. */
+	int skip = 0;
+	/* Number of runs in the newest window. */
+	int newest_run_count = -1;
+
+	struct vy_slice *slice;
+	rlist_foreach_entry(slice, &range->slices, in_range) {
+		int64_t slice_window = slice->run->info.dump_time /
+				       opts->compaction_time_window;
+		if (window_run_count > 0 && slice_window != window) {
+			/* Switch to an older window. */
+			if (newest_run_count < 0)
+				newest_run_count = window_run_count;
+			else if (window_run_count > 1)
+				break;
+			skip += window_run_count;
+			window_run_count = 0;
+		}
+		window = slice_window;
+		window_run_count++;
+	}
+	if (newest_run_count >= 0 && window_run_count > 1) {
+		/* Compact all runs of a closed window. */
+		range->compact_skip = skip;
+		range->compact_priority = window_run_count;
+		return;
+	}
+	if (newest_run_count < 0)
+		newest_run_count = window_run_count;
+	range->compact_priority = vy_range_compact_priority_tiered(range,
+					opts, newest_run_count);
+}
+
+void
+vy_range_update_compact_priority(struct vy_range *range,
+				 const struct index_opts *opts)
+{
+	assert(opts->run_count_per_level > 0);
+	assert(opts->run_size_ratio > 1);
+
+	range->compact_skip = 0;
+	switch (opts->compaction_policy) {
+	case INDEX_COMPACTION_POLICY_LEVELED:
+		range->compact_priority =
+			vy_range_compact_priority_leveled(range, opts);
+		break;
+	case INDEX_COMPACTION_POLICY_TIME_WINDOW:
+		vy_range_update_compact_priority_time_window(range, opts);
+		break;
+	default:
+		range->compact_priority =
+			vy_range_compact_priority_tiered(range, opts,
+							 range->slice_count);
+		break;
+	}
 }
 
 /**
@@ -106,6 +106,12 @@ struct vy_range {
 	 * how we  decide how many runs to compact next time.
 	 */
 	int compact_priority;
+	/**
+	 * Number of the newest runs to leave out of the next
+	 * compaction of this range. May only be non-zero if the
+	 * index uses the time window compaction policy.
+	 */
+	int compact_skip;
 	/** Number of times the range was compacted. */
 	int n_compactions;
 	/** Link in vy_index->tree. */
@@ -749,6 +749,18 @@ vy_read_iterator_add_disk(struct vy_read_iterator *itr)
 		if (slice->run->info.min_lsn > index->dump_lsn)
 			continue;
 		assert(slice->run->info.max_lsn <= index->dump_lsn);
+		/*
+		 * Don't bother opening a run that can't have
+		 * statements matching an equality key according
+		 * to its (full or prefix) bloom filter.
+		 */
+		if ((itr->iterator_type == ITER_EQ ||
+		     itr->iterator_type == ITER_REQ) &&
+		    !vy_run_bloom_may_have(slice->run, index->key_def,
+					   itr->key)) {
+			index->stat.disk.iterator.bloom_hit++;
+			continue;
+		}
 		struct vy_read_src *sub_src = vy_read_iterator_add_src(itr);
 		vy_run_iterator_open(&sub_src->run_iterator,
 				     &index->stat.disk.iterator, slice,
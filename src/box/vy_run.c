@@ -36,6 +36,7 @@
 #include "fiber_cond.h"
 #include "fio.h"
 #include "cbus.h"
+#include "evio_uring.h"
 #include "memory.h"
 #include "coio_file.h"
 
@@ -81,8 +82,19 @@ struct vy_run_reader {
 	struct cpipe reader_pipe;
 	/** Pipe from the reader thread to tx. */
 	struct cpipe tx_pipe;
+	/**
+	 * Ring used for reading pages of a batch asynchronously,
+	 * see vy_run_iterator_prefetch(). Set up by the reader
+	 * thread before it starts accepting requests.
+	 */
+	struct evio_uring ring;
+	/** True if io_uring is available and @ring is usable. */
+	bool has_ring;
 };
 
+/** Max number of page reads a reader thread keeps in flight. */
+enum { VY_RUN_READER_RING_SIZE = 256 };
+
 /** Cbus task for vinyl page read. */
 struct vy_page_read_task {
 	/** parent */
@@ -95,6 +107,168 @@ struct vy_page_read_task {
 	struct vy_page *page;
 };
 
+/** Key of a page in the page cache. */
+struct vy_page_cache_key {
+	/** ID of the run the page belongs to. */
+	int64_t run_id;
+	/** Page position in the run file. */
+	uint32_t page_no;
+};
+
+static inline uint32_t
+vy_page_cache_hash(int64_t run_id, uint32_t page_no)
+{
+	uint64_t h = (uint64_t)run_id * 0x9E3779B97F4A7C15ULL ^ page_no;
+	return (uint32_t)(h ^ (h >> 32));
+}
+
+#define mh_name _vy_page_cache
+#define mh_key_t const struct vy_page_cache_key *
+#define mh_node_t struct vy_page *
+#define mh_arg_t void *
+#define mh_hash(a, arg) vy_page_cache_hash((*(a))->run_id, (*(a))->page_no)
+#define mh_hash_key(a, arg) vy_page_cache_hash((a)->run_id, (a)->page_no)
+#define mh_cmp(a, b, arg) ((*(a))->run_id != (*(b))->run_id || \
+			   (*(a))->page_no != (*(b))->page_no)
+#define mh_cmp_key(a, b, arg) ((a)->run_id != (*(b))->run_id || \
+			       (a)->page_no != (*(b))->page_no)
+#define MH_SOURCE 1
+#include "salad/mhash.h"
+
+static void
+vy_page_delete(struct vy_page *page);
+
+static void
+vy_page_cache_create(struct vy_page_cache *cache)
+{
+	cache->hash = mh_vy_page_cache_new();
+	if (cache->hash == NULL)
+		panic("failed to allocate vinyl page cache");
+	rlist_create(&cache->lru);
+	cache->page_count = 0;
+	cache->mem_used = 0;
+	cache->mem_quota = 0;
+}
+
+/** Size of memory occupied by a page. */
+static inline size_t
+vy_page_mem_size(const struct vy_page *page)
+{
+	return sizeof(*page) + page->unpacked_size +
+	       page->row_count * sizeof(uint32_t);
+}
+
+static inline void
+vy_page_ref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	page->refs++;
+}
+
+static inline void
+vy_page_unref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	if (--page->refs == 0)
+		vy_page_delete(page);
+}
+
+/** Remove a page from the cache and drop the cache reference. */
+static void
+vy_page_cache_remove(struct vy_page_cache *cache, struct vy_page *page,
+		     mh_int_t k)
+{
+	mh_vy_page_cache_del(cache->hash, k, NULL);
+	rlist_del_entry(page, in_lru);
+	assert(cache->page_count > 0);
+	assert(cache->mem_used >= vy_page_mem_size(page));
+	cache->page_count--;
+	cache->mem_used -= vy_page_mem_size(page);
+	vy_page_unref(page);
+}
+
+/** Evict the least recently used pages until they fit in @quota. */
+static void
+vy_page_cache_evict(struct vy_page_cache *cache, size_t quota)
+{
+	while (cache->mem_used > quota) {
+		struct vy_page *page = rlist_last_entry(&cache->lru,
+							struct vy_page, in_lru);
+		struct vy_page_cache_key key = { page->run_id, page->page_no };
+		mh_int_t k = mh_vy_page_cache_find(cache->hash, &key, NULL);
+		assert(k != mh_end(cache->hash));
+		vy_page_cache_remove(cache, page, k);
+	}
+}
+
+static void
+vy_page_cache_destroy(struct vy_page_cache *cache)
+{
+	vy_page_cache_evict(cache, 0);
+	assert(cache->page_count == 0);
+	mh_vy_page_cache_delete(cache->hash);
+}
+
+/**
+ * Look up a page in the cache. The page is not referenced,
+ * the caller must do it if it is going to keep the page.
+ */
+static struct vy_page *
+vy_page_cache_get(struct vy_page_cache *cache, int64_t run_id,
+		  uint32_t page_no)
+{
+	if (cache->page_count == 0)
+		return NULL;
+	struct vy_page_cache_key key = { run_id, page_no };
+	mh_int_t k = mh_vy_page_cache_find(cache->hash, &key, NULL);
+	if (k == mh_end(cache->hash))
+		return NULL;
+	struct vy_page *page = *mh_vy_page_cache_node(cache->hash, k);
+	rlist_move_entry(&cache->lru, page, in_lru);
+	return page;
+}
+
+/** Add a page that has just been read from disk to the cache. */
+static void
+vy_page_cache_put(struct vy_page_cache *cache, struct vy_page *page)
+{
+	size_t size = vy_page_mem_size(page);
+	if (size > cache->mem_quota)
+		return;
+	struct vy_page_cache_key key = { page->run_id, page->page_no };
+	if (mh_vy_page_cache_find(cache->hash, &key, NULL) !=
+	    mh_end(cache->hash)) {
+		/* Another fiber read the page concurrently. */
+		return;
+	}
+	if (mh_vy_page_cache_put(cache->hash, &page, NULL, NULL) ==
+	    mh_end(cache->hash)) {
+		/* Out of memory, leave the page uncached. */
+		return;
+	}
+	vy_page_ref(page);
+	rlist_add_entry(&cache->lru, page, in_lru);
+	cache->page_count++;
+	cache->mem_used += size;
+	vy_page_cache_evict(cache, cache->mem_quota);
+}
+
+/** Drop all cached pages of a run. */
+static void
+vy_page_cache_evict_run(struct vy_page_cache *cache, struct vy_run *run)
+{
+	for (uint32_t page_no = 0; page_no < run->info.page_count &&
+	     cache->page_count > 0; page_no++) {
+		struct vy_page_cache_key key = { run->id, page_no };
+		mh_int_t k = mh_vy_page_cache_find(cache->hash, &key, NULL);
+		if (k != mh_end(cache->hash)) {
+			struct vy_page *page =
+				*mh_vy_page_cache_node(cache->hash, k);
+			vy_page_cache_remove(cache, page, k);
+		}
+	}
+}
+
 /** Destructor for env->zdctx_key thread-local variable */
 static void
 vy_free_zdctx(void *arg)
@@ -111,10 +285,20 @@ vy_run_reader_f(va_list ap)
 	struct cbus_endpoint endpoint;
 
 	cpipe_create(&reader->tx_pipe, "tx_prio");
+	/*
+	 * Fall back on blocking reads if the system doesn't
+	 * support io_uring.
+	 */
+	reader->has_ring = evio_uring_create(&reader->ring, loop(),
+					     VY_RUN_READER_RING_SIZE) == 0;
+	if (!reader->has_ring)
+		diag_clear(diag_get());
 	cbus_endpoint_create(&endpoint, cord_name(cord()),
 			     fiber_schedule_cb, fiber());
 	cbus_loop(&endpoint);
 	cbus_endpoint_destroy(&endpoint, cbus_process);
+	if (reader->has_ring)
+		evio_uring_destroy(&reader->ring);
 	cpipe_destroy(&reader->tx_pipe);
 	return 0;
 }
@@ -170,6 +354,7 @@ vy_run_env_create(struct vy_run_env *env)
 	tt_pthread_key_create(&env->zdctx_key, vy_free_zdctx);
 	mempool_create(&env->read_task_pool, cord_slab_cache(),
 		       sizeof(struct vy_page_read_task));
+	vy_page_cache_create(&env->page_cache);
 }
 
 /**
@@ -180,6 +365,7 @@ vy_run_env_destroy(struct vy_run_env *env)
 {
 	if (env->reader_pool != NULL)
 		vy_run_env_stop_readers(env);
+	vy_page_cache_destroy(&env->page_cache);
 	mempool_destroy(&env->read_task_pool);
 	tt_pthread_key_delete(env->zdctx_key);
 }
@@ -195,6 +381,13 @@ vy_run_env_enable_coio(struct vy_run_env *env, int threads)
 	vy_run_env_start_readers(env, threads);
 }
 
+void
+vy_run_env_set_page_cache_quota(struct vy_run_env *env, size_t quota)
+{
+	env->page_cache.mem_quota = quota;
+	vy_page_cache_evict(&env->page_cache, quota);
+}
+
 /**
  * Initialize page info struct
  *
@@ -220,6 +413,8 @@ vy_page_info_destroy(struct vy_page_info *page_info)
 {
 	if (page_info->min_key != NULL)
 		free(page_info->min_key);
+	if (page_info->max_key != NULL)
+		free(page_info->max_key);
 }
 
 struct vy_run *
@@ -257,6 +452,9 @@ vy_run_clear(struct vy_run *run)
 	if (run->info.has_bloom)
 		bloom_destroy(&run->info.bloom, runtime.quota);
 	run->info.has_bloom = false;
+	if (run->info.bloom_prefix_parts > 0)
+		bloom_destroy(&run->info.prefix_bloom, runtime.quota);
+	run->info.bloom_prefix_parts = 0;
 	free(run->info.min_key);
 	run->info.min_key = NULL;
 	free(run->info.max_key);
@@ -269,6 +467,8 @@ vy_run_delete(struct vy_run *run)
 	assert(run->refs == 0);
 	if (run->fd >= 0 && close(run->fd) < 0)
 		say_syserror("close failed");
+	if (run->env != NULL)
+		vy_page_cache_evict_run(&run->env->page_cache, run);
 	vy_run_clear(run);
 	TRASH(run);
 	free(run);
@@ -356,6 +556,48 @@ vy_page_index_find_page(struct vy_run *run, const struct tuple *key,
 	return page;
 }
 
+/**
+ * Check if a forward search for the given key may skip the page
+ * returned by vy_page_index_find_page(), because all statements
+ * stored in the page are less than the key according to the
+ * page's max key. If so, advance *page_no and return true.
+ * Runs written without max keys are never skipped.
+ */
+static bool
+vy_page_index_skip_page(struct vy_run *run, const struct tuple *key,
+			const struct key_def *cmp_def,
+			enum iterator_type itype, uint32_t *page_no)
+{
+	if (iterator_direction(itype) < 0 ||
+	    *page_no >= run->info.page_count ||
+	    tuple_field_count(key) == 0)
+		return false;
+	struct vy_page_info *info = vy_run_page_info(run, *page_no);
+	if (info->max_key == NULL)
+		return false;
+	int cmp = vy_stmt_compare_with_raw_key(key, info->max_key, cmp_def);
+	if (cmp < 0 || (cmp == 0 && itype != ITER_GT))
+		return false;
+	++*page_no;
+	return true;
+}
+
+/**
+ * Return true if a forward search for the given key can't find
+ * anything starting from the given page. This is the case when
+ * the page's min key is greater than the key of an EQ iterator.
+ */
+static bool
+vy_page_index_eq_page_is_empty(struct vy_run *run, const struct tuple *key,
+			       const struct key_def *cmp_def,
+			       enum iterator_type itype, uint32_t page_no)
+{
+	if (itype != ITER_EQ || page_no >= run->info.page_count)
+		return false;
+	struct vy_page_info *info = vy_run_page_info(run, page_no);
+	return vy_stmt_compare_with_raw_key(key, info->min_key, cmp_def) != 0;
+}
+
 struct vy_slice *
 vy_slice_new(int64_t id, struct vy_run *run,
 	     struct tuple *begin, struct tuple *end,
@@ -514,6 +756,13 @@ vy_page_info_decode(struct vy_page_info *page, const struct xrow_header *xrow,
 		case VY_PAGE_INFO_ROW_INDEX_OFFSET:
 			page->row_index_offset = mp_decode_uint(&pos);
 			break;
+		case VY_PAGE_INFO_MAX_KEY:
+			key_beg = pos;
+			mp_next(&pos);
+			page->max_key = vy_key_dup(key_beg);
+			if (page->max_key == NULL)
+				return -1;
+			break;
 		default:
 			diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
 				 tt_sprintf("Can't decode page info: "
@@ -580,6 +829,35 @@ vy_run_bloom_decode(struct bloom *bloom, const char **buffer,
 	return 0;
 }
 
+/**
+ * Read the prefix bloom filter of a run: the number of key
+ * parts in the prefix followed by the filter itself.
+ */
+static int
+vy_run_prefix_bloom_decode(struct vy_run_info *run_info, const char **pos,
+			   const char *filename)
+{
+	uint32_t array_size = mp_decode_array(pos);
+	if (array_size != 2) {
+		diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
+			 tt_sprintf("Can't decode prefix bloom meta: "
+				    "wrong array size (expected %d, got %u)",
+				    2, (unsigned)array_size));
+		return -1;
+	}
+	uint32_t part_count = mp_decode_uint(pos);
+	if (part_count == 0) {
+		diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
+			 "Can't decode prefix bloom meta: "
+			 "zero prefix part count");
+		return -1;
+	}
+	if (vy_run_bloom_decode(&run_info->prefix_bloom, pos, filename) != 0)
+		return -1;
+	run_info->bloom_prefix_parts = part_count;
+	return 0;
+}
+
 /**
  * Decode the run metadata from xrow.
  *
@@ -638,6 +916,14 @@ vy_run_info_decode(struct vy_run_info *run_info,
 			else
 				return -1;
 			break;
+		case VY_RUN_INFO_PREFIX_BLOOM:
+			if (vy_run_prefix_bloom_decode(run_info, &pos,
+						       filename) != 0)
+				return -1;
+			break;
+		case VY_RUN_INFO_DUMP_TIME:
+			run_info->dump_time = mp_decode_double(&pos);
+			break;
 		default:
 			diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
 				"Can't decode run info: unknown key %u",
@@ -665,6 +951,10 @@ vy_page_new(const struct vy_page_info *page_info)
 			 "load_page", "page cache");
 		return NULL;
 	}
+	page->run_id = -1;
+	page->page_no = 0;
+	page->refs = 1;
+	rlist_create(&page->in_lru);
 	page->unpacked_size = page_info->unpacked_size;
 	page->row_count = page_info->row_count;
 	page->row_index = calloc(page_info->row_count, sizeof(uint32_t));
@@ -750,9 +1040,9 @@ vy_run_iterator_stop(struct vy_run_iterator *itr)
 		itr->curr_stmt = NULL;
 	}
 	if (itr->curr_page != NULL) {
-		vy_page_delete(itr->curr_page);
+		vy_page_unref(itr->curr_page);
 		if (itr->prev_page != NULL)
-			vy_page_delete(itr->prev_page);
+			vy_page_unref(itr->prev_page);
 		itr->curr_page = itr->prev_page = NULL;
 	}
 	itr->search_ended = true;
@@ -800,24 +1090,23 @@ vy_run_filename(struct vy_run *run)
 }
 
 /**
- * Read a page requests from vinyl xlog data file.
+ * Check the result of reading a page from vinyl xlog data file
+ * and decode the page: decompress the rows and load the row
+ * index. Errors are logged.
+ *
+ * @param data    Page data read from the file.
+ * @param readen  Result of the read: number of bytes read or
+ *                -1 with errno set.
  *
  * @retval 0 on success
  * @retval -1 on error, check diag
  */
 static int
-vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
-	     struct vy_run *run, ZSTD_DStream *zdctx)
+vy_page_read_complete(struct vy_page *page,
+		      const struct vy_page_info *page_info,
+		      struct vy_run *run, const char *data, ssize_t readen,
+		      ZSTD_DStream *zdctx)
 {
-	/* read xlog tx from xlog file */
-	size_t region_svp = region_used(&fiber()->gc);
-	char *data = (char *)region_alloc(&fiber()->gc, page_info->size);
-	if (data == NULL) {
-		diag_set(OutOfMemory, page_info->size, "region gc", "page");
-		return -1;
-	}
-	ssize_t readen = fio_pread(run->fd, data, page_info->size,
-				   page_info->offset);
 	ERROR_INJECT(ERRINJ_VYRUN_DATA_READ, {
 		readen = -1;
 		errno = EIO;});
@@ -854,13 +1143,11 @@ vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
 	}
 	if (vy_row_index_decode(page->row_index, page->row_count, &xrow) != 0)
 		goto error;
-	region_truncate(&fiber()->gc, region_svp);
 	ERROR_INJECT(ERRINJ_VY_READ_PAGE, {
 		diag_set(ClientError, ER_INJECTION, "vinyl page read");
 		return -1;});
 	return 0;
 error:
-	region_truncate(&fiber()->gc, region_svp);
 	diag_log();
 	say_error("error reading %s@%llu:%u", vy_run_filename(run),
 		  (unsigned long long)page_info->offset,
@@ -868,6 +1155,31 @@ error:
 	return -1;
 }
 
+/**
+ * Read a page requests from vinyl xlog data file.
+ *
+ * @retval 0 on success
+ * @retval -1 on error, check diag
+ */
+static int
+vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
+	     struct vy_run *run, ZSTD_DStream *zdctx)
+{
+	/* read xlog tx from xlog file */
+	size_t region_svp = region_used(&fiber()->gc);
+	char *data = (char *)region_alloc(&fiber()->gc, page_info->size);
+	if (data == NULL) {
+		diag_set(OutOfMemory, page_info->size, "region gc", "page");
+		return -1;
+	}
+	ssize_t readen = fio_pread(run->fd, data, page_info->size,
+				   page_info->offset);
+	int rc = vy_page_read_complete(page, page_info, run, data,
+				       readen, zdctx);
+	region_truncate(&fiber()->gc, region_svp);
+	return rc;
+}
+
 /**
  * Get thread local zstd decompression context
  */
@@ -912,9 +1224,23 @@ vy_page_read_cb_free(struct cbus_call_msg *base)
 	return 0;
 }
 
+/** Account a page read from disk to iterator statistics. */
+static inline void
+vy_run_iterator_acct_read(struct vy_run_iterator *itr,
+			  const struct vy_page_info *page_info)
+{
+	itr->stat->read.rows += page_info->row_count;
+	itr->stat->read.bytes += page_info->unpacked_size;
+	itr->stat->read.bytes_compressed += page_info->size;
+	itr->stat->read.pages++;
+	itr->stat->page_cache_miss++;
+}
+
 /**
  * Read a page from disk given its number.
- * The function caches two most recently read pages.
+ * The function caches two most recently read pages and looks
+ * up pages in the page cache shared by all iterators before
+ * reading them from disk.
  *
  * @retval 0 success
  * @retval -1 critical error
@@ -940,9 +1266,18 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 		}
 	}
 
+	/* Check the page cache */
+	struct vy_page *page = vy_page_cache_get(&env->page_cache,
+						 slice->run->id, page_no);
+	if (page != NULL) {
+		vy_page_ref(page);
+		itr->stat->page_cache_hit++;
+		goto done;
+	}
+
 	/* Allocate buffers */
 	struct vy_page_info *page_info = vy_run_page_info(slice->run, page_no);
-	struct vy_page *page = vy_page_new(page_info);
+	page = vy_page_new(page_info);
 	if (page == NULL)
 		return -1;
 
@@ -998,23 +1333,200 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 		}
 	}
 
+	page->run_id = slice->run->id;
+	page->page_no = page_no;
+	vy_page_cache_put(&env->page_cache, page);
+	vy_run_iterator_acct_read(itr, page_info);
+done:
 	/* Update cache */
 	if (itr->prev_page != NULL)
-		vy_page_delete(itr->prev_page);
+		vy_page_unref(itr->prev_page);
 	itr->prev_page = itr->curr_page;
 	itr->curr_page = page;
-	page->page_no = page_no;
-
-	/* Update read statistics. */
-	itr->stat->read.rows += page_info->row_count;
-	itr->stat->read.bytes += page_info->unpacked_size;
-	itr->stat->read.bytes_compressed += page_info->size;
-	itr->stat->read.pages++;
 
 	*result = page;
 	return 0;
 }
 
+/* {{{ Batched page reads */
+
+struct vy_page_read_batch_msg;
+
+/** A page read issued as a part of a batch. */
+struct vy_page_read_req {
+	/** io_uring request. */
+	struct evio_uring_req base;
+	/** Link in vy_page_read_batch_msg::reqs. */
+	struct stailq_entry in_msg;
+	/** Link in vy_page_read_batch_msg::completed. */
+	struct stailq_entry in_completed;
+	/** Message the request was sent with. */
+	struct vy_page_read_batch_msg *msg;
+	/** Iterator the page is read for. */
+	struct vy_run_iterator *itr;
+	/** Run to read the page from. */
+	struct vy_run *run;
+	/** Page number and metadata. */
+	uint32_t page_no;
+	const struct vy_page_info *page_info;
+	/** [out] Resulting page. */
+	struct vy_page *page;
+	/** Buffer for raw page data, allocated by the reader. */
+	char *data;
+	/** Number of bytes read or -errno. */
+	int res;
+};
+
+/** Page reads of a batch handed over to one reader thread. */
+struct vy_page_read_batch_msg {
+	struct cmsg base;
+	/** tx -> reader -> tx */
+	struct cmsg_hop route[2];
+	/** Reader thread the message is sent to. */
+	struct vy_run_reader *reader;
+	/** Batch the message belongs to. */
+	struct vy_page_read_batch *batch;
+	/** Reads to process, linked by in_msg. */
+	struct stailq reqs;
+	/** Reads completed, but not decoded yet, linked by in_completed. */
+	struct stailq completed;
+	/** Number of reads submitted, but not completed yet. */
+	int inflight;
+	/** Reader fiber processing the message. */
+	struct fiber *fiber;
+	/** Result of the message, diag is set on failure. */
+	int rc;
+	struct diag diag;
+};
+
+/** Page reads of a point lookup sent to reader threads at once. */
+struct vy_page_read_batch {
+	/** Number of messages that haven't returned yet. */
+	int pending;
+	/** Fiber waiting for the batch to complete. */
+	struct fiber *fiber;
+};
+
+/** io_uring read completion callback. */
+static void
+vy_page_read_req_complete_cb(struct evio_uring_req *base, int res)
+{
+	struct vy_page_read_req *req = container_of(base,
+					struct vy_page_read_req, base);
+	struct vy_page_read_batch_msg *msg = req->msg;
+	req->res = res;
+	assert(msg->inflight > 0);
+	msg->inflight--;
+	stailq_add_tail_entry(&msg->completed, req, in_completed);
+	fiber_wakeup(msg->fiber);
+}
+
+/** Decode a page of a completed read. */
+static int
+vy_page_read_req_decode(struct vy_page_read_req *req, ZSTD_DStream *zdctx)
+{
+	const struct vy_page_info *page_info = req->page_info;
+	ssize_t readen = req->res;
+	if (readen < 0) {
+		errno = -req->res;
+		readen = -1;
+	} else if (readen < (ssize_t)page_info->size) {
+		/* Short read, read the rest synchronously. */
+		ssize_t rc = fio_pread(req->run->fd, req->data + readen,
+				       page_info->size - readen,
+				       page_info->offset + readen);
+		readen = rc < 0 ? rc : readen + rc;
+	}
+	return vy_page_read_complete(req->page, page_info, req->run,
+				     req->data, readen, zdctx);
+}
+
+/**
+ * Process page reads of a batch in a reader thread: submit all
+ * of them to the ring at once, then decompress pages as reads
+ * complete. Without io_uring, pages are read one by one.
+ */
+static void
+vy_page_read_batch_perform(struct cmsg *base)
+{
+	struct vy_page_read_batch_msg *msg =
+		(struct vy_page_read_batch_msg *)base;
+	struct vy_run_reader *reader = msg->reader;
+	size_t region_svp = region_used(&fiber()->gc);
+	struct vy_page_read_req *req;
+
+	msg->fiber = fiber();
+	msg->inflight = 0;
+	stailq_create(&msg->completed);
+
+	int rc = 0;
+	req = stailq_first_entry(&msg->reqs, struct vy_page_read_req, in_msg);
+	ZSTD_DStream *zdctx = vy_env_get_zdctx(req->run->env);
+	if (zdctx == NULL) {
+		rc = -1;
+		goto out;
+	}
+	stailq_foreach_entry(req, &msg->reqs, in_msg) {
+		const struct vy_page_info *page_info = req->page_info;
+		req->msg = msg;
+		req->base.cb = vy_page_read_req_complete_cb;
+		req->data = region_alloc(&fiber()->gc, page_info->size);
+		if (req->data == NULL) {
+			diag_set(OutOfMemory, page_info->size,
+				 "region gc", "page");
+			rc = -1;
+			break;
+		}
+		if (reader->has_ring &&
+		    evio_uring_pread(&reader->ring, &req->base, req->run->fd,
+				     req->data, page_info->size,
+				     page_info->offset) == 0) {
+			msg->inflight++;
+			continue;
+		}
+		/* No io_uring or the ring is full. */
+		ssize_t readen = fio_pread(req->run->fd, req->data,
+					   page_info->size, page_info->offset);
+		req->res = readen >= 0 ? readen : -errno;
+		stailq_add_tail_entry(&msg->completed, req, in_completed);
+	}
+	if (msg->inflight > 0)
+		evio_uring_submit(&reader->ring);
+	/*
+	 * Wait for all submitted reads even on error, because
+	 * the kernel writes to the region memory.
+	 */
+	while (msg->inflight > 0 || !stailq_empty(&msg->completed)) {
+		if (stailq_empty(&msg->completed)) {
+			fiber_yield();
+			continue;
+		}
+		req = stailq_shift_entry(&msg->completed,
+					 struct vy_page_read_req, in_completed);
+		if (rc == 0 && vy_page_read_req_decode(req, zdctx) != 0)
+			rc = -1;
+	}
+	region_truncate(&fiber()->gc, region_svp);
+out:
+	msg->rc = rc;
+	if (rc != 0)
+		diag_move(diag_get(), &msg->diag);
+}
+
+/** Wake up the fiber waiting for the batch when it's done. */
+static void
+vy_page_read_batch_complete(struct cmsg *base)
+{
+	struct vy_page_read_batch_msg *msg =
+		(struct vy_page_read_batch_msg *)base;
+	struct vy_page_read_batch *batch = msg->batch;
+	assert(batch->pending > 0);
+	if (--batch->pending == 0)
+		fiber_wakeup(batch->fiber);
+}
+
+/* }}} Batched page reads */
+
 /**
  * Read key and lsn by a given wide position.
  * For the first record in a page reads the result from the page
@@ -1092,10 +1604,18 @@ vy_run_iterator_search(struct vy_run_iterator *itr,
 		       const struct tuple *key,
 		       struct vy_run_iterator_pos *pos, bool *equal_key)
 {
-	pos->page_no = vy_page_index_find_page(itr->slice->run, key,
-					       itr->cmp_def, iterator_type,
-					       equal_key);
-	if (pos->page_no == itr->slice->run->info.page_count) {
+	struct vy_run *run = itr->slice->run;
+	pos->page_no = vy_page_index_find_page(run, key, itr->cmp_def,
+					       iterator_type, equal_key);
+	if (vy_page_index_skip_page(run, key, itr->cmp_def,
+				    iterator_type, &pos->page_no)) {
+		itr->stat->skipped_pages++;
+		if (vy_page_index_eq_page_is_empty(run, key, itr->cmp_def,
+						   iterator_type,
+						   pos->page_no))
+			pos->page_no = run->info.page_count;
+	}
+	if (pos->page_no == run->info.page_count) {
 		itr->search_ended = true;
 		return 0;
 	}
@@ -1116,6 +1636,37 @@ vy_run_iterator_search(struct vy_run_iterator *itr,
 	return 0;
 }
 
+/**
+ * Return true if the iterator can't find anything in the given
+ * page, which is next to the current one in the iteration order,
+ * so there's no point in loading it. For forward iteration this
+ * is the case when the page's min key is greater than the key of
+ * an EQ iterator or not less than the slice end. For backward
+ * iteration, when the page's max key is less than the slice begin.
+ */
+static bool
+vy_run_iterator_page_is_out_of_range(struct vy_run_iterator *itr,
+				     enum iterator_type iterator_type,
+				     uint32_t page_no)
+{
+	struct vy_slice *slice = itr->slice;
+	struct vy_page_info *page_info = vy_run_page_info(slice->run,
+							  page_no);
+	if (iterator_type == ITER_LE || iterator_type == ITER_LT) {
+		return slice->begin != NULL && page_info->max_key != NULL &&
+		       vy_stmt_compare_with_raw_key(slice->begin,
+						    page_info->max_key,
+						    itr->cmp_def) > 0;
+	}
+	if (iterator_type == ITER_EQ &&
+	    vy_stmt_compare_with_raw_key(itr->key, page_info->min_key,
+					 itr->cmp_def) != 0)
+		return true;
+	return slice->end != NULL &&
+	       vy_stmt_compare_with_raw_key(slice->end, page_info->min_key,
+					    itr->cmp_def) <= 0;
+}
+
 /**
  * Increment (or decrement, depending on the order) the current
  * wide position.
@@ -1138,6 +1689,11 @@ vy_run_iterator_next_pos(struct vy_run_iterator *itr,
 			if (pos->page_no == 0)
 				return 1;
 			pos->page_no--;
+			if (vy_run_iterator_page_is_out_of_range(itr,
+					iterator_type, pos->page_no)) {
+				itr->stat->skipped_pages++;
+				return 1;
+			}
 			struct vy_page_info *page_info =
 				vy_run_page_info(run, pos->page_no);
 			assert(page_info->row_count > 0);
@@ -1156,6 +1712,11 @@ vy_run_iterator_next_pos(struct vy_run_iterator *itr,
 			pos->pos_in_page = 0;
 			if (pos->page_no == run->info.page_count)
 				return 1;
+			if (vy_run_iterator_page_is_out_of_range(itr,
+					iterator_type, pos->page_no)) {
+				itr->stat->skipped_pages++;
+				return 1;
+			}
 		}
 	}
 	return 0;
@@ -1244,6 +1805,43 @@ vy_run_iterator_find_lsn(struct vy_run_iterator *itr,
 	return 0;
 }
 
+/**
+ * Return true if the run has a bloom filter suitable for
+ * looking up @key, see vy_run_bloom_may_have().
+ */
+static inline bool
+vy_run_has_bloom_for(struct vy_run *run, const struct key_def *key_def,
+		     const struct tuple *key)
+{
+	uint32_t part_count = tuple_field_count(key);
+	if (part_count >= key_def->part_count)
+		return run->info.has_bloom;
+	return run->info.bloom_prefix_parts > 0 &&
+	       part_count >= run->info.bloom_prefix_parts;
+}
+
+bool
+vy_run_bloom_may_have(struct vy_run *run, const struct key_def *key_def,
+		      const struct tuple *key)
+{
+	if (!vy_run_has_bloom_for(run, key_def, key))
+		return true;
+	bool is_full_key = tuple_field_count(key) >= key_def->part_count;
+	uint32_t prefix_parts = run->info.bloom_prefix_parts;
+	uint32_t hash;
+	if (vy_stmt_type(key) == IPROTO_SELECT) {
+		const char *data = tuple_data(key);
+		mp_decode_array(&data);
+		hash = is_full_key ? key_hash(data, key_def) :
+		       key_hash_prefix(data, key_def, prefix_parts);
+	} else {
+		hash = is_full_key ? tuple_hash(key, key_def) :
+		       tuple_hash_prefix(key, key_def, prefix_parts);
+	}
+	return bloom_possible_has(is_full_key ? &run->info.bloom :
+				  &run->info.prefix_bloom, hash);
+}
+
 static NODISCARD int
 vy_run_iterator_do_seek(struct vy_run_iterator *itr,
 			enum iterator_type iterator_type,
@@ -1254,21 +1852,12 @@ vy_run_iterator_do_seek(struct vy_run_iterator *itr,
 	*ret = NULL;
 
 	const struct key_def *key_def = itr->key_def;
-	bool is_full_key = (tuple_field_count(key) >= key_def->part_count);
-	if (run->info.has_bloom && iterator_type == ITER_EQ && is_full_key) {
-		uint32_t hash;
-		if (vy_stmt_type(key) == IPROTO_SELECT) {
-			const char *data = tuple_data(key);
-			mp_decode_array(&data);
-			hash = key_hash(data, key_def);
-		} else {
-			hash = tuple_hash(key, key_def);
-		}
-		if (!bloom_possible_has(&run->info.bloom, hash)) {
-			itr->search_ended = true;
-			itr->stat->bloom_hit++;
-			return 0;
-		}
+	bool use_bloom = (iterator_type == ITER_EQ &&
+			  vy_run_has_bloom_for(run, key_def, key));
+	if (use_bloom && !vy_run_bloom_may_have(run, key_def, key)) {
+		itr->search_ended = true;
+		itr->stat->bloom_hit++;
+		return 0;
 	}
 
 	itr->stat->lookup++;
@@ -1279,8 +1868,13 @@ vy_run_iterator_do_seek(struct vy_run_iterator *itr,
 	if (tuple_field_count(key) > 0) {
 		rc = vy_run_iterator_search(itr, iterator_type, key,
 					    &itr->curr_pos, &equal_found);
-		if (rc != 0 || itr->search_ended)
+		if (rc != 0)
 			return rc;
+		if (itr->search_ended) {
+			if (use_bloom)
+				itr->stat->bloom_miss++;
+			return 0;
+		}
 	} else if (iterator_type == ITER_LE) {
 		itr->curr_pos = end_pos;
 	} else {
@@ -1290,7 +1884,7 @@ vy_run_iterator_do_seek(struct vy_run_iterator *itr,
 	}
 	if (iterator_type == ITER_EQ && !equal_found) {
 		vy_run_iterator_stop(itr);
-		if (run->info.has_bloom && is_full_key)
+		if (use_bloom)
 			itr->stat->bloom_miss++;
 		return 0;
 	}
@@ -1550,6 +2144,162 @@ vy_run_iterator_skip(struct vy_run_iterator *itr,
 	return 0;
 }
 
+/**
+ * Find the page a point lookup iterator is going to start from.
+ * Return false if the iterator doesn't need to read the disk,
+ * because the key is out of the slice boundaries or filtered
+ * out by the bloom filter.
+ */
+static bool
+vy_run_iterator_first_page(struct vy_run_iterator *itr, uint32_t *page_no)
+{
+	struct vy_slice *slice = itr->slice;
+	struct vy_run *run = slice->run;
+	const struct tuple *key = itr->key;
+	if (itr->iterator_type != ITER_EQ || itr->search_started ||
+	    tuple_field_count(key) < itr->key_def->part_count)
+		return false;
+	if (slice->begin != NULL &&
+	    vy_stmt_compare_with_key(key, slice->begin, itr->cmp_def) < 0)
+		return false;
+	if (slice->end != NULL &&
+	    vy_stmt_compare_with_key(key, slice->end, itr->cmp_def) >= 0)
+		return false;
+	if (!vy_run_bloom_may_have(run, itr->key_def, key))
+		return false;
+	bool equal_key;
+	*page_no = vy_page_index_find_page(run, key, itr->cmp_def,
+					   ITER_EQ, &equal_key);
+	if (vy_page_index_skip_page(run, key, itr->cmp_def,
+				    ITER_EQ, page_no) &&
+	    vy_page_index_eq_page_is_empty(run, key, itr->cmp_def,
+					   ITER_EQ, *page_no))
+		return false;
+	return *page_no < run->info.page_count;
+}
+
+NODISCARD int
+vy_run_iterator_prefetch(struct vy_run_iterator *itrs, int count)
+{
+	if (count < 2)
+		return 0;
+	struct vy_run_env *env = itrs[0].slice->run->env;
+	if (env->reader_pool == NULL)
+		return 0;
+
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	int msg_count = MIN(count, env->reader_pool_size);
+	size_t size = count * sizeof(struct vy_page_read_req) +
+		      msg_count * sizeof(struct vy_page_read_batch_msg);
+	struct vy_page_read_req *reqs = region_alloc(region, size);
+	if (reqs == NULL) {
+		diag_set(OutOfMemory, size, "region", "page read batch");
+		return -1;
+	}
+	struct vy_page_read_batch_msg *msgs =
+		(struct vy_page_read_batch_msg *)(reqs + count);
+
+	/* Collect pages that have to be read from disk. */
+	int req_count = 0;
+	for (int i = 0; i < count; i++) {
+		struct vy_run_iterator *itr = &itrs[i];
+		struct vy_run *run = itr->slice->run;
+		uint32_t page_no;
+		if (!vy_run_iterator_first_page(itr, &page_no) ||
+		    vy_page_cache_get(&env->page_cache, run->id,
+				      page_no) != NULL)
+			continue;
+		struct vy_page_read_req *req = &reqs[req_count++];
+		req->itr = itr;
+		req->run = run;
+		req->page_no = page_no;
+		req->page_info = vy_run_page_info(run, page_no);
+		req->page = NULL;
+	}
+	/* Nothing to batch, let the iterators read the page. */
+	if (req_count < 2)
+		goto out;
+
+	for (int i = 0; i < req_count; i++) {
+		struct vy_page_read_req *req = &reqs[i];
+		req->page = vy_page_new(req->page_info);
+		if (req->page == NULL)
+			goto fail;
+	}
+
+	/* Spread the reads over reader threads. */
+	struct vy_page_read_batch batch;
+	batch.pending = 0;
+	batch.fiber = fiber();
+	msg_count = MIN(req_count, msg_count);
+	for (int i = 0; i < msg_count; i++) {
+		struct vy_page_read_batch_msg *msg = &msgs[i];
+		msg->reader = &env->reader_pool[env->next_reader++];
+		env->next_reader %= env->reader_pool_size;
+		msg->batch = &batch;
+		stailq_create(&msg->reqs);
+		msg->rc = 0;
+		diag_create(&msg->diag);
+		msg->route[0].f = vy_page_read_batch_perform;
+		msg->route[0].pipe = &msg->reader->tx_pipe;
+		msg->route[1].f = vy_page_read_batch_complete;
+		msg->route[1].pipe = NULL;
+		cmsg_init(&msg->base, msg->route);
+	}
+	for (int i = 0; i < req_count; i++)
+		stailq_add_tail_entry(&msgs[i % msg_count].reqs,
+				      &reqs[i], in_msg);
+	for (int i = 0; i < msg_count; i++) {
+		batch.pending++;
+		cpipe_push(&msgs[i].reader->reader_pipe, &msgs[i].base);
+	}
+
+	/*
+	 * Reader threads use the batch memory, so wait for all
+	 * of them to return, whatever happens.
+	 */
+	bool cancellable = fiber_set_cancellable(false);
+	while (batch.pending > 0)
+		fiber_yield();
+	fiber_set_cancellable(cancellable);
+
+	int rc = 0;
+	for (int i = 0; i < msg_count; i++) {
+		struct vy_page_read_batch_msg *msg = &msgs[i];
+		if (msg->rc != 0 && rc == 0) {
+			diag_move(&msg->diag, diag_get());
+			rc = -1;
+		}
+		diag_destroy(&msg->diag);
+	}
+	if (rc != 0)
+		goto fail;
+
+	/* Hand the pages over to the iterators. */
+	for (int i = 0; i < req_count; i++) {
+		struct vy_page_read_req *req = &reqs[i];
+		struct vy_run_iterator *itr = req->itr;
+		struct vy_page *page = req->page;
+		page->run_id = req->run->id;
+		page->page_no = req->page_no;
+		vy_page_cache_put(&env->page_cache, page);
+		vy_run_iterator_acct_read(itr, req->page_info);
+		assert(itr->curr_page == NULL);
+		itr->curr_page = page;
+	}
+out:
+	region_truncate(region, region_svp);
+	return 0;
+fail:
+	for (int i = 0; i < req_count; i++) {
+		if (reqs[i].page != NULL)
+			vy_page_unref(reqs[i].page);
+	}
+	region_truncate(region, region_svp);
+	return -1;
+}
+
 void
 vy_run_iterator_close(struct vy_run_iterator *itr)
 {
@@ -1567,6 +2317,11 @@ vy_run_acct_page(struct vy_run *run, struct vy_page_info *page)
 	mp_next(&min_key_end);
 	run->page_index_size += sizeof(struct vy_page_info);
 	run->page_index_size += min_key_end - page->min_key;
+	if (page->max_key != NULL) {
+		const char *max_key_end = page->max_key;
+		mp_next(&max_key_end);
+		run->page_index_size += max_key_end - page->max_key;
+	}
 	run->count.rows += page->row_count;
 	run->count.bytes += page->unpacked_size;
 	run->count.bytes_compressed += page->size;
@@ -1801,10 +2556,19 @@ vy_page_info_encode(const struct vy_page_info *page_info,
 	mp_next(&tmp);
 	min_key_size = tmp - page_info->min_key;
 
+	uint32_t max_key_size = 0;
+	if (page_info->max_key != NULL) {
+		tmp = page_info->max_key;
+		assert(mp_typeof(*tmp) == MP_ARRAY);
+		mp_next(&tmp);
+		max_key_size = tmp - page_info->max_key;
+	}
+	uint32_t key_count = page_info->max_key != NULL ? 7 : 6;
+
 	/* calc tuple size */
 	uint32_t size;
 	/* 3 items: page offset, size, and map */
-	size = mp_sizeof_map(6) +
+	size = mp_sizeof_map(key_count) +
 	       mp_sizeof_uint(VY_PAGE_INFO_OFFSET) +
 	       mp_sizeof_uint(page_info->offset) +
 	       mp_sizeof_uint(VY_PAGE_INFO_SIZE) +
@@ -1817,6 +2581,8 @@ vy_page_info_encode(const struct vy_page_info *page_info,
 	       mp_sizeof_uint(page_info->unpacked_size) +
 	       mp_sizeof_uint(VY_PAGE_INFO_ROW_INDEX_OFFSET) +
 	       mp_sizeof_uint(page_info->row_index_offset);
+	if (page_info->max_key != NULL)
+		size += mp_sizeof_uint(VY_PAGE_INFO_MAX_KEY) + max_key_size;
 
 	char *pos = region_alloc(region, size);
 	if (pos == NULL) {
@@ -1827,7 +2593,7 @@ vy_page_info_encode(const struct vy_page_info *page_info,
 	memset(xrow, 0, sizeof(*xrow));
 	/* encode page */
 	xrow->body->iov_base = pos;
-	pos = mp_encode_map(pos, 6);
+	pos = mp_encode_map(pos, key_count);
 	pos = mp_encode_uint(pos, VY_PAGE_INFO_OFFSET);
 	pos = mp_encode_uint(pos, page_info->offset);
 	pos = mp_encode_uint(pos, VY_PAGE_INFO_SIZE);
@@ -1841,6 +2607,11 @@ vy_page_info_encode(const struct vy_page_info *page_info,
 	pos = mp_encode_uint(pos, page_info->unpacked_size);
 	pos = mp_encode_uint(pos, VY_PAGE_INFO_ROW_INDEX_OFFSET);
 	pos = mp_encode_uint(pos, page_info->row_index_offset);
+	if (page_info->max_key != NULL) {
+		pos = mp_encode_uint(pos, VY_PAGE_INFO_MAX_KEY);
+		memcpy(pos, page_info->max_key, max_key_size);
+		pos += max_key_size;
+	}
 	xrow->body->iov_len = (void *)pos - xrow->body->iov_base;
 	xrow->bodycnt = 1;
 
@@ -1913,6 +2684,10 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	uint32_t key_count = 5;
 	if (run_info->has_bloom)
 		key_count++;
+	if (run_info->bloom_prefix_parts > 0)
+		key_count++;
+	if (run_info->dump_time > 0)
+		key_count++;
 
 	size_t size = mp_sizeof_map(key_count);
 	size += mp_sizeof_uint(VY_RUN_INFO_MIN_KEY) + min_key_size;
@@ -1926,6 +2701,14 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	if (run_info->has_bloom)
 		size += mp_sizeof_uint(VY_RUN_INFO_BLOOM) +
 			vy_run_bloom_encode_size(&run_info->bloom);
+	if (run_info->bloom_prefix_parts > 0)
+		size += mp_sizeof_uint(VY_RUN_INFO_PREFIX_BLOOM) +
+			mp_sizeof_array(2) +
+			mp_sizeof_uint(run_info->bloom_prefix_parts) +
+			vy_run_bloom_encode_size(&run_info->prefix_bloom);
+	if (run_info->dump_time > 0)
+		size += mp_sizeof_uint(VY_RUN_INFO_DUMP_TIME) +
+			mp_sizeof_double(run_info->dump_time);
 
 	char *pos = region_alloc(&fiber()->gc, size);
 	if (pos == NULL) {
@@ -1952,6 +2735,16 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 		pos = mp_encode_uint(pos, VY_RUN_INFO_BLOOM);
 		pos = vy_run_bloom_encode(&run_info->bloom, pos);
 	}
+	if (run_info->bloom_prefix_parts > 0) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_PREFIX_BLOOM);
+		pos = mp_encode_array(pos, 2);
+		pos = mp_encode_uint(pos, run_info->bloom_prefix_parts);
+		pos = vy_run_bloom_encode(&run_info->prefix_bloom, pos);
+	}
+	if (run_info->dump_time > 0) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_DUMP_TIME);
+		pos = mp_encode_double(pos, run_info->dump_time);
+	}
 	xrow->body->iov_len = (void *)pos - xrow->body->iov_base;
 	xrow->bodycnt = 1;
 	xrow->type = VY_INDEX_RUN_INFO;
@@ -2019,7 +2812,8 @@ int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		const char *dirpath, uint32_t space_id, uint32_t iid,
 		const struct key_def *cmp_def, const struct key_def *key_def,
-		uint64_t page_size, double bloom_fpr, size_t max_output_count)
+		uint64_t page_size, double bloom_fpr,
+		uint32_t bloom_prefix_parts, size_t max_output_count)
 {
 	memset(writer, 0, sizeof(*writer));
 	writer->run = run;
@@ -2037,6 +2831,18 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 			 "bloom_spectrum_create", "bloom_spectrum");
 		return -1;
 	}
+	if (writer->has_bloom && bloom_prefix_parts > 0) {
+		assert(bloom_prefix_parts < key_def->part_count);
+		if (bloom_spectrum_create(&writer->prefix_bloom,
+					  max_output_count, bloom_fpr,
+					  runtime.quota) != 0) {
+			diag_set(OutOfMemory, 0,
+				 "bloom_spectrum_create", "bloom_spectrum");
+			bloom_spectrum_destroy(&writer->bloom, runtime.quota);
+			return -1;
+		}
+		writer->bloom_prefix_parts = bloom_prefix_parts;
+	}
 	xlog_clear(&writer->data_xlog);
 	ibuf_create(&writer->row_index_buf, &cord()->slabc,
 		    4096 * sizeof(uint32_t));
@@ -2131,6 +2937,15 @@ vy_run_writer_write_to_page(struct vy_run_writer *writer, struct tuple *stmt)
 		bloom_spectrum_add(&writer->bloom,
 				   tuple_hash(stmt, writer->key_def));
 	}
+	if (writer->bloom_prefix_parts > 0) {
+		uint32_t hash = tuple_hash_prefix(stmt, writer->key_def,
+						  writer->bloom_prefix_parts);
+		if (writer->prefix_bloom.count_collected == 0 ||
+		    hash != writer->last_prefix_hash) {
+			bloom_spectrum_add(&writer->prefix_bloom, hash);
+			writer->last_prefix_hash = hash;
+		}
+	}
 	int64_t lsn = vy_stmt_lsn(stmt);
 	run->info.min_lsn = MIN(run->info.min_lsn, lsn);
 	run->info.max_lsn = MAX(run->info.max_lsn, lsn);
@@ -2153,6 +2968,16 @@ vy_run_writer_end_page(struct vy_run_writer *writer)
 	assert(ibuf_used(&writer->row_index_buf) ==
 	       sizeof(uint32_t) * page->row_count);
 
+	assert(writer->last_stmt != NULL);
+	const char *key = tuple_extract_key(writer->last_stmt,
+					    writer->cmp_def, NULL);
+	if (key == NULL)
+		return -1;
+	assert(page->max_key == NULL);
+	page->max_key = vy_key_dup(key);
+	if (page->max_key == NULL)
+		return -1;
+
 	struct xrow_header xrow;
 	uint32_t *row_index = (uint32_t *)writer->row_index_buf.rpos;
 	if (vy_row_index_encode(row_index, page->row_count, &xrow) < 0)
@@ -2212,6 +3037,8 @@ vy_run_writer_destroy(struct vy_run_writer *writer, bool reuse_fd)
 		xlog_close(&writer->data_xlog, reuse_fd);
 	if (writer->has_bloom)
 		bloom_spectrum_destroy(&writer->bloom, runtime.quota);
+	if (writer->bloom_prefix_parts > 0)
+		bloom_spectrum_destroy(&writer->prefix_bloom, runtime.quota);
 	ibuf_destroy(&writer->row_index_buf);
 }
 
@@ -2252,6 +3079,11 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 		bloom_spectrum_choose(&writer->bloom, &run->info.bloom);
 		run->info.has_bloom = true;
 	}
+	if (writer->bloom_prefix_parts > 0) {
+		bloom_spectrum_choose(&writer->prefix_bloom,
+				      &run->info.prefix_bloom);
+		run->info.bloom_prefix_parts = writer->bloom_prefix_parts;
+	}
 	if (vy_run_write_index(run, writer->dirpath,
 			       writer->space_id, writer->iid) != 0)
 		goto out;
@@ -2352,6 +3184,11 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 		info->unpacked_size = xlog_cursor_tx_pos(&cursor);
 		info->row_index_offset = page_row_index_offset;
 		++run->info.page_count;
+		if (key != NULL) {
+			info->max_key = vy_key_dup(key);
+			if (info->max_key == NULL)
+				goto close_err;
+		}
 		run_row_count += page_row_count;
 		vy_run_acct_page(run, info);
 		region_truncate(region, mem_used);
@@ -2375,6 +3212,16 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 			 "bloom_create", "bloom");
 		goto close_err;
 	}
+	uint32_t prefix_parts = opts->bloom_prefix_parts;
+	if (prefix_parts > 0) {
+		if (bloom_create(&run->info.prefix_bloom, run_row_count,
+				 opts->bloom_fpr, runtime.quota) != 0) {
+			diag_set(OutOfMemory, 0,
+				 "bloom_create", "bloom");
+			goto close_err;
+		}
+		run->info.bloom_prefix_parts = prefix_parts;
+	}
 	struct xrow_header xrow;
 	while ((rc = xlog_cursor_next(&cursor, &xrow, false)) == 0) {
 		if (xrow.type == VY_RUN_ROW_INDEX)
@@ -2385,6 +3232,11 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 		if (tuple == NULL)
 			goto close_err;
 		bloom_add(&run->info.bloom, tuple_hash(tuple, key_def));
+		if (prefix_parts > 0) {
+			bloom_add(&run->info.prefix_bloom,
+				  tuple_hash_prefix(tuple, key_def,
+						    prefix_parts));
+		}
 	}
 	run->info.has_bloom = true;
 done:
@@ -51,6 +51,27 @@ extern "C" {
 #endif /* defined(__cplusplus) */
 
 struct vy_run_reader;
+struct mh_vy_page_cache_t;
+
+/**
+ * Cache of decompressed run pages, shared by all run iterators.
+ * Pages are looked up by run id and page number, so iterators
+ * and point lookups reading a hot page find it already read and
+ * decompressed. When the memory occupied by cached pages exceeds
+ * the quota, the least recently used pages are evicted.
+ */
+struct vy_page_cache {
+	/** Run id and page number -> struct vy_page. */
+	struct mh_vy_page_cache_t *hash;
+	/** LRU list of cached pages, the first is the newest. */
+	struct rlist lru;
+	/** Number of cached pages. */
+	int64_t page_count;
+	/** Size of memory occupied by cached pages. */
+	size_t mem_used;
+	/** Max memory size that can be used for cached pages. */
+	size_t mem_quota;
+};
 
 /** Part of vinyl environment for run read/write */
 struct vy_run_env {
@@ -67,6 +88,8 @@ struct vy_run_env {
 	 * processing the next read request.
 	 */
 	int next_reader;
+	/** Cache of decompressed pages of all runs. */
+	struct vy_page_cache page_cache;
 };
 
 /**
@@ -87,6 +110,19 @@ struct vy_run_info {
 	bool has_bloom;
 	/** Bloom filter of all tuples in run */
 	struct bloom bloom;
+	/**
+	 * Number of leading key parts hashed into @prefix_bloom,
+	 * 0 if the run has no prefix bloom filter.
+	 */
+	uint32_t bloom_prefix_parts;
+	/** Bloom filter of key prefixes of all tuples in run. */
+	struct bloom prefix_bloom;
+	/**
+	 * Time when the most recent statement of the run was
+	 * dumped to disk, 0 if unknown. Used by the time window
+	 * compaction policy.
+	 */
+	double dump_time;
 };
 
 /**
@@ -105,6 +141,11 @@ struct vy_page_info {
 	char *min_key;
 	/** Offset of the row index in the page. */
 	uint32_t row_index_offset;
+	/**
+	 * Maximal key stored in the page or NULL if the run
+	 * was written before max keys were stored in the index.
+	 */
+	char *max_key;
 };
 
 /**
@@ -266,6 +307,8 @@ struct vy_run_iterator {
  * Vinyl page stored in memory.
  */
 struct vy_page {
+	/** ID of the run the page belongs to. */
+	int64_t run_id;
 	/** Page position in the run file. */
 	uint32_t page_no;
 	/** Size of page data in memory, i.e. unpacked. */
@@ -276,6 +319,13 @@ struct vy_page {
 	uint32_t *row_index;
 	/** Pointer to the page data. */
 	char *data;
+	/**
+	 * Number of references to the page: one for each run
+	 * iterator using it and one if the page is cached.
+	 */
+	int refs;
+	/** Link in vy_page_cache::lru, empty if not cached. */
+	struct rlist in_lru;
 };
 
 /**
@@ -302,12 +352,40 @@ vy_run_env_destroy(struct vy_run_env *env);
 void
 vy_run_env_enable_coio(struct vy_run_env *env, int threads);
 
+/**
+ * Set memory limit for the page cache of a vinyl run
+ * environment, evicting pages that don't fit in the new
+ * limit. Zero disables the cache.
+ */
+void
+vy_run_env_set_page_cache_quota(struct vy_run_env *env, size_t quota);
+
 static inline size_t
 vy_run_bloom_size(struct vy_run *run)
 {
-	return run->info.has_bloom ? bloom_store_size(&run->info.bloom) : 0;
+	size_t size = 0;
+	if (run->info.has_bloom)
+		size += bloom_store_size(&run->info.bloom);
+	if (run->info.bloom_prefix_parts > 0)
+		size += bloom_store_size(&run->info.prefix_bloom);
+	return size;
 }
 
+/**
+ * Check bloom filters of a run for a key looked up with
+ * ITER_EQ or ITER_REQ. A full key is checked against the
+ * filter of full keys, a partial key that has at least
+ * bloom_prefix_parts parts - against the filter of key
+ * prefixes.
+ *
+ * @retval false The run definitely has no statements for @key.
+ * @retval true  The run may have them or it has no filter
+ *               suitable for @key.
+ */
+bool
+vy_run_bloom_may_have(struct vy_run *run, const struct key_def *key_def,
+		      const struct tuple *key);
+
 static inline struct vy_page_info *
 vy_run_page_info(struct vy_run *run, uint32_t pos)
 {
@@ -498,6 +576,24 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 		     struct tuple_format *upsert_format,
 		     bool is_primary);
 
+/**
+ * Read pages needed by point lookup iterators in one batch.
+ *
+ * @itrs are ITER_EQ iterators that haven't been started yet.
+ * For each of them, the function checks the slice boundaries
+ * and the bloom filter and finds the page the iteration will
+ * start from. Pages missing in the page cache are read at once:
+ * the reads are spread over reader threads, which submit them
+ * asynchronously with io_uring, if available, and decompress
+ * pages as reads complete. The pages are then handed over to
+ * the iterators, so a lookup over many runs waits for the
+ * slowest read rather than for the sum of them.
+ *
+ * Returns 0 on success, -1 on memory allocation or IO error.
+ */
+NODISCARD int
+vy_run_iterator_prefetch(struct vy_run_iterator *itrs, int count);
+
 /**
  * Advance a run iterator to the newest statement for the next key.
  * The statement is returned in @ret (NULL if EOF).
@@ -604,6 +700,22 @@ struct vy_run_writer {
 	bool has_bloom;
 	/** Bloom filter. */
 	struct bloom_spectrum bloom;
+	/**
+	 * Number of key parts to build the prefix bloom filter
+	 * over, 0 if the run doesn't need one.
+	 */
+	uint32_t bloom_prefix_parts;
+	/** Bloom filter of key prefixes. */
+	struct bloom_spectrum prefix_bloom;
+	/**
+	 * Hash of the last key prefix added to @prefix_bloom.
+	 * Statements are written in key order, so statements
+	 * sharing a prefix go in a row and only the first of
+	 * them needs to be added, which keeps the number of
+	 * values counted by the spectrum close to the number
+	 * of distinct prefixes.
+	 */
+	uint32_t last_prefix_hash;
 	/** Buffer of a current page row offsets. */
 	struct ibuf row_index_buf;
 	/**
@@ -618,7 +730,8 @@ int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		const char *dirpath, uint32_t space_id, uint32_t iid,
 		const struct key_def *cmp_def, const struct key_def *key_def,
-		uint64_t page_size, double bloom_fpr, size_t max_output_count);
+		uint64_t page_size, double bloom_fpr,
+		uint32_t bloom_prefix_parts, size_t max_output_count);
 
 /**
  * Write a specified statement into a run.
@@ -141,6 +141,7 @@ struct vy_task {
 	 * from another thread.
 	 */
 	double bloom_fpr;
+	uint32_t bloom_prefix_parts;
 	int64_t page_size;
 };
 
@@ -640,6 +641,7 @@ vy_task_write_run(struct vy_scheduler *scheduler, struct vy_task *task)
 				 index->space_id, index->id,
 				 index->cmp_def, index->key_def,
 				 task->page_size, task->bloom_fpr,
+				 task->bloom_prefix_parts,
 				 task->max_output_count) != 0)
 		goto fail;
 
@@ -986,6 +988,7 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_index *index,
 
 	assert(dump_lsn >= 0);
 	new_run->dump_lsn = dump_lsn;
+	new_run->info.dump_time = ev_now(loop());
 
 	struct vy_stmt_stream *wi;
 	bool is_last_level = (index->run_count == 0);
@@ -1005,6 +1008,7 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_index *index,
 	task->wi = wi;
 	task->max_output_count = max_output_count;
 	task->bloom_fpr = index->opts.bloom_fpr;
+	task->bloom_prefix_parts = index->opts.bloom_prefix_parts;
 	task->page_size = index->opts.page_size;
 
 	index->is_dumping = true;
@@ -1263,7 +1267,8 @@ vy_task_compact_new(struct vy_scheduler *scheduler, struct vy_index *index,
 		goto err_run;
 
 	struct vy_stmt_stream *wi;
-	bool is_last_level = (range->compact_priority == range->slice_count);
+	bool is_last_level = (range->compact_skip + range->compact_priority ==
+			      range->slice_count);
 	wi = vy_write_iterator_new(index->cmp_def, index->disk_format,
 				   index->upsert_format, index->id == 0,
 				   is_last_level, scheduler->read_views);
@@ -1271,14 +1276,25 @@ vy_task_compact_new(struct vy_scheduler *scheduler, struct vy_index *index,
 		goto err_wi;
 
 	struct vy_slice *slice;
+	int skip = range->compact_skip;
 	int n = range->compact_priority;
 	rlist_foreach_entry(slice, &range->slices, in_range) {
+		/*
+		 * The time window policy may leave the newest
+		 * runs out of compaction.
+		 */
+		if (skip > 0) {
+			skip--;
+			continue;
+		}
 		if (vy_write_iterator_new_slice(wi, slice) != 0)
 			goto err_wi_sub;
 
 		task->max_output_count += slice->count.rows;
 		new_run->dump_lsn = MAX(new_run->dump_lsn,
 					slice->run->dump_lsn);
+		new_run->info.dump_time = MAX(new_run->info.dump_time,
+					      slice->run->info.dump_time);
 
 		/* Remember the slices we are compacting. */
 		if (task->first_slice == NULL)
@@ -1295,6 +1311,7 @@ vy_task_compact_new(struct vy_scheduler *scheduler, struct vy_index *index,
 	task->new_run = new_run;
 	task->wi = wi;
 	task->bloom_fpr = index->opts.bloom_fpr;
+	task->bloom_prefix_parts = index->opts.bloom_prefix_parts;
 	task->page_size = index->opts.page_size;
 
 	/*
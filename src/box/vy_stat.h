@@ -84,6 +84,18 @@ struct vy_run_iterator_stat {
 	 * prevent a disk read.
 	 */
 	int64_t bloom_miss;
+	/** Number of pages found in the page cache. */
+	int64_t page_cache_hit;
+	/**
+	 * Number of pages missing in the page cache,
+	 * i.e. read from the disk.
+	 */
+	int64_t page_cache_miss;
+	/**
+	 * Number of page reads avoided thanks to the min and
+	 * max keys stored in the page index.
+	 */
+	int64_t skipped_pages;
 	/**
 	 * Number of statements actually read from the disk.
 	 * It may be greater than the number of statements
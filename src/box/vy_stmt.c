@@ -377,6 +377,11 @@ vy_stmt_new_surrogate_from_key(const char *key, enum iproto_type type,
 
 	char *raw = (char *) tuple_data(stmt);
 	uint32_t *field_map = (uint32_t *) raw;
+	if (field_count < format->offset_field_count) {
+		/* Hot fields are not stored in a surrogate key. */
+		memset((char *)field_map - format->field_map_size, 0,
+		       format->field_map_size);
+	}
 	char *wpos = mp_encode_array(raw, field_count);
 	for (uint32_t i = 0; i < field_count; ++i) {
 		const struct tuple_field *field = &format->fields[i];
@@ -422,17 +427,15 @@ vy_stmt_new_surrogate_delete(struct tuple_format *format,
 	const char *src_pos = src_data;
 	uint32_t src_count = mp_decode_array(&src_pos);
 	assert(src_count >= format->min_field_count);
-	uint32_t field_count;
-	if (src_count < format->index_field_count) {
-		field_count = src_count;
+	uint32_t field_count = MIN(src_count, format->index_field_count);
+	if (field_count < format->offset_field_count) {
 		/*
 		 * Nullify field map to be able to detect by 0,
-		 * which key fields are absent in tuple_field().
+		 * which key and hot fields are absent in
+		 * tuple_field().
 		 */
 		memset((char *)field_map - format->field_map_size, 0,
 		       format->field_map_size);
-	} else {
-		field_count = format->index_field_count;
 	}
 	char *pos = mp_encode_array(data, field_count);
 	for (uint32_t i = 0; i < field_count; ++i) {
@@ -440,6 +443,8 @@ vy_stmt_new_surrogate_delete(struct tuple_format *format,
 		if (! field->is_key_part) {
 			/* Unindexed field - write NIL. */
 			assert(i < src_count);
+			if (field->offset_slot != TUPLE_OFFSET_SLOT_NIL)
+				field_map[field->offset_slot] = pos - data;
 			pos = mp_encode_nil(pos);
 			mp_next(&src_pos);
 			continue;
@@ -41,10 +41,40 @@
 #include "cbus.h"
 #include "coio_task.h"
 #include "replication.h"
+#include "histogram.h"
+#include "clock.h"
+#include "info.h"
+#include "small/ibuf.h"
 
 
 const char *wal_mode_STRS[] = { "none", "write", "fsync", NULL };
 
+enum {
+	/**
+	 * Sync the WAL without waiting for the group commit
+	 * window to expire as soon as this many transactions
+	 * are waiting for the sync.
+	 */
+	WAL_SYNC_BATCH_MAX = 4096,
+	/**
+	 * Size of the ring of rows recently written to the WAL,
+	 * see struct wal_ring.
+	 */
+	WAL_RING_SIZE = 16 * 1024 * 1024,
+};
+
+/**
+ * Max time a written transaction may wait for more transactions
+ * to share the same WAL sync, in seconds.
+ */
+static const double WAL_SYNC_WINDOW_MAX = 0.001;
+
+/**
+ * Weight of the last observation in the moving averages used to
+ * compute the group commit window.
+ */
+static const double WAL_SYNC_AVG_WEIGHT = 0.1;
+
 int wal_dir_lock = -1;
 
 static int64_t
@@ -63,6 +93,32 @@ struct wal_thread {
 	struct cpipe tx_pipe;
 };
 
+/**
+ * Ring of rows recently written to the WAL. Relays which keep
+ * up with the master copy rows from it instead of reading them
+ * back from xlog files. Rows are appended by the WAL thread
+ * after they are written and copied out by relay threads, both
+ * under the mutex. The ring is maintained only while there are
+ * WAL watchers.
+ *
+ * Each row is stored as struct wal_ring_row followed by the
+ * encoded row. Positions in the ring grow monotonically, the
+ * offset in the buffer is the position modulo the ring size.
+ */
+struct wal_ring {
+	pthread_mutex_t mutex;
+	/** Buffer of @size bytes or NULL if not allocated yet. */
+	char *buf;
+	/** WAL_RING_SIZE, unless changed by error injection. */
+	size_t size;
+	/** Position of the first row in the ring. */
+	uint64_t begin;
+	/** Position following the last row in the ring. */
+	uint64_t end;
+	/** Vclock of the WAL preceding the first row in the ring. */
+	struct vclock vclock;
+};
+
 /*
  * WAL writer - maintain a Write Ahead Log for every change
  * in the data state.
@@ -117,6 +173,29 @@ struct wal_writer
 	 * Used for replication relays.
 	 */
 	struct rlist watchers;
+	/** Rows recently written to the WAL, read by relays. */
+	struct wal_ring ring;
+	/**
+	 * wal_mode = "fsync": batches written to the current WAL
+	 * and waiting for the sync. They are passed back to tx
+	 * once a single fdatasync() covering all of them is done,
+	 * see wal_sync().
+	 */
+	struct stailq sync_queue;
+	/** Number of transactions in sync_queue. */
+	int sync_queue_len;
+	/** Timer firing at the end of the group commit window. */
+	struct ev_timer sync_timer;
+	/** Moving average of fdatasync() time, in seconds. */
+	double sync_time_avg;
+	/** Moving average of the number of transactions per sync. */
+	double sync_batch_avg;
+	/** Number of WAL syncs done so far. */
+	int64_t sync_count;
+	/** Histogram of the number of transactions per sync. */
+	struct histogram *sync_batch_hist;
+	/** Histogram of fdatasync() time, in microseconds. */
+	struct histogram *sync_time_hist;
 };
 
 struct wal_msg: public cmsg {
@@ -150,11 +229,24 @@ wal_mode()
 static void
 wal_write_to_disk(struct cmsg *msg);
 
+static void
+wal_sync_timer_cb(ev_loop *loop, ev_timer *timer, int events);
+
+static void
+wal_sync(struct wal_writer *writer);
+
+static void
+wal_writer_begin_rollback(struct wal_writer *writer);
+
 static void
 tx_schedule_commit(struct cmsg *msg);
 
+/*
+ * A batch is passed back to tx by wal_msg_complete(), since in
+ * "fsync" mode it has to wait for the WAL sync.
+ */
 static struct cmsg_hop wal_request_route[] = {
-	{wal_write_to_disk, &wal_thread.tx_pipe},
+	{wal_write_to_disk, NULL},
 	{tx_schedule_commit, NULL},
 };
 
@@ -172,6 +264,15 @@ wal_msg(struct cmsg *msg)
 	return msg->route == wal_request_route ? (struct wal_msg *) msg : NULL;
 }
 
+/** Pass a processed batch back to tx. */
+static void
+wal_msg_complete(struct wal_msg *batch)
+{
+	assert(batch->hop == &wal_request_route[0]);
+	batch->hop++;
+	cpipe_push(&wal_thread.tx_pipe, batch);
+}
+
 /** Write a request to a log in a single transaction. */
 static ssize_t
 xlog_write_entry(struct xlog *l, struct journal_entry *entry)
@@ -273,8 +374,6 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 
 	xdir_create(&writer->wal_dir, wal_dirname, XLOG, instance_uuid);
 	xlog_clear(&writer->current_wal);
-	if (wal_mode == WAL_FSYNC)
-		writer->wal_dir.open_wflags |= O_SYNC;
 
 	stailq_create(&writer->rollback);
 	cmsg_init(&writer->in_rollback, NULL);
@@ -284,6 +383,50 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	vclock_copy(&writer->vclock, vclock);
 
 	rlist_create(&writer->watchers);
+
+	tt_pthread_mutex_init(&writer->ring.mutex, NULL);
+	writer->ring.buf = NULL;
+	writer->ring.size = 0;
+	writer->ring.begin = writer->ring.end = 0;
+	vclock_create(&writer->ring.vclock);
+
+	stailq_create(&writer->sync_queue);
+	writer->sync_queue_len = 0;
+	ev_timer_init(&writer->sync_timer, wal_sync_timer_cb, 0, 0);
+	writer->sync_timer.data = writer;
+	writer->sync_time_avg = 0;
+	writer->sync_batch_avg = 0;
+	writer->sync_count = 0;
+}
+
+/** Allocate WAL sync statistics. */
+static void
+wal_writer_create_stat(struct wal_writer *writer)
+{
+	static const int64_t batch_buckets[] = {
+		1, 2, 3, 4, 5, 6, 8, 10, 15, 20, 30, 40, 50, 75, 100,
+		150, 200, 300, 400, 500, 750, 1000, 1500, 2000, 3000,
+		WAL_SYNC_BATCH_MAX,
+	};
+	static const int64_t time_buckets[] = {
+		10, 20, 30, 40, 50, 75, 100, 150, 200, 300, 400, 500,
+		750, 1000, 1500, 2000, 3000, 4000, 5000, 7500, 10000,
+		15000, 20000, 30000, 50000, 75000, 100000, 200000,
+		500000, 1000000,
+	};
+	writer->sync_batch_hist = histogram_new(batch_buckets,
+						lengthof(batch_buckets));
+	if (writer->sync_batch_hist == NULL) {
+		tnt_raise(OutOfMemory, sizeof(struct histogram),
+			  "histogram_new", "WAL sync batch histogram");
+	}
+	writer->sync_time_hist = histogram_new(time_buckets,
+					       lengthof(time_buckets));
+	if (writer->sync_time_hist == NULL) {
+		histogram_delete(writer->sync_batch_hist);
+		tnt_raise(OutOfMemory, sizeof(struct histogram),
+			  "histogram_new", "WAL sync time histogram");
+	}
 }
 
 /** Destroy a WAL writer structure. */
@@ -291,6 +434,10 @@ static void
 wal_writer_destroy(struct wal_writer *writer)
 {
 	xdir_destroy(&writer->wal_dir);
+	free(writer->ring.buf);
+	tt_pthread_mutex_destroy(&writer->ring.mutex);
+	histogram_delete(writer->sync_batch_hist);
+	histogram_delete(writer->sync_time_hist);
 }
 
 /** WAL thread routine. */
@@ -327,6 +474,7 @@ wal_init(enum wal_mode wal_mode, const char *wal_dirname,
 
 	wal_writer_create(writer, wal_mode, wal_dirname, instance_uuid,
 			  vclock, wal_max_rows, wal_max_size);
+	wal_writer_create_stat(writer);
 
 	xdir_scan_xc(&writer->wal_dir);
 
@@ -369,6 +517,11 @@ wal_checkpoint_f(struct cmsg *data)
 		msg->res = -1;
 		return;
 	}
+	/*
+	 * The checkpoint must not include rows which are
+	 * not synced yet.
+	 */
+	wal_sync(writer);
 	/*
 	 * Avoid closing the current WAL if it has no rows (empty).
 	 */
@@ -461,6 +614,105 @@ wal_collect_garbage(int64_t lsn)
 static void
 wal_notify_watchers(struct wal_writer *writer, unsigned events);
 
+/**
+ * Sync the current WAL and pass all batches waiting for the sync
+ * to tx.
+ *
+ * A failed sync is fatal: rows of the batches have already been
+ * written and their LSNs assigned, so after a restart recovery
+ * would replay transactions reported as failed. Besides, after
+ * fdatasync() failure the kernel may have dropped the dirty pages
+ * so that retrying it would falsely succeed.
+ */
+static void
+wal_sync(struct wal_writer *writer)
+{
+	ev_timer_stop(loop(), &writer->sync_timer);
+	if (stailq_empty(&writer->sync_queue))
+		return;
+
+	double start = clock_monotonic();
+	if (fdatasync(writer->current_wal.fd) < 0) {
+		panic_syserror("%s: fdatasync() failed",
+			       writer->current_wal.filename);
+	}
+	double time = clock_monotonic() - start;
+
+	writer->sync_count++;
+	histogram_collect(writer->sync_batch_hist, writer->sync_queue_len);
+	histogram_collect(writer->sync_time_hist, time * 1000000);
+	writer->sync_time_avg += WAL_SYNC_AVG_WEIGHT *
+				 (time - writer->sync_time_avg);
+	writer->sync_batch_avg += WAL_SYNC_AVG_WEIGHT *
+		(writer->sync_queue_len - writer->sync_batch_avg);
+
+	struct stailq queue;
+	stailq_create(&queue);
+	stailq_concat(&queue, &writer->sync_queue);
+	writer->sync_queue_len = 0;
+
+	struct wal_msg *batch, *next;
+	stailq_foreach_entry_safe(batch, next, &queue, fifo)
+		wal_msg_complete(batch);
+	wal_notify_watchers(writer, WAL_EVENT_WRITE);
+}
+
+static void
+wal_sync_timer_cb(ev_loop *loop, ev_timer *timer, int events)
+{
+	(void) loop;
+	(void) events;
+	struct wal_writer *writer = (struct wal_writer *) timer->data;
+	wal_sync(writer);
+}
+
+/**
+ * Return the time written transactions should wait for more
+ * transactions to share the same WAL sync with.
+ *
+ * Waiting makes sense only if transactions are committed
+ * concurrently, i.e. a sync used to cover more than one of
+ * them, and more of them are expected than already queued.
+ * The window is a fraction of the time a sync takes, so that
+ * the latency added to a commit is bounded by the latency of
+ * the sync itself.
+ */
+static double
+wal_sync_window(struct wal_writer *writer)
+{
+	if (writer->sync_batch_avg < 2 ||
+	    writer->sync_queue_len >= writer->sync_batch_avg)
+		return 0;
+	return MIN(writer->sync_time_avg / 2, WAL_SYNC_WINDOW_MAX);
+}
+
+/**
+ * Put a written batch to the queue of batches waiting for
+ * the WAL sync (wal_mode = "fsync").
+ */
+static void
+wal_sync_enqueue(struct wal_writer *writer, struct wal_msg *batch,
+		 int n_entries)
+{
+	stailq_add_tail_entry(&writer->sync_queue, batch, fifo);
+	writer->sync_queue_len += n_entries;
+	if (writer->sync_queue_len >= WAL_SYNC_BATCH_MAX) {
+		wal_sync(writer);
+		return;
+	}
+	if (!ev_is_active(&writer->sync_timer)) {
+		/*
+		 * The timer fires not earlier than the next event
+		 * loop iteration, so even with zero window all
+		 * batches received by this iteration share one
+		 * sync.
+		 */
+		ev_timer_set(&writer->sync_timer,
+			     wal_sync_window(writer), 0);
+		ev_timer_start(loop(), &writer->sync_timer);
+	}
+}
+
 /**
  * If there is no current WAL, try to open it, and close the
  * previous WAL. We close the previous WAL only after opening
@@ -485,6 +737,11 @@ wal_opt_rotate(struct wal_writer *writer)
 	if (xlog_is_open(&writer->current_wal) &&
 	    (writer->current_wal.rows >= writer->wal_max_rows ||
 	     writer->current_wal.offset >= writer->wal_max_size)) {
+		/*
+		 * Batches waiting for the sync must be
+		 * synced before the file is closed.
+		 */
+		wal_sync(writer);
 		/*
 		 * We can not handle xlog_close()
 		 * failure in any reasonable way.
@@ -534,6 +791,12 @@ wal_writer_end_rollback(struct cmsg *msg)
 static void
 wal_writer_begin_rollback(struct wal_writer *writer)
 {
+	/*
+	 * Batches written before the failed one must reach
+	 * tx before the rollback.
+	 */
+	wal_sync(writer);
+
 	static struct cmsg_hop rollback_route[4] = {
 		/*
 		 * Step 1: clear the bus, so that it contains
@@ -565,6 +828,202 @@ wal_writer_begin_rollback(struct wal_writer *writer)
 	cpipe_push(&wal_thread.tx_pipe, &writer->in_rollback);
 }
 
+/* {{{ Ring of recently written rows */
+
+static void
+wal_ring_copy_in(struct wal_ring *ring, uint64_t pos,
+		 const void *data, size_t size)
+{
+	size_t offset = pos % ring->size;
+	size_t chunk = MIN(size, ring->size - offset);
+	memcpy(ring->buf + offset, data, chunk);
+	memcpy(ring->buf, (const char *)data + chunk, size - chunk);
+}
+
+static void
+wal_ring_copy_out(struct wal_ring *ring, uint64_t pos,
+		  void *data, size_t size)
+{
+	size_t offset = pos % ring->size;
+	size_t chunk = MIN(size, ring->size - offset);
+	memcpy(data, ring->buf + offset, chunk);
+	memcpy((char *)data + chunk, ring->buf, size - chunk);
+}
+
+/** Drop the first row from the ring. The mutex must be held. */
+static void
+wal_ring_evict(struct wal_ring *ring)
+{
+	struct wal_ring_row hdr;
+	wal_ring_copy_out(ring, ring->begin, &hdr, sizeof(hdr));
+	vclock_follow(&ring->vclock, hdr.replica_id, hdr.lsn);
+	ring->begin += sizeof(hdr) + hdr.size;
+}
+
+/**
+ * Append a row to the ring, evicting the oldest rows to make
+ * room for it. The mutex must be held.
+ */
+static int
+wal_ring_append(struct wal_ring *ring, struct xrow_header *row)
+{
+	struct iovec iov[XROW_IOVMAX];
+	int iovcnt = xrow_header_encode(row, 0, iov, 0);
+	if (iovcnt < 0)
+		return -1;
+	struct wal_ring_row hdr;
+	hdr.size = 0;
+	hdr.replica_id = row->replica_id;
+	hdr.lsn = row->lsn;
+	for (int i = 0; i < iovcnt; i++)
+		hdr.size += iov[i].iov_len;
+	size_t size = sizeof(hdr) + hdr.size;
+	if (size > ring->size) {
+		/*
+		 * The row doesn't fit in the ring. Skip it along
+		 * with all rows stored so far, relays will read
+		 * them from the xlog.
+		 */
+		while (ring->begin < ring->end)
+			wal_ring_evict(ring);
+		vclock_follow(&ring->vclock, row->replica_id, row->lsn);
+		ring->end += size;
+		ring->begin = ring->end;
+		return 0;
+	}
+	while (ring->end + size - ring->begin > ring->size)
+		wal_ring_evict(ring);
+	uint64_t pos = ring->end;
+	wal_ring_copy_in(ring, pos, &hdr, sizeof(hdr));
+	pos += sizeof(hdr);
+	for (int i = 0; i < iovcnt; i++) {
+		wal_ring_copy_in(ring, pos, iov[i].iov_base, iov[i].iov_len);
+		pos += iov[i].iov_len;
+	}
+	ring->end = pos;
+	return 0;
+}
+
+/**
+ * Make the ring empty and start it at the current WAL vclock.
+ * Called when the first WAL watcher is attached, since rows
+ * aren't added to the ring while there are no watchers.
+ */
+static void
+wal_ring_reset(struct wal_writer *writer)
+{
+	struct wal_ring *ring = &writer->ring;
+	size_t size = WAL_RING_SIZE;
+	struct errinj *inj = errinj(ERRINJ_WAL_RING_SIZE, ERRINJ_INT);
+	if (inj != NULL && inj->iparam > 0)
+		size = inj->iparam;
+	tt_pthread_mutex_lock(&ring->mutex);
+	if (ring->buf != NULL && ring->size != size) {
+		free(ring->buf);
+		ring->buf = NULL;
+	}
+	if (ring->buf == NULL) {
+		ring->buf = (char *)malloc(size);
+		ring->size = size;
+		if (ring->buf == NULL) {
+			say_warn("failed to allocate WAL ring, "
+				 "relays will read rows from xlog files");
+		}
+	}
+	ring->begin = ring->end;
+	vclock_copy(&ring->vclock, &writer->vclock);
+	tt_pthread_mutex_unlock(&ring->mutex);
+}
+
+/** Add rows of written transactions to the ring. */
+static void
+wal_ring_write(struct wal_writer *writer, struct stailq *entries)
+{
+	struct wal_ring *ring = &writer->ring;
+	if (ring->buf == NULL || rlist_empty(&writer->watchers))
+		return;
+	tt_pthread_mutex_lock(&ring->mutex);
+	struct journal_entry *entry;
+	stailq_foreach_entry(entry, entries, fifo) {
+		for (int i = 0; i < entry->n_rows; i++) {
+			if (wal_ring_append(ring, entry->rows[i]) == 0)
+				continue;
+			/*
+			 * Rows can't be skipped, drop the whole
+			 * ring so that relays fall back on xlog
+			 * files. The WAL vclock covers all rows
+			 * of the batch. Move the end forward, as
+			 * wal_ring_append() does for a row that
+			 * doesn't fit, so that a relay positioned
+			 * at the old end notices the gap.
+			 */
+			diag_log();
+			diag_clear(diag_get());
+			ring->end += sizeof(struct wal_ring_row);
+			ring->begin = ring->end;
+			vclock_copy(&ring->vclock, &writer->vclock);
+			goto out;
+		}
+	}
+out:
+	tt_pthread_mutex_unlock(&ring->mutex);
+}
+
+int
+wal_ring_seek(const struct vclock *vclock, uint64_t *pos)
+{
+	struct wal_ring *ring = &wal_writer_singleton.ring;
+	int rc = -1;
+	tt_pthread_mutex_lock(&ring->mutex);
+	if (ring->buf != NULL && vclock_compare(&ring->vclock, vclock) <= 0) {
+		/*
+		 * The ring has all rows following the vclock.
+		 * Skip those the reader already has.
+		 */
+		uint64_t p = ring->begin;
+		while (p < ring->end) {
+			struct wal_ring_row hdr;
+			wal_ring_copy_out(ring, p, &hdr, sizeof(hdr));
+			if (hdr.lsn > vclock_get(vclock, hdr.replica_id))
+				break;
+			p += sizeof(hdr) + hdr.size;
+		}
+		*pos = p;
+		rc = 0;
+	}
+	tt_pthread_mutex_unlock(&ring->mutex);
+	return rc;
+}
+
+ssize_t
+wal_ring_read(uint64_t *pos, struct ibuf *buf, size_t size)
+{
+	struct wal_ring *ring = &wal_writer_singleton.ring;
+	ssize_t rc = -1;
+	tt_pthread_mutex_lock(&ring->mutex);
+	if (*pos >= ring->begin && *pos <= ring->end) {
+		uint64_t end = *pos;
+		while (end < ring->end && end - *pos < size) {
+			struct wal_ring_row hdr;
+			wal_ring_copy_out(ring, end, &hdr, sizeof(hdr));
+			end += sizeof(hdr) + hdr.size;
+		}
+		void *data = ibuf_alloc(buf, end - *pos);
+		if (data != NULL) {
+			wal_ring_copy_out(ring, *pos, data, end - *pos);
+			rc = end - *pos;
+			*pos = end;
+		} else {
+			diag_set(OutOfMemory, end - *pos,
+				 "ibuf_alloc", "WAL ring rows");
+		}
+	}
+	tt_pthread_mutex_unlock(&ring->mutex);
+	return rc;
+}
+
+/* }}} */
+
 static void
 wal_assign_lsn(struct wal_writer *writer, struct xrow_header **row,
 	       struct xrow_header **end)
@@ -594,13 +1053,14 @@ wal_write_to_disk(struct cmsg *msg)
 	if (writer->in_rollback.route != NULL) {
 		/* We're rolling back a failed write. */
 		stailq_concat(&wal_msg->rollback, &wal_msg->commit);
-		return;
+		return wal_msg_complete(wal_msg);
 	}
 
 	/* Xlog is only rotated between queue processing  */
 	if (wal_opt_rotate(writer) != 0) {
+		wal_writer_begin_rollback(writer);
 		stailq_concat(&wal_msg->rollback, &wal_msg->commit);
-		return wal_writer_begin_rollback(writer);
+		return wal_msg_complete(wal_msg);
 	}
 
 	/*
@@ -631,7 +1091,9 @@ wal_write_to_disk(struct cmsg *msg)
 	 */
 	struct journal_entry *entry;
 	struct stailq_entry *last_committed = NULL;
+	int n_entries = 0;
 	stailq_foreach_entry(entry, &wal_msg->commit, fifo) {
+		n_entries++;
 		wal_assign_lsn(writer, entry->rows, entry->rows + entry->n_rows);
 		entry->res = vclock_sum(&writer->vclock);
 		int rc = xlog_write_entry(l, entry);
@@ -662,6 +1124,7 @@ done:
 	 */
 	struct stailq rollback;
 	stailq_cut_tail(&wal_msg->commit, last_committed, &rollback);
+	wal_ring_write(writer, &wal_msg->commit);
 
 	if (!stailq_empty(&rollback)) {
 		/* Update status of the successfully committed requests. */
@@ -669,10 +1132,36 @@ done:
 			entry->res = -1;
 		/* Rollback unprocessed requests */
 		stailq_concat(&wal_msg->rollback, &rollback);
-		wal_writer_begin_rollback(writer);
+		if (writer->wal_mode == WAL_FSYNC) {
+			/*
+			 * Requests written before the failure
+			 * still need the sync, which is done
+			 * on rollback.
+			 */
+			int n_committed = 0;
+			stailq_foreach_entry(entry, &wal_msg->commit, fifo)
+				n_committed++;
+			wal_sync_enqueue(writer, wal_msg, n_committed);
+			wal_writer_begin_rollback(writer);
+		} else {
+			wal_writer_begin_rollback(writer);
+			wal_msg_complete(wal_msg);
+		}
+		fiber_gc();
+		return;
 	}
 	fiber_gc();
+	if (writer->wal_mode == WAL_FSYNC) {
+		/*
+		 * Group commit: the batch is passed to tx after
+		 * fdatasync() covering it and batches written in
+		 * the same window.
+		 */
+		wal_sync_enqueue(writer, wal_msg, n_entries);
+		return;
+	}
 	wal_notify_watchers(writer, WAL_EVENT_WRITE);
+	wal_msg_complete(wal_msg);
 }
 
 /** WAL thread main loop.  */
@@ -697,6 +1186,8 @@ wal_thread_f(va_list ap)
 
 	struct wal_writer *writer = &wal_writer_singleton;
 
+	wal_sync(writer);
+
 	if (xlog_is_open(&writer->current_wal))
 		xlog_close(&writer->current_wal, false);
 
@@ -857,6 +1348,98 @@ wal_rotate_vy_log()
 	fiber_set_cancellable(cancellable);
 }
 
+struct wal_stat_msg: public cbus_call_msg
+{
+	int64_t sync_count;
+	double sync_window;
+	double sync_batch_avg;
+	double sync_time_avg;
+	int64_t sync_batch_p50;
+	int64_t sync_batch_p99;
+	int64_t sync_time_p50;
+	int64_t sync_time_p99;
+	char sync_batch_hist[1024];
+	char sync_time_hist[1024];
+};
+
+static int
+wal_stat_f(struct cbus_call_msg *data)
+{
+	struct wal_stat_msg *msg = (struct wal_stat_msg *) data;
+	struct wal_writer *writer = &wal_writer_singleton;
+	msg->sync_count = writer->sync_count;
+	msg->sync_window = wal_sync_window(writer);
+	msg->sync_batch_avg = writer->sync_batch_avg;
+	msg->sync_time_avg = writer->sync_time_avg;
+	msg->sync_batch_p50 = histogram_percentile(writer->sync_batch_hist, 50);
+	msg->sync_batch_p99 = histogram_percentile(writer->sync_batch_hist, 99);
+	msg->sync_time_p50 = histogram_percentile(writer->sync_time_hist, 50);
+	msg->sync_time_p99 = histogram_percentile(writer->sync_time_hist, 99);
+	histogram_snprint(msg->sync_batch_hist, sizeof(msg->sync_batch_hist),
+			  writer->sync_batch_hist);
+	histogram_snprint(msg->sync_time_hist, sizeof(msg->sync_time_hist),
+			  writer->sync_time_hist);
+	return 0;
+}
+
+void
+wal_stat(struct info_handler *h)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_stat_msg msg;
+	memset(&msg, 0, sizeof(msg));
+	if (writer->sync_batch_hist != NULL) {
+		bool cancellable = fiber_set_cancellable(false);
+		cbus_call(&wal_thread.wal_pipe, &wal_thread.tx_pipe, &msg,
+			  wal_stat_f, NULL, TIMEOUT_INFINITY);
+		fiber_set_cancellable(cancellable);
+	}
+
+	info_begin(h);
+	info_append_int(h, "sync_count", msg.sync_count);
+	info_append_double(h, "sync_window", msg.sync_window);
+
+	info_table_begin(h, "sync_batch");
+	info_append_double(h, "avg", msg.sync_batch_avg);
+	info_append_int(h, "p50", msg.sync_batch_p50);
+	info_append_int(h, "p99", msg.sync_batch_p99);
+	info_append_str(h, "histogram", msg.sync_batch_hist);
+	info_table_end(h);
+
+	info_table_begin(h, "sync_time");
+	info_append_double(h, "avg", msg.sync_time_avg * 1000000);
+	info_append_int(h, "p50", msg.sync_time_p50);
+	info_append_int(h, "p99", msg.sync_time_p99);
+	info_append_str(h, "histogram", msg.sync_time_hist);
+	info_table_end(h);
+
+	info_end(h);
+}
+
+static int
+wal_reset_stat_f(struct cbus_call_msg *data)
+{
+	(void) data;
+	struct wal_writer *writer = &wal_writer_singleton;
+	writer->sync_count = 0;
+	histogram_reset(writer->sync_batch_hist);
+	histogram_reset(writer->sync_time_hist);
+	return 0;
+}
+
+void
+wal_reset_stat(void)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	if (writer->sync_batch_hist == NULL)
+		return;
+	struct cbus_call_msg msg;
+	bool cancellable = fiber_set_cancellable(false);
+	cbus_call(&wal_thread.wal_pipe, &wal_thread.tx_pipe, &msg,
+		  wal_reset_stat_f, NULL, TIMEOUT_INFINITY);
+	fiber_set_cancellable(cancellable);
+}
+
 static void
 wal_watcher_notify(struct wal_watcher *watcher, unsigned events)
 {
@@ -917,6 +1500,8 @@ wal_watcher_attach(void *arg)
 	struct wal_writer *writer = &wal_writer_singleton;
 
 	assert(rlist_empty(&watcher->next));
+	if (rlist_empty(&writer->watchers))
+		wal_ring_reset(writer);
 	rlist_add_tail_entry(&writer->watchers, watcher, next);
 
 	/*
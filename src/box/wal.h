@@ -39,6 +39,8 @@
 struct fiber;
 struct vclock;
 struct wal_writer;
+struct info_handler;
+struct ibuf;
 
 enum wal_mode { WAL_NONE = 0, WAL_WRITE, WAL_FSYNC, WAL_MODE_MAX };
 
@@ -135,6 +137,52 @@ void
 wal_clear_watcher(struct wal_watcher *watcher,
 		  void (*process_cb)(struct cbus_endpoint *));
 
+/**
+ * Header of a row in the ring of rows recently written to
+ * the WAL. It is followed by the row encoded as in xlog files,
+ * without the fixheader.
+ */
+struct wal_ring_row {
+	/** Size of the encoded row. */
+	uint32_t size;
+	/** Replica id of the row. */
+	uint32_t replica_id;
+	/** LSN of the row. */
+	int64_t lsn;
+};
+
+/**
+ * Find the first row following the given vclock in the ring
+ * of rows recently written to the WAL. Can only be called by
+ * a registered WAL watcher.
+ *
+ * @param vclock      Vclock of the rows the caller already has.
+ * @param[out] pos    Position of the next row in the ring.
+ *
+ * @retval 0 success
+ * @retval -1 some rows following the vclock have already left
+ *            the ring and must be read from xlog files
+ */
+int
+wal_ring_seek(const struct vclock *vclock, uint64_t *pos);
+
+/**
+ * Copy rows from the ring of rows recently written to the WAL,
+ * starting at the given position, to a buffer. Each row is
+ * stored as struct wal_ring_row followed by the encoded row.
+ * Copying stops when the ring is exhausted or at least @size
+ * bytes are copied. The position is advanced past the copied
+ * rows.
+ *
+ * @retval >= 0 the number of bytes copied
+ * @retval -1 the rows at the position have been overwritten,
+ *            i.e. the reader lags too far behind, or memory
+ *            allocation failed; the rows must be read from
+ *            xlog files
+ */
+ssize_t
+wal_ring_read(uint64_t *pos, struct ibuf *buf, size_t size);
+
 void
 wal_atfork();
 
@@ -176,6 +224,19 @@ wal_write_vy_log(struct journal_entry *req);
 void
 wal_rotate_vy_log();
 
+/**
+ * Fill WAL statistics: the number of WAL syncs done in
+ * wal_mode = "fsync", the current group commit window, in
+ * seconds, and distributions of the number of transactions
+ * per sync and of the sync time, in microseconds.
+ */
+void
+wal_stat(struct info_handler *h);
+
+/** Reset WAL statistics. */
+void
+wal_reset_stat(void);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
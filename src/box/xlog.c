@@ -37,6 +37,7 @@
 #include "exception.h"
 #include "crc32.h"
 #include "fio.h"
+#include "tt_pthread.h"
 #include "third_party/tarantool_eio.h"
 #include <msgpuck.h>
 
@@ -658,6 +659,7 @@ xlog_init(struct xlog *xlog)
 	xlog->sync_interval = SNAP_SYNC_INTERVAL;
 	xlog->sync_time = ev_monotonic_time();
 	xlog->is_autocommit = true;
+	tt_pthread_mutex_init(&xlog->mutex, NULL);
 	obuf_create(&xlog->obuf, &cord()->slabc, XLOG_TX_AUTOCOMMIT_THRESHOLD);
 	obuf_create(&xlog->zbuf, &cord()->slabc, XLOG_TX_AUTOCOMMIT_THRESHOLD);
 	xlog->zctx = ZSTD_createCCtx();
@@ -682,6 +684,7 @@ xlog_destroy(struct xlog *xlog)
 	obuf_destroy(&xlog->obuf);
 	obuf_destroy(&xlog->zbuf);
 	ZSTD_freeCCtx(xlog->zctx);
+	tt_pthread_mutex_destroy(&xlog->mutex);
 	TRASH(xlog);
 	xlog->fd = -1;
 }
@@ -752,6 +755,22 @@ err:
 	return -1;
 }
 
+int
+xlog_create_shared(struct xlog *xlog, struct xlog *parent)
+{
+	assert(parent->parent == NULL);
+	if (xlog_init(xlog) != 0) {
+		xlog_destroy(xlog);
+		return -1;
+	}
+	xlog->meta = parent->meta;
+	xlog->is_inprogress = parent->is_inprogress;
+	snprintf(xlog->filename, PATH_MAX, "%s", parent->filename);
+	xlog->fd = parent->fd;
+	xlog->parent = parent;
+	return 0;
+}
+
 int
 xlog_open(struct xlog *xlog, const char *name)
 {
@@ -885,13 +904,14 @@ xdir_create_xlog(struct xdir *dir, struct xlog *xlog,
 }
 
 /**
- * Write a sequence of uncompressed xrow objects.
+ * Prepare a sequence of uncompressed xrow objects for writing:
+ * fill the fixheader reserved in the output buffer.
  *
  * @retval -1 error
- * @retval >= 0 the number of bytes written
+ * @retval 0 success, the block is in log->obuf
  */
-static off_t
-xlog_tx_write_plain(struct xlog *log)
+static int
+xlog_tx_encode_plain(struct xlog *log)
 {
 	/**
 	 * We created an obuf savepoint at start of xlog_tx,
@@ -933,23 +953,16 @@ xlog_tx_write_plain(struct xlog *log)
 		diag_set(ClientError, ER_INJECTION, "xlog write injection");
 		return -1;
 	});
-
-	ssize_t written = fio_writevn(log->fd, log->obuf.iov, log->obuf.pos + 1);
-	if (written < 0) {
-		diag_set(SystemError, "failed to write to '%s' file",
-			 log->filename);
-		return -1;
-	}
-	return obuf_size(&log->obuf);
+	return 0;
 }
 
 /**
- * Write a compressed block of xrow objects.
+ * Compress a block of xrow objects.
  * @retval -1  error
- * @retval >= 0 the number of bytes written
+ * @retval 0 success, the block is in log->zbuf
  */
-static off_t
-xlog_tx_write_zstd(struct xlog *log)
+static int
+xlog_tx_encode_zstd(struct xlog *log)
 {
 	char *fixheader = (char *)obuf_alloc(&log->zbuf,
 					     XLOG_FIXHEADER_SIZE);
@@ -1019,20 +1032,9 @@ xlog_tx_write_zstd(struct xlog *log)
 
 	ERROR_INJECT(ERRINJ_WAL_WRITE_DISK, {
 		diag_set(ClientError, ER_INJECTION, "xlog write injection");
-		obuf_reset(&log->zbuf);
 		goto error;
 	});
-
-	ssize_t written;
-	written = fio_writevn(log->fd, log->zbuf.iov,
-			      log->zbuf.pos + 1);
-	if (written < 0) {
-		diag_set(SystemError, "failed to write to '%s' file",
-			 log->filename);
-		goto error;
-	}
-	obuf_reset(&log->zbuf);
-	return written;
+	return 0;
 error:
 	obuf_reset(&log->zbuf);
 	return -1;
@@ -1051,18 +1053,37 @@ xlog_tx_write(struct xlog *log)
 {
 	if (obuf_size(&log->obuf) == XLOG_FIXHEADER_SIZE)
 		return 0;
-	ssize_t written;
 
+	struct obuf *buf;
+	int rc;
 	if (obuf_size(&log->obuf) >= XLOG_TX_COMPRESS_THRESHOLD) {
-		written = xlog_tx_write_zstd(log);
+		rc = xlog_tx_encode_zstd(log);
+		buf = &log->zbuf;
 	} else {
-		written = xlog_tx_write_plain(log);
+		rc = xlog_tx_encode_plain(log);
+		buf = &log->obuf;
+	}
+	/*
+	 * A shared file is appended by one writer at a time,
+	 * while the blocks are compressed in parallel.
+	 */
+	struct xlog *file = log->parent != NULL ? log->parent : log;
+	if (log->parent != NULL)
+		tt_pthread_mutex_lock(&file->mutex);
+	ssize_t written = -1;
+	if (rc == 0) {
+		written = fio_writevn(file->fd, buf->iov, buf->pos + 1);
+		if (written < 0) {
+			diag_set(SystemError, "failed to write to '%s' file",
+				 file->filename);
+		}
 	}
 	ERROR_INJECT(ERRINJ_WAL_WRITE, {
 		diag_set(ClientError, ER_INJECTION, "xlog write injection");
 		written = -1;
 	});
 
+	obuf_reset(&log->zbuf);
 	obuf_reset(&log->obuf);
 	/*
 	 * Simplify recovery after a temporary write failure:
@@ -1070,52 +1091,58 @@ xlog_tx_write(struct xlog *log)
 	 * position.
 	 */
 	if (written < 0) {
-		if (lseek(log->fd, log->offset, SEEK_SET) < 0 ||
-		    ftruncate(log->fd, log->offset) != 0)
+		if (lseek(file->fd, file->offset, SEEK_SET) < 0 ||
+		    ftruncate(file->fd, file->offset) != 0)
 			panic_syserror("failed to truncate xlog after write error");
+		if (log->parent != NULL)
+			tt_pthread_mutex_unlock(&file->mutex);
 		return -1;
 	}
-	log->offset += written;
-	log->rows += log->tx_rows;
+	file->offset += written;
+	file->rows += log->tx_rows;
+	if (log->parent != NULL)
+		log->rows += log->tx_rows;
 	log->tx_rows = 0;
-	if ((log->sync_interval && log->offset >=
-	    (off_t)(log->synced_size + log->sync_interval)) ||
-	    (log->rate_limit && log->offset >=
-	    (off_t)(log->synced_size + log->rate_limit))) {
-		off_t sync_from = SYNC_ROUND_DOWN(log->synced_size);
-		size_t sync_len = SYNC_ROUND_UP(log->offset) -
+	if ((file->sync_interval && file->offset >=
+	    (off_t)(file->synced_size + file->sync_interval)) ||
+	    (file->rate_limit && file->offset >=
+	    (off_t)(file->synced_size + file->rate_limit))) {
+		off_t sync_from = SYNC_ROUND_DOWN(file->synced_size);
+		size_t sync_len = SYNC_ROUND_UP(file->offset) -
 				  sync_from;
-		if (log->rate_limit > 0) {
+		if (file->rate_limit > 0) {
 			double throttle_time;
-			throttle_time = (double)sync_len / log->rate_limit -
-					(ev_monotonic_time() - log->sync_time);
+			throttle_time = (double)sync_len / file->rate_limit -
+					(ev_monotonic_time() - file->sync_time);
 			if (throttle_time > 0)
 				fiber_sleep(throttle_time);
 		}
 		/** sync data from cache to disk */
 #ifdef HAVE_SYNC_FILE_RANGE
-		sync_file_range(log->fd, sync_from, sync_len,
+		sync_file_range(file->fd, sync_from, sync_len,
 				SYNC_FILE_RANGE_WAIT_BEFORE |
 				SYNC_FILE_RANGE_WRITE |
 				SYNC_FILE_RANGE_WAIT_AFTER);
 #else
-		fdatasync(log->fd);
+		fdatasync(file->fd);
 #endif /* HAVE_SYNC_FILE_RANGE */
-		log->sync_time = ev_monotonic_time();
-		if (log->free_cache) {
+		file->sync_time = ev_monotonic_time();
+		if (file->free_cache) {
 #ifdef HAVE_POSIX_FADVISE
 			/** free page cache */
-			if (posix_fadvise(log->fd, sync_from, sync_len,
+			if (posix_fadvise(file->fd, sync_from, sync_len,
 					  POSIX_FADV_DONTNEED) != 0) {
-				say_syserror("posix_fadvise, fd=%i", log->fd);
+				say_syserror("posix_fadvise, fd=%i", file->fd);
 			}
 #else
 			(void) sync_from;
 			(void) sync_len;
 #endif /* HAVE_POSIX_FADVISE */
 		}
-		log->synced_size = log->offset;
+		file->synced_size = file->offset;
 	}
+	if (log->parent != NULL)
+		tt_pthread_mutex_unlock(&file->mutex);
 	return written;
 }
 
@@ -1282,6 +1309,11 @@ xlog_write_eof(struct xlog *l)
 int
 xlog_close(struct xlog *l, bool reuse_fd)
 {
+	if (l->parent != NULL) {
+		/* The file is owned by the parent xlog. */
+		xlog_destroy(l);
+		return 0;
+	}
 	int rc = xlog_write_eof(l);
 	if (rc < 0)
 		say_error("%s: failed to write EOF marker: %s", l->filename,
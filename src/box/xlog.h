@@ -33,6 +33,7 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <sys/stat.h>
+#include <pthread.h>
 #include "tt_uuid.h"
 #include "vclock.h"
 
@@ -311,6 +312,14 @@ struct xlog {
 	uint64_t rate_limit;
 	/** Time when xlog wast synced last time */
 	double sync_time;
+	/**
+	 * If not NULL, the xlog doesn't own a file and appends
+	 * tx blocks to the file of the parent xlog, which may be
+	 * shared by several threads, see xlog_create_shared().
+	 */
+	struct xlog *parent;
+	/** Serializes appends of the xlogs sharing this file. */
+	pthread_mutex_t mutex;
 };
 
 /**
@@ -359,6 +368,24 @@ int
 xlog_create(struct xlog *xlog, const char *name, int flags,
 	    const struct xlog_meta *meta);
 
+/**
+ * Create a writer appending to the file of another xlog.
+ *
+ * Rows written to @a xlog are accumulated and compressed in
+ * its own buffers, so writers of the same file may be used
+ * by different threads concurrently. Complete tx blocks are
+ * appended to the file of @a parent one at a time. The order
+ * of blocks written by different writers is unspecified.
+ *
+ * The writer must be closed with xlog_close() before
+ * @a parent. It doesn't write the EOF marker.
+ *
+ * @retval 0 success
+ * @retval -1 error
+ */
+int
+xlog_create_shared(struct xlog *xlog, struct xlog *parent);
+
 /**
  * Open an existing xlog file for appending.
  * @param xlog          xlog descriptor
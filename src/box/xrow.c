@@ -409,13 +409,14 @@ iproto_reply_map_key(struct obuf *buf, uint32_t size, uint8_t key)
 }
 
 void
-iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
-		    uint32_t schema_version, uint32_t count)
+iproto_reply_select_spliced(struct obuf *buf, struct obuf_svp *svp,
+			    uint64_t sync, uint32_t schema_version,
+			    uint32_t count, size_t spliced_size)
 {
 	char *pos = (char *) obuf_svp_to_ptr(buf, svp);
 	iproto_header_encode(pos, IPROTO_OK, sync, schema_version,
-			        obuf_size(buf) - svp->used -
-				IPROTO_HEADER_LEN);
+			        obuf_size(buf) - svp->used +
+				spliced_size - IPROTO_HEADER_LEN);
 
 	struct iproto_body_bin body = iproto_body_bin;
 	body.v_data_len = mp_bswap_u32(count);
@@ -423,6 +424,29 @@ iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 	memcpy(pos + IPROTO_HEADER_LEN, &body, sizeof(body));
 }
 
+int
+iproto_reply_select_cursor(struct obuf *buf, struct obuf_svp *svp,
+			   uint64_t sync, uint32_t schema_version,
+			   uint32_t count, size_t spliced_size,
+			   uint64_t cursor_id)
+{
+	size_t size = mp_sizeof_uint(IPROTO_CURSOR_ID) +
+		      mp_sizeof_uint(cursor_id);
+	char *pos = (char *) obuf_alloc(buf, size);
+	if (pos == NULL) {
+		diag_set(OutOfMemory, size, "obuf_alloc", "pos");
+		return -1;
+	}
+	pos = mp_encode_uint(pos, IPROTO_CURSOR_ID);
+	pos = mp_encode_uint(pos, cursor_id);
+	iproto_reply_select_spliced(buf, svp, sync, schema_version,
+				    count, spliced_size);
+	/* The body is {IPROTO_DATA: [...], IPROTO_CURSOR_ID: id}. */
+	pos = (char *) obuf_svp_to_ptr(buf, svp);
+	*(pos + IPROTO_HEADER_LEN) = 0x82;
+	return 0;
+}
+
 void
 iproto_reply_sql(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 		 uint32_t schema_version, int keys)
@@ -497,6 +521,12 @@ error:
 		case IPROTO_ITERATOR:
 			request->iterator = mp_decode_uint(&value);
 			break;
+		case IPROTO_FETCH_SIZE:
+			request->fetch_size = mp_decode_uint(&value);
+			break;
+		case IPROTO_CURSOR_ID:
+			request->cursor_id = mp_decode_uint(&value);
+			break;
 		case IPROTO_TUPLE:
 			request->tuple = value;
 			request->tuple_end = data;
@@ -864,7 +894,7 @@ int
 xrow_encode_subscribe(struct xrow_header *row,
 		      const struct tt_uuid *replicaset_uuid,
 		      const struct tt_uuid *instance_uuid,
-		      const struct vclock *vclock)
+		      const struct vclock *vclock, uint32_t compression)
 {
 	memset(row, 0, sizeof(*row));
 	uint32_t replicaset_size = vclock_size(vclock);
@@ -876,7 +906,8 @@ xrow_encode_subscribe(struct xrow_header *row,
 		return -1;
 	}
 	char *data = buf;
-	data = mp_encode_map(data, 4);
+	data = mp_encode_map(data, compression != IPROTO_COMPRESSION_NONE ?
+			     5 : 4);
 	data = mp_encode_uint(data, IPROTO_CLUSTER_UUID);
 	data = xrow_encode_uuid(data, replicaset_uuid);
 	data = mp_encode_uint(data, IPROTO_INSTANCE_UUID);
@@ -891,6 +922,10 @@ xrow_encode_subscribe(struct xrow_header *row,
 	}
 	data = mp_encode_uint(data, IPROTO_SERVER_VERSION);
 	data = mp_encode_uint(data, tarantool_version_id());
+	if (compression != IPROTO_COMPRESSION_NONE) {
+		data = mp_encode_uint(data, IPROTO_COMPRESSION);
+		data = mp_encode_uint(data, compression);
+	}
 	assert(data <= buf + size);
 	row->body[0].iov_base = buf;
 	row->body[0].iov_len = (data - buf);
@@ -902,7 +937,7 @@ xrow_encode_subscribe(struct xrow_header *row,
 int
 xrow_decode_subscribe(struct xrow_header *row, struct tt_uuid *replicaset_uuid,
 		      struct tt_uuid *instance_uuid, struct vclock *vclock,
-		      uint32_t *version_id)
+		      uint32_t *version_id, uint32_t *compression)
 {
 	if (row->bodycnt == 0) {
 		diag_set(ClientError, ER_INVALID_MSGPACK, "request body");
@@ -961,6 +996,16 @@ xrow_decode_subscribe(struct xrow_header *row, struct tt_uuid *replicaset_uuid,
 			}
 			*version_id = mp_decode_uint(&d);
 			break;
+		case IPROTO_COMPRESSION:
+			if (compression == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_UINT) {
+				diag_set(ClientError, ER_INVALID_MSGPACK,
+					 "invalid COMPRESSION");
+				return -1;
+			}
+			*compression = mp_decode_uint(&d);
+			break;
 		default: skip:
 			mp_next(&d); /* value */
 		}
@@ -988,6 +1033,86 @@ xrow_decode_subscribe(struct xrow_header *row, struct tt_uuid *replicaset_uuid,
 	return 0;
 }
 
+int
+xrow_encode_compressed_rows(struct xrow_header *row, const char *data,
+			    uint32_t size)
+{
+	memset(row, 0, sizeof(*row));
+	size_t buf_size = mp_sizeof_map(2) +
+		mp_sizeof_uint(IPROTO_COMPRESSION) +
+		mp_sizeof_uint(IPROTO_COMPRESSION_ZSTD) +
+		mp_sizeof_uint(IPROTO_DATA) + mp_sizeof_binl(size);
+	char *buf = (char *) region_alloc(&fiber()->gc, buf_size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, buf_size, "region_alloc", "buf");
+		return -1;
+	}
+	char *d = buf;
+	d = mp_encode_map(d, 2);
+	d = mp_encode_uint(d, IPROTO_COMPRESSION);
+	d = mp_encode_uint(d, IPROTO_COMPRESSION_ZSTD);
+	d = mp_encode_uint(d, IPROTO_DATA);
+	d = mp_encode_binl(d, size);
+	assert(d == buf + buf_size);
+	row->body[0].iov_base = buf;
+	row->body[0].iov_len = buf_size;
+	row->body[1].iov_base = (void *) data;
+	row->body[1].iov_len = size;
+	row->bodycnt = 2;
+	row->type = IPROTO_COMPRESSED_ROWS;
+	return 0;
+}
+
+int
+xrow_decode_compressed_rows(struct xrow_header *row, const char **data,
+			    uint32_t *size)
+{
+	if (row->bodycnt == 0)
+		goto error;
+	assert(row->bodycnt == 1);
+	const char *d = (const char *) row->body[0].iov_base;
+	const char *end = d + row->body[0].iov_len;
+	const char *check = d;
+	if (mp_check(&check, end) != 0 || mp_typeof(*d) != MP_MAP)
+		goto error;
+	uint32_t compression = IPROTO_COMPRESSION_NONE;
+	*data = NULL;
+	uint32_t map_size = mp_decode_map(&d);
+	for (uint32_t i = 0; i < map_size; i++) {
+		if (mp_typeof(*d) != MP_UINT) {
+			mp_next(&d); /* key */
+			mp_next(&d); /* value */
+			continue;
+		}
+		uint64_t key = mp_decode_uint(&d);
+		switch (key) {
+		case IPROTO_COMPRESSION:
+			if (mp_typeof(*d) != MP_UINT)
+				goto error;
+			compression = mp_decode_uint(&d);
+			break;
+		case IPROTO_DATA:
+			if (mp_typeof(*d) != MP_BIN)
+				goto error;
+			*data = mp_decode_bin(&d, size);
+			break;
+		default:
+			mp_next(&d); /* value */
+		}
+	}
+	if (*data == NULL)
+		goto error;
+	if (compression != IPROTO_COMPRESSION_ZSTD) {
+		diag_set(ClientError, ER_DECOMPRESSION,
+			 "unknown compression algorithm");
+		return -1;
+	}
+	return 0;
+error:
+	diag_set(ClientError, ER_INVALID_MSGPACK, "compressed rows");
+	return -1;
+}
+
 int
 xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid)
 {
@@ -130,6 +130,10 @@ struct request {
 	uint32_t offset;
 	uint32_t limit;
 	uint32_t iterator;
+	/** SELECT/FETCH chunk size, IPROTO_FETCH_SIZE. */
+	uint32_t fetch_size;
+	/** FETCH cursor id, IPROTO_CURSOR_ID. */
+	uint64_t cursor_id;
 	/** Search key. */
 	const char *key;
 	const char *key_end;
@@ -248,6 +252,8 @@ xrow_encode_request_vote(struct xrow_header *row);
  * @param replicaset_uuid Replica set uuid.
  * @param instance_uuid Instance uuid.
  * @param vclock Replication clock.
+ * @param compression Compression of the row stream the replica
+ *        asks for, see enum iproto_compression.
  *
  * @retval  0 Success.
  * @retval -1 Memory error.
@@ -256,7 +262,7 @@ int
 xrow_encode_subscribe(struct xrow_header *row,
 		      const struct tt_uuid *replicaset_uuid,
 		      const struct tt_uuid *instance_uuid,
-		      const struct vclock *vclock);
+		      const struct vclock *vclock, uint32_t compression);
 
 /**
  * Decode SUBSCRIBE command.
@@ -264,6 +270,8 @@ xrow_encode_subscribe(struct xrow_header *row,
  * @param[out] replicaset_uuid.
  * @param[out] instance_uuid.
  * @param[out] vclock.
+ * @param[out] version_id.
+ * @param[out] compression, left intact if not requested.
  *
  * @retval  0 Success.
  * @retval -1 Memory or format error.
@@ -271,7 +279,43 @@ xrow_encode_subscribe(struct xrow_header *row,
 int
 xrow_decode_subscribe(struct xrow_header *row, struct tt_uuid *replicaset_uuid,
 		      struct tt_uuid *instance_uuid, struct vclock *vclock,
-		      uint32_t *version_id);
+		      uint32_t *version_id, uint32_t *compression);
+
+/** Statistics of replication stream compression. */
+struct xrow_compression_stat {
+	/** Size of rows before compression. */
+	uint64_t raw_size;
+	/** Size of compressed frames. */
+	uint64_t compressed_size;
+	/** CPU time spent compressing or decompressing, in seconds. */
+	double time;
+};
+
+/**
+ * Encode a batch of rows compressed by a relay.
+ * @param[out] row Row to encode into.
+ * @param data Encoded rows compressed with zstd.
+ * @param size Size of data, which is not copied.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+xrow_encode_compressed_rows(struct xrow_header *row, const char *data,
+			    uint32_t size);
+
+/**
+ * Decode a batch of compressed rows.
+ * @param row Row to decode.
+ * @param[out] data Compressed data.
+ * @param[out] size Size of data.
+ *
+ * @retval  0 Success.
+ * @retval -1 Format error or unknown compression algorithm.
+ */
+int
+xrow_decode_compressed_rows(struct xrow_header *row, const char **data,
+			    uint32_t *size);
 
 /**
  * Encode JOIN command.
@@ -295,7 +339,8 @@ xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid);
 static inline int
 xrow_decode_join(struct xrow_header *row, struct tt_uuid *instance_uuid)
 {
-	return xrow_decode_subscribe(row, NULL, instance_uuid, NULL, NULL);
+	return xrow_decode_subscribe(row, NULL, instance_uuid, NULL, NULL,
+				     NULL);
 }
 
 /**
@@ -320,7 +365,7 @@ xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock);
 static inline int
 xrow_decode_vclock(struct xrow_header *row, struct vclock *vclock)
 {
-	return xrow_decode_subscribe(row, NULL, NULL, vclock, NULL);
+	return xrow_decode_subscribe(row, NULL, NULL, vclock, NULL, NULL);
 }
 
 /**
@@ -378,13 +423,43 @@ iproto_prepare_select(struct obuf *buf, struct obuf_svp *svp)
 	return iproto_prepare_header(buf, svp, IPROTO_SELECT_HEADER_LEN);
 }
 
+/**
+ * Finish a chunk of a streamed select result set, the same way
+ * iproto_reply_select_spliced() finishes a select result set,
+ * and append the id of the cursor to fetch the next chunk from
+ * to the reply body.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+iproto_reply_select_cursor(struct obuf *buf, struct obuf_svp *svp,
+			   uint64_t sync, uint32_t schema_version,
+			   uint32_t count, size_t spliced_size,
+			   uint64_t cursor_id);
+
 /**
  * Write select header to a preallocated buffer.
  * This function doesn't throw (and we rely on this in iproto.cc).
+ * @param spliced_size Size of the result set data which is not
+ *        stored in @a buf, but is sent from tuple memory
+ *        directly (see zero-copy replies in iproto.cc).
  */
 void
+iproto_reply_select_spliced(struct obuf *buf, struct obuf_svp *svp,
+			    uint64_t sync, uint32_t schema_version,
+			    uint32_t count, size_t spliced_size);
+
+/**
+ * Write select header to a preallocated buffer.
+ * This function doesn't throw (and we rely on this in iproto.cc).
+ */
+static inline void
 iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
-		    uint32_t schema_version, uint32_t count);
+		    uint32_t schema_version, uint32_t count)
+{
+	iproto_reply_select_spliced(buf, svp, sync, schema_version, count, 0);
+}
 
 /**
  * Write header of the key to a preallocated buffer by svp.
@@ -613,10 +688,10 @@ static inline void
 xrow_encode_subscribe_xc(struct xrow_header *row,
 			 const struct tt_uuid *replicaset_uuid,
 			 const struct tt_uuid *instance_uuid,
-			 const struct vclock *vclock)
+			 const struct vclock *vclock, uint32_t compression)
 {
 	if (xrow_encode_subscribe(row, replicaset_uuid, instance_uuid,
-				  vclock) != 0)
+				  vclock, compression) != 0)
 		diag_raise();
 }
 
@@ -625,10 +700,11 @@ static inline void
 xrow_decode_subscribe_xc(struct xrow_header *row,
 			 struct tt_uuid *replicaset_uuid,
 		         struct tt_uuid *instance_uuid, struct vclock *vclock,
-			 uint32_t *replica_version_id)
+			 uint32_t *replica_version_id, uint32_t *compression)
 {
 	if (xrow_decode_subscribe(row, replicaset_uuid, instance_uuid,
-				  vclock, replica_version_id) != 0)
+				  vclock, replica_version_id,
+				  compression) != 0)
 		diag_raise();
 }
 
@@ -31,9 +31,18 @@
 #include "cbus.h"
 
 #include <limits.h>
+#include <pmatomic.h>
 #include "fiber.h"
 #include "trigger.h"
 
+enum {
+	/**
+	 * How many times cbus_loop() polls an empty endpoint
+	 * queue before going to sleep.
+	 */
+	CBUS_POLL_COUNT = 256,
+};
+
 /**
  * Cord interconnect.
  */
@@ -87,6 +96,147 @@ static void
 cpipe_flush_cb(ev_loop * /* loop */, struct ev_async *watcher,
 	       int /* events */);
 
+/** Hint the CPU that we are busy-waiting. */
+static inline void
+cbus_cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	__asm__ __volatile__("yield" ::: "memory");
+#endif
+}
+
+/**
+ * Append a chain of messages to the endpoint queue.
+ * Can be called from any cord.
+ */
+static inline void
+cbus_endpoint_push(struct cbus_endpoint *endpoint,
+		   struct stailq_entry *first, struct stailq_entry *last)
+{
+	last->next = NULL;
+	struct stailq_entry *prev =
+		pm_atomic_exchange_explicit(&endpoint->queue_tail, last,
+					    pm_memory_order_seq_cst);
+	/*
+	 * Until the link is stored, the consumer sees the
+	 * queue end at prev, see cbus_endpoint_fetch().
+	 */
+	pm_atomic_store_explicit(&prev->next, first,
+				 pm_memory_order_release);
+}
+
+/**
+ * Return true if the endpoint queue has no messages, neither
+ * fetchable nor being appended. Must be called by the consumer.
+ */
+static inline bool
+cbus_endpoint_is_empty(struct cbus_endpoint *endpoint)
+{
+	return pm_atomic_load_explicit(&endpoint->queue_tail,
+				       pm_memory_order_seq_cst) ==
+		&endpoint->stub;
+}
+
+/**
+ * Ask the consumer to look at the queue, unless it's known
+ * to do so anyway.
+ */
+static inline void
+cbus_endpoint_wakeup(struct cbus_endpoint *endpoint)
+{
+	if (!pm_atomic_exchange_explicit(&endpoint->wakeup_pending, true,
+					 pm_memory_order_seq_cst)) {
+		/* Count statistics */
+		rmean_collect(cbus.stats, CBUS_STAT_EVENTS, 1);
+
+		ev_async_send(endpoint->consumer, &endpoint->async);
+	}
+}
+
+void
+cbus_endpoint_fetch(struct cbus_endpoint *endpoint, struct stailq *output)
+{
+	/*
+	 * Clear the flag before looking at the queue: a message
+	 * pushed after the walk below is over is then followed
+	 * by a fresh async event.
+	 */
+	pm_atomic_exchange_explicit(&endpoint->wakeup_pending, false,
+				    pm_memory_order_seq_cst);
+	/*
+	 * The walk always ends at the stub, so the next one
+	 * starts from it.
+	 */
+	struct stailq_entry *stub = &endpoint->stub;
+	struct stailq_entry *head = stub;
+	while (true) {
+		struct stailq_entry *next =
+			pm_atomic_load_explicit(&head->next,
+						pm_memory_order_acquire);
+		if (head == stub) {
+			if (next == NULL)
+				break;
+			head = next;
+			continue;
+		}
+		if (next == NULL) {
+			if (head == pm_atomic_load_explicit(&endpoint->queue_tail,
+						pm_memory_order_seq_cst)) {
+				/*
+				 * The last message can't be detached
+				 * while it's the tail, put the stub
+				 * behind it.
+				 */
+				cbus_endpoint_push(endpoint, stub, stub);
+				continue;
+			}
+			/*
+			 * A producer has swapped the tail, but
+			 * hasn't linked its batch yet. Don't wait
+			 * for it: the producer may be preempted.
+			 * Its wakeup, which follows the link, will
+			 * make us fetch the rest. The stub isn't
+			 * in the queue anymore, so it's safe to
+			 * store the resume point in it.
+			 */
+			pm_atomic_store_explicit(&stub->next, head,
+						 pm_memory_order_relaxed);
+			break;
+		}
+		stailq_add_tail(output, head);
+		head = next;
+	}
+}
+
+/**
+ * Poll the endpoint queue for a while before the consumer
+ * goes to sleep. Under load the next batch is usually on its
+ * way already: picking it up here saves the producer an
+ * ev_async_send() and the consumer an event loop iteration.
+ * @retval true if the queue is not empty.
+ */
+static bool
+cbus_endpoint_poll(struct cbus_endpoint *endpoint)
+{
+	/* Producers needn't wake us up while we are polling. */
+	pm_atomic_store_explicit(&endpoint->wakeup_pending, true,
+				 pm_memory_order_seq_cst);
+	for (int i = 0; i < CBUS_POLL_COUNT; i++) {
+		if (!cbus_endpoint_is_empty(endpoint))
+			return true;
+		cbus_cpu_relax();
+	}
+	pm_atomic_exchange_explicit(&endpoint->wakeup_pending, false,
+				    pm_memory_order_seq_cst);
+	/*
+	 * A producer could have skipped the wakeup
+	 * right before the flag was cleared.
+	 */
+	return !cbus_endpoint_is_empty(endpoint);
+}
+
 void
 cpipe_create(struct cpipe *pipe, const char *consumer)
 {
@@ -148,12 +298,13 @@ cpipe_destroy(struct cpipe *pipe)
 	 * we want to control the way the poison message is
 	 * delivered.
 	 */
+	/* Add the pipe shutdown message as the last one. */
+	stailq_add_tail_entry(&pipe->input, poison, msg.fifo);
+	pipe->n_input = 0;
 	tt_pthread_mutex_lock(&endpoint->mutex);
 	/* Flush input */
-	stailq_concat(&endpoint->output, &pipe->input);
-	pipe->n_input = 0;
-	/* Add the pipe shutdown message as the last one. */
-	stailq_add_tail_entry(&endpoint->output, poison, msg.fifo);
+	cbus_endpoint_push(endpoint, stailq_first(&pipe->input),
+			   stailq_last(&pipe->input));
 	/* Count statistics */
 	rmean_collect(cbus.stats, CBUS_STAT_EVENTS, 1);
 	/*
@@ -162,6 +313,8 @@ cpipe_destroy(struct cpipe *pipe)
 	 * ev_async_send() and execution of the poison
 	 * message, after which the endpoint may disappear.
 	 */
+	pm_atomic_store_explicit(&endpoint->wakeup_pending, true,
+				 pm_memory_order_seq_cst);
 	ev_async_send(endpoint->consumer, &endpoint->async);
 	tt_pthread_mutex_unlock(&endpoint->mutex);
 
@@ -218,7 +371,9 @@ cbus_endpoint_create(struct cbus_endpoint *endpoint, const char *name,
 	endpoint->n_pipes = 0;
 	fiber_cond_create(&endpoint->cond);
 	tt_pthread_mutex_init(&endpoint->mutex, NULL);
-	stailq_create(&endpoint->output);
+	endpoint->stub.next = NULL;
+	endpoint->queue_tail = &endpoint->stub;
+	endpoint->wakeup_pending = false;
 	ev_async_init(&endpoint->async,
 		      (void (*)(ev_loop *, struct ev_async *, int)) fetch_cb);
 	endpoint->async.data = fetch_data;
@@ -252,14 +407,14 @@ cbus_endpoint_destroy(struct cbus_endpoint *endpoint,
 	while (true) {
 		if (process_cb)
 			process_cb(endpoint);
-		if (endpoint->n_pipes == 0 && stailq_empty(&endpoint->output))
+		if (endpoint->n_pipes == 0 && cbus_endpoint_is_empty(endpoint))
 			break;
 		 fiber_cond_wait(&endpoint->cond);
 	}
 
 	/*
-	 * Pipe flush func can still lock mutex, so just lock and unlock
-	 * it.
+	 * Pipe destroy func can still lock mutex, so just lock and
+	 * unlock it.
 	 */
 	tt_pthread_mutex_lock(&endpoint->mutex);
 	tt_pthread_mutex_unlock(&endpoint->mutex);
@@ -281,22 +436,13 @@ cpipe_flush_cb(ev_loop *loop, struct ev_async *watcher, int events)
 		return;
 
 	trigger_run(&pipe->on_flush, pipe);
-	/* Trigger task processing when the queue becomes non-empty. */
-	bool output_was_empty;
-
-	tt_pthread_mutex_lock(&endpoint->mutex);
-	output_was_empty = stailq_empty(&endpoint->output);
 	/** Flush input */
-	stailq_concat(&endpoint->output, &pipe->input);
-	tt_pthread_mutex_unlock(&endpoint->mutex);
-
+	cbus_endpoint_push(endpoint, stailq_first(&pipe->input),
+			   stailq_last(&pipe->input));
+	stailq_create(&pipe->input);
 	pipe->n_input = 0;
-	if (output_was_empty) {
-		/* Count statistics */
-		rmean_collect(cbus.stats, CBUS_STAT_EVENTS, 1);
-
-		ev_async_send(endpoint->consumer, &endpoint->async);
-	}
+	/* Trigger task processing unless the consumer is awake. */
+	cbus_endpoint_wakeup(endpoint);
 }
 
 void
@@ -642,6 +788,15 @@ cbus_loop(struct cbus_endpoint *endpoint)
 		cbus_process(endpoint);
 		if (fiber_is_cancelled())
 			break;
+		if (cbus_endpoint_poll(endpoint)) {
+			/*
+			 * Let the event loop run between rounds
+			 * even under steady load, otherwise timers
+			 * and I/O of this cord would starve.
+			 */
+			fiber_reschedule();
+			continue;
+		}
 		fiber_yield();
 	}
 }
@@ -118,7 +118,8 @@ struct cpipe {
 	/**
 	 * When pushing messages, keep the staged input size under
 	 * this limit (speeds up message delivery and reduces
-	 * latency, while still keeping the bus mutex cold enough).
+	 * latency, while still keeping the number of consumer
+	 * wakeups low enough).
 	 */
 	int max_input;
 	/**
@@ -166,7 +167,7 @@ cpipe_destroy(struct cpipe *pipe);
  * Otherwise, the messages flushed once per event loop iteration.
  *
  * @todo: collect bus stats per second and adjust max_input once
- * a second to keep the mutex cold regardless of the message load,
+ * a second to keep wakeups rare regardless of the message load,
  * while still keeping the latency low if there are few
  * long-to-process messages.
  */
@@ -251,10 +252,26 @@ struct cbus_endpoint {
 	char name[FIBER_NAME_MAX];
 	/** Member of cbus->endpoints */
 	struct rlist in_cbus;
-	/** The lock around the pipe. */
+	/**
+	 * The lock serializing pipe destruction with endpoint
+	 * destruction. Messages are delivered without taking it.
+	 */
 	pthread_mutex_t mutex;
-	/** A queue with incoming messages. */
-	struct stailq output;
+	/**
+	 * Incoming messages, a lock-free multi-producer
+	 * single-consumer queue. Producers append batches by
+	 * swapping queue_tail, the consumer walks the list
+	 * from the stub, which always stays in the queue
+	 * so that the tail never becomes NULL.
+	 */
+	struct stailq_entry *queue_tail;
+	/** The head of the incoming message queue. */
+	struct stailq_entry stub;
+	/**
+	 * Set if the consumer is known to look at the queue
+	 * again, so producers needn't send it an async event.
+	 */
+	bool wakeup_pending;
 	/** Consumer cord loop */
 	ev_loop *consumer;
 	/** Async to notify the consumer */
@@ -266,15 +283,11 @@ struct cbus_endpoint {
 };
 
 /**
- * Fetch incomming messages to output
+ * Fetch incomming messages to output. Must be called
+ * by the endpoint consumer.
  */
-static inline void
-cbus_endpoint_fetch(struct cbus_endpoint *endpoint, struct stailq *output)
-{
-	tt_pthread_mutex_lock(&endpoint->mutex);
-	stailq_concat(output, &endpoint->output);
-	tt_pthread_mutex_unlock(&endpoint->mutex);
-}
+void
+cbus_endpoint_fetch(struct cbus_endpoint *endpoint, struct stailq *output);
 
 /** Initialize the global singleton bus. */
 void
@@ -356,6 +356,26 @@ evio_service_bind(struct evio_service *service, const char *uri)
 		  evio_service_name(service));
 }
 
+void
+evio_service_attach(struct evio_service *dst,
+		    const struct evio_service *src)
+{
+	assert(! ev_is_active(&dst->ev));
+	assert(src->ev.fd >= 0);
+	/*
+	 * Use a separate descriptor for the same socket, so that
+	 * every service can stop and close it independently.
+	 */
+	int fd = dup(src->ev.fd);
+	if (fd < 0)
+		tnt_raise(SocketError, src->ev.fd, "dup");
+	snprintf(dst->host, sizeof(dst->host), "%s", src->host);
+	snprintf(dst->serv, sizeof(dst->serv), "%s", src->serv);
+	memcpy(&dst->addrstorage, &src->addrstorage, src->addr_len);
+	dst->addr_len = src->addr_len;
+	ev_io_set(&dst->ev, fd, EV_READ);
+}
+
 /** It's safe to stop a service which is not started yet. */
 void
 evio_service_stop(struct evio_service *service)
@@ -112,6 +112,15 @@ evio_service_bind(struct evio_service *service, const char *uri);
 void
 evio_service_listen(struct evio_service *service);
 
+/**
+ * Make @a dst share the bound acceptor socket of @a src, so
+ * that connections are accepted by both services. The services
+ * may belong to different event loops.
+ */
+void
+evio_service_attach(struct evio_service *dst,
+		    const struct evio_service *src);
+
 /** If started, stop event flow and close the acceptor socket. */
 void
 evio_service_stop(struct evio_service *service);
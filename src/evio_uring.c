@@ -0,0 +1,364 @@
+/*
+ * Copyright 2010-2018, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "evio_uring.h"
+
+#include "trivia/config.h"
+#include "diag.h"
+
+#if defined(HAVE_LINUX_IO_URING_H)
+#include <linux/io_uring.h>
+#endif
+
+/*
+ * IORING_FEAT_FAST_POLL is the oldest feature the backend relies
+ * on, see evio_uring_create().
+ */
+#if defined(HAVE_LINUX_IO_URING_H) && defined(IORING_FEAT_FAST_POLL)
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+
+#include "say.h"
+
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter 426
+#endif
+
+static inline int
+sys_io_uring_setup(unsigned entries, struct io_uring_params *params)
+{
+	return syscall(__NR_io_uring_setup, entries, params);
+}
+
+static inline int
+sys_io_uring_enter(int fd, unsigned to_submit)
+{
+	return syscall(__NR_io_uring_enter, fd, to_submit, 0, 0, NULL, 0);
+}
+
+static void
+evio_uring_submit_cb(ev_loop *loop, struct ev_prepare *watcher, int events)
+{
+	(void) loop;
+	(void) events;
+	evio_uring_submit((struct evio_uring *) watcher->data);
+}
+
+static void
+evio_uring_complete_cb(ev_loop *loop, struct ev_io *watcher, int events)
+{
+	(void) loop;
+	(void) events;
+	struct evio_uring *ring = (struct evio_uring *) watcher->data;
+	unsigned head = *ring->cq_head;
+	while (head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+		struct io_uring_cqe *cqe = &ring->cqes[head & ring->cq_mask];
+		struct evio_uring_req *req =
+			(struct evio_uring_req *) (uintptr_t) cqe->user_data;
+		int res = cqe->res;
+		/*
+		 * Release the entry before invoking the callback,
+		 * which may queue a new request.
+		 */
+		__atomic_store_n(ring->cq_head, ++head, __ATOMIC_RELEASE);
+		ring->inflight--;
+		req->cb(req, res);
+	}
+}
+
+int
+evio_uring_create(struct evio_uring *ring, struct ev_loop *loop,
+		  unsigned entries)
+{
+	memset(ring, 0, sizeof(*ring));
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	ring->fd = sys_io_uring_setup(entries, &params);
+	if (ring->fd < 0) {
+		diag_set(SystemError, "io_uring_setup");
+		return -1;
+	}
+	/*
+	 * Fast poll (Linux 5.7) implies IORING_OP_RECV, IORING_OP_READ and
+	 * reliable -EAGAIN for MSG_DONTWAIT/RWF_NOWAIT requests.
+	 */
+	if ((params.features & IORING_FEAT_FAST_POLL) == 0) {
+		errno = ENOTSUP;
+		diag_set(SystemError, "io_uring: fast poll is not supported");
+		goto err_close;
+	}
+	ring->sq_ring_size = params.sq_off.array +
+			     params.sq_entries * sizeof(unsigned);
+	ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+			     MAP_SHARED | MAP_POPULATE, ring->fd,
+			     IORING_OFF_SQ_RING);
+	if (ring->sq_ring == MAP_FAILED) {
+		diag_set(SystemError, "mmap");
+		goto err_close;
+	}
+	ring->cq_ring_size = params.cq_off.cqes +
+			     params.cq_entries * sizeof(struct io_uring_cqe);
+	ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+			     MAP_SHARED | MAP_POPULATE, ring->fd,
+			     IORING_OFF_CQ_RING);
+	if (ring->cq_ring == MAP_FAILED) {
+		diag_set(SystemError, "mmap");
+		goto err_sq_ring;
+	}
+	ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	ring->sqes = (struct io_uring_sqe *)
+		mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+		     MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+	if (ring->sqes == MAP_FAILED) {
+		diag_set(SystemError, "mmap");
+		goto err_cq_ring;
+	}
+	char *sq = (char *) ring->sq_ring;
+	ring->sq_head = (unsigned *) (sq + params.sq_off.head);
+	ring->sq_tail = (unsigned *) (sq + params.sq_off.tail);
+	ring->sq_array = (unsigned *) (sq + params.sq_off.array);
+	ring->sq_mask = *(unsigned *) (sq + params.sq_off.ring_mask);
+	ring->sq_entries = params.sq_entries;
+	char *cq = (char *) ring->cq_ring;
+	ring->cq_head = (unsigned *) (cq + params.cq_off.head);
+	ring->cq_tail = (unsigned *) (cq + params.cq_off.tail);
+	ring->cqes = (struct io_uring_cqe *) (cq + params.cq_off.cqes);
+	ring->cq_mask = *(unsigned *) (cq + params.cq_off.ring_mask);
+	ring->cq_entries = params.cq_entries;
+
+	ring->loop = loop;
+	ev_prepare_init(&ring->submit, evio_uring_submit_cb);
+	ring->submit.data = ring;
+	ev_prepare_start(loop, &ring->submit);
+	/* The ring descriptor is readable while there are completions. */
+	ev_io_init(&ring->complete, evio_uring_complete_cb, ring->fd, EV_READ);
+	ring->complete.data = ring;
+	ev_io_start(loop, &ring->complete);
+	return 0;
+err_cq_ring:
+	munmap(ring->cq_ring, ring->cq_ring_size);
+err_sq_ring:
+	munmap(ring->sq_ring, ring->sq_ring_size);
+err_close:
+	close(ring->fd);
+	return -1;
+}
+
+void
+evio_uring_destroy(struct evio_uring *ring)
+{
+	ev_prepare_stop(ring->loop, &ring->submit);
+	ev_io_stop(ring->loop, &ring->complete);
+	munmap(ring->sqes, ring->sqes_size);
+	munmap(ring->cq_ring, ring->cq_ring_size);
+	munmap(ring->sq_ring, ring->sq_ring_size);
+	close(ring->fd);
+}
+
+void
+evio_uring_submit(struct evio_uring *ring)
+{
+	while (ring->pending > 0) {
+		int rc = sys_io_uring_enter(ring->fd, ring->pending);
+		if (rc < 0) {
+			if (errno == EINTR)
+				continue;
+			/*
+			 * EAGAIN or EBUSY: the kernel is short of
+			 * resources or the completion queue is
+			 * full. Retry after completions are reaped.
+			 */
+			if (errno != EAGAIN && errno != EBUSY)
+				say_syserror("io_uring_enter");
+			return;
+		}
+		ring->pending -= rc;
+		ring->inflight += rc;
+	}
+}
+
+/**
+ * Get a free submission queue entry. Return NULL if the
+ * submission queue is full or the completion queue could
+ * overflow if one more request was queued.
+ */
+static struct io_uring_sqe *
+evio_uring_get_sqe(struct evio_uring *ring)
+{
+	if (ring->pending + ring->inflight >= ring->cq_entries)
+		return NULL;
+	if (ring->pending == ring->sq_entries) {
+		evio_uring_submit(ring);
+		if (ring->pending == ring->sq_entries)
+			return NULL;
+	}
+	unsigned tail = *ring->sq_tail;
+	unsigned index = tail & ring->sq_mask;
+	struct io_uring_sqe *sqe = &ring->sqes[index];
+	memset(sqe, 0, sizeof(*sqe));
+	ring->sq_array[index] = index;
+	return sqe;
+}
+
+/** Make the entry got with evio_uring_get_sqe() visible to the kernel. */
+static void
+evio_uring_queue_sqe(struct evio_uring *ring, struct io_uring_sqe *sqe,
+		     struct evio_uring_req *req)
+{
+	sqe->user_data = (uint64_t) (uintptr_t) req;
+	__atomic_store_n(ring->sq_tail, *ring->sq_tail + 1, __ATOMIC_RELEASE);
+	ring->pending++;
+}
+
+int
+evio_uring_recv(struct evio_uring *ring, struct evio_uring_req *req,
+		int fd, void *buf, size_t len)
+{
+	struct io_uring_sqe *sqe = evio_uring_get_sqe(ring);
+	if (sqe == NULL)
+		return -1;
+	sqe->opcode = IORING_OP_RECV;
+	sqe->fd = fd;
+	sqe->addr = (uint64_t) (uintptr_t) buf;
+	sqe->len = len;
+	sqe->msg_flags = MSG_DONTWAIT;
+	evio_uring_queue_sqe(ring, sqe, req);
+	return 0;
+}
+
+int
+evio_uring_writev(struct evio_uring *ring, struct evio_uring_req *req,
+		  int fd, const struct iovec *iov, int iovcnt)
+{
+	struct io_uring_sqe *sqe = evio_uring_get_sqe(ring);
+	if (sqe == NULL)
+		return -1;
+	sqe->opcode = IORING_OP_WRITEV;
+	sqe->fd = fd;
+	sqe->addr = (uint64_t) (uintptr_t) iov;
+	sqe->len = iovcnt;
+	sqe->rw_flags = RWF_NOWAIT;
+	evio_uring_queue_sqe(ring, sqe, req);
+	return 0;
+}
+
+int
+evio_uring_pread(struct evio_uring *ring, struct evio_uring_req *req,
+		 int fd, void *buf, size_t len, off_t offset)
+{
+	struct io_uring_sqe *sqe = evio_uring_get_sqe(ring);
+	if (sqe == NULL)
+		return -1;
+	sqe->opcode = IORING_OP_READ;
+	sqe->fd = fd;
+	sqe->off = offset;
+	sqe->addr = (uint64_t) (uintptr_t) buf;
+	sqe->len = len;
+	evio_uring_queue_sqe(ring, sqe, req);
+	return 0;
+}
+
+#else /* !io_uring */
+
+int
+evio_uring_create(struct evio_uring *ring, struct ev_loop *loop,
+		  unsigned entries)
+{
+	(void) ring;
+	(void) loop;
+	(void) entries;
+	diag_set(IllegalParams, "io_uring is not supported on this system");
+	return -1;
+}
+
+void
+evio_uring_destroy(struct evio_uring *ring)
+{
+	(void) ring;
+	unreachable();
+}
+
+int
+evio_uring_recv(struct evio_uring *ring, struct evio_uring_req *req,
+		int fd, void *buf, size_t len)
+{
+	(void) ring;
+	(void) req;
+	(void) fd;
+	(void) buf;
+	(void) len;
+	unreachable();
+	return -1;
+}
+
+int
+evio_uring_writev(struct evio_uring *ring, struct evio_uring_req *req,
+		  int fd, const struct iovec *iov, int iovcnt)
+{
+	(void) ring;
+	(void) req;
+	(void) fd;
+	(void) iov;
+	(void) iovcnt;
+	unreachable();
+	return -1;
+}
+
+int
+evio_uring_pread(struct evio_uring *ring, struct evio_uring_req *req,
+		 int fd, void *buf, size_t len, off_t offset)
+{
+	(void) ring;
+	(void) req;
+	(void) fd;
+	(void) buf;
+	(void) len;
+	(void) offset;
+	unreachable();
+	return -1;
+}
+
+void
+evio_uring_submit(struct evio_uring *ring)
+{
+	(void) ring;
+	unreachable();
+}
+
+#endif /* !io_uring */
@@ -0,0 +1,176 @@
+#ifndef TARANTOOL_EVIO_URING_H_INCLUDED
+#define TARANTOOL_EVIO_URING_H_INCLUDED
+/*
+ * Copyright 2010-2018, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include "tarantool_ev.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Batched socket I/O on top of Linux io_uring.
+ *
+ * Unlike libev, which only reports readiness of a socket so that
+ * every read() and writev() is a syscall of its own, io_uring
+ * lets us queue I/O requests for many sockets and submit them
+ * with a single syscall. The ring lives in a libev loop: requests
+ * queued by event callbacks are submitted all at once right
+ * before the loop blocks (ev_prepare), completions are reaped
+ * when the ring file descriptor becomes readable.
+ *
+ * Requests are issued with MSG_DONTWAIT/RWF_NOWAIT: a request on
+ * a socket which is not ready completes with -EAGAIN instead of
+ * being parked in the kernel, so the readiness can still be
+ * tracked with regular ev_io watchers and a closed socket never
+ * has a request stuck on it.
+ *
+ * File reads are the exception: a regular file is always
+ * "ready", so they are issued as plain asynchronous reads and
+ * let a thread keep many disk requests in flight at once.
+ */
+struct evio_uring_req;
+
+/**
+ * Completion callback. @a res is the result of the request,
+ * as returned by the corresponding syscall, or -errno.
+ */
+typedef void
+(*evio_uring_cb)(struct evio_uring_req *req, int res);
+
+/** An I/O request, usually embedded into its owner. */
+struct evio_uring_req {
+	evio_uring_cb cb;
+};
+
+struct evio_uring {
+	/** io_uring file descriptor. */
+	int fd;
+	/** Submission queue ring, shared with the kernel. */
+	void *sq_ring;
+	size_t sq_ring_size;
+	unsigned *sq_head;
+	unsigned *sq_tail;
+	unsigned *sq_array;
+	unsigned sq_mask;
+	unsigned sq_entries;
+	/** Submission queue entries. */
+	struct io_uring_sqe *sqes;
+	size_t sqes_size;
+	/** Completion queue ring, shared with the kernel. */
+	void *cq_ring;
+	size_t cq_ring_size;
+	unsigned *cq_head;
+	unsigned *cq_tail;
+	struct io_uring_cqe *cqes;
+	unsigned cq_mask;
+	unsigned cq_entries;
+	/** Requests queued, but not submitted yet. */
+	unsigned pending;
+	/** Requests submitted, but not completed yet. */
+	unsigned inflight;
+	/** Submits queued requests before the loop blocks. */
+	struct ev_prepare submit;
+	/** Reaps completions. */
+	struct ev_io complete;
+	struct ev_loop *loop;
+};
+
+/**
+ * Create a ring of @a entries submission queue entries
+ * and attach it to the given event loop.
+ *
+ * @retval  0 Success.
+ * @retval -1 io_uring is not supported by the system or
+ *            memory error, diag is set.
+ */
+int
+evio_uring_create(struct evio_uring *ring, struct ev_loop *loop,
+		  unsigned entries);
+
+/**
+ * Detach the ring from the loop and destroy it. Requests in
+ * flight are abandoned, their callbacks are never invoked.
+ */
+void
+evio_uring_destroy(struct evio_uring *ring);
+
+/**
+ * Queue recv() of at most @a len bytes from @a fd into @a buf.
+ *
+ * @retval  0 Queued, @a req callback is invoked on completion.
+ * @retval -1 The ring is full, the caller is expected to
+ *            fall back to a synchronous call.
+ */
+int
+evio_uring_recv(struct evio_uring *ring, struct evio_uring_req *req,
+		int fd, void *buf, size_t len);
+
+/**
+ * Queue writev() of @a iov to @a fd. @a iov must stay valid
+ * until the request is completed.
+ *
+ * @retval  0 Queued, @a req callback is invoked on completion.
+ * @retval -1 The ring is full, the caller is expected to
+ *            fall back to a synchronous call.
+ */
+int
+evio_uring_writev(struct evio_uring *ring, struct evio_uring_req *req,
+		  int fd, const struct iovec *iov, int iovcnt);
+
+/**
+ * Queue pread() of @a len bytes at @a offset of file @a fd into
+ * @a buf. Unlike socket requests, the read is not issued with
+ * RWF_NOWAIT, so it completes when the data is read from disk.
+ *
+ * @retval  0 Queued, @a req callback is invoked on completion.
+ * @retval -1 The ring is full, the caller is expected to
+ *            fall back to a synchronous call.
+ */
+int
+evio_uring_pread(struct evio_uring *ring, struct evio_uring_req *req,
+		 int fd, void *buf, size_t len, off_t offset);
+
+/**
+ * Submit all queued requests. Called automatically before
+ * the loop blocks.
+ */
+void
+evio_uring_submit(struct evio_uring *ring);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* TARANTOOL_EVIO_URING_H_INCLUDED */
@@ -1207,6 +1207,18 @@ cord_slab_cache(void)
 	return &cord()->slabc;
 }
 
+size_t
+box_region_used(void)
+{
+	return region_used(&fiber()->gc);
+}
+
+void
+box_region_truncate(size_t size)
+{
+	region_truncate(&fiber()->gc, size);
+}
+
 static NOINLINE int
 check_stack_direction(void *prev_stack_frame)
 {
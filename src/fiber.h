@@ -105,7 +105,9 @@ enum fiber_key {
 	/** User global privilege and authentication token */
 	FIBER_KEY_USER = 3,
 	FIBER_KEY_MSG = 4,
-	FIBER_KEY_MAX = 5
+	/** Time spent waiting for WAL, accumulated by txn commit */
+	FIBER_KEY_WAL_WAIT = 5,
+	FIBER_KEY_MAX = 6
 };
 
 /** \cond public */
@@ -329,6 +331,20 @@ struct slab_cache;
 API_EXPORT struct slab_cache *
 cord_slab_cache(void);
 
+/**
+ * Return the amount of memory allocated on the region of the
+ * current fiber, e.g. by box_txn_alloc() or box_tuple_extract_key().
+ */
+API_EXPORT size_t
+box_region_used(void);
+
+/**
+ * Free memory allocated on the region of the current fiber
+ * after the moment box_region_used() returned @a size.
+ */
+API_EXPORT void
+box_region_truncate(size_t size);
+
 /** \endcond public */
 
 /**
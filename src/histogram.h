@@ -82,6 +82,13 @@ histogram_collect(struct histogram *hist, int64_t val);
 void
 histogram_discard(struct histogram *hist, int64_t val);
 
+/**
+ * Add all observations of a histogram to another one.
+ * Both histograms must have the same bucket boundaries.
+ */
+void
+histogram_merge(struct histogram *dst, const struct histogram *src);
+
 /**
  * Calculate a percentile, i.e. the value below which a given
  * percentage of observations fall.
@@ -89,6 +96,13 @@ histogram_discard(struct histogram *hist, int64_t val);
 int64_t
 histogram_percentile(struct histogram *hist, int pct);
 
+/**
+ * Same as histogram_percentile(), but the share of observations
+ * is given in tenths of a percent, e.g. 999 for p99.9.
+ */
+int64_t
+histogram_permille(struct histogram *hist, int pml);
+
 /**
  * Print string representation of a histogram.
  */
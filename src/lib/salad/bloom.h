@@ -32,7 +32,8 @@
  */
 
 /* Classic bloom filter with several improvements
- * 1) Cache oblivious:
+ * 1) Cache oblivious (all bits of a value are in one cache line,
+ *  so a lookup is tested against a single block with SIMD):
  *  Putze, F.; Sanders, P.; Singler, J. (2007),
  *  "Cache-, Hash- and Space-Efficient Bloom Filters"
  *  http://algo2.iti.kit.edu/singler/publications/cacheefficientbloomfilters-wea2007.pdf
@@ -47,6 +48,10 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <limits.h>
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 #include "bit/bit.h"
 #include "small/quota.h"
 
@@ -232,26 +237,61 @@ bloom_add(struct bloom *bloom, bloom_hash_t hash)
 	}
 }
 
+/**
+ * Check that all bits set in @a mask are set in @a block.
+ */
+static inline bool
+bloom_block_has(const struct bloom_block *block,
+		const struct bloom_block *mask)
+{
+#if defined(__SSE2__)
+	__m128i miss = _mm_setzero_si128();
+	for (int i = 0; i < BLOOM_CACHE_LINE / 16; i++) {
+		__m128i b = _mm_loadu_si128((const __m128i *)block->bits + i);
+		__m128i m = _mm_loadu_si128((const __m128i *)mask->bits + i);
+		/* Bits of the mask missing in the block. */
+		miss = _mm_or_si128(miss, _mm_andnot_si128(b, m));
+	}
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(miss,
+				 _mm_setzero_si128())) == 0xFFFF;
+#else
+	const unsigned long *b = (const unsigned long *)block->bits;
+	const unsigned long *m = (const unsigned long *)mask->bits;
+	unsigned long miss = 0;
+	for (size_t i = 0; i < BLOOM_CACHE_LINE / sizeof(*m); i++)
+		miss |= m[i] & ~b[i];
+	return miss == 0;
+#endif
+}
+
 static inline bool
 bloom_possible_has(const struct bloom *bloom, bloom_hash_t hash)
 {
 	/* Using lower part of the has for finding a block */
 	bloom_hash_t pos = hash % bloom->table_size;
 	hash = hash / bloom->table_size;
-	/* __builtin_prefetch(bloom->table + pos, 0); */
 	const bloom_hash_t bloom_block_bits = BLOOM_CACHE_LINE * CHAR_BIT;
 	/* bit_no in block is less than bloom_block_bits (512).
 	 * split the given hash into independent lower part and high part. */
 	bloom_hash_t hash2 = hash / bloom_block_bits + 1;
+	/*
+	 * Instead of testing bits one by one, which is a chain
+	 * of unpredictable branches, collect the bits of the value
+	 * in a mask and test the whole block at once.
+	 */
+	union {
+		struct bloom_block block;
+		unsigned long words[BLOOM_CACHE_LINE / sizeof(unsigned long)];
+	} mask;
+	memset(&mask, 0, sizeof(mask));
 	for (bloom_hash_t i = 0; i < bloom->hash_count; i++) {
 		bloom_hash_t bit_no = hash % bloom_block_bits;
-		if (!bit_test(bloom->table[pos].bits, bit_no))
-			return false;
+		bit_set(mask.words, bit_no);
 		/* Combine two hashes to create required number of hashes */
 		/* Add i**2 for better distribution */
 		hash += hash2 + i * i;
 	}
-	return true;
+	return bloom_block_has(&bloom->table[pos], &mask.block);
 }
 
 static inline void
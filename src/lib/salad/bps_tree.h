@@ -136,6 +136,9 @@
  *                      alloc_ctx);
  * void bps_tree_destroy(tree);
  * int bps_tree_build(tree, sorted_array, array_size);
+ * void bps_tree_load_begin(tree, loader, count);
+ * int bps_tree_load_next(loader, elem);
+ * void bps_tree_load_end(loader);
  * bps_tree_elem_t *bps_tree_find(tree, key);
  * int bps_tree_insert(tree, new_elem, replaced_elem);
  * int bps_tree_insert_get_iterator(tree, new_elem, replaced_elem,
@@ -274,6 +277,18 @@
 #error "BPS_TREE_COMPARE_KEY must be defined"
 #endif
 
+/**
+ * Function to check that two elements are the same element,
+ * not just equal in terms of BPS_TREE_COMPARE. Used in debug
+ * self-checks. Must be defined if elements can not be compared
+ * with ==, e.g. if an element is a structure.
+ * Example:
+ * #define BPS_TREE_IS_IDENTICAL(a, b) ((a).ptr == (b).ptr)
+ */
+#ifndef BPS_TREE_IS_IDENTICAL
+#define BPS_TREE_IS_IDENTICAL(a, b) ((a) == (b))
+#endif
+
 /**
  * A switch to define the type of search in an array elements.
  * By default, bps_tree uses binary search to find a particular
@@ -347,6 +362,12 @@ typedef uint32_t bps_tree_block_id_t;
 
 #define bps_tree_create _api_name(create)
 #define bps_tree_build _api_name(build)
+#define bps_tree_loader _api_name(loader)
+#define bps_tree_load_begin _api_name(load_begin)
+#define bps_tree_load_next _api_name(load_next)
+#define bps_tree_load_end _api_name(load_end)
+#define bps_tree_load_new_leaf _bps_tree(load_new_leaf)
+#define bps_tree_load_close_leaf _bps_tree(load_close_leaf)
 #define bps_tree_destroy _api_name(destroy)
 #define bps_tree_find _api_name(find)
 #define bps_tree_insert _api_name(insert)
@@ -583,6 +604,45 @@ static inline int
 bps_tree_build(struct bps_tree *tree, bps_tree_elem_t *sorted_array,
 	       size_t array_size);
 
+/**
+ * struct bps_tree_loader forward declaration
+ */
+struct bps_tree_loader;
+
+/**
+ * @brief Start filling a new (asserted) tree with a known number of
+ *  elements that are passed one by one in sorted order. Leaves and
+ *  inner blocks are filled completely (but evenly) and attached to
+ *  the tree as soon as they are full, so no intermediate array is
+ *  needed.
+ * @param tree - pointer to a tree
+ * @param loader - loader to initialize
+ * @param count - total number of elements that will be loaded
+ */
+static inline void
+bps_tree_load_begin(struct bps_tree *tree, struct bps_tree_loader *loader,
+		    size_t count);
+
+/**
+ * @brief Append the next element to a tree being loaded.
+ *  Elements are not checked to be sorted!
+ *  On memory error the tree is reset to the empty state and the
+ *  loader must not be used anymore.
+ * @param loader - loader started with bps_tree_load_begin
+ * @param elem - element to append
+ * @return 0 on success, -1 on memory error
+ */
+static inline int
+bps_tree_load_next(struct bps_tree_loader *loader, bps_tree_elem_t elem);
+
+/**
+ * @brief Finish loading a tree. All the elements announced in
+ *  bps_tree_load_begin must have been appended.
+ * @param loader - loader started with bps_tree_load_begin
+ */
+static inline void
+bps_tree_load_end(struct bps_tree_loader *loader);
+
 /**
  * @brief Tree destruction. Frees allocated memory.
  * @param tree - pointer to a tree
@@ -989,6 +1049,40 @@ struct bps_garbage {
  */
 CT_ASSERT_G(sizeof(struct bps_garbage) <= BPS_TREE_BLOCK_SIZE);
 
+/**
+ * State of a tree being filled with bps_tree_load_next()
+ */
+struct bps_tree_loader {
+	/* The tree being loaded */
+	struct bps_tree *tree;
+	/* Total number of elements */
+	size_t count;
+	/* Number of elements that are not in full leaves yet */
+	size_t elems_left;
+	/* Number of leaves that are not full yet */
+	bps_tree_block_id_t leaf_left;
+	/* Depth of the resulting tree */
+	bps_tree_block_id_t depth;
+	/* Number of blocks not full yet on each inner level */
+	bps_tree_block_id_t level_block_count[BPS_TREE_MAX_DEPTH];
+	/* Number of children not attached yet on each inner level */
+	bps_tree_block_id_t level_child_count[BPS_TREE_MAX_DEPTH];
+	/* Inner blocks being filled on each level */
+	struct bps_inner *parents[BPS_TREE_MAX_DEPTH];
+	/* Leaf being filled, NULL if a new leaf is to be allocated */
+	struct bps_leaf *leaf;
+	/* Number of elements the current leaf is to be filled with */
+	bps_tree_pos_t leaf_size;
+	/* The last allocated leaf and its ID */
+	struct bps_leaf *last_leaf;
+	bps_tree_block_id_t last_leaf_id;
+	bps_tree_block_id_t first_leaf_id;
+	bps_tree_block_id_t inner_count;
+	bps_tree_block_id_t root_if_inner_id;
+	/* The last appended element */
+	bps_tree_elem_t max_elem;
+};
+
 /**
  * Struct for collecting path in tree, corresponds to one inner block
  */
@@ -1082,24 +1176,30 @@ bps_tree_create(struct bps_tree *tree, bps_tree_arg_t arg,
 }
 
 /**
- * @brief Fills a new (asserted) tree with values from sorted array.
- *  Elements are copied from the array. Array is not checked to be sorted!
+ * @brief Start filling a new (asserted) tree with a known number of
+ *  elements that are passed one by one in sorted order.
  * @param tree - pointer to a tree
- * @param sorted_array - pointer to the sorted array
- * @param array_size - size of the array (count of elements)
- * @return 0 on success, -1 on memory error
+ * @param loader - loader to initialize
+ * @param count - total number of elements that will be loaded
  */
-static inline int
-bps_tree_build(struct bps_tree *tree, bps_tree_elem_t *sorted_array,
-	       size_t array_size)
+static inline void
+bps_tree_load_begin(struct bps_tree *tree, struct bps_tree_loader *loader,
+		    size_t count)
 {
 	assert(tree->size == 0);
 	assert(tree->root_id == (bps_tree_block_id_t)(-1));
 	assert(tree->garbage_head_id == (bps_tree_block_id_t)(-1));
 	assert(tree->matras.head.block_count == 0);
-	if (array_size == 0)
-		return 0;
-	bps_tree_block_id_t leaf_count = (array_size +
+	memset(loader, 0, sizeof(*loader));
+	loader->tree = tree;
+	loader->count = count;
+	loader->elems_left = count;
+	loader->last_leaf_id = (bps_tree_block_id_t)-1;
+	loader->first_leaf_id = (bps_tree_block_id_t)-1;
+	loader->root_if_inner_id = (bps_tree_block_id_t)-1;
+	if (count == 0)
+		return;
+	bps_tree_block_id_t leaf_count = (count +
 		BPS_TREE_MAX_COUNT_IN_LEAF - 1) / BPS_TREE_MAX_COUNT_IN_LEAF;
 
 	bps_tree_block_id_t depth = 1;
@@ -1109,117 +1209,175 @@ bps_tree_build(struct bps_tree *tree, bps_tree_elem_t *sorted_array,
 			      / BPS_TREE_MAX_COUNT_IN_INNER;
 		depth++;
 	}
+	loader->depth = depth;
+	loader->leaf_left = leaf_count;
 
-	/* Initializing by {0} to suppress compile warnings (gh-1287) */
-	bps_tree_block_id_t level_block_count[BPS_TREE_MAX_DEPTH] = {0};
-	bps_tree_block_id_t level_child_count[BPS_TREE_MAX_DEPTH] = {0};
-	struct bps_inner *parents[BPS_TREE_MAX_DEPTH];
 	level_count = leaf_count;
 	for (bps_tree_block_id_t i = 0; i < depth - 1; i++) {
-		level_child_count[i] = level_count;
+		loader->level_child_count[i] = level_count;
 		level_count = (level_count + BPS_TREE_MAX_COUNT_IN_INNER - 1)
 			      / BPS_TREE_MAX_COUNT_IN_INNER;
-		level_block_count[i] = level_count;
-		parents[i] = 0;
+		loader->level_block_count[i] = level_count;
+		loader->parents[i] = 0;
 	}
+}
 
-	bps_tree_block_id_t leaf_left = leaf_count;
-	size_t elems_left = array_size;
-	bps_tree_elem_t *current = sorted_array;
-	struct bps_leaf *leaf = 0;
-	bps_tree_block_id_t prev_leaf_id = (bps_tree_block_id_t)-1;
-	bps_tree_block_id_t first_leaf_id = (bps_tree_block_id_t)-1;
-	bps_tree_block_id_t last_leaf_id = (bps_tree_block_id_t)-1;
-	bps_tree_block_id_t inner_count = 0;
-	bps_tree_block_id_t root_if_inner_id = (bps_tree_block_id_t)-1;
-	do {
-		bps_tree_block_id_t id;
-		struct bps_leaf *new_leaf = (struct bps_leaf *)
-			matras_alloc(&tree->matras, &id);
-		if (!new_leaf) {
-			matras_reset(&tree->matras);
-			return -1;
+/**
+ * @brief Allocate a new leaf for a tree being loaded and attach it
+ *  to the inner blocks.
+ * @return 0 on success, -1 on memory error
+ */
+static inline int
+bps_tree_load_new_leaf(struct bps_tree_loader *loader)
+{
+	struct bps_tree *tree = loader->tree;
+	bps_tree_block_id_t id;
+	struct bps_leaf *leaf = (struct bps_leaf *)
+		matras_alloc(&tree->matras, &id);
+	if (!leaf)
+		return -1;
+	if (loader->first_leaf_id == (bps_tree_block_id_t)-1)
+		loader->first_leaf_id = id;
+	if (loader->last_leaf)
+		loader->last_leaf->next_id = id;
+
+	leaf->header.type = BPS_TREE_BT_LEAF;
+	leaf->header.size = 0;
+	leaf->prev_id = loader->last_leaf_id;
+	leaf->next_id = (bps_tree_block_id_t)-1;
+	loader->last_leaf = leaf;
+	loader->last_leaf_id = id;
+	loader->leaf = leaf;
+	loader->leaf_size = loader->elems_left / loader->leaf_left;
+
+	bps_tree_block_id_t insert_id = id;
+	for (bps_tree_block_id_t i = 0; i < loader->depth - 1; i++) {
+		bps_tree_block_id_t new_id = (bps_tree_block_id_t)-1;
+		struct bps_inner **parent = &loader->parents[i];
+		if (!*parent) {
+			*parent = (struct bps_inner *)
+				matras_alloc(&tree->matras, &new_id);
+			if (!*parent)
+				return -1;
+			(*parent)->header.type = BPS_TREE_BT_INNER;
+			(*parent)->header.size = 0;
+			loader->inner_count++;
 		}
-		if (first_leaf_id == (bps_tree_block_id_t)-1)
-			first_leaf_id = id;
-		last_leaf_id = id;
-		if (leaf)
-			leaf->next_id = id;
-
-		leaf = new_leaf;
-		leaf->header.type = BPS_TREE_BT_LEAF;
-		leaf->header.size = elems_left / leaf_left;
-		leaf->prev_id = prev_leaf_id;
-		prev_leaf_id = id;
-		memmove(leaf->elems, current,
-			leaf->header.size * sizeof(*current));
-
-		bps_tree_block_id_t insert_id = id;
-		for (bps_tree_block_id_t i = 0; i < depth - 1; i++) {
-			bps_tree_block_id_t new_id = (bps_tree_block_id_t)-1;
-			if (!parents[i]) {
-				parents[i] = (struct bps_inner *)
-					matras_alloc(&tree->matras, &new_id);
-				if (!parents[i]) {
-					matras_reset(&tree->matras);
-					return -1;
-				}
-				parents[i]->header.type = BPS_TREE_BT_INNER;
-				parents[i]->header.size = 0;
-				inner_count++;
-			}
-			parents[i]->child_ids[parents[i]->header.size] =
-				insert_id;
-			if (new_id == (bps_tree_block_id_t)-1)
-				break;
-			if (i == depth - 2) {
-				root_if_inner_id = new_id;
-			} else {
-				insert_id = new_id;
-			}
+		(*parent)->child_ids[(*parent)->header.size] = insert_id;
+		if (new_id == (bps_tree_block_id_t)-1)
+			break;
+		if (i == loader->depth - 2) {
+			loader->root_if_inner_id = new_id;
+		} else {
+			insert_id = new_id;
 		}
+	}
+	return 0;
+}
 
-		bps_tree_elem_t insert_value = current[leaf->header.size - 1];
-		for (bps_tree_block_id_t i = 0; i < depth - 1; i++) {
-			parents[i]->header.size++;
-			bps_tree_block_id_t max_size = level_child_count[i] /
-						       level_block_count[i];
-			if ((uint32_t)parents[i]->header.size != max_size) {
-				parents[i]->elems[parents[i]->header.size - 1] =
-					insert_value;
-				break;
-			} else {
-				parents[i] = 0;
-				level_child_count[i] -= max_size;
-				level_block_count[i]--;
-			}
+/**
+ * @brief Account a full leaf in the inner blocks of a tree being
+ *  loaded.
+ */
+static inline void
+bps_tree_load_close_leaf(struct bps_tree_loader *loader)
+{
+	struct bps_leaf *leaf = loader->leaf;
+	bps_tree_elem_t insert_value = leaf->elems[leaf->header.size - 1];
+	for (bps_tree_block_id_t i = 0; i < loader->depth - 1; i++) {
+		struct bps_inner *parent = loader->parents[i];
+		parent->header.size++;
+		bps_tree_block_id_t max_size = loader->level_child_count[i] /
+					       loader->level_block_count[i];
+		if ((uint32_t)parent->header.size != max_size) {
+			parent->elems[parent->header.size - 1] = insert_value;
+			break;
+		} else {
+			loader->parents[i] = 0;
+			loader->level_child_count[i] -= max_size;
+			loader->level_block_count[i]--;
 		}
+	}
+	loader->leaf_left--;
+	loader->elems_left -= leaf->header.size;
+	loader->leaf = NULL;
+}
 
-		leaf_left--;
-		elems_left -= leaf->header.size;
-		current += leaf->header.size;
-	} while (leaf_left);
-	leaf->next_id = (bps_tree_block_id_t)-1;
+/**
+ * @brief Append the next element to a tree being loaded.
+ * @param loader - loader started with bps_tree_load_begin
+ * @param elem - element to append
+ * @return 0 on success, -1 on memory error
+ */
+static inline int
+bps_tree_load_next(struct bps_tree_loader *loader, bps_tree_elem_t elem)
+{
+	assert(loader->leaf_left > 0);
+	if (loader->leaf == NULL && bps_tree_load_new_leaf(loader) != 0) {
+		matras_reset(&loader->tree->matras);
+		return -1;
+	}
+	struct bps_leaf *leaf = loader->leaf;
+	leaf->elems[leaf->header.size++] = elem;
+	loader->max_elem = elem;
+	if (leaf->header.size == loader->leaf_size)
+		bps_tree_load_close_leaf(loader);
+	return 0;
+}
 
-	assert(elems_left == 0);
-	for (bps_tree_block_id_t i = 0; i < depth - 1; i++) {
-		assert(level_child_count[i] == 0);
-		assert(level_block_count[i] == 0);
-		assert(parents[i] == 0);
+/**
+ * @brief Finish loading a tree.
+ * @param loader - loader started with bps_tree_load_begin
+ */
+static inline void
+bps_tree_load_end(struct bps_tree_loader *loader)
+{
+	struct bps_tree *tree = loader->tree;
+	if (loader->count == 0)
+		return;
+	assert(loader->elems_left == 0);
+	assert(loader->leaf_left == 0);
+	assert(loader->leaf == NULL);
+	for (bps_tree_block_id_t i = 0; i < loader->depth - 1; i++) {
+		assert(loader->level_child_count[i] == 0);
+		assert(loader->level_block_count[i] == 0);
+		assert(loader->parents[i] == 0);
 	}
 
-	tree->first_id = first_leaf_id;
-	tree->last_id = last_leaf_id;
-	tree->leaf_count = leaf_count;
-	tree->inner_count = inner_count;
-	tree->depth = depth;
-	tree->size = array_size;
-	tree->max_elem = sorted_array[array_size - 1];
-	if (depth == 1) {
-		tree->root_id = first_leaf_id;
+	tree->first_id = loader->first_leaf_id;
+	tree->last_id = loader->last_leaf_id;
+	tree->leaf_count = (loader->count + BPS_TREE_MAX_COUNT_IN_LEAF - 1) /
+			   BPS_TREE_MAX_COUNT_IN_LEAF;
+	tree->inner_count = loader->inner_count;
+	tree->depth = loader->depth;
+	tree->size = loader->count;
+	tree->max_elem = loader->max_elem;
+	if (loader->depth == 1) {
+		tree->root_id = loader->first_leaf_id;
 	} else {
-		tree->root_id = root_if_inner_id;
+		tree->root_id = loader->root_if_inner_id;
+	}
+}
+
+/**
+ * @brief Fills a new (asserted) tree with values from sorted array.
+ *  Elements are copied from the array. Array is not checked to be sorted!
+ * @param tree - pointer to a tree
+ * @param sorted_array - pointer to the sorted array
+ * @param array_size - size of the array (count of elements)
+ * @return 0 on success, -1 on memory error
+ */
+static inline int
+bps_tree_build(struct bps_tree *tree, bps_tree_elem_t *sorted_array,
+	       size_t array_size)
+{
+	struct bps_tree_loader loader;
+	bps_tree_load_begin(tree, &loader, array_size);
+	for (size_t i = 0; i < array_size; i++) {
+		if (bps_tree_load_next(&loader, sorted_array[i]) != 0)
+			return -1;
 	}
+	bps_tree_load_end(&loader);
 	return 0;
 }
 
@@ -4592,7 +4750,8 @@ bps_tree_debug_check_block(const struct bps_tree *tree, struct bps_block *block,
 						       inner->child_ids[i]);
 			bps_tree_elem_t calc_max_elem =
 				bps_tree_debug_find_max_elem(tree, tmp_block);
-			if (inner->elems[i] != calc_max_elem)
+			if (!BPS_TREE_IS_IDENTICAL(inner->elems[i],
+						   calc_max_elem))
 				result |= 0x4000;
 		}
 		if (block->size > 1) {
@@ -4651,7 +4810,8 @@ bps_tree_debug_check(const struct bps_tree *tree)
 		return result;
 	}
 	struct bps_block *root = bps_tree_root(tree);
-	if (tree->max_elem != bps_tree_debug_find_max_elem(tree, root))
+	if (!BPS_TREE_IS_IDENTICAL(tree->max_elem,
+			bps_tree_debug_find_max_elem(tree, root)))
 		result |= 0x8;
 	size_t calc_count = 0;
 	bps_tree_block_id_t expected_prev_id = (bps_tree_block_id_t)(-1);
@@ -5017,12 +5177,14 @@ bps_tree_debug_check_move_to_right_leaf(struct bps_tree *tree, bool assertme)
 				}
 
 				if (a.header.size)
-					if (ma != a.elems[a.header.size - 1]) {
+					if (!BPS_TREE_IS_IDENTICAL(ma,
+						a.elems[a.header.size - 1])) {
 						result |= (1 << 5);
 						assert(!assertme);
 					}
 				if (b.header.size)
-					if (mb != b.elems[b.header.size - 1]) {
+					if (!BPS_TREE_IS_IDENTICAL(mb,
+						b.elems[b.header.size - 1])) {
 						result |= (1 << 5);
 						assert(!assertme);
 					}
@@ -5114,12 +5276,14 @@ bps_tree_debug_check_move_to_left_leaf(struct bps_tree *tree, bool assertme)
 				}
 
 				if (a.header.size)
-					if (ma != a.elems[a.header.size - 1]) {
+					if (!BPS_TREE_IS_IDENTICAL(ma,
+						a.elems[a.header.size - 1])) {
 						result |= (1 << 7);
 						assert(!assertme);
 					}
 				if (b.header.size)
-					if (mb != b.elems[b.header.size - 1]) {
+					if (!BPS_TREE_IS_IDENTICAL(mb,
+						b.elems[b.header.size - 1])) {
 						result |= (1 << 7);
 						assert(!assertme);
 					}
@@ -5225,16 +5389,16 @@ bps_tree_debug_check_insert_and_move_to_right_leaf(struct bps_tree *tree,
 					}
 
 					if (i - u + 1)
-						if (ma
-							!= a.elems[a.header.size
-								- 1]) {
+						if (!BPS_TREE_IS_IDENTICAL(ma,
+							a.elems[a.header.size
+								- 1])) {
 							result |= (1 << 9);
 							assert(!assertme);
 						}
 					if (j + u)
-						if (mb
-							!= b.elems[b.header.size
-								- 1]) {
+						if (!BPS_TREE_IS_IDENTICAL(mb,
+							b.elems[b.header.size
+								- 1])) {
 							result |= (1 << 9);
 							assert(!assertme);
 						}
@@ -5341,16 +5505,16 @@ bps_tree_debug_check_insert_and_move_to_left_leaf(struct bps_tree *tree,
 					}
 
 					if (i + u)
-						if (ma
-							!= a.elems[a.header.size
-								- 1]) {
+						if (!BPS_TREE_IS_IDENTICAL(ma,
+							a.elems[a.header.size
+								- 1])) {
 							result |= (1 << 11);
 							assert(!assertme);
 						}
 					if (j - u + 1)
-						if (mb
-							!= b.elems[b.header.size
-								- 1]) {
+						if (!BPS_TREE_IS_IDENTICAL(mb,
+							b.elems[b.header.size
+								- 1])) {
 							result |= (1 << 11);
 							assert(!assertme);
 						}
@@ -6002,6 +6166,7 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef BPS_TREE_MEMMOVE
 #undef BPS_TREE_DATAMOVE
 #undef BPS_TREE_BRANCH_TRACE
+#undef BPS_TREE_IS_IDENTICAL
 
 /* {{{ Macros for custom naming of structs and functions */
 #undef _bps
@@ -6021,6 +6186,12 @@ bps_tree_debug_check_internal_functions(bool assertme)
 
 #undef bps_tree_create
 #undef bps_tree_build
+#undef bps_tree_loader
+#undef bps_tree_load_begin
+#undef bps_tree_load_next
+#undef bps_tree_load_end
+#undef bps_tree_load_new_leaf
+#undef bps_tree_load_close_leaf
 #undef bps_tree_destroy
 #undef bps_tree_find
 #undef bps_tree_insert
@@ -47,6 +47,11 @@
  */
 #cmakedefine HAVE_CPUID 1
 
+/**
+ * Defined if AVX2 code can be compiled with the target attribute.
+ */
+#cmakedefine HAVE_AVX2_TARGET 1
+
 /*
  * Defined if gcov instrumentation should be enabled.
  */
@@ -169,6 +174,7 @@
 #cmakedefine HAVE_MREMAP 1
 
 #cmakedefine HAVE_PRCTL_H 1
+#cmakedefine HAVE_LINUX_IO_URING_H 1
 
 #cmakedefine HAVE_UUIDGEN 1
 #cmakedefine HAVE_CLOCK_GETTIME 1
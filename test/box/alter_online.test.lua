@@ -0,0 +1,72 @@
+fiber = require('fiber')
+
+--
+-- A memtx index is built without blocking tx: the space remains
+-- writable meanwhile and the build progress is reported by
+-- box.info.memtx().
+--
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+box.begin() for i = 1, 20000 do s:insert{i, i, i % 10} end box.commit()
+
+done = false
+progress = nil
+test_run = require('test_run').new()
+test_run:cmd("setopt delimiter ';'")
+function writer()
+    local i = 0
+    while not done do
+        i = i + 1
+        local k = (i * 7919) % 25000 + 1
+        if k % 3 == 0 then
+            s:delete{k}
+        else
+            s:replace{k, k + 100000, k % 10}
+        end
+        if progress == nil then
+            progress = box.info.memtx().index_build['test.sk']
+        end
+        fiber.sleep(0)
+    end
+end;
+function check(index)
+    for _, t in s:pairs() do
+        local t2 = index:get(t[2])
+        if t2 == nil or t2[1] ~= t[1] then
+            return false
+        end
+    end
+    return true
+end;
+test_run:cmd("setopt delimiter ''");
+
+f = fiber.create(writer)
+sk = s:create_index('sk', {parts = {2, 'unsigned'}})
+hk = s:create_index('hk', {type = 'hash', parts = {2, 'unsigned'}})
+done = true
+
+progress.total > 0
+progress.processed > 0
+s:len() == sk:len()
+s:len() == hk:len()
+check(sk)
+check(hk)
+next(box.info.memtx().index_build) == nil
+s:drop()
+
+-- A concurrent change may violate the new unique constraint.
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+for i = 1, 5000 do s:insert{i, i} end
+test_run:cmd("setopt delimiter ';'")
+f = fiber.create(function()
+    while box.info.memtx().index_build['test.sk'] == nil do
+        fiber.sleep(0)
+    end
+    s:replace{1, 5000}
+end);
+test_run:cmd("setopt delimiter ''");
+s:create_index('sk', {parts = {2, 'unsigned'}})
+s.index.sk
+s:get(1)
+s:drop()
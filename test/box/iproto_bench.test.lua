@@ -0,0 +1,58 @@
+test_run = require('test_run').new()
+net_box = require('net.box')
+fiber = require('fiber')
+log = require('log')
+
+--
+-- Compare network I/O backends: requests per second and server
+-- CPU time per request with many connections sending pipelined
+-- requests. Results are written to the log.
+--
+CONNECTIONS = 100
+FIBERS = 10
+DURATION = 10
+
+test_run:cmd("setopt delimiter ';'")
+function bench(backend)
+    test_run:cmd("create server iproto_bench with script='box/iproto_uring.lua'")
+    test_run:cmd("start server iproto_bench with args='"..backend.."'")
+    test_run:eval('iproto_bench', "box.schema.user.grant('guest', 'read', 'universe')")
+    test_run:eval('iproto_bench', "box.schema.space.create('test'):create_index('pk')")
+    test_run:eval('iproto_bench', "box.space.test:replace{1}")
+    local uri = test_run:eval('iproto_bench', 'return box.cfg.listen')[1]
+    local conns = {}
+    for i = 1, CONNECTIONS do
+        conns[i] = net_box.connect(uri)
+    end
+    local count = 0
+    local done = fiber.channel(CONNECTIONS * FIBERS)
+    local cpu = test_run:eval('iproto_bench', 'return os.clock()')[1]
+    local deadline = fiber.time() + DURATION
+    for i = 1, CONNECTIONS do
+        for j = 1, FIBERS do
+            fiber.create(function()
+                while fiber.time() < deadline do
+                    conns[i].space.test:get{1}
+                    count = count + 1
+                end
+                done:put(true)
+            end)
+        end
+    end
+    for i = 1, CONNECTIONS * FIBERS do
+        done:get()
+    end
+    cpu = test_run:eval('iproto_bench', 'return os.clock()')[1] - cpu
+    for i = 1, CONNECTIONS do
+        conns[i]:close()
+    end
+    test_run:cmd("stop server iproto_bench")
+    test_run:cmd("cleanup server iproto_bench")
+    log.info("%s: %d requests/s, %.2f us of server CPU per request",
+             backend, count / DURATION, cpu * 1e6 / count)
+    return count > 0
+end;
+test_run:cmd("setopt delimiter ''");
+
+bench('libev')
+bench('io_uring')
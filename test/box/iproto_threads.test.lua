@@ -0,0 +1,47 @@
+test_run = require('test_run').new()
+net_box = require('net.box')
+
+--
+-- Connections are served by several network threads
+-- sharing the listening socket.
+--
+test_run:cmd("create server iproto_threads with script='box/iproto_threads.lua'")
+test_run:cmd("start server iproto_threads")
+test_run:cmd("switch iproto_threads")
+box.cfg.iproto_threads
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+box.schema.user.grant('guest', 'read,write,execute', 'universe')
+test_run:cmd("switch default")
+
+uri = test_run:eval('iproto_threads', 'return box.cfg.listen')[1]
+test_run:cmd("setopt delimiter ';'")
+conns = {};
+for i = 1, 16 do
+    conns[i] = net_box.connect(uri)
+end;
+for i = 1, 16 do
+    for j = 1, 10 do
+        conns[i].space.test:replace{i * 100 + j}
+    end
+end;
+ok = 0;
+for i = 1, 16 do
+    if conns[i]:ping() and conns[i].space.test:get{i * 100 + 1} ~= nil then
+        ok = ok + 1
+    end
+end;
+test_run:cmd("setopt delimiter ''");
+ok
+conns[1].space.test:count()
+for i = 1, 16 do conns[i]:close() end
+
+test_run:cmd("switch iproto_threads")
+-- Statistics are summed over all threads.
+box.stat.net().RECEIVED.total > 0
+box.stat.net().SENT.total > 0
+box.stat.net.SENT.total == box.stat.net().SENT.total
+test_run:cmd("switch default")
+
+test_run:cmd("stop server iproto_threads")
+test_run:cmd("cleanup server iproto_threads")
@@ -0,0 +1,11 @@
+#!/usr/bin/env tarantool
+os = require('os')
+
+box.cfg{
+    listen              = os.getenv("LISTEN"),
+    memtx_memory        = 107374182,
+    pid_file            = "tarantool.pid",
+    net_io_backend      = arg[1] or 'io_uring',
+}
+
+require('console').listen(os.getenv('ADMIN'))
@@ -0,0 +1,53 @@
+test_run = require('test_run').new()
+net_box = require('net.box')
+fiber = require('fiber')
+
+--
+-- Socket I/O batched with io_uring. If the system doesn't
+-- support io_uring, the instance falls back to libev and the
+-- results are the same.
+--
+test_run:cmd("create server iproto_uring with script='box/iproto_uring.lua'")
+test_run:cmd("start server iproto_uring")
+test_run:cmd("switch iproto_uring")
+box.cfg.net_io_backend
+box.cfg{net_io_backend = 'libev'}
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+box.schema.user.grant('guest', 'read,write,execute', 'universe')
+for i = 1, 1000 do s:replace{i, string.rep('x', i)} end
+test_run:cmd("switch default")
+
+uri = test_run:eval('iproto_uring', 'return box.cfg.listen')[1]
+test_run:cmd("setopt delimiter ';'")
+conns = {};
+for i = 1, 16 do
+    conns[i] = net_box.connect(uri)
+end;
+-- Pipelined requests of many connections.
+ch = fiber.channel(160);
+for i = 1, 16 do
+    for j = 1, 10 do
+        fiber.create(function()
+            local t = conns[i].space.test:get{i * 10 + j}
+            ch:put(t ~= nil and #t[2] == i * 10 + j)
+        end)
+    end
+end;
+ok = 0;
+for i = 1, 160 do
+    if ch:get() then
+        ok = ok + 1
+    end
+end;
+test_run:cmd("setopt delimiter ''");
+ok
+-- A big reply takes several writes.
+res = conns[1].space.test:select()
+#res
+res[1000][2] == string.rep('x', 1000)
+res = nil
+for i = 1, 16 do conns[i]:close() end
+
+test_run:cmd("stop server iproto_uring")
+test_run:cmd("cleanup server iproto_uring")
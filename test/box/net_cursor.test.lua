@@ -0,0 +1,55 @@
+net_box = require('net.box')
+fiber = require('fiber')
+--
+-- Streamed SELECT: the server keeps the index iterator open
+-- between chunks of the result set, net.box index:pairs().
+--
+box.schema.user.grant('guest', 'read', 'universe')
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+for i = 1, 1000 do s:insert{i} end
+c = net_box.connect(box.cfg.listen)
+n = 0
+ok = true
+for _, t in c.space.test:pairs({}, {fetch_size = 64}) do n = n + 1 if t[1] ~= n then ok = false end end
+n, ok
+-- Offset and limit apply to the whole result set.
+t = {}
+for _, v in c.space.test:pairs({500}, {iterator = 'GE', offset = 10, limit = 100, fetch_size = 30}) do table.insert(t, v[1]) end
+#t, t[1], t[100]
+-- The number of open cursors of a session is limited.
+box.cfg{net_cursor_max = 2}
+it1 = c.space.test:pairs({}, {fetch_size = 10})
+it2 = c.space.test:pairs({}, {fetch_size = 10})
+ok, err = pcall(c.space.test.pairs, c.space.test, {}, {fetch_size = 10})
+ok, tostring(err):match('too many open cursors') ~= nil
+-- A result set which fits in a chunk doesn't keep a cursor.
+#c.space.test:pairs({}, {limit = 5, fetch_size = 10}):totable()
+-- The cursor is closed at the end of the result set...
+#it1:totable()
+-- ... or when the iterator is garbage collected.
+it2 = nil
+collectgarbage('collect')
+c:ping()
+it1 = c.space.test:pairs({}, {fetch_size = 10})
+it2 = c.space.test:pairs({}, {fetch_size = 10})
+-- Idle cursors are closed after net_cursor_timeout.
+box.cfg{net_cursor_timeout = 0.1}
+fiber.sleep(1.5)
+ok, err = pcall(it1.totable, it1)
+ok, tostring(err):match('is closed or does not exist') ~= nil
+box.cfg{net_cursor_timeout = 60}
+-- Vinyl.
+v = box.schema.space.create('test_vinyl', {engine = 'vinyl'})
+_ = v:create_index('pk')
+for i = 1, 100 do v:insert{i} end
+c:reload_schema()
+#c.space.test_vinyl:pairs({}, {fetch_size = 7}):totable()
+-- Options.
+box.cfg{net_cursor_max = 0}
+box.cfg{net_cursor_timeout = 0}
+box.cfg{net_cursor_max = 16}
+c:close()
+v:drop()
+s:drop()
+box.schema.user.revoke('guest', 'read', 'universe')
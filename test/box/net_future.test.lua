@@ -0,0 +1,81 @@
+net_box = require('net.box')
+fiber = require('fiber')
+--
+-- Asynchronous requests: a fiber submits a batch of requests
+-- without waiting for the responses and collects the results
+-- afterwards.
+--
+box.schema.user.grant('guest', 'read,write,execute', 'universe')
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+c = net_box.connect(box.cfg.listen)
+futures = {}
+for i = 1, 100 do table.insert(futures, c.space.test:insert({i}, {is_async = true})) end
+ok = true
+for i, f in ipairs(futures) do if f:wait_result()[1] ~= i then ok = false end end
+ok
+s:count()
+-- Method specific results.
+f = c.space.test:select({}, {limit = 2, is_async = true})
+f:wait_result()
+f = c.space.test:get({3}, {is_async = true})
+f:wait_result()
+f = c.space.test:update({3}, {{'=', 2, 'x'}}, {is_async = true})
+f:wait_result()
+f = c.space.test:upsert({3}, {{'=', 2, 'y'}}, {is_async = true})
+f:wait_result()
+f = c.space.test:delete({3}, {is_async = true})
+f:wait_result()
+f = c.space.test.index.pk:count(nil, {is_async = true})
+f:wait_result()
+f = c:eval('return 1, 2, 3', {}, {is_async = true})
+f:wait_result()
+-- The result can be requested many times.
+f:result()
+f = c.space.test:select({1}, {is_async = true})
+f:wait_result()
+f:wait_result()
+-- Errors.
+f = c.space.test:insert({1}, {is_async = true})
+f:wait_result()
+res, err = f:result()
+res, tostring(err)
+f = c:eval('require("fiber").sleep(0.2) return 1', {}, {is_async = true})
+f:is_ready()
+res, err = f:result()
+res, tostring(err)
+ok, err = pcall(f.wait_result, f, 0.01)
+ok, tostring(err)
+f:wait_result()
+f:is_ready()
+-- A discarded request never completes.
+f = c:eval('require("fiber").sleep(0.2) return 1', {}, {is_async = true})
+f:discard()
+res, err = f:result()
+res, tostring(err)
+c:ping()
+-- Any number of fibers can wait for the same future.
+f = c:eval('require("fiber").sleep(0.1) return 1', {}, {is_async = true})
+ch = fiber.channel(2)
+for i = 1, 2 do fiber.create(function() ch:put(f:wait_result()) end) end
+ch:get(), ch:get()
+-- A request is resent if the schema has changed.
+s2 = box.schema.space.create('test2')
+f = c.space.test:get({1}, {is_async = true})
+f:wait_result()
+s2:drop()
+-- Pending requests fail when the connection is closed.
+c2 = net_box.connect(box.cfg.listen)
+f = c2:eval('require("fiber").sleep(0.2) return 1', {}, {is_async = true})
+c2:close()
+res, err = f:result()
+res, tostring(err)
+f = c2:eval('return 1', {}, {is_async = true})
+res, err = f:result()
+res, tostring(err)
+-- Streamed SELECT and SQL can't be asynchronous.
+ok, err = pcall(c.space.test.pairs, c.space.test, {}, {is_async = true})
+ok, err:match('is_async') ~= nil
+c:close()
+s:drop()
+box.schema.user.revoke('guest', 'read,write,execute', 'universe')
@@ -0,0 +1,39 @@
+net_box = require('net.box')
+fiber = require('fiber')
+
+--
+-- Zero-copy SELECT replies: bodies of big tuples are sent from
+-- tuple memory rather than copied to the output buffer.
+--
+box.schema.user.grant('guest', 'read', 'universe')
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+-- Small tuples are still copied, mix them with big ones.
+for i = 1, 2000 do s:insert{i, string.rep('x', i % 2 == 0 and 10 or 1000 + i)} end
+box.cfg{net_zero_copy_select = true}
+c = net_box.connect(box.cfg.listen)
+
+-- The reply doesn't fit in the socket buffer.
+res = c.space.test:select()
+#res
+ok = true
+for i, t in ipairs(res) do if t[1] ~= i or t[2] ~= s:get{i}[2] then ok = false end end
+ok
+res = nil
+
+-- Pipelined replies are not mixed up.
+ch = fiber.channel(10)
+for i = 1, 10 do fiber.create(function() ch:put(c.space.test:select({i * 100}, {iterator = 'GE', limit = 100})) end) end
+ok = true
+for i = 1, 10 do local r = ch:get() if #r ~= 100 or r[100][2] ~= s:get{r[100][1]}[2] then ok = false end end
+ok
+
+-- The reply is consistent with the space contents.
+c.space.test:get{1}[2] == string.rep('x', 1001)
+_ = s:delete{1}
+c.space.test:get{1}
+
+c:close()
+box.cfg{net_zero_copy_select = false}
+s:drop()
+box.schema.user.revoke('guest', 'read', 'universe')
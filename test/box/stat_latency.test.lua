@@ -0,0 +1,33 @@
+--
+-- Request latency by request type and by space.
+--
+box.schema.user.grant('guest', 'read,write,execute', 'universe')
+space = box.schema.space.create('test_latency')
+_ = space:create_index('pk')
+cn = require('net.box').connect(box.cfg.listen)
+box.stat.reset()
+stat = box.stat.latency()
+stat.INSERT == nil, next(stat.space) == nil
+for i = 1, 10 do cn.space.test_latency:insert{i} end
+_ = cn.space.test_latency:select()
+cn:eval('return 1')
+stat = box.stat.latency()
+stat.INSERT.count, stat.SELECT.count, stat.EVAL.count
+stat.space.test_latency.count
+t = {}
+for k, v in pairs(stat.INSERT) do table.insert(t, k) end
+table.sort(t)
+t
+t = {}
+for k, v in pairs(stat.INSERT.total) do table.insert(t, k) end
+table.sort(t)
+t
+-- Requests which don't write to WAL don't wait for it.
+stat.SELECT.wal.p999
+-- Reset.
+box.stat.reset()
+stat = box.stat.latency()
+stat.INSERT == nil, next(stat.space) == nil
+cn:close()
+space:drop()
+box.schema.user.revoke('guest', 'read,write,execute', 'universe')
@@ -21,6 +21,25 @@ box.stat.net.RECEIVED.total > 0
 -- box.stat.net.EVENTS.total > 0
 -- box.stat.net.LOCKS.total > 0
 
+--
+-- Per-connection back-pressure: a connection which has too many
+-- requests in flight stops being read until some of them are
+-- answered.
+--
+box.cfg{net_connection_msg_max = 0}
+box.cfg{net_msg_max_size = 0}
+box.stat.net.STALLS.total
+box.cfg{net_connection_msg_max = 2}
+fiber = require('fiber')
+function sleepy() fiber.sleep(0.01) return true end
+ch = fiber.channel(20)
+for i = 1, 20 do fiber.create(function() ch:put(cn:call('sleepy')) end) end
+ok = 0
+for i = 1, 20 do if ch:get() then ok = ok + 1 end end
+ok
+box.stat.net.STALLS.total > 0
+box.cfg{net_connection_msg_max = 768}
+
 -- reset
 box.stat.reset()
 box.stat.net.SENT.total
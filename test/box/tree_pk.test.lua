@@ -301,3 +301,47 @@ s:drop()
 
 box.internal.collation.drop('test')
 box.internal.collation.drop('test-ci')
+
+-- bulk build of a tree index on a populated space
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+for i = 1, 10000 do s:insert{i, 10001 - i, i % 7} end
+sk = s:create_index('sk', {parts = {2, 'unsigned'}})
+sk:len()
+sk:min()
+sk:max()
+sk:get(5000)
+ok = true
+prev = 0
+for _, t in sk:pairs() do ok = ok and t[2] == prev + 1 prev = t[2] end
+ok
+s:create_index('dup', {parts = {3, 'unsigned'}})
+s.index.dup
+nu = s:create_index('nu', {parts = {3, 'unsigned'}, unique = false})
+nu:count(3)
+s:drop()
+
+-- comparison hints
+s = box.schema.space.create('test')
+pk = s:create_index('pk', {parts = {1, 'string'}})
+ik = s:create_index('ik', {parts = {2, 'integer'}, unique = false})
+ck = s:create_index('ck', {parts = {{3, 'string', collation = 'unicode_ci'}}, unique = false})
+nh = s:create_index('nh', {parts = {1, 'string'}, hint = false})
+s:insert{'abcdefgh2', -1, 'b'}
+s:insert{'abcdefgh1', 2, 'A'}
+s:insert{'abcdefg', -100, 'a'}
+s:insert{'b', 18446744073709551615ULL, 'B'}
+s:insert{'abcdefgh', 0, 'C'}
+pk:select{}
+pk:select({'abcdefgh'}, {iterator = 'GT'})
+ik:select{}
+ik:select({0}, {iterator = 'LT'})
+ck:select{}
+ck:select{'b'}
+nh:select({'abcdefgh1'}, {iterator = 'LE'})
+nh:alter({hint = true})
+nh:select({'abcdefgh1'}, {iterator = 'GE'})
+s:replace{'abcdefgh', 5, 'c'}
+ik:select{}
+s:create_index('bad', {parts = {1, 'string'}, hint = 1})
+s:drop()
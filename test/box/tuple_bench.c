@@ -1,5 +1,6 @@
 #include "module.h"
 
+#include <stdlib.h>
 #include <sys/time.h>
 
 #include <msgpuck.h>
@@ -76,3 +77,113 @@ tuple_bench(box_function_ctx_t *ctx, const char *args, const char *args_end)
 	say_info("%lf\n", t);
 	return 0;
 }
+
+/**
+ * Benchmark comparators of an index key definition: compare
+ * tuples of the index with each other, with their keys and
+ * extract the keys. Arguments are a space name, an index name
+ * and a number of iterations. Timings are written to the log.
+ */
+int
+tuple_compare_bench(box_function_ctx_t *ctx, const char *args,
+		    const char *args_end)
+{
+	(void) ctx;
+	(void) args_end;
+	uint32_t arg_count = mp_decode_array(&args);
+	if (arg_count != 3) {
+		return box_error_set(__FILE__, __LINE__, ER_PROC_C, "%s",
+			"usage: tuple_compare_bench(space, index, count)");
+	}
+	uint32_t space_name_len, index_name_len;
+	const char *space_name = mp_decode_str(&args, &space_name_len);
+	const char *index_name = mp_decode_str(&args, &index_name_len);
+	uint64_t count = mp_decode_uint(&args);
+
+	uint32_t space_id = box_space_id_by_name(space_name, space_name_len);
+	uint32_t index_id = box_index_id_by_name(space_id, index_name,
+						 index_name_len);
+	if (space_id == BOX_ID_NIL || index_id == BOX_ID_NIL) {
+		return box_error_set(__FILE__, __LINE__, ER_PROC_C,
+			"Can't find index %.*s in space %.*s",
+			index_name_len, index_name,
+			space_name_len, space_name);
+	}
+
+	char key_all[1];
+	mp_encode_array(key_all, 0);
+	box_iterator_t *it = box_index_iterator(space_id, index_id, ITER_ALL,
+						key_all, key_all + 1);
+	if (it == NULL)
+		return -1;
+	const box_key_def_t *key_def = box_iterator_key_def(it);
+	box_tuple_t **tuples = NULL;
+	const char **keys = NULL;
+	uint32_t n = 0, capacity = 0;
+	box_tuple_t *tuple;
+	int rc = -1;
+	while (box_iterator_next(it, &tuple) == 0 && tuple != NULL) {
+		if (n == capacity) {
+			capacity = capacity > 0 ? capacity * 2 : 1024;
+			box_tuple_t **new_tuples = realloc(tuples,
+				capacity * sizeof(*tuples));
+			if (new_tuples == NULL)
+				goto out;
+			tuples = new_tuples;
+		}
+		box_tuple_ref(tuple);
+		tuples[n++] = tuple;
+	}
+	if (n < 2) {
+		box_error_set(__FILE__, __LINE__, ER_PROC_C, "%s",
+			      "the index must contain at least 2 tuples");
+		goto out;
+	}
+	keys = malloc(n * sizeof(*keys));
+	if (keys == NULL)
+		goto out;
+	for (uint32_t i = 0; i < n; i++) {
+		keys[i] = box_tuple_extract_key(tuples[i], space_id, index_id,
+						NULL);
+		if (keys[i] == NULL)
+			goto out;
+	}
+
+	int sum = 0;
+	double t = proctime();
+	for (uint64_t i = 0; i < count; i++) {
+		sum += box_tuple_compare(tuples[i % n],
+					 tuples[(i * 7 + 1) % n], key_def);
+	}
+	double compare_time = proctime() - t;
+	t = proctime();
+	for (uint64_t i = 0; i < count; i++) {
+		sum += box_tuple_compare_with_key(tuples[i % n],
+						  keys[(i * 7 + 1) % n],
+						  key_def);
+	}
+	double compare_with_key_time = proctime() - t;
+	/* Keys are allocated on the fiber region, free them. */
+	size_t region_svp = box_region_used();
+	t = proctime();
+	for (uint64_t i = 0; i < count; i++) {
+		if (box_tuple_extract_key(tuples[i % n], space_id, index_id,
+					  NULL) == NULL)
+			goto out;
+		box_region_truncate(region_svp);
+	}
+	double extract_key_time = proctime() - t;
+	say_info("%.*s.%.*s: %u tuples, %llu iterations, compare %lf, "
+		 "compare_with_key %lf, extract_key %lf (%d)",
+		 space_name_len, space_name, index_name_len, index_name, n,
+		 (unsigned long long) count, compare_time,
+		 compare_with_key_time, extract_key_time, sum);
+	rc = 0;
+out:
+	for (uint32_t i = 0; i < n; i++)
+		box_tuple_unref(tuples[i]);
+	free(tuples);
+	free(keys);
+	box_iterator_free(it);
+	return rc;
+}
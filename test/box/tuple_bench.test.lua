@@ -30,3 +30,22 @@ prof.stop()
 box.schema.func.drop("tuple_bench")
 
 box.space.tester:drop()
+
+--
+-- Comparators specialized for key part types. Timings of
+-- every key shape are written to the log.
+--
+box.schema.func.create('tuple_compare_bench', {language = "C"})
+box.schema.user.grant('guest', 'execute', 'function', 'tuple_compare_bench')
+space = box.schema.space.create('tester')
+_ = space:create_index('primary', {parts = {1, 'unsigned'}})
+_ = space:create_index('uis', {parts = {2, 'unsigned', 3, 'integer', 4, 'string'}})
+_ = space:create_index('isu', {parts = {3, 'integer', 4, 'string', 2, 'unsigned'}})
+_ = space:create_index('nullable', {parts = {{5, 'unsigned', is_nullable = true}, {4, 'string', is_nullable = true}}, unique = false})
+_ = space:create_index('number', {parts = {6, 'number', 3, 'integer'}, unique = false})
+_ = space:create_index('scalar', {parts = {7, 'scalar', 2, 'unsigned', 4, 'string', 3, 'integer'}})
+for i = 1, 9000 do space:insert{i, i % 7, i % 13 - 6, tostring(i % 101), i % 3 == 0 and box.NULL or i % 5, i / 4, i % 2 == 0 and 'a' or i} end
+for _, index in ipairs({'primary', 'uis', 'isu', 'nullable', 'number', 'scalar'}) do c:call('tuple_compare_bench', {'tester', index, 10000000}) end
+
+box.schema.func.drop("tuple_compare_bench")
+box.space.tester:drop()
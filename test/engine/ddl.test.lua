@@ -162,3 +162,32 @@ pk:get({4})
 sk:select({box.NULL})
 sk:get({5})
 s:drop()
+
+--
+-- Hot fields are not indexed, but are accessed by offset.
+--
+s = box.schema.space.create('test', {engine = engine})
+format = {}
+format[1] = {'field1', 'unsigned'}
+format[2] = {'field2', 'unsigned'}
+format[3] = {'field3', 'string', is_hot = true}
+format[4] = {'field4', 'any'}
+format[5] = {'field5', 'unsigned', is_hot = true, is_nullable = true}
+s:format(format)
+s:format()[3].is_hot
+pk = s:create_index('pk')
+sk = s:create_index('sk', {parts = {2, 'unsigned'}})
+used = box.slab.info().hot_field_map_used
+s:replace{1, 10, 'a', {1, 2}, 100}
+s:replace{2, 20, 'b', {3}}
+engine ~= 'memtx' or box.slab.info().hot_field_map_used - used == 16
+t = s:get{1}
+t[3], t[4], t[5], t.field3, t.field5
+t = s:get{2}
+t[3], t[4], t[5], t.field5
+sk:select{}
+_ = sk:delete{20}
+s:select{}
+s:update({1}, {{'=', 5, 200}, {'=', 3, 'c'}})
+s:get{1}.field5
+s:drop()
@@ -108,3 +108,18 @@ for i = 1,c2 do total_count = total_count + #space:select{i} end
 total_count --c1 * c2
 space:drop()
 
+-- secondary keys of mixed part types on non-sequential fields
+space = box.schema.space.create('test', { engine = engine })
+pk = space:create_index('primary', { type = 'tree', parts = {1, 'unsigned'} })
+sk = space:create_index('secondary', { type = 'tree', parts = {3, 'integer', 2, 'string', 1, 'unsigned'} })
+space:insert{1, 'b', -1}
+space:insert{2, 'a', 5}
+space:insert{3, 'a', -1}
+space:insert{4, 'b', 5}
+space:insert{5, 'a', -1}
+sk:select{}
+sk:select{-1}
+sk:select{-1, 'a'}
+sk:select({5, 'a'}, {iterator = 'GT'})
+sk:select({-1, 'a', 5}, {iterator = 'LE'})
+space:drop()
@@ -0,0 +1,49 @@
+--
+-- Parallel apply of replicated rows, see
+-- box.cfg.replication_apply_fibers.
+--
+env = require('test_run')
+test_run = env.new()
+engine = test_run:get_cfg('engine')
+
+box.schema.user.grant('guest', 'replication')
+s = box.schema.space.create('test', {engine = engine})
+_ = s:create_index('pk')
+
+test_run:cmd("create server replica with rpl_master=default, script='replication/replica_apply.lua'")
+test_run:cmd("start server replica")
+
+-- Rows modifying the same key must be applied in order.
+for i = 1, 1000 do s:replace{i % 10, i} end
+-- DDL waits for all rows in progress to be applied.
+_ = box.schema.space.create('test2', {engine = engine})
+_ = box.space.test2:create_index('pk')
+for i = 1, 1000 do s:upsert({i % 10, i}, {{'+', 2, 1}}) end
+for i = 1, 100 do box.space.test2:insert{i} end
+s:select()
+box.space.test2:count()
+
+vclock = test_run:get_vclock('default')
+_ = test_run:wait_vclock('replica', vclock)
+
+test_run:cmd("switch replica")
+fiber = require('fiber')
+box.cfg.replication_apply_fibers
+upstream = box.info.replication[1].upstream
+while upstream.apply_queue > 0 do fiber.sleep(0.01) upstream = box.info.replication[1].upstream end
+upstream.status
+upstream.applied.total >= 2100
+upstream.apply_lag < 1
+box.space.test:select()
+box.space.test2:count()
+
+-- The new value takes effect on resubscribe.
+box.cfg{replication_apply_fibers = 1}
+box.cfg.replication_apply_fibers
+
+test_run:cmd("switch default")
+test_run:cmd("stop server replica")
+test_run:cmd("cleanup server replica")
+s:drop()
+box.space.test2:drop()
+box.schema.user.revoke('guest', 'replication')
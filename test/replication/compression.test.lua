@@ -0,0 +1,34 @@
+--
+-- Compression of the replication stream, see
+-- box.cfg.replication_compression.
+--
+env = require('test_run')
+test_run = env.new()
+engine = test_run:get_cfg('engine')
+fiber = require('fiber')
+box.schema.user.grant('guest', 'replication')
+s = box.schema.space.create('test', {engine = engine})
+_ = s:create_index('pk')
+test_run:cmd("create server replica with rpl_master=default, script='replication/replica_compression.lua'")
+test_run:cmd("start server replica")
+for i = 1, 1000 do s:insert{i, string.rep('x', 100)} end
+vclock = test_run:get_vclock('default')
+_ = test_run:wait_vclock('replica', vclock)
+test_run:cmd("switch replica")
+box.cfg.replication_compression
+box.space.test:count()
+upstream = box.info.replication[1].upstream
+upstream.status
+upstream.compression.bytes > 0
+upstream.compression.ratio > 5
+upstream.compression.time >= 0
+test_run:cmd("switch default")
+-- The relay reports statistics along with the replica vclock.
+while box.info.replication[2].downstream.compression == nil do fiber.sleep(0.01) end
+downstream = box.info.replication[2].downstream
+downstream.compression.bytes > 0
+downstream.compression.ratio > 5
+test_run:cmd("stop server replica")
+test_run:cmd("cleanup server replica")
+s:drop()
+box.schema.user.revoke('guest', 'replication')
@@ -0,0 +1,71 @@
+test_run = require('test_run').new()
+engine = test_run:get_cfg('engine')
+fiber = require('fiber')
+fio = require('fio')
+test_run:cleanup_cluster()
+-- Make each snapshot trigger garbage collection.
+default_checkpoint_count = box.cfg.checkpoint_count
+box.cfg{checkpoint_count = 1}
+function wait_gc(n) while #box.internal.gc.info().checkpoints > n do fiber.sleep(0.01) end end
+function xlog_count() return #fio.glob(fio.pathjoin(box.cfg.wal_dir, '*.xlog')) end
+box.schema.user.grant('guest', 'read,write,execute', 'universe')
+box.schema.user.grant('guest', 'replication')
+box.error.injection.set('ERRINJ_RELAY_REPORT_INTERVAL', 0.05)
+-- Shrink the ring of rows recently written to the WAL so that
+-- a lagging replica overruns it quickly. The new size takes
+-- effect when the first relay attaches to the WAL.
+box.error.injection.set('ERRINJ_WAL_RING_SIZE', 4096)
+s = box.schema.space.create('test', {engine = engine})
+_ = s:create_index('pk')
+for i = 1, 10 do s:insert{i, string.rep('x', 100)} end
+box.snapshot()
+test_run:cmd("create server replica with rpl_master=default, script='replication/replica.lua'")
+test_run:cmd("start server replica")
+-- Once the replica has caught up, rows are relayed from the ring.
+for i = 11, 20 do s:insert{i, string.rep('x', 100)} end
+test_run:cmd("switch replica")
+fiber = require('fiber')
+while box.space.test:count() < 20 do fiber.sleep(0.01) end
+box.space.test:count()
+test_run:cmd("switch default")
+test_run:grep_log('default', 'relay switched to the WAL ring') ~= nil
+--
+-- Make the replica lag behind the ring. The relay must fall
+-- back on reading xlog files and return to the ring once it
+-- has caught up.
+--
+box.error.injection.set('ERRINJ_RELAY_TIMEOUT', 0.01)
+for i = 21, 120 do s:insert{i, string.rep('x', 100)} end
+while test_run:grep_log('default', 'relay fell behind the WAL ring', 1000) == nil do fiber.sleep(0.01) end
+box.error.injection.set('ERRINJ_RELAY_TIMEOUT', 0)
+test_run:cmd("switch replica")
+while box.space.test:count() < 120 do fiber.sleep(0.01) end
+box.space.test:count()
+test_run:cmd("switch default")
+test_run:grep_log('default', 'relay switched to the WAL ring', 200) ~= nil
+--
+-- Xlog files aren't read while the relay is streaming rows
+-- from the ring. Check that it still lets the garbage collector
+-- delete files sent to the replica.
+--
+box.snapshot()
+-- Rotate the WAL.
+for i = 121, 130 do s:insert{i, string.rep('x', 100)} end
+test_run:cmd("switch replica")
+while box.space.test:count() < 130 do fiber.sleep(0.01) end
+box.space.test:count()
+test_run:cmd("switch default")
+wait_gc(1)
+#box.internal.gc.info().checkpoints == 1 or box.internal.gc.info()
+while xlog_count() > 1 do fiber.sleep(0.01) end
+xlog_count()
+-- Cleanup.
+test_run:cmd("stop server replica")
+test_run:cmd("cleanup server replica")
+test_run:cleanup_cluster()
+s:drop()
+box.error.injection.set('ERRINJ_WAL_RING_SIZE', -1)
+box.error.injection.set('ERRINJ_RELAY_REPORT_INTERVAL', 0)
+box.schema.user.revoke('guest', 'replication')
+box.schema.user.revoke('guest', 'read,write,execute', 'universe')
+box.cfg{checkpoint_count = default_checkpoint_count}
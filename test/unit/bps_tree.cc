@@ -577,6 +577,35 @@ loading_test()
 			fail("wrong build result", "true");
 
 		test_destroy(&tree);
+
+		/* The same using the streaming loader. */
+		test_create(&tree, 0, extent_alloc, extent_free,
+			    &extents_count);
+
+		struct test_loader loader;
+		test_load_begin(&tree, &loader, i);
+		for (type_t j = 0; j < i; j++) {
+			if (test_load_next(&loader, j))
+				fail("loading failed", "true");
+		}
+		test_load_end(&loader);
+
+		if (test_debug_check(&tree))
+			fail("debug check nonzero", "true");
+		if (test_size(&tree) != (size_t)i)
+			fail("wrong load result", "true");
+
+		iterator = test_iterator_first(&tree);
+		for (type_t j = 0; j < i; j++) {
+			type_t *v = test_iterator_get_elem(&tree, &iterator);
+			if (!v || *v != j)
+				fail("wrong load result", "true");
+			test_iterator_next(&tree, &iterator);
+		}
+		if (!test_iterator_is_invalid(&iterator))
+			fail("wrong load result", "true");
+
+		test_destroy(&tree);
 	}
 
 	footer();
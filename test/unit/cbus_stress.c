@@ -8,6 +8,7 @@
 #include "memory.h"
 #include "fiber.h"
 #include "cbus.h"
+#include "clock.h"
 #include "unit.h"
 
 /*
@@ -325,6 +326,121 @@ thread_func(va_list ap)
 	return 0;
 }
 
+/*
+ * Benchmark: the main thread sends messages to a thread that
+ * bounces them back, keeping up to bench_window of them in
+ * flight. Results go to stderr, so as not to affect the test
+ * output.
+ */
+
+/* Number of messages sent in the throughput benchmark. */
+static const int bench_msg_count = 1000000;
+
+/* Max number of messages in flight in the throughput benchmark. */
+static const int bench_window = 256;
+
+/* Number of round trips made in the latency benchmark. */
+static const int bench_rtt_count = 100000;
+
+static struct {
+	/* Cord bouncing messages back. */
+	struct cord cord;
+	/* Pipe from the main thread to the bench thread. */
+	struct cpipe to;
+	/* Pipe from the bench thread to the main thread. */
+	struct cpipe from;
+	/* Number of messages left to send. */
+	int to_send;
+	/* Number of messages left to receive. */
+	int to_receive;
+} bench;
+
+static void
+bench_echo_cb(struct cmsg *cmsg)
+{
+	(void)cmsg;
+}
+
+static void
+bench_reply_cb(struct cmsg *cmsg);
+
+static struct cmsg_hop bench_route[] = {
+	{ bench_echo_cb, NULL },
+	{ bench_reply_cb, NULL },
+};
+
+static void
+bench_reply_cb(struct cmsg *cmsg)
+{
+	bench.to_receive--;
+	if (bench.to_send > 0) {
+		bench.to_send--;
+		cmsg_init(cmsg, bench_route);
+		cpipe_push(&bench.to, cmsg);
+	}
+}
+
+static int
+bench_thread_func(va_list ap)
+{
+	(void)ap;
+	struct cbus_endpoint endpoint;
+	cbus_endpoint_create(&endpoint, "bench", fiber_schedule_cb, fiber());
+	cbus_loop(&endpoint);
+	cbus_endpoint_destroy(&endpoint, cbus_process);
+	return 0;
+}
+
+/*
+ * Send count messages keeping at most window of them in flight
+ * and wait until all of them are back. Returns elapsed time.
+ */
+static double
+bench_run(struct cbus_endpoint *endpoint, int count, int window)
+{
+	struct cmsg *msgs = calloc(window, sizeof(*msgs));
+	assert(msgs != NULL);
+	double start = clock_monotonic();
+	bench.to_send = count - window;
+	bench.to_receive = count;
+	for (int i = 0; i < window; i++) {
+		cmsg_init(&msgs[i], bench_route);
+		cpipe_push_input(&bench.to, &msgs[i]);
+	}
+	cpipe_flush_input(&bench.to);
+	while (true) {
+		cbus_process(endpoint);
+		if (bench.to_receive == 0)
+			break;
+		fiber_yield();
+	}
+	double elapsed = clock_monotonic() - start;
+	free(msgs);
+	return elapsed;
+}
+
+static void
+bench_main(struct cbus_endpoint *endpoint)
+{
+	if (cord_costart(&bench.cord, "bench", bench_thread_func, NULL) != 0)
+		unreachable();
+	cbus_pair("bench", "main", &bench.to, &bench.from,
+		  NULL, NULL, cbus_process);
+	bench_route[0].pipe = &bench.from;
+
+	double elapsed = bench_run(endpoint, bench_msg_count, bench_window);
+	fprintf(stderr, "cbus throughput: %.0f messages/s\n",
+		bench_msg_count / elapsed);
+	elapsed = bench_run(endpoint, bench_rtt_count, 1);
+	fprintf(stderr, "cbus round trip: %.2f us\n",
+		elapsed / bench_rtt_count * 1e6);
+
+	cbus_stop_loop(&bench.to);
+	cbus_unpair(&bench.to, &bench.from, NULL, NULL, cbus_process);
+	if (cord_join(&bench.cord) != 0)
+		unreachable();
+}
+
 static int
 main_func(va_list ap)
 {
@@ -333,6 +449,8 @@ main_func(va_list ap)
 	struct cbus_endpoint endpoint;
 	cbus_endpoint_create(&endpoint, "main", fiber_schedule_cb, fiber());
 
+	bench_main(&endpoint);
+
 	threads = calloc(thread_count, sizeof(*threads));
 	assert(threads != NULL);
 
@@ -0,0 +1,148 @@
+#include "field_scan.h"
+#include "unit.h"
+#include "msgpuck.h"
+#include "trivia/util.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum { MAX_FIELDS = 200, MAX_FIELD_SIZE = 64 };
+
+/** Encode the @a i-th field of a tuple of the given kind. */
+typedef char *(*field_encode_f)(char *data, int i);
+
+static char *
+small_ints(char *data, int i)
+{
+	return i % 2 == 0 ? mp_encode_uint(data, i % 128) :
+			    mp_encode_int(data, -1 - i % 32);
+}
+
+static char *
+mixed(char *data, int i)
+{
+	switch (i % 3) {
+	case 0:
+		return mp_encode_str(data, "abc", 3);
+	case 1:
+		return mp_encode_nil(data);
+	default:
+		return mp_encode_uint(data, 1000 + i);
+	}
+}
+
+static char *
+runs(char *data, int i)
+{
+	if (i % 21 == 20)
+		return mp_encode_str(data, "a long string value", 19);
+	return i % 2 == 0 ? mp_encode_bool(data, true) : mp_encode_nil(data);
+}
+
+static char *
+all_types(char *data, int i)
+{
+	switch (i % 10) {
+	case 0:
+		data = mp_encode_array(data, 2);
+		data = mp_encode_uint(data, 1);
+		return mp_encode_str(data, "x", 1);
+	case 1:
+		data = mp_encode_map(data, 1);
+		data = mp_encode_str(data, "key", 3);
+		return mp_encode_array(data, 0);
+	case 2:
+		return mp_encode_bin(data, "\x01\x02\x03", 3);
+	case 3:
+		return mp_encode_double(data, 1.5);
+	case 4:
+		return mp_encode_float(data, 2.5);
+	case 5:
+		return mp_encode_int(data, -100000);
+	case 6:
+		return mp_encode_uint(data, UINT64_MAX);
+	case 7:
+		return mp_encode_str(data, "", 0);
+	default:
+		return mp_encode_uint(data, i);
+	}
+}
+
+static char *
+field_data_new(field_encode_f encode, int count, char **end)
+{
+	char buf[MAX_FIELDS * MAX_FIELD_SIZE];
+	char *pos = buf;
+	for (int i = 0; i < count; i++)
+		pos = encode(pos, i);
+	/* Use an exact-size buffer to catch reads past the end. */
+	char *data = (char *)malloc(pos - buf);
+	fail_if(data == NULL);
+	memcpy(data, buf, pos - buf);
+	*end = data + (pos - buf);
+	return data;
+}
+
+static void
+check_field_scan(field_encode_f encode, int count, const char *name)
+{
+	char *end;
+	char *data = field_data_new(encode, count, &end);
+	uint32_t expected[MAX_FIELDS + 1];
+	const char *pos = data;
+	for (int i = 0; i < count; i++) {
+		expected[i] = pos - data;
+		mp_next(&pos);
+	}
+	expected[count] = pos - data;
+	fail_unless(pos == end);
+
+	bool skip_ok = true;
+	for (int i = 0; i <= count; i++) {
+		if (field_scan_skip(data, i) != data + expected[i])
+			skip_ok = false;
+	}
+	ok(skip_ok, "%s: skip", name);
+
+	bool offsets_ok = true;
+	uint32_t offsets[MAX_FIELDS + 1];
+	for (int i = 0; i <= count; i++) {
+		const char *ret = field_scan_offsets(data + expected[i],
+						     count - i, data,
+						     offsets);
+		if (ret != end ||
+		    memcmp(offsets, expected + i,
+			   (count - i + 1) * sizeof(*offsets)) != 0)
+			offsets_ok = false;
+	}
+	ok(offsets_ok, "%s: offsets", name);
+	free(data);
+}
+
+static void
+field_scan_test(void)
+{
+	check_field_scan(small_ints, 100, "small ints");
+	check_field_scan(small_ints, 31, "small ints, short");
+	check_field_scan(small_ints, 1, "one field");
+	check_field_scan(mixed, 100, "mixed");
+	check_field_scan(runs, MAX_FIELDS, "runs");
+	check_field_scan(all_types, 95, "all types");
+}
+
+int
+main()
+{
+	header();
+	plan(24);
+
+	/* Default implementation. */
+	field_scan_test();
+	/* Implementation picked for this CPU. */
+	field_scan_init();
+	field_scan_test();
+
+	footer();
+	check_plan();
+}
@@ -171,6 +171,44 @@ test_percentile(void)
 	footer();
 }
 
+static void
+test_merge(void)
+{
+	header();
+
+	size_t n_buckets;
+	int64_t *buckets = gen_buckets(&n_buckets);
+
+	size_t data_len;
+	int64_t *data = gen_rand_data(&data_len);
+
+	struct histogram *hist = histogram_new(buckets, n_buckets);
+	struct histogram *hist1 = histogram_new(buckets, n_buckets);
+	struct histogram *hist2 = histogram_new(buckets, n_buckets);
+	for (size_t i = 0; i < data_len; i++) {
+		histogram_collect(hist, data[i]);
+		histogram_collect(i % 2 == 0 ? hist1 : hist2, data[i]);
+	}
+	histogram_merge(hist1, hist2);
+
+	fail_if(hist1->total != hist->total);
+	fail_if(hist1->max != hist->max);
+	for (size_t b = 0; b < n_buckets; b++)
+		fail_if(hist1->buckets[b].count != hist->buckets[b].count);
+	for (int pml = 5; pml < 1000; pml += 5) {
+		fail_if(histogram_permille(hist1, pml) !=
+			histogram_permille(hist, pml));
+	}
+
+	histogram_delete(hist);
+	histogram_delete(hist1);
+	histogram_delete(hist2);
+	free(data);
+	free(buckets);
+
+	footer();
+}
+
 int
 main()
 {
@@ -178,4 +216,5 @@ main()
 	test_counts();
 	test_discard();
 	test_percentile();
+	test_merge();
 }
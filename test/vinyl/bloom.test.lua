@@ -60,3 +60,49 @@ new_reflects() > 980
 new_seeks() < 20
 
 s:drop()
+
+--
+-- A prefix bloom filter lets lookups by a partial key skip runs.
+--
+test_run = require('test_run').new()
+s = box.schema.space.create('test', {engine = 'vinyl'})
+ok, err = pcall(s.create_index, s, 'pk', {parts = {1, 'unsigned', 2, 'unsigned'}, bloom_prefix_parts = 2})
+ok
+string.match(tostring(err), 'bloom_prefix_parts must be less than part count') ~= nil
+_ = s:create_index('pk', {parts = {1, 'unsigned', 2, 'unsigned'}, bloom_prefix_parts = 1, run_count_per_level = 10})
+box.space._index:get{s.id, 0}[5].bloom_prefix_parts
+function bloom_hits() return s.index.pk:info().disk.iterator.bloom.hit end
+for i = 1, 10 do for j = 1, 10 do s:replace{i, j} end end
+box.snapshot()
+for i = 11, 20 do for j = 1, 10 do s:replace{i, j} end end
+box.snapshot()
+s.index.pk:info().run_count
+hits = bloom_hits()
+-- Every tenant is found in exactly one run.
+count = 0
+for i = 1, 20 do count = count + #s:select{i} end
+count
+bloom_hits() - hits >= 18
+#s:select({5}, {iterator = 'REQ'})
+s:select({15}, {iterator = 'REQ', limit = 2})
+-- Absent tenants are filtered out in both runs.
+hits = bloom_hits()
+count = 0
+for i = 21, 120 do count = count + #s:select{i} end
+count
+bloom_hits() - hits > 180
+-- Range lookups don't use the filter.
+hits = bloom_hits()
+#s:select({10}, {iterator = 'GE'})
+bloom_hits() - hits
+-- The filter survives restart.
+test_run:cmd('restart server default')
+s = box.space.test
+function bloom_hits() return s.index.pk:info().disk.iterator.bloom.hit end
+hits = bloom_hits()
+count = 0
+for i = 21, 120 do count = count + #s:select{i} end
+count
+bloom_hits() - hits > 180
+#s:select{7}
+s:drop()
@@ -0,0 +1,79 @@
+--
+-- Compaction policies and amplification statistics.
+--
+test_run = require('test_run').new()
+fiber = require('fiber')
+digest = require('digest')
+box.cfg{vinyl_cache = 0}
+s = box.schema.space.create('test', {engine = 'vinyl'})
+s:create_index('pk', {compaction_policy = 'foo'})
+s:create_index('pk', {compaction_policy = 1})
+s:create_index('pk', {compaction_time_window = 0})
+_ = s:create_index('pk', {compaction_policy = 'LEVELED', compaction_time_window = 60})
+box.space._index:get{s.id, 0}[5].compaction_policy
+box.space._index:get{s.id, 0}[5].compaction_time_window
+s:drop()
+function dump(first, count) for i = first, first + count - 1 do s:replace{i, digest.urandom(100)} end box.snapshot() end
+--
+-- Tiered compaction (the default) lets a level accumulate
+-- run_count_per_level runs before compacting it.
+--
+s = box.schema.space.create('test', {engine = 'vinyl'})
+pk = s:create_index('pk', {run_count_per_level = 2, run_size_ratio = 4, bloom_fpr = 1})
+dump(1, 60)
+dump(101, 10)
+dump(201, 10)
+pk:info().run_count
+pk:info().disk.compact.count
+s:drop()
+--
+-- Leveled compaction keeps each run run_size_ratio times
+-- larger than all newer runs.
+--
+s = box.schema.space.create('test', {engine = 'vinyl'})
+pk = s:create_index('pk', {compaction_policy = 'leveled', run_count_per_level = 2, run_size_ratio = 4, bloom_fpr = 1})
+dump(1, 60)
+dump(101, 10)
+pk:info().run_count
+amp = pk:info().amplification
+amp.write
+amp.space > 1
+box.stat.reset()
+s:get{1000}
+pk:info().amplification.read
+dump(201, 10)
+while pk:info().disk.compact.count < 1 do fiber.sleep(0.01) end
+pk:info().run_count
+amp = pk:info().amplification
+amp.write > 1
+amp.space
+s:drop()
+--
+-- Time window compaction never mixes runs dumped in different
+-- windows and compacts runs of a window once it is closed.
+--
+s = box.schema.space.create('test', {engine = 'vinyl'})
+window = 1
+pk = s:create_index('pk', {compaction_policy = 'time_window', compaction_time_window = window, run_count_per_level = 10})
+-- Make sure the first two runs are dumped in the same window.
+fiber.sleep(window - fiber.time() % window + 0.01)
+dump(1, 10)
+dump(101, 10)
+pk:info().run_count
+fiber.sleep(window)
+dump(201, 10)
+while pk:info().disk.compact.count < 1 do fiber.sleep(0.01) end
+pk:info().run_count
+pk:info().disk.compact.out.rows
+-- Dump time is persisted in the index file.
+test_run:cmd('restart server default')
+fiber = require('fiber')
+digest = require('digest')
+s = box.space.test
+pk = s.index.pk
+function dump(first, count) for i = first, first + count - 1 do s:replace{i, digest.urandom(100)} end box.snapshot() end
+dump(301, 10)
+fiber.sleep(0.1)
+pk:info().run_count
+pk:info().disk.compact.count
+s:drop()
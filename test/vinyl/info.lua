@@ -2,6 +2,7 @@
 
 box.cfg{
     vinyl_cache = 15 * 1024, -- 15K to test cache eviction
+    vinyl_page_cache = 0, -- count all page reads as disk reads
 }
 
 require('console').listen(os.getenv('ADMIN'))
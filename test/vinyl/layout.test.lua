@@ -56,5 +56,6 @@ box.backup.stop() -- resume the garbage collection process
 test_run:cmd("push filter 'timestamp: .*' to 'timestamp: <timestamp>'")
 test_run:cmd("push filter 'offset: .*' to 'offset: <offset>'")
 test_run:cmd("push filter 'bloom_filter: .*' to 'bloom_filter: <bloom_filter>'")
+test_run:cmd("push filter 'dump_time: .*' to 'dump_time: <dump_time>'")
 result
 test_run:cmd("clear filter")
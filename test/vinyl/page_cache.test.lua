@@ -0,0 +1,42 @@
+--
+-- Cache of decompressed run pages, see box.cfg.vinyl_page_cache.
+--
+test_run = require('test_run').new()
+-- Disable the tuple cache so that lookups always reach the disk.
+vinyl_cache = box.cfg.vinyl_cache
+box.cfg{vinyl_cache = 0}
+-- Flush pages cached by other tests.
+page_cache = box.cfg.vinyl_page_cache
+box.cfg{vinyl_page_cache = 0}
+box.cfg{vinyl_page_cache = page_cache}
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk', {page_size = 1024})
+for i = 1, 4 do s:insert{i, string.rep('x', 100)} end
+box.snapshot()
+function stat() return s.index.pk:info().disk.iterator end
+-- The first lookup reads the page from disk.
+s:get{1} ~= nil
+stat().page_cache.hit
+stat().page_cache.miss
+stat().read.pages
+box.info.vinyl().page_cache.pages
+box.info.vinyl().page_cache.used > 0
+-- A lookup of another key in the same page finds it in the cache.
+s:get{2} ~= nil
+stat().page_cache.hit
+stat().page_cache.miss
+stat().read.pages
+#s:select{}
+stat().page_cache.hit
+stat().read.pages
+-- Shrinking the cache evicts pages.
+box.cfg{vinyl_page_cache = 0}
+box.info.vinyl().page_cache.pages
+box.info.vinyl().page_cache.used
+s:get{1} ~= nil
+stat().page_cache.miss
+stat().read.pages
+box.info.vinyl().page_cache.pages
+box.cfg{vinyl_page_cache = page_cache}
+s:drop()
+box.cfg{vinyl_cache = vinyl_cache}
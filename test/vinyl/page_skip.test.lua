@@ -0,0 +1,39 @@
+--
+-- Min and max keys stored in the page index let the run
+-- iterator skip pages that can't contain the searched key.
+--
+test_run = require('test_run').new()
+-- Disable caches so that lookups always reach the disk.
+vinyl_cache = box.cfg.vinyl_cache
+box.cfg{vinyl_cache = 0}
+page_cache = box.cfg.vinyl_page_cache
+box.cfg{vinyl_page_cache = 0}
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk', {parts = {1, 'unsigned', 2, 'unsigned'}, page_size = 1024, bloom_fpr = 1})
+for i = 1, 100 do s:insert{i * 2, 0, string.rep('x', 100)} end
+box.snapshot()
+page_count = s.index.pk:info().disk.pages
+page_count > 1
+function skipped() return s.index.pk:info().disk.iterator.skipped_pages end
+function pages() return s.index.pk:info().disk.iterator.read.pages end
+-- Keys greater than all keys of the run don't need a page read.
+sk, pg = skipped(), pages()
+s:get{1000, 0}
+s:select({1000}, {iterator = 'GE'})
+s:select({200}, {iterator = 'GT'})
+skipped() - sk
+pages() - pg
+-- A partial key lookup skips the page preceding the first
+-- matching one and stops at the end of the last matching page.
+sk = skipped()
+count = 0
+for i = 1, 100 do count = count + #s:select{i * 2} end
+count
+skipped() - sk == 2 * (page_count - 1)
+-- Max keys are persisted in the index file.
+test_run:cmd('restart server default')
+s = box.space.test
+function skipped() return s.index.pk:info().disk.iterator.skipped_pages end
+s:select({1000}, {iterator = 'GE'})
+skipped()
+s:drop()
@@ -0,0 +1,38 @@
+--
+-- Point lookups read pages of all runs in one batch.
+--
+test_run = require('test_run').new()
+-- Disable caches so that lookups always reach the disk.
+vinyl_cache = box.cfg.vinyl_cache
+box.cfg{vinyl_cache = 0}
+page_cache = box.cfg.vinyl_page_cache
+box.cfg{vinyl_page_cache = 0}
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk', {run_count_per_level = 10})
+function stat() return s.index.pk:info().disk.iterator end
+s:insert{1, 1}
+box.snapshot()
+s:upsert({1, 1}, {{'+', 2, 1}})
+s:insert{2, 2}
+box.snapshot()
+s:upsert({1, 1}, {{'+', 2, 1}})
+s:insert{3, 3}
+box.snapshot()
+s.index.pk:info().run_count
+-- The history of the key is collected from all runs.
+s:get{1}
+stat().read.pages
+s:get{2}
+s:get{3}
+s:get{4}
+-- A terminal statement in a newer run.
+s:replace{1, 10}
+box.snapshot()
+s:get{1}
+s:delete{2}
+box.snapshot()
+s:get{2}
+s:select{}
+s:drop()
+box.cfg{vinyl_page_cache = page_cache}
+box.cfg{vinyl_cache = vinyl_cache}
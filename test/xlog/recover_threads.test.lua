@@ -0,0 +1,41 @@
+env = require('test_run')
+test_run = env.new()
+
+--
+-- Recovery with memtx_threads > 1: the snapshot is read in
+-- a separate thread and secondary keys are built in parallel.
+--
+test_run:cmd("create server memtx_threads with script='xlog/memtx_threads.lua'")
+test_run:cmd("start server memtx_threads")
+test_run:cmd("switch memtx_threads")
+box.cfg.memtx_threads
+
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+_ = s:create_index('sk1', {parts = {2, 'unsigned'}})
+_ = s:create_index('sk2', {parts = {3, 'string'}, unique = false})
+_ = s:create_index('sk3', {type = 'hash', parts = {2, 'unsigned', 3, 'string'}})
+box.begin() for i = 1, 10000 do s:insert{i, 10000 - i, tostring(i % 100)} end box.commit()
+box.snapshot()
+-- Rows that are recovered from the WAL.
+box.begin() for i = 10001, 11000 do s:insert{i, i, tostring(i % 100)} end box.commit()
+
+test_run:cmd("restart server memtx_threads")
+
+s = box.space.test
+s:len()
+s.index.sk1:len()
+s.index.sk2:len()
+s.index.sk3:len()
+s.index.sk1:min()
+s.index.sk1:max()
+s.index.sk2:count('42')
+s.index.sk3:get{9000, '0'}
+ok = true
+prev = -1
+for _, t in s.index.sk1:pairs() do ok = ok and t[2] > prev prev = t[2] end
+ok
+
+test_run:cmd("switch default")
+test_run:cmd("stop server memtx_threads")
+test_run:cmd("cleanup server memtx_threads")
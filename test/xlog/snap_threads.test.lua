@@ -0,0 +1,36 @@
+test_run = require('test_run').new()
+test_run:cmd('restart server default with cleanup=1')
+
+fio = require('fio')
+xlog = require('xlog')
+
+--
+-- A snapshot written by several threads.
+--
+box.cfg{memtx_threads = 4}
+
+for i = 1, 8 do box.schema.space.create('test' .. i) end
+for i = 1, 8 do box.space['test' .. i]:create_index('pk') end
+for i = 1, 8 do box.space['test' .. i]:create_index('sk', {parts = {2, 'unsigned'}}) end
+for i = 1, 8 do box.begin() for j = 1, 1000 * i do box.space['test' .. i]:insert{j, j * i} end box.commit() end
+
+box.snapshot()
+
+-- All rows are in the snapshot once.
+snap_path = fio.pathjoin(box.cfg.memtx_dir, string.format("%020d.snap", box.info.signature))
+count = {}
+for _, row in xlog.pairs(snap_path) do local id = row.BODY.space_id count[id] = (count[id] or 0) + 1 end
+ok = true
+for i = 1, 8 do local s = box.space['test' .. i] ok = ok and count[s.id] == s:len() end
+ok
+
+test_run:cmd('restart server default')
+
+for i = 1, 8 do assert(box.space['test' .. i]:len() == 1000 * i) end
+box.space.test8.index.sk:get(8000)
+box.space.test3:get(1000)
+
+box.cfg.memtx_threads
+box.cfg{memtx_threads = 1}
+
+for i = 1, 8 do box.space['test' .. i]:drop() end